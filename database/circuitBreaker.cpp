@@ -0,0 +1,116 @@
+#include "circuitBreaker.hpp"
+
+CircuitBreaker::CircuitBreaker(const CircuitBreakerConfig& config) : config(config)
+{
+}
+
+CircuitBreaker& CircuitBreaker::getInstance()
+{
+    static CircuitBreaker instance;
+    return instance;
+}
+
+bool CircuitBreaker::allowRequest()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == BreakerState::CLOSED)
+    {
+        return true;
+    }
+
+    // Open: wait for the cool-down. Half-open: a probe that never reported back is replaced after the same delay
+    auto now = std::chrono::steady_clock::now();
+    if (now - openedAt < std::chrono::milliseconds(config.openMs))
+    {
+        return false;
+    }
+    state = BreakerState::HALF_OPEN;
+    openedAt = now;
+    return true;
+}
+
+bool CircuitBreaker::wouldAllowRequest() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return state == BreakerState::CLOSED ||
+           std::chrono::steady_clock::now() - openedAt >= std::chrono::milliseconds(config.openMs);
+}
+
+void CircuitBreaker::recordSuccess(std::chrono::milliseconds latency)
+{
+    record(latency.count() > config.slowCallMs);
+}
+
+void CircuitBreaker::recordFailure()
+{
+    record(true);
+}
+
+BreakerState CircuitBreaker::getState() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return state;
+}
+
+void CircuitBreaker::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    state = BreakerState::CLOSED;
+    outcomes.clear();
+    failures = 0;
+}
+
+void CircuitBreaker::configure(const CircuitBreakerConfig& newConfig)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    config = newConfig;
+    state = BreakerState::CLOSED;
+    outcomes.clear();
+    failures = 0;
+}
+
+void CircuitBreaker::record(bool failed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == BreakerState::HALF_OPEN)
+    {
+        // The probe decides: back to normal, or another cool-down
+        if (failed)
+        {
+            open();
+        }
+        else
+        {
+            state = BreakerState::CLOSED;
+            outcomes.clear();
+            failures = 0;
+        }
+        return;
+    }
+    if (state == BreakerState::OPEN)
+    {
+        return;
+    }
+
+    outcomes.push_back(failed);
+    failures += failed ? 1 : 0;
+    if (outcomes.size() > config.window)
+    {
+        failures -= outcomes.front() ? 1 : 0;
+        outcomes.pop_front();
+    }
+
+    if (outcomes.size() >= config.minCalls &&
+        failures * 100 >= static_cast<std::size_t>(config.errorRatePercent) * outcomes.size())
+    {
+        open();
+    }
+}
+
+void CircuitBreaker::open()
+{
+    state = BreakerState::OPEN;
+    openedAt = std::chrono::steady_clock::now();
+    outcomes.clear();
+    failures = 0;
+}
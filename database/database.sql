@@ -21,10 +21,12 @@ VALUES
 -- Create the `hubs` table
 DROP TABLE IF EXISTS `hubs`;
 CREATE TABLE `hubs` (
-  `id_hub` int DEFAULT NULL,
-  `id_product` int DEFAULT NULL,
-  `product_name` varchar(100) DEFAULT NULL,
-  `available_quantity` int DEFAULT '0'
+  `id_hub` int NOT NULL,
+  `id_product` int NOT NULL,
+  `product_name` varchar(100) NOT NULL,
+  `available_quantity` int NOT NULL DEFAULT '0',
+  PRIMARY KEY (`id_hub`, `id_product`),
+  KEY `idx_hubs_product_name` (`product_name`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
 
 -- Insert data into the `hubs` table
@@ -35,10 +37,12 @@ UNLOCK TABLES;
 -- Create the `warehouses` table
 DROP TABLE IF EXISTS `warehouses`;
 CREATE TABLE `warehouses` (
-  `id_warehouse` int DEFAULT NULL,
-  `id_product` int DEFAULT NULL,
-  `product_name` varchar(100) DEFAULT NULL,
-  `available_quantity` int DEFAULT NULL
+  `id_warehouse` int NOT NULL,
+  `id_product` int NOT NULL,
+  `product_name` varchar(100) NOT NULL,
+  `available_quantity` int NOT NULL DEFAULT '0',
+  PRIMARY KEY (`id_warehouse`, `id_product`),
+  KEY `idx_warehouses_product_name` (`product_name`)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
 
 -- Insert data into the `warehouses` table
@@ -105,3 +109,61 @@ BEGIN
 	WHERE product_name = p_product_name AND id_warehouse = p_warehouse_id;
 END ;;
 DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `updateHubInventoryById`(
+    IN p_hub_id INT,         -- Hub ID
+    IN p_product_id INT,     -- Product ID
+    IN p_quantity INT        -- Quantity to add (can be negative to subtract)
+)
+BEGIN
+    -- Primary key lookup on (id_hub, id_product)
+    UPDATE hubs
+    SET available_quantity = available_quantity + p_quantity
+    WHERE id_hub = p_hub_id
+    AND id_product = p_product_id
+    AND available_quantity + p_quantity >= 0;  -- Ensure no negative quantities
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `updateWarehouseInventoryById`(
+    IN p_warehouse_id INT,   -- Warehouse ID
+    IN p_product_id INT,     -- Product ID
+    IN p_quantity INT        -- Quantity to add (can be negative to subtract)
+)
+BEGIN
+    -- Primary key lookup on (id_warehouse, id_product)
+    UPDATE warehouses
+    SET available_quantity = available_quantity + p_quantity
+    WHERE id_warehouse = p_warehouse_id
+    AND id_product = p_product_id
+    AND available_quantity + p_quantity >= 0;  -- Ensure no negative quantities
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `getHubInventoryById`(
+	IN p_hub_id INT,
+	IN p_product_id INT
+)
+BEGIN
+	-- Get the available quantity for the product in the hub
+	SELECT available_quantity
+	FROM hubs
+	WHERE id_hub = p_hub_id AND id_product = p_product_id;
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `getWarehouseInventoryById`(
+	IN p_warehouse_id INT,
+	IN p_product_id INT
+)
+BEGIN
+	-- Get the available quantity for the product in the warehouse
+	SELECT available_quantity
+	FROM warehouses
+	WHERE id_warehouse = p_warehouse_id AND id_product = p_product_id;
+END ;;
+DELIMITER ;
@@ -0,0 +1,157 @@
+#include "db_pool.h"
+
+static const char* statementQueries[DB_STMT_COUNT] = {
+    "SELECT name, password, role FROM user WHERE email = ?",
+    "INSERT INTO user (name, password, email, role) VALUES (?, ?, ?, ?)",
+    "DELETE FROM user WHERE email = ?",
+    "SELECT name, email, role FROM user",
+};
+
+static pthread_once_t poolOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t connectionReleased = PTHREAD_COND_INITIALIZER;
+static DbConnection* pool = NULL;
+static int poolSize = 0;
+
+int loadDbPoolSize(void)
+{
+    const char* value = getenv("DB_POOL_SIZE");
+    if (value != NULL)
+    {
+        int size = atoi(value);
+        if (size > 0)
+            return size;
+    }
+    return DB_POOL_SIZE;
+}
+
+static void initDbPool(void)
+{
+    int size = loadDbPoolSize();
+    pool = calloc((size_t)size, sizeof(DbConnection));
+    if (!pool)
+    {
+        fprintf(stderr, "❌ Could not allocate the connection pool\n");
+        return;
+    }
+    poolSize = size;
+    atexit(closeDbPool);
+}
+
+static void closeDbConnection(DbConnection* connection)
+{
+    for (int i = 0; i < DB_STMT_COUNT; i++)
+    {
+        if (connection->stmts[i])
+        {
+            mysql_stmt_close(connection->stmts[i]);
+            connection->stmts[i] = NULL;
+        }
+    }
+    if (connection->conn)
+    {
+        mysql_close(connection->conn);
+        connection->conn = NULL;
+    }
+}
+
+DbConnection* acquireDbConnection(void)
+{
+    pthread_once(&poolOnce, initDbPool);
+    if (poolSize == 0)
+        return NULL;
+
+    pthread_mutex_lock(&poolMutex);
+    DbConnection* connection = NULL;
+    while (!connection)
+    {
+        // Reuse an open connection before opening a new one
+        for (int i = 0; i < poolSize && !connection; i++)
+        {
+            if (!pool[i].inUse && pool[i].conn)
+                connection = &pool[i];
+        }
+        for (int i = 0; i < poolSize && !connection; i++)
+        {
+            if (!pool[i].inUse)
+                connection = &pool[i];
+        }
+        if (!connection)
+            pthread_cond_wait(&connectionReleased, &poolMutex);
+    }
+    connection->inUse = true;
+    pthread_mutex_unlock(&poolMutex);
+
+    if (!connection->conn)
+    {
+        connection->conn = connectToDb();
+        if (!connection->conn)
+        {
+            releaseDbConnection(connection, true);
+            return NULL;
+        }
+    }
+    return connection;
+}
+
+void releaseDbConnection(DbConnection* connection, bool broken)
+{
+    if (!connection)
+        return;
+
+    if (broken)
+    {
+        closeDbConnection(connection);
+    }
+    else
+    {
+        for (int i = 0; i < DB_STMT_COUNT; i++)
+        {
+            if (connection->stmts[i])
+                mysql_stmt_free_result(connection->stmts[i]);
+        }
+    }
+
+    pthread_mutex_lock(&poolMutex);
+    connection->inUse = false;
+    pthread_cond_signal(&connectionReleased);
+    pthread_mutex_unlock(&poolMutex);
+}
+
+MYSQL_STMT* getDbStatement(DbConnection* connection, DbStatement statement)
+{
+    if (!connection || !connection->conn || statement < 0 || statement >= DB_STMT_COUNT)
+        return NULL;
+
+    if (connection->stmts[statement])
+        return connection->stmts[statement];
+
+    MYSQL_STMT* stmt = mysql_stmt_init(connection->conn);
+    if (!stmt)
+    {
+        fprintf(stderr, "❌ mysql_stmt_init() failed\n");
+        return NULL;
+    }
+
+    const char* query = statementQueries[statement];
+    if (mysql_stmt_prepare(stmt, query, strlen(query)))
+    {
+        fprintf(stderr, "❌ mysql_stmt_prepare() failed: %s\n", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    connection->stmts[statement] = stmt;
+    return stmt;
+}
+
+void closeDbPool(void)
+{
+    pthread_mutex_lock(&poolMutex);
+    for (int i = 0; i < poolSize; i++)
+    {
+        if (!pool[i].inUse)
+            closeDbConnection(&pool[i]);
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
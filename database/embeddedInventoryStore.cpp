@@ -0,0 +1,363 @@
+#include "embeddedInventoryStore.hpp"
+#include "stockLevelMonitor.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+
+// Products of the bundled schema, in the order of database/database.sql
+static const char* const SEED_PRODUCTS[] = {"Meat", "Water", "Medicines", "Weapons", "Clothes"};
+
+static bool syncPath(const std::string& path, int flags)
+{
+    int syncFd = ::open(path.c_str(), flags);
+    if (syncFd < 0)
+    {
+        return false;
+    }
+    bool synced = fsync(syncFd) == 0;
+    close(syncFd);
+    return synced;
+}
+
+static std::string directoryOf(const std::string& path)
+{
+    std::size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+}
+
+EmbeddedInventoryStore::~EmbeddedInventoryStore()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+EmbeddedInventoryStore::Key EmbeddedInventoryStore::makeKey(LocationType type, int locationId,
+                                                            const std::string& product)
+{
+    std::string lowered = product;
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return Key{type, locationId, lowered};
+}
+
+bool EmbeddedInventoryStore::open(const std::string& newPath)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    std::ifstream in(newPath);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        lineNumber++;
+        if (in.eof())
+        {
+            // Last line without its newline: the write was interrupted, so the change never committed
+            std::cerr << "⚠️ Ignoring incomplete line " << lineNumber << " of " << newPath << std::endl;
+            break;
+        }
+        if (!replay(line))
+        {
+            std::cerr << "⚠️ Ignoring invalid line " << lineNumber << " of " << newPath << std::endl;
+        }
+    }
+
+    path = newPath;
+    return compact();
+}
+
+bool EmbeddedInventoryStore::replay(const std::string& line)
+{
+    std::istringstream in(line);
+    std::string operation;
+    std::string typeName;
+    LocationType type;
+    int locationId;
+    std::string product;
+
+    in >> operation >> typeName >> locationId;
+    if (!in || !parseLocationType(typeName, type))
+    {
+        return false;
+    }
+
+    if (operation == "set" || operation == "add")
+    {
+        int value;
+        if (!(in >> value) || !std::getline(in >> std::ws, product) || product.empty())
+        {
+            return false;
+        }
+        Key key = makeKey(type, locationId, product);
+        if (operation == "set")
+        {
+            rows[key] = Entry{value, product};
+            return true;
+        }
+        auto it = rows.find(key);
+        if (it == rows.end())
+        {
+            return false;
+        }
+        it->second.quantity += value;
+        return true;
+    }
+
+    if (operation == "move")
+    {
+        std::string destinationName;
+        LocationType destinationType;
+        int destinationId;
+        int quantity;
+        if (!(in >> destinationName >> destinationId >> quantity) ||
+            !parseLocationType(destinationName, destinationType) || !std::getline(in >> std::ws, product) ||
+            product.empty())
+        {
+            return false;
+        }
+        auto source = rows.find(makeKey(type, locationId, product));
+        auto destination = rows.find(makeKey(destinationType, destinationId, product));
+        if (source == rows.end() || destination == rows.end())
+        {
+            return false;
+        }
+        source->second.quantity -= quantity;
+        destination->second.quantity += quantity;
+        return true;
+    }
+
+    return false;
+}
+
+bool EmbeddedInventoryStore::compact()
+{
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        for (const auto& row : rows)
+        {
+            out << "set " << locationTypeName(std::get<0>(row.first)) << " " << std::get<1>(row.first) << " "
+                << row.second.quantity << " " << row.second.productName << "\n";
+        }
+        out.flush();
+        if (!out)
+        {
+            std::cerr << "❌ Could not write inventory file " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    // The rows reach the disk before the rename, and the rename before the first append
+    if (!syncPath(tmpPath, O_RDONLY))
+    {
+        std::cerr << "❌ Could not sync inventory file " << tmpPath << std::endl;
+        return false;
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "❌ Could not replace inventory file " << path << std::endl;
+        return false;
+    }
+    syncPath(directoryOf(path), O_RDONLY | O_DIRECTORY);
+
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "❌ Could not open inventory file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool EmbeddedInventoryStore::append(const std::string& line)
+{
+    if (fd < 0)
+    {
+        return true;
+    }
+
+    // One write per change, so a change is either entirely in the file or ends in an ignored partial line
+    std::string data = line + "\n";
+    const char* cursor = data.data();
+    std::size_t remaining = data.size();
+    while (remaining > 0)
+    {
+        ssize_t written = write(fd, cursor, remaining);
+        if (written < 0)
+        {
+            std::cerr << "❌ Could not persist inventory change to " << path << std::endl;
+            return false;
+        }
+        cursor += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+
+    // The change is only applied in memory once it is on disk
+    if (fdatasync(fd) != 0)
+    {
+        std::cerr << "❌ Could not sync inventory change to " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool EmbeddedInventoryStore::put(LocationType type, int locationId, const std::string& product, int quantity)
+{
+    if (quantity < 0 || product.empty())
+    {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!append("set " + locationTypeName(type) + " " + std::to_string(locationId) + " " + std::to_string(quantity) +
+                " " + product))
+    {
+        return false;
+    }
+    rows[makeKey(type, locationId, product)] = Entry{quantity, product};
+    StockLevelMonitor::getInstance().observe(type, locationId, product, quantity);
+    return true;
+}
+
+std::size_t EmbeddedInventoryStore::seed()
+{
+    if (size() > 0)
+    {
+        return 0;
+    }
+
+    std::size_t created = 0;
+    for (LocationType type : {LocationType::HUB, LocationType::WAREHOUSE})
+    {
+        for (int locationId = 1; locationId <= EMBEDDED_SEED_LOCATIONS; locationId++)
+        {
+            for (const char* product : SEED_PRODUCTS)
+            {
+                if (!put(type, locationId, product, 0))
+                {
+                    return 0;
+                }
+                created++;
+            }
+        }
+    }
+    return created;
+}
+
+std::size_t EmbeddedInventoryStore::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return rows.size();
+}
+
+int EmbeddedInventoryStore::getQuantity(LocationType type, int locationId, const std::string& product)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = rows.find(makeKey(type, locationId, product));
+    return it == rows.end() ? -1 : it->second.quantity;
+}
+
+int EmbeddedInventoryStore::addQuantity(LocationType type, int locationId, const std::string& product, int delta)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = rows.find(makeKey(type, locationId, product));
+    if (it == rows.end() || it->second.quantity + delta < 0)
+    {
+        std::cerr << "❌ No " << locationTypeName(type) << " records were updated." << std::endl;
+        return -1;
+    }
+
+    if (!append("add " + locationTypeName(type) + " " + std::to_string(locationId) + " " + std::to_string(delta) +
+                " " + it->second.productName))
+    {
+        return -1;
+    }
+    it->second.quantity += delta;
+    StockLevelMonitor::getInstance().observe(type, locationId, it->second.productName, it->second.quantity);
+    return 1;
+}
+
+int EmbeddedInventoryStore::raiseToCapacity(LocationType type, int locationId, const std::string& product,
+                                            int capacity)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = rows.find(makeKey(type, locationId, product));
+    if (it == rows.end())
+    {
+        std::cerr << "❌ No " << locationTypeName(type) << " records were updated." << std::endl;
+        return -1;
+    }
+
+    int missing = capacity - it->second.quantity;
+    if (missing <= 0)
+    {
+        return 0;
+    }
+    // Journaled as the add it resolved to, so a replay does not depend on the level at the time
+    if (!append("add " + locationTypeName(type) + " " + std::to_string(locationId) + " " + std::to_string(missing) +
+                " " + it->second.productName))
+    {
+        return -1;
+    }
+    it->second.quantity += missing;
+    StockLevelMonitor::getInstance().observe(type, locationId, it->second.productName, it->second.quantity);
+    return missing;
+}
+
+int EmbeddedInventoryStore::transfer(const InventoryTransfer& transfer)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto source = rows.find(makeKey(transfer.sourceType, transfer.sourceLocation, transfer.product));
+    auto destination = rows.find(makeKey(transfer.destinationType, transfer.destinationLocation, transfer.product));
+    if (source == rows.end() || destination == rows.end() || source->second.quantity < transfer.quantity ||
+        destination->second.quantity + transfer.quantity < 0)
+    {
+        std::cerr << "❌ Error updating inventory in realTimeUpdate." << std::endl;
+        return -1;
+    }
+
+    if (!append("move " + locationTypeName(transfer.sourceType) + " " + std::to_string(transfer.sourceLocation) + " " +
+                locationTypeName(transfer.destinationType) + " " + std::to_string(transfer.destinationLocation) + " " +
+                std::to_string(transfer.quantity) + " " + source->second.productName))
+    {
+        return -1;
+    }
+    source->second.quantity -= transfer.quantity;
+    destination->second.quantity += transfer.quantity;
+    StockLevelMonitor& monitor = StockLevelMonitor::getInstance();
+    monitor.observe(transfer.sourceType, transfer.sourceLocation, source->second.productName, source->second.quantity);
+    monitor.observe(transfer.destinationType, transfer.destinationLocation, destination->second.productName,
+                    destination->second.quantity);
+    return 1;
+}
+
+int EmbeddedInventoryStore::getSnapshot(LocationType type, const std::vector<int>& locationIds,
+                                        std::vector<StockLevel>& levels)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    int loaded = 0;
+    for (const auto& row : rows)
+    {
+        int locationId = std::get<1>(row.first);
+        if (std::get<0>(row.first) == type &&
+            (locationIds.empty() ||
+             std::find(locationIds.begin(), locationIds.end(), locationId) != locationIds.end()))
+        {
+            levels.push_back(StockLevel{type, locationId, row.second.productName, row.second.quantity});
+            loaded++;
+        }
+    }
+    return loaded;
+}
@@ -0,0 +1,120 @@
+#include "inventoryCache.hpp"
+#include "stockLevelMonitor.hpp"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+bool parseLocationType(const std::string& name, LocationType& type)
+{
+    if (name == "hub")
+    {
+        type = LocationType::HUB;
+        return true;
+    }
+    if (name == "warehouse")
+    {
+        type = LocationType::WAREHOUSE;
+        return true;
+    }
+    return false;
+}
+
+std::string locationTypeName(LocationType type)
+{
+    return type == LocationType::HUB ? "hub" : "warehouse";
+}
+
+InventoryCache& InventoryCache::getInstance()
+{
+    static InventoryCache instance;
+    return instance;
+}
+
+bool InventoryCache::Key::operator==(const Key& other) const
+{
+    return type == other.type && locationId == other.locationId && product == other.product;
+}
+
+std::size_t InventoryCache::KeyHash::operator()(const Key& key) const
+{
+    std::size_t hash = std::hash<std::string>()(key.product);
+    hash ^= std::hash<int>()(key.locationId) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::size_t>(key.type) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+InventoryCache::Key InventoryCache::makeKey(LocationType type, int locationId, const std::string& product)
+{
+    Key key{type, locationId, product};
+    std::transform(key.product.begin(), key.product.end(), key.product.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+void InventoryCache::load(LocationType type, int locationId, const std::string& product, int quantity)
+{
+    Key key = makeKey(type, locationId, product);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    levels[std::move(key)] = Entry{quantity, product};
+    StockLevelMonitor::getInstance().observe(type, locationId, product, quantity);
+}
+
+void InventoryCache::markWarm()
+{
+    warm = true;
+}
+
+bool InventoryCache::isWarm() const
+{
+    return warm;
+}
+
+bool InventoryCache::get(LocationType type, int locationId, const std::string& product, int& quantity) const
+{
+    Key key = makeKey(type, locationId, product);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = levels.find(key);
+    if (it == levels.end())
+    {
+        return false;
+    }
+    quantity = it->second.quantity;
+    return true;
+}
+
+bool InventoryCache::applyDelta(LocationType type, int locationId, const std::string& product, int delta)
+{
+    Key key = makeKey(type, locationId, product);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = levels.find(key);
+    if (it == levels.end() || it->second.quantity + delta < 0)
+    {
+        return false;
+    }
+    it->second.quantity += delta;
+    // Reported under the lock, so the monitor sees the levels of a row in the order they were written
+    StockLevelMonitor::getInstance().observe(type, locationId, it->second.productName, it->second.quantity);
+    return true;
+}
+
+void InventoryCache::forEach(const std::function<void(LocationType, int, const std::string&, int)>& visitor) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const auto& pair : levels)
+    {
+        visitor(pair.first.type, pair.first.locationId, pair.second.productName, pair.second.quantity);
+    }
+}
+
+std::size_t InventoryCache::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return levels.size();
+}
+
+void InventoryCache::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    levels.clear();
+    warm = false;
+}
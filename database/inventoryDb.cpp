@@ -1,8 +1,14 @@
 
 #include "inventoryDb.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <iostream>
 #include <json/json.h>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 
 const int EXIT_OPTION = 0;
 const int QUERY_WAREHOUSE = 1;
@@ -28,36 +34,260 @@ mysqlx::Session connectToDb()
     }
 }
 
-int getWarehouseInventory(mysqlx::Session& session, int warehouseId, const std::string& product)
+// Product name (lower-cased, as the database collation compares it) -> id_product
+static std::shared_mutex productIdsMutex;
+static std::unordered_map<std::string, int> productIds;
+
+static std::string lowerCase(const std::string& text)
+{
+    std::string lowered = text;
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lowered;
+}
+
+// Runs one database call under the inventory circuit breaker: failures and slow calls are recorded
+template <typename Query>
+static auto guarded(Query query) -> decltype(query())
+{
+    CircuitBreaker& breaker = CircuitBreaker::getInstance();
+    auto start = std::chrono::steady_clock::now();
+    try
+    {
+        auto result = query();
+        breaker.recordSuccess(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+        return result;
+    }
+    catch (const mysqlx::Error&)
+    {
+        breaker.recordFailure();
+        throw;
+    }
+}
+
+static void rememberProductId(const std::string& product, int productId)
+{
+    std::unique_lock<std::shared_mutex> lock(productIdsMutex);
+    productIds[lowerCase(product)] = productId;
+}
+
+int resolveProductId(mysqlx::Session& session, const std::string& product)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(productIdsMutex);
+        auto it = productIds.find(lowerCase(product));
+        if (it != productIds.end())
+        {
+            return it->second;
+        }
+    }
+
+    try
+    {
+        int productId = guarded([&session, &product]() {
+            mysqlx::SqlResult sql_result = session
+                                               .sql("SELECT id_product FROM hubs WHERE product_name = ? UNION "
+                                                    "SELECT id_product FROM warehouses WHERE product_name = ? LIMIT 1")
+                                               .bind(product, product)
+                                               .execute();
+            mysqlx::Row row;
+            if ((row = sql_result.fetchOne()) && !row[0].isNull())
+            {
+                return row[0].get<int>();
+            }
+            return -1;
+        });
+
+        if (productId >= 0)
+        {
+            rememberProductId(product, productId);
+        }
+        return productId;
+    }
+    catch (const mysqlx::Error& err)
+    {
+        std::cerr << "❌ Error resolving product ID: " << err.what() << std::endl;
+        return -1;
+    }
+}
+
+static int loadLocationRows(mysqlx::Session& session, const std::string& query, LocationType type)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    mysqlx::SqlResult sql_result = session.sql(query).execute();
+    int loaded = 0;
+    mysqlx::Row row;
+    while ((row = sql_result.fetchOne()))
+    {
+        if (row[0].isNull() || row[1].isNull() || row[2].isNull())
+        {
+            continue;
+        }
+        std::string product = row[2].get<std::string>();
+        int quantity = row[3].isNull() ? 0 : row[3].get<int>();
+        rememberProductId(product, row[1].get<int>());
+        cache.load(type, row[0].get<int>(), product, quantity);
+        loaded++;
+    }
+    return loaded;
+}
+
+int loadInventoryCache(mysqlx::Session& session)
 {
     try
     {
-        mysqlx::SqlResult sql_result =
-            session.sql("CALL getWarehouseInventory(?, ?)").bind(product, warehouseId).execute();
+        int loaded = loadLocationRows(
+            session, "SELECT id_hub, id_product, product_name, available_quantity FROM hubs", LocationType::HUB);
+        loaded += loadLocationRows(
+            session, "SELECT id_warehouse, id_product, product_name, available_quantity FROM warehouses",
+            LocationType::WAREHOUSE);
+        InventoryCache::getInstance().markWarm();
+        std::cout << "✅ Inventory cache warmed with " << loaded << " rows." << std::endl;
+        return loaded;
+    }
+    catch (const mysqlx::Error& err)
+    {
+        std::cerr << "❌ Error warming inventory cache: " << err.what() << std::endl;
+        InventoryCache::getInstance().clear();
+        return -1;
+    }
+}
+
+static int selectQuantity(mysqlx::Session& session, LocationType type, int locationId, int productId)
+{
+    return guarded([&]() -> int {
+        InventoryStatements* statements = InventoryStatements::forSession(session);
+        if (statements != nullptr)
+        {
+            return statements->selectQuantity(type, locationId, productId);
+        }
+
+        const char* query =
+            type == LocationType::HUB ? "CALL getHubInventoryById(?, ?)" : "CALL getWarehouseInventoryById(?, ?)";
+        mysqlx::SqlResult sql_result = session.sql(query).bind(locationId, productId).execute();
         mysqlx::Row row;
         if ((row = sql_result.fetchOne()))
         {
             return row[0];
         }
+        return -1;
+    });
+}
+
+static uint64_t addQuantity(mysqlx::Session& session, LocationType type, int locationId, int productId, int delta)
+{
+    return guarded([&]() -> uint64_t {
+        InventoryStatements* statements = InventoryStatements::forSession(session);
+        if (statements != nullptr)
+        {
+            return statements->addQuantity(type, locationId, productId, delta);
+        }
+
+        const char* query = type == LocationType::HUB ? "CALL updateHubInventoryById(?, ?, ?)"
+                                                      : "CALL updateWarehouseInventoryById(?, ?, ?)";
+        return session.sql(query).bind(locationId, productId, delta).execute().getAffectedItemsCount();
+    });
+}
+
+static int raiseQuantity(mysqlx::Session& session, LocationType type, int locationId, int productId, int capacity)
+{
+    // The row stays locked from the read to the write, so no credit lands in between
+    const char* query = type == LocationType::HUB
+                            ? "SELECT available_quantity FROM hubs WHERE id_hub = ? AND id_product = ? FOR UPDATE"
+                            : "SELECT available_quantity FROM warehouses WHERE id_warehouse = ? AND id_product = ? "
+                              "FOR UPDATE";
+    session.startTransaction();
+    try
+    {
+        int quantity = guarded([&]() -> int {
+            mysqlx::Row row = session.sql(query).bind(locationId, productId).execute().fetchOne();
+            return !row || row[0].isNull() ? -1 : row[0].get<int>();
+        });
+        int missing = capacity - quantity;
+        if (quantity < 0 || (missing > 0 && addQuantity(session, type, locationId, productId, missing) == 0))
+        {
+            session.rollback();
+            return -1;
+        }
+        session.commit();
+        return std::max(missing, 0);
+    }
+    catch (const mysqlx::Error&)
+    {
+        try
+        {
+            session.rollback();
+        }
+        catch (const mysqlx::Error&)
+        {
+        }
+        throw;
+    }
+}
+
+static int getInventory(mysqlx::Session& session, LocationType type, int locationId, const std::string& product)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    int quantity;
+    if (cache.isWarm())
+    {
+        return cache.get(type, locationId, product, quantity) ? quantity : -1;
+    }
+
+    if (!CircuitBreaker::getInstance().allowRequest())
+    {
+        // Degraded read-only mode: answer with the last level read from the database
+        return cache.get(type, locationId, product, quantity) ? quantity : -1;
+    }
 
+    int productId = resolveProductId(session, product);
+    if (productId < 0)
+    {
         return -1;
     }
+
+    try
+    {
+        quantity = selectQuantity(session, type, locationId, productId);
+        if (quantity >= 0)
+        {
+            cache.load(type, locationId, product, quantity);
+        }
+        return quantity;
+    }
     catch (const mysqlx::Error& err)
     {
-        std::cerr << "❌ Error getting warehouse inventory: " << err.what() << std::endl;
+        std::cerr << "❌ Error getting " << locationTypeName(type) << " inventory: " << err.what() << std::endl;
         return -1;
     }
 }
 
+int getWarehouseInventory(mysqlx::Session& session, int warehouseId, const std::string& product)
+{
+    return getInventory(session, LocationType::WAREHOUSE, warehouseId, product);
+}
+
 int updateWarehouseInventory(mysqlx::Session& session, int warehouseId, const std::string& product, int quantity)
 {
-    try
+    if (!CircuitBreaker::getInstance().allowRequest())
+    {
+        std::cerr << "❌ Inventory database unavailable, warehouse not updated." << std::endl;
+        return -1;
+    }
+
+    int productId = resolveProductId(session, product);
+    if (productId < 0)
     {
-        mysqlx::SqlResult result =
-            session.sql("CALL updateWarehouseInventory(?, ?, ?)").bind(warehouseId, product, quantity).execute();
+        std::cerr << "❌ No warehouse records were updated." << std::endl;
+        return -1;
+    }
 
-        if (result.getAffectedItemsCount() > 0)
+    try
+    {
+        if (addQuantity(session, LocationType::WAREHOUSE, warehouseId, productId, quantity) > 0)
         {
+            InventoryCache::getInstance().applyDelta(LocationType::WAREHOUSE, warehouseId, product, quantity);
             std::cout << "✅ Warehouse inventory updated." << std::endl;
             return 1;
         }
@@ -76,33 +306,29 @@ int updateWarehouseInventory(mysqlx::Session& session, int warehouseId, const st
 
 int getHubInventory(mysqlx::Session& session, int hubId, const std::string& product)
 {
-    try
-    {
-        mysqlx::SqlResult sql_result = session.sql("CALL getHubInventory(?, ?)").bind(product, hubId).execute();
-        mysqlx::Row row;
-        if ((row = sql_result.fetchOne()))
-        {
-            return row[0];
-        }
+    return getInventory(session, LocationType::HUB, hubId, product);
+}
 
+int updateHubInventory(mysqlx::Session& session, int hubId, const std::string& product, int quantity)
+{
+    if (!CircuitBreaker::getInstance().allowRequest())
+    {
+        std::cerr << "❌ Inventory database unavailable, hub not updated." << std::endl;
         return -1;
     }
-    catch (const mysqlx::Error& err)
+
+    int productId = resolveProductId(session, product);
+    if (productId < 0)
     {
-        std::cerr << "❌ Error getting hub inventory: " << err.what() << std::endl;
+        std::cerr << "❌ No hub records were updated." << std::endl;
         return -1;
     }
-}
 
-int updateHubInventory(mysqlx::Session& session, int hubId, const std::string& product, int quantity)
-{
     try
     {
-        mysqlx::SqlResult result =
-            session.sql("CALL updateHubInventory(?, ?, ?)").bind(hubId, product, quantity).execute();
-
-        if (result.getAffectedItemsCount() > 0)
+        if (addQuantity(session, LocationType::HUB, hubId, productId, quantity) > 0)
         {
+            InventoryCache::getInstance().applyDelta(LocationType::HUB, hubId, product, quantity);
             std::cout << "✅ Hub inventory updated." << std::endl;
             return 1;
         }
@@ -119,47 +345,269 @@ int updateHubInventory(mysqlx::Session& session, int hubId, const std::string& p
     }
 }
 
+int getInventorySnapshot(mysqlx::Session& session, LocationType type, const std::vector<int>& locationIds,
+                         std::vector<StockLevel>& levels)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    // With the breaker open the last known levels are served instead
+    if (cache.isWarm() || !CircuitBreaker::getInstance().allowRequest())
+    {
+        std::size_t before = levels.size();
+        cache.forEach([&](LocationType rowType, int locationId, const std::string& product, int quantity) {
+            if (rowType == type && (locationIds.empty() || std::find(locationIds.begin(), locationIds.end(),
+                                                                     locationId) != locationIds.end()))
+            {
+                levels.push_back(StockLevel{rowType, locationId, product, quantity});
+            }
+        });
+        return static_cast<int>(levels.size() - before);
+    }
+
+    std::string query = type == LocationType::HUB
+                            ? "SELECT id_hub, product_name, available_quantity FROM hubs"
+                            : "SELECT id_warehouse, product_name, available_quantity FROM warehouses";
+    if (!locationIds.empty())
+    {
+        query += type == LocationType::HUB ? " WHERE id_hub IN (" : " WHERE id_warehouse IN (";
+        for (std::size_t i = 0; i < locationIds.size(); i++)
+        {
+            query += i == 0 ? "?" : ", ?";
+        }
+        query += ")";
+    }
+
+    try
+    {
+        return guarded([&]() {
+            mysqlx::SqlStatement statement = session.sql(query);
+            for (int locationId : locationIds)
+            {
+                statement.bind(locationId);
+            }
+
+            mysqlx::SqlResult sql_result = statement.execute();
+            int loaded = 0;
+            mysqlx::Row row;
+            while ((row = sql_result.fetchOne()))
+            {
+                int quantity = row[2].isNull() ? 0 : row[2].get<int>();
+                levels.push_back(StockLevel{type, row[0].get<int>(), row[1].get<std::string>(), quantity});
+                loaded++;
+            }
+            return loaded;
+        });
+    }
+    catch (const mysqlx::Error& err)
+    {
+        std::cerr << "❌ Error reading inventory snapshot: " << err.what() << std::endl;
+        return -1;
+    }
+}
+
+int commitInventoryDeltas(mysqlx::Session& session, const std::vector<InventoryDelta>& deltas)
+{
+    if (!CircuitBreaker::getInstance().allowRequest())
+    {
+        std::cerr << "❌ Inventory database unavailable, batch not committed." << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        session.startTransaction();
+        for (const auto& delta : deltas)
+        {
+            int productId = resolveProductId(session, delta.product);
+            if (productId < 0 || addQuantity(session, delta.type, delta.locationId, productId, delta.delta) == 0)
+            {
+                std::cerr << "❌ Group commit could not update " << delta.product << " at location "
+                          << delta.locationId << std::endl;
+                session.rollback();
+                return 0;
+            }
+        }
+        session.commit();
+        return 1;
+    }
+    catch (const mysqlx::Error& err)
+    {
+        std::cerr << "❌ Error committing inventory batch: " << err.what() << std::endl;
+        try
+        {
+            session.rollback();
+        }
+        catch (const mysqlx::Error&)
+        {
+        }
+        return -1;
+    }
+}
+
 int realTimeUpdate(mysqlx::Session& session, const Json::Value& request)
 {
-    std::string sourceType = request["general_info"]["source"]["type"].asString();
-    int sourceLocation = request["general_info"]["source"]["location"].asInt();
+    MySqlInventoryStore store(session);
+    return realTimeUpdate(store, request);
+}
+
+MySqlInventoryStore::MySqlInventoryStore(mysqlx::Session& session) : session(session)
+{
+}
 
-    std::string destinationType = request["general_info"]["destination"]["type"].asString();
-    int destinationLocation = request["general_info"]["destination"]["location"].asInt();
+int MySqlInventoryStore::getQuantity(LocationType type, int locationId, const std::string& product)
+{
+    return getInventory(session, type, locationId, product);
+}
 
-    std::string productName = request["general_info"]["action"]["product"]["name"].asString();
-    int quantity = request["general_info"]["action"]["product"]["quantity"].asInt();
+int MySqlInventoryStore::addQuantity(LocationType type, int locationId, const std::string& product, int delta)
+{
+    return type == LocationType::HUB ? updateHubInventory(session, locationId, product, delta)
+                                     : updateWarehouseInventory(session, locationId, product, delta);
+}
 
-    int result = 0;
+int MySqlInventoryStore::raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity)
+{
+    // MySQL lags behind the ledger, so the level to top up from is the ledger's
+    InventoryWriteBehind& writeBehind = InventoryWriteBehind::getInstance();
+    if (writeBehind.isRunning())
+    {
+        return writeBehind.raiseToCapacity(type, locationId, product, capacity);
+    }
 
-    if (sourceType == "hub")
+    if (!CircuitBreaker::getInstance().allowRequest())
     {
-        result = updateHubInventory(session, sourceLocation, productName, -quantity);
+        std::cerr << "❌ Inventory database unavailable, " << locationTypeName(type) << " not updated." << std::endl;
+        return -1;
     }
-    else if (sourceType == "warehouse")
+
+    int productId = resolveProductId(session, product);
+    if (productId < 0)
     {
-        result = updateWarehouseInventory(session, sourceLocation, productName, -quantity);
+        std::cerr << "❌ No " << locationTypeName(type) << " records were updated." << std::endl;
+        return -1;
     }
 
-    if (result > 0)
+    try
     {
-        if (destinationType == "hub")
+        int added = raiseQuantity(session, type, locationId, productId, capacity);
+        if (added < 0)
         {
-            result = updateHubInventory(session, destinationLocation, productName, quantity);
+            std::cerr << "❌ No " << locationTypeName(type) << " records were updated." << std::endl;
+            return -1;
         }
-        else if (destinationType == "warehouse")
+        if (added > 0)
         {
-            result = updateWarehouseInventory(session, destinationLocation, productName, quantity);
+            InventoryCache::getInstance().applyDelta(type, locationId, product, added);
         }
+        return added;
+    }
+    catch (const mysqlx::Error& err)
+    {
+        std::cerr << "❌ Error raising " << locationTypeName(type) << " inventory: " << err.what() << std::endl;
+        return -1;
+    }
+}
+
+int MySqlInventoryStore::transfer(const InventoryTransfer& transfer)
+{
+    InventoryWriteBehind& writeBehind = InventoryWriteBehind::getInstance();
+    if (writeBehind.isRunning())
+    {
+        return writeBehind.submit(
+            {InventoryDelta{transfer.sourceType, transfer.sourceLocation, transfer.product, -transfer.quantity},
+             InventoryDelta{transfer.destinationType, transfer.destinationLocation, transfer.product,
+                            transfer.quantity}});
     }
-    else
+
+    // The source is debited first, so no client ever sees a credit for units that were not taken
+    int result = addQuantity(transfer.sourceType, transfer.sourceLocation, transfer.product, -transfer.quantity);
+    if (result <= 0)
     {
         std::cerr << "❌ Error updating inventory in realTimeUpdate." << std::endl;
+        return result;
+    }
+
+    result = addQuantity(transfer.destinationType, transfer.destinationLocation, transfer.product, transfer.quantity);
+    if (result > 0)
+    {
+        return result;
     }
 
+    if (addQuantity(transfer.sourceType, transfer.sourceLocation, transfer.product, transfer.quantity) <= 0)
+    {
+        std::cerr << "❌ Could not restore " << transfer.quantity << " units of " << transfer.product
+                  << " debited from location " << transfer.sourceLocation << ", the inventory needs reconciliation."
+                  << std::endl;
+        return TRANSFER_COMPENSATION_FAILED;
+    }
+    std::cerr << "❌ Error updating inventory in realTimeUpdate." << std::endl;
     return result;
 }
 
+int MySqlInventoryStore::getSnapshot(LocationType type, const std::vector<int>& locationIds,
+                                     std::vector<StockLevel>& levels)
+{
+    return getInventorySnapshot(session, type, locationIds, levels);
+}
+
+static std::future<int> readyFuture(int value)
+{
+    std::promise<int> promise;
+    promise.set_value(value);
+    return promise.get_future();
+}
+
+static std::future<int> getInventoryAsync(LocationType type, int locationId, const std::string& product)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    if (cache.isWarm())
+    {
+        int quantity = -1;
+        return readyFuture(cache.get(type, locationId, product, quantity) ? quantity : -1);
+    }
+
+    try
+    {
+        return InventoryExecutor::getInstance().submit([type, locationId, product](mysqlx::Session& session) {
+            return type == LocationType::HUB ? getHubInventory(session, locationId, product)
+                                             : getWarehouseInventory(session, locationId, product);
+        });
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "❌ Error queuing inventory query: " << err.what() << std::endl;
+        return readyFuture(-1);
+    }
+}
+
+std::future<int> getWarehouseInventoryAsync(int warehouseId, const std::string& product)
+{
+    return getInventoryAsync(LocationType::WAREHOUSE, warehouseId, product);
+}
+
+std::future<int> getHubInventoryAsync(int hubId, const std::string& product)
+{
+    return getInventoryAsync(LocationType::HUB, hubId, product);
+}
+
+bool realTimeUpdateAsync(const Json::Value& request, InventoryCallback onComplete)
+{
+    // Debit and credit run in order on one worker, so the credit only happens once the debit is confirmed
+    return InventoryExecutor::getInstance().post([request, onComplete](mysqlx::Session& session) {
+        onComplete(realTimeUpdate(session, request), session);
+    });
+}
+
+std::future<int> realTimeUpdateAsync(const Json::Value& request)
+{
+    auto promise = std::make_shared<std::promise<int>>();
+    std::future<int> future = promise->get_future();
+    if (!realTimeUpdateAsync(request, [promise](int result, mysqlx::Session&) { promise->set_value(result); }))
+    {
+        promise->set_value(-1);
+    }
+    return future;
+}
+
 /*void manageDbInventory() {
   int mOption;
 
@@ -0,0 +1,140 @@
+#include "inventoryExecutor.hpp"
+#include "inventoryStatements.hpp"
+#include <cstdlib>
+#include <iostream>
+
+int loadDbThreads()
+{
+    const char* value = std::getenv("DB_THREADS");
+    if (value == nullptr)
+    {
+        return DB_THREADS;
+    }
+
+    try
+    {
+        int parsed = std::stoi(value);
+        return parsed > 0 ? parsed : DB_THREADS;
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Invalid value in DB_THREADS, using " << DB_THREADS << "." << std::endl;
+        return DB_THREADS;
+    }
+}
+
+InventoryExecutor& InventoryExecutor::getInstance()
+{
+    static InventoryExecutor instance;
+    return instance;
+}
+
+bool InventoryExecutor::start(int threads, SessionFactory sessionFactory)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running || threads < 1)
+    {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<mysqlx::Session>> opened;
+    try
+    {
+        for (int i = 0; i < threads; i++)
+        {
+            opened.push_back(std::make_unique<mysqlx::Session>(sessionFactory()));
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "❌ Error opening inventory worker session: " << err.what() << std::endl;
+        return false;
+    }
+
+    sessions = std::move(opened);
+    running = true;
+    for (auto& session : sessions)
+    {
+        InventoryStatements::attach(*session);
+        workers.emplace_back(&InventoryExecutor::workerLoop, this, std::ref(*session));
+    }
+    return true;
+}
+
+void InventoryExecutor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    workers.clear();
+    for (auto& session : sessions)
+    {
+        InventoryStatements::detach(*session);
+    }
+    sessions.clear();
+}
+
+bool InventoryExecutor::isRunning() const
+{
+    return running;
+}
+
+bool InventoryExecutor::post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+    return true;
+}
+
+std::size_t InventoryExecutor::queueSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+void InventoryExecutor::workerLoop(mysqlx::Session& session)
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return !running || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try
+        {
+            task(session);
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "❌ Inventory task failed: " << err.what() << std::endl;
+        }
+    }
+}
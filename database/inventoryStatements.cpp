@@ -0,0 +1,74 @@
+#include "inventoryStatements.hpp"
+#include <mutex>
+#include <unordered_map>
+
+static std::mutex registryMutex;
+static std::unordered_map<mysqlx::Session*, std::unique_ptr<InventoryStatements>> registry;
+
+void InventoryStatements::attach(mysqlx::Session& session)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (registry.find(&session) == registry.end())
+    {
+        registry[&session] = std::unique_ptr<InventoryStatements>(new InventoryStatements(session));
+    }
+}
+
+void InventoryStatements::detach(mysqlx::Session& session)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(&session);
+}
+
+InventoryStatements* InventoryStatements::forSession(mysqlx::Session& session)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(&session);
+    return it == registry.end() ? nullptr : it->second.get();
+}
+
+InventoryStatements::InventoryStatements(mysqlx::Session& session) : session(session)
+{
+}
+
+InventoryStatements::TableStatements& InventoryStatements::statementsFor(LocationType type)
+{
+    std::unique_ptr<TableStatements>& statements = type == LocationType::HUB ? hubs : warehouses;
+    if (!statements)
+    {
+        const char* tableName = type == LocationType::HUB ? "hubs" : "warehouses";
+        std::string key = type == LocationType::HUB ? "id_hub = :location" : "id_warehouse = :location";
+        key += " AND id_product = :product";
+
+        mysqlx::Table table = session.getSchema(INVENTORY_SCHEMA).getTable(tableName);
+        statements.reset(new TableStatements{
+            table.select("available_quantity").where(key),
+            table.update()
+                .set("available_quantity", mysqlx::expr("available_quantity + :delta"))
+                .where(key + " AND available_quantity + :delta >= 0"),
+        });
+    }
+    return *statements;
+}
+
+int InventoryStatements::selectQuantity(LocationType type, int locationId, int productId)
+{
+    mysqlx::RowResult result =
+        statementsFor(type).select.bind("location", locationId).bind("product", productId).execute();
+    mysqlx::Row row = result.fetchOne();
+    if (!row || row[0].isNull())
+    {
+        return -1;
+    }
+    return row[0].get<int>();
+}
+
+uint64_t InventoryStatements::addQuantity(LocationType type, int locationId, int productId, int delta)
+{
+    mysqlx::Result result = statementsFor(type)
+                                .update.bind("location", locationId)
+                                .bind("product", productId)
+                                .bind("delta", delta)
+                                .execute();
+    return result.getAffectedItemsCount();
+}
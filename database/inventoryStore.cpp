@@ -0,0 +1,65 @@
+#include "inventoryStore.hpp"
+#include <cstdlib>
+#include <iostream>
+
+InventoryBackendConfig loadInventoryBackendConfig()
+{
+    InventoryBackendConfig config;
+
+    const char* backend = std::getenv("INVENTORY_BACKEND");
+    if (backend != nullptr && std::string(backend) == INVENTORY_BACKEND_EMBEDDED)
+    {
+        config.backend = InventoryBackend::EMBEDDED;
+    }
+
+    const char* path = std::getenv("INVENTORY_FILE");
+    if (path != nullptr)
+    {
+        config.path = path;
+    }
+
+    return config;
+}
+
+// Locations arrive either as numbers or as numeric strings
+static bool readLocation(const Json::Value& value, int& location)
+{
+    try
+    {
+        location = value.isString() ? std::stoi(value.asString()) : value.asInt();
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+bool parseInventoryTransfer(const Json::Value& request, InventoryTransfer& transfer)
+{
+    const Json::Value& generalInfo = request["general_info"];
+    const Json::Value& product = generalInfo["action"]["product"];
+
+    if (!parseLocationType(generalInfo["source"]["type"].asString(), transfer.sourceType) ||
+        !parseLocationType(generalInfo["destination"]["type"].asString(), transfer.destinationType) ||
+        !readLocation(generalInfo["source"]["location"], transfer.sourceLocation) ||
+        !readLocation(generalInfo["destination"]["location"], transfer.destinationLocation))
+    {
+        return false;
+    }
+
+    transfer.product = product["name"].asString();
+    transfer.quantity = product["quantity"].asInt();
+    return true;
+}
+
+int realTimeUpdate(InventoryStore& store, const Json::Value& request)
+{
+    InventoryTransfer transfer;
+    if (!parseInventoryTransfer(request, transfer))
+    {
+        std::cerr << "❌ Error updating inventory in realTimeUpdate." << std::endl;
+        return 0;
+    }
+    return store.transfer(transfer);
+}
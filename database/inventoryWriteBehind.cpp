@@ -0,0 +1,297 @@
+#include "inventoryWriteBehind.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+static int readEnvInt(const char* name, int defaultValue)
+{
+    const char* value = std::getenv(name);
+    if (value == nullptr)
+    {
+        return defaultValue;
+    }
+
+    try
+    {
+        int parsed = std::stoi(value);
+        return parsed > 0 ? parsed : defaultValue;
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Invalid value in " << name << ", using " << defaultValue << "." << std::endl;
+        return defaultValue;
+    }
+}
+
+WriteBehindConfig loadWriteBehindConfig()
+{
+    WriteBehindConfig config;
+
+    const char* enabled = std::getenv("INVENTORY_WRITE_BEHIND");
+    config.enabled = enabled != nullptr && std::string(enabled) == "1";
+    config.flushIntervalMs = readEnvInt("INVENTORY_FLUSH_MS", WRITE_BEHIND_FLUSH_MS);
+    config.flushOrders = readEnvInt("INVENTORY_FLUSH_ORDERS", WRITE_BEHIND_FLUSH_ORDERS);
+
+    const char* durability = std::getenv("INVENTORY_DURABILITY");
+    if (durability != nullptr && std::string(durability) == "ack")
+    {
+        config.durability = WriteBehindDurability::ACK_IMMEDIATELY;
+    }
+
+    return config;
+}
+
+InventoryWriteBehind& InventoryWriteBehind::getInstance()
+{
+    static InventoryWriteBehind instance;
+    return instance;
+}
+
+bool InventoryWriteBehind::start(const WriteBehindConfig& newConfig, FlushFunction newFlushFunction,
+                                 ReloadFunction newReloadFunction)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running || !InventoryCache::getInstance().isWarm())
+    {
+        return false;
+    }
+
+    config = newConfig;
+    flushFunction = std::move(newFlushFunction);
+    reloadFunction = std::move(newReloadFunction);
+    reloadNeeded = false;
+    currentBatch = std::make_shared<Batch>();
+    ordersSinceFlush = 0;
+    running = true;
+    flusher = std::thread(&InventoryWriteBehind::flushLoop, this);
+    return true;
+}
+
+void InventoryWriteBehind::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    flushRequested.notify_one();
+    if (flusher.joinable())
+    {
+        flusher.join();
+    }
+}
+
+bool InventoryWriteBehind::isRunning() const
+{
+    return running;
+}
+
+std::size_t InventoryWriteBehind::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+}
+
+std::size_t InventoryWriteBehind::deadLetterCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return deadLetters;
+}
+
+void InventoryWriteBehind::revert(const std::vector<InventoryDelta>& deltas)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    for (const auto& delta : deltas)
+    {
+        if (!cache.applyDelta(delta.type, delta.locationId, delta.product, -delta.delta))
+        {
+            std::cerr << "❌ Could not revert ledger delta for " << delta.product << " at location "
+                      << delta.locationId << ", reloading the inventory cache." << std::endl;
+            // The ledger no longer matches MySQL: reads go to the database until it is reloaded
+            cache.clear();
+            reloadNeeded = true;
+            return;
+        }
+    }
+}
+
+int InventoryWriteBehind::submit(const std::vector<InventoryDelta>& deltas)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!running)
+    {
+        return -1;
+    }
+    // The cache is cold until the reload, so every delta would fail as if the rows did not exist
+    if (reloadNeeded)
+    {
+        std::cerr << "❌ Inventory ledger is being reloaded, order not applied." << std::endl;
+        return WRITE_BEHIND_RETRY_LATER;
+    }
+    return acceptLocked(deltas, lock);
+}
+
+int InventoryWriteBehind::raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    int quantity;
+    if (!running || reloadNeeded || !InventoryCache::getInstance().get(type, locationId, product, quantity))
+    {
+        return -1;
+    }
+
+    // The ledger level already counts the deltas not flushed yet, so they cannot push the row over capacity later
+    int missing = capacity - quantity;
+    if (missing <= 0)
+    {
+        return 0;
+    }
+    return acceptLocked({InventoryDelta{type, locationId, product, missing}}, lock) == 1 ? missing : -1;
+}
+
+int InventoryWriteBehind::acceptLocked(const std::vector<InventoryDelta>& deltas, std::unique_lock<std::mutex>& lock)
+{
+    InventoryCache& cache = InventoryCache::getInstance();
+    std::vector<InventoryDelta> applied;
+    for (const auto& delta : deltas)
+    {
+        if (!cache.applyDelta(delta.type, delta.locationId, delta.product, delta.delta))
+        {
+            revert(applied);
+            return -1;
+        }
+        applied.push_back(delta);
+    }
+
+    for (const auto& delta : deltas)
+    {
+        pending[DeltaKey(delta.type, delta.locationId, delta.product)] += delta.delta;
+    }
+
+    std::shared_ptr<Batch> batch = currentBatch;
+    if (++ordersSinceFlush >= config.flushOrders)
+    {
+        flushRequested.notify_one();
+    }
+
+    if (config.durability == WriteBehindDurability::ACK_IMMEDIATELY)
+    {
+        return 1;
+    }
+
+    batchDone.wait(lock, [&batch]() { return batch->done; });
+    return batch->committed ? 1 : -1;
+}
+
+void InventoryWriteBehind::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        flushRequested.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs),
+                                [this]() { return !running || ordersSinceFlush >= config.flushOrders; });
+        flushPending(lock);
+        reloadIfNeeded();
+    }
+    flushPending(lock);
+}
+
+void InventoryWriteBehind::reloadIfNeeded()
+{
+    // Reloaded only once every pending delta reached MySQL, so the reload reads them back
+    auto now = std::chrono::steady_clock::now();
+    if (!reloadNeeded || !pending.empty() || !reloadFunction ||
+        now - lastReload < std::chrono::milliseconds(WRITE_BEHIND_RELOAD_RETRY_MS))
+    {
+        return;
+    }
+
+    // Orders wait on the ledger lock instead of failing against a half-loaded cache
+    lastReload = now;
+    InventoryCache::getInstance().clear();
+    reloadNeeded = !reloadFunction();
+}
+
+void InventoryWriteBehind::flushPending(std::unique_lock<std::mutex>& lock)
+{
+    if (ordersSinceFlush == 0 && pending.empty())
+    {
+        return;
+    }
+
+    std::vector<InventoryDelta> deltas;
+    for (const auto& pair : pending)
+    {
+        if (pair.second != 0)
+        {
+            deltas.push_back(
+                InventoryDelta{std::get<0>(pair.first), std::get<1>(pair.first), std::get<2>(pair.first), pair.second});
+        }
+    }
+    pending.clear();
+    ordersSinceFlush = 0;
+    std::shared_ptr<Batch> batch = currentBatch;
+    currentBatch = std::make_shared<Batch>();
+
+    // The database round trip happens without holding the ledger lock
+    lock.unlock();
+    int result = deltas.empty() ? 1 : flushFunction(deltas);
+    std::vector<int> results(deltas.size(), result);
+    if (result == 0 && config.durability == WriteBehindDurability::ACK_IMMEDIATELY && deltas.size() > 1)
+    {
+        // Committed one by one so the rejected rows do not hold back the others
+        for (std::size_t i = 0; i < deltas.size(); i++)
+        {
+            results[i] = flushFunction({deltas[i]});
+        }
+    }
+    lock.lock();
+
+    if (result != 1 && config.durability == WriteBehindDurability::GROUP_COMMIT)
+    {
+        std::cerr << "❌ Group commit failed, rejecting " << deltas.size() << " inventory deltas." << std::endl;
+        revert(deltas);
+    }
+    else
+    {
+        if (result != 1)
+        {
+            std::cerr << "❌ Group commit failed, retrying " << deltas.size() << " inventory deltas." << std::endl;
+        }
+        for (std::size_t i = 0; i < deltas.size(); i++)
+        {
+            settle(deltas[i], results[i]);
+        }
+    }
+
+    batch->done = true;
+    batch->committed = result == 1;
+    batchDone.notify_all();
+}
+
+void InventoryWriteBehind::settle(const InventoryDelta& delta, int result)
+{
+    DeltaKey key(delta.type, delta.locationId, delta.product);
+    if (result == 1)
+    {
+        rejections.erase(key);
+        return;
+    }
+
+    // An unreachable database is waited for; a row the database keeps rejecting is dropped
+    if (result == 0 && ++rejections[key] >= WRITE_BEHIND_MAX_REJECTIONS)
+    {
+        std::cerr << "❌ Dropping inventory delta " << delta.delta << " for " << delta.product << " at location "
+                  << delta.locationId << " after " << WRITE_BEHIND_MAX_REJECTIONS << " rejected commits."
+                  << std::endl;
+        rejections.erase(key);
+        deadLetters++;
+        revert({delta});
+        return;
+    }
+
+    pending[key] += delta.delta;
+}
@@ -0,0 +1,90 @@
+-- Migration 001: key the inventory tables by (location ID, product ID)
+-- Applies to databases created from a previous database.sql.
+USE manage_system;
+
+-- Rows without IDs cannot be addressed by the primary key
+DELETE FROM hubs WHERE id_hub IS NULL OR id_product IS NULL OR product_name IS NULL;
+DELETE FROM warehouses WHERE id_warehouse IS NULL OR id_product IS NULL OR product_name IS NULL;
+
+UPDATE hubs SET available_quantity = 0 WHERE available_quantity IS NULL;
+UPDATE warehouses SET available_quantity = 0 WHERE available_quantity IS NULL;
+
+ALTER TABLE `hubs`
+  MODIFY `id_hub` int NOT NULL,
+  MODIFY `id_product` int NOT NULL,
+  MODIFY `product_name` varchar(100) NOT NULL,
+  MODIFY `available_quantity` int NOT NULL DEFAULT '0',
+  ADD PRIMARY KEY (`id_hub`, `id_product`),
+  ADD KEY `idx_hubs_product_name` (`product_name`);
+
+ALTER TABLE `warehouses`
+  MODIFY `id_warehouse` int NOT NULL,
+  MODIFY `id_product` int NOT NULL,
+  MODIFY `product_name` varchar(100) NOT NULL,
+  MODIFY `available_quantity` int NOT NULL DEFAULT '0',
+  ADD PRIMARY KEY (`id_warehouse`, `id_product`),
+  ADD KEY `idx_warehouses_product_name` (`product_name`);
+
+-- Integer-keyed stored procedures
+DROP PROCEDURE IF EXISTS `updateHubInventoryById`;
+DROP PROCEDURE IF EXISTS `updateWarehouseInventoryById`;
+DROP PROCEDURE IF EXISTS `getHubInventoryById`;
+DROP PROCEDURE IF EXISTS `getWarehouseInventoryById`;
+
+DELIMITER ;;
+CREATE PROCEDURE `updateHubInventoryById`(
+    IN p_hub_id INT,         -- Hub ID
+    IN p_product_id INT,     -- Product ID
+    IN p_quantity INT        -- Quantity to add (can be negative to subtract)
+)
+BEGIN
+    -- Primary key lookup on (id_hub, id_product)
+    UPDATE hubs
+    SET available_quantity = available_quantity + p_quantity
+    WHERE id_hub = p_hub_id
+    AND id_product = p_product_id
+    AND available_quantity + p_quantity >= 0;  -- Ensure no negative quantities
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `updateWarehouseInventoryById`(
+    IN p_warehouse_id INT,   -- Warehouse ID
+    IN p_product_id INT,     -- Product ID
+    IN p_quantity INT        -- Quantity to add (can be negative to subtract)
+)
+BEGIN
+    -- Primary key lookup on (id_warehouse, id_product)
+    UPDATE warehouses
+    SET available_quantity = available_quantity + p_quantity
+    WHERE id_warehouse = p_warehouse_id
+    AND id_product = p_product_id
+    AND available_quantity + p_quantity >= 0;  -- Ensure no negative quantities
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `getHubInventoryById`(
+	IN p_hub_id INT,
+	IN p_product_id INT
+)
+BEGIN
+	-- Get the available quantity for the product in the hub
+	SELECT available_quantity
+	FROM hubs
+	WHERE id_hub = p_hub_id AND id_product = p_product_id;
+END ;;
+DELIMITER ;
+
+DELIMITER ;;
+CREATE PROCEDURE `getWarehouseInventoryById`(
+	IN p_warehouse_id INT,
+	IN p_product_id INT
+)
+BEGIN
+	-- Get the available quantity for the product in the warehouse
+	SELECT available_quantity
+	FROM warehouses
+	WHERE id_warehouse = p_warehouse_id AND id_product = p_product_id;
+END ;;
+DELIMITER ;
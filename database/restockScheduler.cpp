@@ -0,0 +1,254 @@
+#include "restockScheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static long long millisecondsBetween(std::chrono::steady_clock::time_point from,
+                                     std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+std::string formatRestockStatus(const std::vector<RestockRecord>& pending, const std::vector<RestockRecord>& completed)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    std::ostringstream msgStream;
+    msgStream << "\n----- Re-stocks -----\n";
+    msgStream << "Pending: " << pending.size() << "\n";
+    for (const auto& record : pending)
+    {
+        msgStream << "- warehouse " << record.warehouseId << " " << record.product << ": waiting "
+                  << millisecondsBetween(record.requested, now) << " ms\n";
+    }
+
+    msgStream << "Completed: " << completed.size() << "\n";
+    for (const auto& record : completed)
+    {
+        msgStream << "- warehouse " << record.warehouseId << " " << record.product << ": ";
+        if (record.ok)
+        {
+            msgStream << "+" << record.added << " units";
+        }
+        else
+        {
+            msgStream << "failed";
+        }
+        msgStream << " after " << millisecondsBetween(record.requested, record.completed) << " ms\n";
+    }
+    msgStream << "---------------------";
+    return msgStream.str();
+}
+
+RestockScheduler::RestockScheduler(int capacity, std::chrono::milliseconds batchDelay, std::size_t historyMax)
+    : capacity(capacity), batchDelay(batchDelay), historyMax(historyMax)
+{
+}
+
+RestockScheduler::~RestockScheduler()
+{
+    stop();
+}
+
+RestockScheduler& RestockScheduler::getInstance()
+{
+    static RestockScheduler instance;
+    return instance;
+}
+
+RestockScheduler::Key RestockScheduler::makeKey(int warehouseId, const std::string& product)
+{
+    return Key{warehouseId, toLower(product)};
+}
+
+bool RestockScheduler::request(int warehouseId, const std::string& product)
+{
+    Key key = makeKey(warehouseId, product);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // A row already waiting or being topped up is not refilled twice
+        if (inFlight.count(key) > 0)
+        {
+            return false;
+        }
+        auto& products = queued[warehouseId];
+        if (products.count(key.second) > 0)
+        {
+            return false;
+        }
+
+        RestockRecord record;
+        record.warehouseId = warehouseId;
+        record.product = product;
+        record.requested = std::chrono::steady_clock::now();
+        products.emplace(key.second, record);
+    }
+    ready.notify_one();
+    return true;
+}
+
+std::vector<RestockScheduler::Batch> RestockScheduler::takeBatches()
+{
+    std::vector<Batch> batches;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& warehouse : queued)
+    {
+        Batch batch;
+        for (auto& pair : warehouse.second)
+        {
+            inFlight.emplace(Key{warehouse.first, pair.first}, pair.second);
+            batch.push_back(std::move(pair.second));
+        }
+        batches.push_back(std::move(batch));
+    }
+    queued.clear();
+    return batches;
+}
+
+std::size_t RestockScheduler::applyBatch(InventoryStore& store, Batch batch)
+{
+    // Each row is read and topped up in one store operation, so stock credited meanwhile is never overfilled
+    std::size_t applied = 0;
+    for (RestockRecord& record : batch)
+    {
+        int added = store.raiseToCapacity(LocationType::WAREHOUSE, record.warehouseId, record.product, capacity);
+        record.ok = added >= 0;
+        record.added = std::max(added, 0);
+        record.completed = std::chrono::steady_clock::now();
+        applied += record.ok;
+    }
+
+    finish(batch);
+    return applied;
+}
+
+void RestockScheduler::finish(const Batch& batch)
+{
+    for (const RestockRecord& record : batch)
+    {
+        if (!record.ok)
+        {
+            std::cerr << "❌ Error trying to re-stock " << record.product << " in warehouse " << record.warehouseId
+                      << std::endl;
+            // The next order that reaches the threshold requests it again
+            StockLevelMonitor::getInstance().forget(record.warehouseId, record.product);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const RestockRecord& record : batch)
+    {
+        inFlight.erase(makeKey(record.warehouseId, record.product));
+        history.push_back(record);
+    }
+    while (history.size() > historyMax)
+    {
+        history.pop_front();
+    }
+}
+
+std::size_t RestockScheduler::applyPending(InventoryStore& store)
+{
+    std::size_t applied = 0;
+    for (Batch& batch : takeBatches())
+    {
+        applied += applyBatch(store, std::move(batch));
+    }
+    return applied;
+}
+
+bool RestockScheduler::start(RunFunction run)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (worker.joinable())
+    {
+        return false;
+    }
+
+    stopping = false;
+    worker = std::thread(&RestockScheduler::run, this, std::move(run));
+    return true;
+}
+
+void RestockScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable())
+        {
+            return;
+        }
+        stopping = true;
+    }
+    ready.notify_all();
+    worker.join();
+}
+
+std::vector<RestockRecord> RestockScheduler::pending() const
+{
+    std::vector<RestockRecord> records;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& pair : inFlight)
+    {
+        records.push_back(pair.second);
+    }
+    for (const auto& warehouse : queued)
+    {
+        for (const auto& pair : warehouse.second)
+        {
+            records.push_back(pair.second);
+        }
+    }
+    std::sort(records.begin(), records.end(), [](const RestockRecord& a, const RestockRecord& b) {
+        return makeKey(a.warehouseId, a.product) < makeKey(b.warehouseId, b.product);
+    });
+    return records;
+}
+
+std::vector<RestockRecord> RestockScheduler::completed() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<RestockRecord>(history.begin(), history.end());
+}
+
+void RestockScheduler::run(RunFunction runTask)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        ready.wait(lock, [this]() { return stopping || !queued.empty(); });
+        // Requests made during the delay join the batch of their warehouse
+        ready.wait_for(lock, batchDelay, [this]() { return stopping; });
+        bool exiting = stopping;
+
+        lock.unlock();
+        for (Batch& batch : takeBatches())
+        {
+            bool queuedTask = runTask([this, batch](InventoryStore& store) { applyBatch(store, batch); });
+            if (!queuedTask)
+            {
+                for (RestockRecord& record : batch)
+                {
+                    record.completed = std::chrono::steady_clock::now();
+                }
+                finish(batch);
+            }
+        }
+        lock.lock();
+
+        if (exiting)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "stockLevelMonitor.hpp"
+#include <algorithm>
+#include <cctype>
+
+StockLevelMonitor::StockLevelMonitor(const StockThresholds& thresholds) : thresholds(thresholds)
+{
+}
+
+StockLevelMonitor& StockLevelMonitor::getInstance()
+{
+    static StockLevelMonitor instance;
+    return instance;
+}
+
+StockLevelMonitor::Key StockLevelMonitor::makeKey(int warehouseId, const std::string& product)
+{
+    Key key{warehouseId, product};
+    std::transform(key.second.begin(), key.second.end(), key.second.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+// Fires when the level reaches the threshold while armed; re-arms once it is clearly above it again
+static void track(int quantity, int threshold, int hysteresis, bool& armed, bool& pending)
+{
+    if (armed && quantity <= threshold)
+    {
+        armed = false;
+        pending = true;
+    }
+    else if (!armed && quantity > threshold + hysteresis)
+    {
+        armed = true;
+        pending = false;
+    }
+}
+
+void StockLevelMonitor::observe(LocationType type, int locationId, const std::string& product, int quantity)
+{
+    if (type != LocationType::WAREHOUSE)
+    {
+        return;
+    }
+
+    Key key = makeKey(locationId, product);
+    std::lock_guard<std::mutex> lock(mutex);
+    Row& row = rows[std::move(key)];
+    row.quantity = quantity;
+    track(quantity, thresholds.low, thresholds.hysteresis, row.lowArmed, row.lowPending);
+    track(quantity, thresholds.restock, thresholds.hysteresis, row.restockArmed, row.restockPending);
+}
+
+bool StockLevelMonitor::take(int warehouseId, const std::string& product, StockCrossing& crossing)
+{
+    Key key = makeKey(warehouseId, product);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = rows.find(key);
+    if (it == rows.end())
+    {
+        return false;
+    }
+
+    crossing.low = it->second.lowPending;
+    crossing.restock = it->second.restockPending;
+    crossing.quantity = it->second.quantity;
+    it->second.lowPending = false;
+    it->second.restockPending = false;
+    return true;
+}
+
+void StockLevelMonitor::forget(int warehouseId, const std::string& product)
+{
+    Key key = makeKey(warehouseId, product);
+    std::lock_guard<std::mutex> lock(mutex);
+    rows.erase(key);
+}
+
+std::size_t StockLevelMonitor::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<std::size_t>(std::count_if(rows.begin(), rows.end(), [](const auto& pair) {
+        return pair.second.lowPending || pair.second.restockPending;
+    }));
+}
@@ -1,4 +1,5 @@
 #include "user_db.h"
+#include "db_pool.h"
 
 MYSQL* connectToDb()
 {
@@ -32,43 +33,73 @@ void showMenuUser()
     printf("0. End\n");
 }
 
+static void bindString(MYSQL_BIND* bind, const char* value, unsigned long* length)
+{
+    *length = strlen(value);
+    bind->buffer_type = MYSQL_TYPE_STRING;
+    bind->buffer = (void*)value;
+    bind->buffer_length = *length;
+    bind->length = length;
+}
+
 int getUsers()
 {
-    MYSQL* conn = connectToDb();
-    if (!conn)
+    DbConnection* connection = acquireDbConnection();
+    if (!connection)
         return 0;
 
-    if (mysql_query(conn, "SELECT name, email, role FROM user"))
+    MYSQL_STMT* stmt = getDbStatement(connection, DB_STMT_LIST_USERS);
+    if (!stmt)
     {
-        fprintf(stderr, "❌ Error: %s\n", mysql_error(conn));
-        mysql_close(conn);
+        releaseDbConnection(connection, true);
         return 0;
     }
 
-    MYSQL_RES* res = mysql_store_result(conn);
-    if (!res)
+    if (mysql_stmt_execute(stmt))
     {
-        fprintf(stderr, "❌ mysql_store_result() failed\n");
-        mysql_close(conn);
+        fprintf(stderr, "❌ Error: %s\n", mysql_stmt_error(stmt));
+        releaseDbConnection(connection, true);
         return 0;
     }
 
-    MYSQL_ROW row;
-    int num_fields = mysql_num_fields(res);
+    char fields[3][MAX_EMAIL_LENGTH];
+    unsigned long lengths[3];
+    bool is_null[3];
+    MYSQL_BIND bind_result[3];
+    memset(bind_result, 0, sizeof(bind_result));
+    for (int i = 0; i < 3; i++)
+    {
+        bind_result[i].buffer_type = MYSQL_TYPE_STRING;
+        bind_result[i].buffer = (void*)fields[i];
+        bind_result[i].buffer_length = sizeof(fields[i]);
+        bind_result[i].length = &lengths[i];
+        bind_result[i].is_null = &is_null[i];
+    }
+
+    if (mysql_stmt_bind_result(stmt, bind_result))
+    {
+        fprintf(stderr, "❌ mysql_stmt_bind_result() failed: %s\n", mysql_stmt_error(stmt));
+        releaseDbConnection(connection, true);
+        return 0;
+    }
 
     printf("\nUsers in database:\n");
-    while ((row = mysql_fetch_row(res)))
+    int status;
+    while ((status = mysql_stmt_fetch(stmt)) == 0 || status == MYSQL_DATA_TRUNCATED)
     {
-        for (int i = 0; i < num_fields; i++)
+        for (int i = 0; i < 3; i++)
         {
-            printf("%s%s", row[i] ? row[i] : "NULL", (i < num_fields - 1) ? ", " : "");
+            // A truncated value fills the whole buffer without a terminator
+            unsigned long end = lengths[i] < sizeof(fields[i]) - 1 ? lengths[i] : sizeof(fields[i]) - 1;
+            fields[i][end] = '\0';
+            printf("%s%s", is_null[i] ? "NULL" : fields[i], (i < 2) ? ", " : "");
         }
         printf("\n");
     }
     printf("\n");
-    mysql_free_result(res);
-    mysql_close(conn);
-    return 1;
+
+    releaseDbConnection(connection, status != MYSQL_NO_DATA);
+    return status == MYSQL_NO_DATA;
 }
 
 int createUser(const char* name, const char* password, const char* email, const char* role)
@@ -80,33 +111,43 @@ int createUser(const char* name, const char* password, const char* email, const
         return 0;
     }
 
-    MYSQL* conn = connectToDb();
-    if (!conn)
-        return 0;
-
     char* salt = "$2a$12$abcdefghijklmnopqrstuvwxz0123456789";
     char* hashed = crypt(password, salt);
 
     if (!hashed)
     {
         fprintf(stderr, "❌ Error generating hash.\n");
-        mysql_close(conn);
         return 0;
     }
 
-    char query[MAX_QUERY_LENGTH];
-    snprintf(query, sizeof(query), "INSERT INTO user (name, password, email, role) VALUES ('%s', '%s', '%s', '%s')",
-             name, hashed, email, role);
+    DbConnection* connection = acquireDbConnection();
+    if (!connection)
+        return 0;
 
-    if (mysql_query(conn, query))
+    MYSQL_STMT* stmt = getDbStatement(connection, DB_STMT_INSERT_USER);
+    if (!stmt)
     {
-        fprintf(stderr, "❌ Error creating user: %s\n", mysql_error(conn));
-        mysql_close(conn);
+        releaseDbConnection(connection, true);
+        return 0;
+    }
+
+    MYSQL_BIND bind_param[4];
+    unsigned long lengths[4];
+    memset(bind_param, 0, sizeof(bind_param));
+    bindString(&bind_param[0], name, &lengths[0]);
+    bindString(&bind_param[1], hashed, &lengths[1]);
+    bindString(&bind_param[2], email, &lengths[2]);
+    bindString(&bind_param[3], role, &lengths[3]);
+
+    if (mysql_stmt_bind_param(stmt, bind_param) || mysql_stmt_execute(stmt))
+    {
+        fprintf(stderr, "❌ Error creating user: %s\n", mysql_stmt_error(stmt));
+        releaseDbConnection(connection, true);
         return 0;
     }
 
     printf("✅ User successfully created.\n");
-    mysql_close(conn);
+    releaseDbConnection(connection, false);
     return 1;
 }
 
@@ -118,21 +159,30 @@ int deleteUser(const char* email)
         return 0;
     }
 
-    MYSQL* conn = connectToDb();
-    if (!conn)
+    DbConnection* connection = acquireDbConnection();
+    if (!connection)
         return 0;
 
-    char query[MAX_QUERY_LENGTH];
-    snprintf(query, sizeof(query), "DELETE FROM user WHERE email='%s'", email);
+    MYSQL_STMT* stmt = getDbStatement(connection, DB_STMT_DELETE_USER);
+    if (!stmt)
+    {
+        releaseDbConnection(connection, true);
+        return 0;
+    }
+
+    MYSQL_BIND bind_param[1];
+    unsigned long email_length;
+    memset(bind_param, 0, sizeof(bind_param));
+    bindString(&bind_param[0], email, &email_length);
 
-    if (mysql_query(conn, query))
+    if (mysql_stmt_bind_param(stmt, bind_param) || mysql_stmt_execute(stmt))
     {
-        fprintf(stderr, "❌ Error deleting user: %s\n", mysql_error(conn));
-        mysql_close(conn);
+        fprintf(stderr, "❌ Error deleting user: %s\n", mysql_stmt_error(stmt));
+        releaseDbConnection(connection, true);
         return 0;
     }
 
-    if (mysql_affected_rows(conn) > 0)
+    if (mysql_stmt_affected_rows(stmt) > 0)
     {
         printf("✅ User successfully deleted.\n");
     }
@@ -141,7 +191,7 @@ int deleteUser(const char* email)
         printf("❌ User not found.\n");
     }
 
-    mysql_close(conn);
+    releaseDbConnection(connection, false);
     return 1;
 }
 
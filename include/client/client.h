@@ -29,6 +29,44 @@
 #define MAX_RETRIES 3           ///< Maximum number of retries before giving up on a response.
 #define TIMEOUT 5               ///< Timeout duration in seconds for receiving a response.
 
+#define CHUNK_FRAME_PREFIX "@CHUNK "          ///< First bytes of a frame of a chunked server response.
+#define CHUNK_HEADER_MAX 96                   ///< Longest frame header, newline included.
+#define CHUNK_RESPONSE_MAX (16 * 1024 * 1024) ///< Largest chunked response the client reassembles.
+
+/**
+ * @brief Result of feeding a frame to a chunk_assembler.
+ */
+enum chunk_status
+{
+    CHUNK_INCOMPLETE, ///< The data does not hold a whole frame yet; nothing was consumed.
+    CHUNK_STORED,     ///< The chunk was stored; more frames follow without asking.
+    CHUNK_CONTINUE,   ///< The chunk ended a window; send chunk_assembler_request() to get the next one.
+    CHUNK_GAP,        ///< A frame was lost; send chunk_assembler_request() to get it again.
+    CHUNK_IGNORED,    ///< Duplicate or stale frame, dropped.
+    CHUNK_DONE,       ///< The response is complete; take it with chunk_assembler_take().
+    CHUNK_INVALID     ///< Malformed frame.
+};
+
+/**
+ * @struct chunk_assembler
+ * @brief Reassembles a chunked server response from its frames.
+ *
+ * The server splits responses longer than one read in frames
+ * "@CHUNK <stream> <index> <count> <length> <cursor>\n<payload>". Frames of one
+ * stream are appended in order; the assembler tracks the first missing index so
+ * lost UDP datagrams can be requested again with "CONTINUE <stream>:<index>".
+ */
+struct chunk_assembler
+{
+    unsigned long stream;   ///< Stream being reassembled.
+    unsigned long finished; ///< Last stream completed, whose late duplicates are ignored.
+    size_t next_index;      ///< First chunk not received yet.
+    size_t count;           ///< Number of chunks of the stream, 0 when idle.
+    size_t requested;       ///< Index last asked for after a gap, to ask only once.
+    char* data;             ///< Payload received so far.
+    size_t length;          ///< Bytes in data.
+};
+
 struct receiver_data
 {
     int sockfd;
@@ -36,6 +74,49 @@ struct receiver_data
     const char* protocol;
 };
 
+/**
+ * @brief Prepares an idle assembler.
+ *
+ * @param assembler Assembler to initialize.
+ */
+void chunk_assembler_init(struct chunk_assembler* assembler);
+
+/**
+ * @brief Consumes the frame at the start of the received data.
+ *
+ * @param assembler Assembler receiving the frame.
+ * @param data Received bytes, starting with CHUNK_FRAME_PREFIX.
+ * @param length Number of received bytes.
+ * @param consumed Output parameter receiving the bytes of the frame, 0 if none was consumed.
+ * @return The chunk_status of the frame.
+ */
+int chunk_assembler_feed(struct chunk_assembler* assembler, const char* data, size_t length, size_t* consumed);
+
+/**
+ * @brief Writes the CONTINUE command asking for the first missing chunk.
+ *
+ * @param assembler Assembler of the stream.
+ * @param request Buffer receiving the command.
+ * @param size Size of the buffer.
+ * @return Length of the command, -1 if no stream is being reassembled.
+ */
+int chunk_assembler_request(const struct chunk_assembler* assembler, char* request, size_t size);
+
+/**
+ * @brief Hands over a complete response and makes the assembler idle.
+ *
+ * @param assembler Assembler that returned CHUNK_DONE.
+ * @return The null-terminated response, to be freed by the caller.
+ */
+char* chunk_assembler_take(struct chunk_assembler* assembler);
+
+/**
+ * @brief Drops any partial response.
+ *
+ * @param assembler Assembler to reset.
+ */
+void chunk_assembler_free(struct chunk_assembler* assembler);
+
 /**
  * @brief Thread function that listens for incoming messages from other clients via server
  *
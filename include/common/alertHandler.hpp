@@ -16,6 +16,7 @@
 #include "json/value.h"
 #include "json/version.h"
 #include "json/writer.h"
+#include <cstddef>
 #include <string>
 
 /**
@@ -48,6 +49,25 @@ class AlertHandler
     */
     static std::string generateAlert(const std::string& name, const std::string& message, int productId,
                                     const std::string& productName);
+
+    /**
+    * @brief Generates an alert standing for several occurrences of the same alert.
+    *
+    * The JSON has the fields of generateAlert(), plus the location, the number of
+    * occurrences and the window they were counted in.
+    *
+    * @param name The type or category of the alert.
+    * @param message A detailed description of the latest occurrence.
+    * @param productId The ID of the product related to the alert.
+    * @param productName The name of the product related to the alert.
+    * @param location The location the alert is about.
+    * @param count Number of occurrences summarized.
+    * @param windowSeconds Length of the window the occurrences were counted in.
+    * @return A string containing the alert in JSON format.
+    */
+    static std::string generateAlertSummary(const std::string& name, const std::string& message, int productId,
+                                           const std::string& productName, const std::string& location,
+                                           std::size_t count, long long windowSeconds);
 };
 
 #endif // ALERTHANDLER_HPP
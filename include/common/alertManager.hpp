@@ -0,0 +1,116 @@
+/**
+ * @file alertManager.hpp
+ * @brief Coalescing of repeated alerts per location, product and alert type.
+ *
+ * Every alert is submitted to the AlertManager before it is sent. The first
+ * alert of a (location, product, type) key opens a window and is sent as is;
+ * the same alert repeated inside the window is only counted. The first one
+ * after the window is sent as a summary carrying how many occurrences it
+ * stands for, and flush() summarizes the windows that closed with suppressed
+ * alerts and no later occurrence. The number of alerts sent grows with the
+ * incidents, not with the order rate.
+ */
+
+#ifndef ALERT_MANAGER_HPP
+#define ALERT_MANAGER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// Default seconds during which repeated alerts of the same key are only counted.
+#define ALERT_COALESCE_WINDOW_SECONDS 60
+
+/**
+ * @struct AlertManagerConfig
+ * @brief Coalescing window of the alerts.
+ */
+struct AlertManagerConfig
+{
+    /** Time repeated alerts are counted instead of sent; zero sends every alert. */
+    std::chrono::milliseconds window{std::chrono::seconds(ALERT_COALESCE_WINDOW_SECONDS)};
+};
+
+/**
+ * @brief Reads the alert settings from the environment.
+ *
+ * - ALERT_COALESCE_WINDOW_SECONDS: seconds repeated alerts are counted instead of sent; 0 disables it.
+ *
+ * @return The parsed configuration.
+ */
+AlertManagerConfig loadAlertManagerConfig();
+
+/**
+ * @class AlertManager
+ * @brief Thread-safe deduplication and aggregation of alerts.
+ */
+class AlertManager
+{
+  public:
+    /**
+     * @brief Creates a manager with no open windows.
+     * @param config Coalescing window.
+     */
+    explicit AlertManager(const AlertManagerConfig& config = AlertManagerConfig());
+
+    /**
+     * @brief Gets the manager of the server.
+     * @return The process-wide manager, configured from the environment.
+     */
+    static AlertManager& getInstance();
+
+    /**
+     * @brief Submits an alert and decides whether it is sent.
+     *
+     * @param location Location the alert is about, e.g. "warehouse 1".
+     * @param name The type or category of the alert.
+     * @param message A detailed description of the issue triggering the alert.
+     * @param productId The ID of the product related to the alert.
+     * @param productName The name of the product related to the alert.
+     * @param alertOut Output parameter receiving the JSON to send: the alert, or a summary if
+     *                 occurrences were suppressed since the last one sent.
+     * @return true if the alert must be sent, false if it was counted in an open window.
+     */
+    bool submit(const std::string& location, const std::string& name, const std::string& message, int productId,
+                const std::string& productName, std::string& alertOut);
+
+    /**
+     * @brief Closes the expired windows.
+     * @return A summary for every closed window that suppressed alerts.
+     */
+    std::vector<std::string> flush();
+
+    /**
+     * @brief Gets the number of alerts counted but not reported yet.
+     * @return Suppressed alerts of the open windows.
+     */
+    std::size_t suppressed() const;
+
+  private:
+    /**
+     * @struct Window
+     * @brief Alerts of one key since the last one sent.
+     */
+    struct Window
+    {
+        std::chrono::steady_clock::time_point start; /**< Moment the last alert was sent. */
+        std::size_t suppressed = 0;                  /**< Alerts counted since. */
+        std::string message;                         /**< Description of the latest alert. */
+        int productId = 0;                           /**< Product ID of the latest alert. */
+        std::string productName;                     /**< Product name of the latest alert. */
+    };
+
+    using Key = std::tuple<std::string, std::string, std::string>;
+
+    std::string summaryOf(const Key& key, const Window& window, std::size_t count) const;
+
+    const AlertManagerConfig config; /**< Coalescing window. */
+    mutable std::mutex mutex;        /**< Guards windows. */
+    std::map<Key, Window> windows;   /**< Open windows by location, lower-cased product and alert type. */
+};
+
+#endif // ALERT_MANAGER_HPP
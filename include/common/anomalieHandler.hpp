@@ -2,9 +2,8 @@
 #define ANOMALIE_HANDLER_HPP
 
 #include "errorHandler.hpp"
-#include "inventoryDb.hpp"
+#include "inventoryStore.hpp"
 #include <json/json.h>
-#include <mysqlx/xdevapi.h>
 #include <string>
 
 /**
@@ -29,9 +28,9 @@
  * @param orderJson JSON object containing the full order information.
  * @param errorMessage Reference to a string where the error message will be
  * stored if stock is insufficient or malformed.
- * @param session Active MySQL session.
+ * @param store Inventory backend.
  * @return true if sufficient stock is available, false otherwise.
  */
-bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage, mysqlx::Session& session);
+bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage, InventoryStore& store);
 
 #endif // ANOMALIE_HANDLER_HPP
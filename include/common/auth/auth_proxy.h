@@ -10,6 +10,7 @@
 #ifndef AUTH_PROXY_H
 #define AUTH_PROXY_H
 
+#include "db_pool.h"
 #include "user_db.h"
 #include <crypt.h>
 #include <mysql.h>
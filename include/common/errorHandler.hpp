@@ -26,6 +26,7 @@
 // Define error levels
 
 #define ERROR_CODE 500
+#define ERROR_SERVICE_UNAVAILABLE 503
 
 /**
 * @enum ErrorLevel
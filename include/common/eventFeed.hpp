@@ -0,0 +1,240 @@
+/**
+ * @file eventFeed.hpp
+ * @brief Publish/subscribe feed of stock alerts and inventory changes.
+ *
+ * Any client can register for topics instead of polling GET_STOCK:
+ *
+ *     SUBSCRIBE <topic> [<topic>...]
+ *     UNSUBSCRIBE [<topic>...]
+ *
+ * UNSUBSCRIBE without topics drops every subscription of the client. The
+ * topics are:
+ *
+ * - low-stock: low stock alerts of every warehouse.
+ * - restock: re-stock alerts of every warehouse.
+ * - stock: stock changes of every location; stock:<type> narrows it to hubs
+ *   or warehouses and stock:<type>:<id> to one location.
+ *
+ * A subscription receives the events of its topic and of every topic below
+ * it. Publishing only appends the event to the queue of each subscriber, so
+ * the order path never waits on a socket; a queue keeps the newest
+ * EVENT_QUEUE_MAX events and counts the ones it dropped. The dispatcher
+ * thread sends the queued events of a subscriber as one message:
+ *
+ *     @EVENTS <count> <dropped>\n{"topic":...,"data":...}\n...
+ *
+ * with one compact JSON event per line. UDP subscribers must keep sending
+ * messages, or they are dropped with the other inactive UDP clients.
+ */
+
+#ifndef EVENT_FEED_HPP
+#define EVENT_FEED_HPP
+
+#include "errorHandler.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Name of the command registering a client for event topics.
+#define SUBSCRIBE_COMMAND "SUBSCRIBE"
+
+/// Name of the command dropping subscriptions.
+#define UNSUBSCRIBE_COMMAND "UNSUBSCRIBE"
+
+/// Error code for a malformed SUBSCRIBE or UNSUBSCRIBE command.
+#define ERR_INVALID_SUBSCRIPTION 1014
+
+/// Topic of the low stock alerts.
+#define EVENT_TOPIC_LOW_STOCK "low-stock"
+
+/// Topic of the re-stock alerts.
+#define EVENT_TOPIC_RESTOCK "restock"
+
+/// Topic of the stock changes; locations are appended as ":<type>:<id>".
+#define EVENT_TOPIC_STOCK "stock"
+
+/// First bytes of every event batch.
+#define EVENT_FRAME_PREFIX "@EVENTS"
+
+/// Events kept per subscriber while the dispatcher is behind; the oldest is dropped first.
+#define EVENT_QUEUE_MAX 256
+
+/// Milliseconds the dispatcher waits after the first event, so a burst goes out as one message.
+#define EVENT_BATCH_DELAY_MS 20
+
+/**
+ * @brief Builds the topic of the stock changes of one location.
+ *
+ * @param locationType "hub" or "warehouse".
+ * @param locationId ID of the location.
+ * @return The topic, e.g. "stock:warehouse:1".
+ */
+std::string stockTopic(const std::string& locationType, int locationId);
+
+/**
+ * @brief Parses a SUBSCRIBE or UNSUBSCRIBE command.
+ *
+ * @param command The raw command received from the client.
+ * @param topics Output parameter receiving the topics, without duplicates.
+ * @param error Output parameter receiving a JSON error when a topic is unknown,
+ *              or when SUBSCRIBE has no topic.
+ * @return true if the command is valid, false otherwise.
+ */
+bool parseSubscription(const std::string& command, std::vector<std::string>& topics, std::string& error);
+
+/**
+ * @struct EventBatch
+ * @brief Queued events of one subscriber, ready to send.
+ */
+struct EventBatch
+{
+    int clientId;         /**< Client receiving the events. */
+    std::string protocol; /**< Protocol used by the client. */
+    std::string message;  /**< The @EVENTS message. */
+};
+
+/**
+ * @class EventFeed
+ * @brief Thread-safe subscriptions, per-subscriber queues and the dispatcher sending them.
+ */
+class EventFeed
+{
+  public:
+    /**
+     * @brief Sends a batch to its subscriber.
+     */
+    using SendFunction = std::function<void(const EventBatch&)>;
+
+    /**
+     * @brief Creates a feed without subscribers.
+     * @param queueMax Events kept per subscriber.
+     * @param batchDelay Time the dispatcher waits after the first event of a batch.
+     */
+    explicit EventFeed(std::size_t queueMax = EVENT_QUEUE_MAX,
+                       std::chrono::milliseconds batchDelay = std::chrono::milliseconds(EVENT_BATCH_DELAY_MS));
+
+    /**
+     * @brief Stops the dispatcher.
+     */
+    ~EventFeed();
+
+    /**
+     * @brief Gets the feed of the server.
+     * @return The process-wide feed.
+     */
+    static EventFeed& getInstance();
+
+    /**
+     * @brief Adds topics to the subscriptions of a client.
+     *
+     * @param clientId ID of the client.
+     * @param protocol Protocol used by the client.
+     * @param topics Topics to add.
+     * @return Every topic the client is now subscribed to, sorted.
+     */
+    std::vector<std::string> subscribe(int clientId, const std::string& protocol,
+                                       const std::vector<std::string>& topics);
+
+    /**
+     * @brief Drops topics from the subscriptions of a client.
+     *
+     * @param clientId ID of the client.
+     * @param protocol Protocol used by the client.
+     * @param topics Topics to drop; every topic when empty.
+     * @return Every topic the client is still subscribed to, sorted.
+     */
+    std::vector<std::string> unsubscribe(int clientId, const std::string& protocol,
+                                         const std::vector<std::string>& topics);
+
+    /**
+     * @brief Drops a client and its queued events, e.g. when it disconnects.
+     *
+     * @param clientId ID of the client.
+     * @param protocol Protocol used by the client.
+     */
+    void removeClient(int clientId, const std::string& protocol);
+
+    /**
+     * @brief Tells whether any subscriber would receive an event of a topic.
+     *
+     * Publishers check it before building an event that costs a read.
+     *
+     * @param topic Topic of the event.
+     * @return true if at least one subscription covers the topic.
+     */
+    bool wants(const std::string& topic) const;
+
+    /**
+     * @brief Queues an event for every subscriber of its topic.
+     *
+     * @param topic Topic of the event.
+     * @param data Content of the event.
+     * @return Number of subscribers that will receive it.
+     */
+    std::size_t publish(const std::string& topic, const Json::Value& data);
+
+    /**
+     * @brief Takes the queued events, one batch per subscriber that has any.
+     * @return The batches, in no particular order.
+     */
+    std::vector<EventBatch> drain();
+
+    /**
+     * @brief Starts the dispatcher thread sending the batches.
+     * @param send Function sending a batch; called on the dispatcher thread only.
+     * @return true if the dispatcher started, false if it was already running.
+     */
+    bool start(SendFunction send);
+
+    /**
+     * @brief Sends the events still queued and stops the dispatcher thread.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of clients with at least one subscription.
+     * @return Subscriber count.
+     */
+    std::size_t subscribers() const;
+
+  private:
+    /**
+     * @struct Subscriber
+     * @brief Subscriptions and pending events of one client.
+     */
+    struct Subscriber
+    {
+        std::set<std::string> topics;  /**< Subscribed topics. */
+        std::deque<std::string> queue; /**< Serialized events not sent yet, oldest first. */
+        std::size_t dropped = 0;       /**< Events dropped from the queue since the last batch. */
+    };
+
+    using Key = std::pair<int, std::string>;
+
+    static Key makeKey(int clientId, const std::string& protocol);
+    static bool covers(const std::set<std::string>& topics, const std::string& topic);
+
+    void run(SendFunction send);
+
+    const std::size_t queueMax;                 /**< Events kept per subscriber. */
+    const std::chrono::milliseconds batchDelay; /**< Wait after the first event of a batch. */
+    mutable std::mutex mutex;                   /**< Guards clients, queued and stopping. */
+    std::condition_variable ready;              /**< Signalled when an event is queued or the feed stops. */
+    std::map<Key, Subscriber> clients;          /**< Subscribers by client ID and lower-cased protocol. */
+    std::atomic<std::size_t> count{0};          /**< Number of subscribers, read without the lock. */
+    std::size_t queued = 0;                     /**< Events waiting in every queue. */
+    bool stopping = false;                      /**< Whether the dispatcher must exit. */
+    std::thread dispatcher;                     /**< Thread sending the batches. */
+};
+
+#endif // EVENT_FEED_HPP
@@ -2,18 +2,22 @@
 #define LOW_STOCK_CHECKER_HPP
 
 #include "alertHandler.hpp"
-#include "inventoryDb.hpp"
+#include "alertManager.hpp"
+#include "eventFeed.hpp"
+#include "inventoryStore.hpp"
+#include "restockScheduler.hpp"
+#include "stockLevelMonitor.hpp"
+#include <cstddef>
 #include <iostream>
 #include <json/json.h>
-#include <mysqlx/xdevapi.h>
 #include <string>
+#include <vector>
 
-/// Maximum capacity of the warehouse for a product.
-#define MAX_CAPACITY 1000
-/// Threshold value for low stock alerts (20% of max stock, assumed to be 1000 units per product).
-#define STOCK_THRESHOLD 200
-/// Threshold value for restock alerts (10% of max stock, assumed to be 1000 units per product).
-#define RESTOCK_THRESHOLD 100
+/// Name of the low stock alerts, published to EVENT_TOPIC_LOW_STOCK.
+#define LOW_STOCK_ALERT_NAME "Low Stock Alert: "
+
+/// Name of the re-stock alerts, published to EVENT_TOPIC_RESTOCK.
+#define RESTOCK_ALERT_NAME "Re-stock Alert: "
 
 /**
  * @brief Checks whether a product in a warehouse has low stock and generates an alert if necessary.
@@ -22,12 +26,12 @@
  * If it is, it retrieves the current stock level for the specified product from the warehouse's inventory.
  * If the stock is less than or equal to STOCK_THRESHOLD (20% of max capacity), an alert message is generated.
  *
- * @param session The MySQL session used to access the inventory database.
+ * @param store The inventory backend holding the warehouse stock.
  * @param pedidoJson The JSON object representing the order.
  * @param alertOut A reference to a string where the generated alert will be stored, if applicable.
  * @return True if a low stock alert was generated; false otherwise.
  */
-bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson, std::string& alertOut);
+bool checkLowStockAlert(InventoryStore& store, const Json::Value& pedidoJson, std::string& alertOut);
 
 /**
  * @brief Checks whether a product in a warehouse needs to be re-stocked and performs the update if necessary.
@@ -35,13 +39,44 @@ bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson,
  * This function analyzes the provided order JSON to determine whether the source of the order is a warehouse.
  * If it is, it retrieves the current stock for the product. If the stock is less than or equal to RESTOCK_THRESHOLD
  * (10% of max capacity), it automatically replenishes the product's stock to MAX_CAPACITY using the
- * updateWarehouseInventory() method, and generates a re-stock alert message.
+ * store, and generates a re-stock alert message.
  *
- * @param session The MySQL session used to access the inventory database.
+ * @param store The inventory backend holding the warehouse stock.
  * @param pedidoJson The JSON object representing the order.
  * @param alertOut A reference to a string where the generated re-stock alert will be stored, if applicable.
  * @return True if the product was re-stocked; false otherwise.
  */
-bool reStock(mysqlx::Session& session, const Json::Value& pedidoJson, std::string& alertOut);
+bool reStock(InventoryStore& store, const Json::Value& pedidoJson, std::string& alertOut);
+
+/**
+ * @brief Reports the threshold crossings of the source warehouse of an order and requests its re-stock if needed.
+ *
+ * Unlike checkLowStockAlert() and reStock(), which read the stock after every order, this takes the
+ * crossings the StockLevelMonitor recorded when the inventory backend changed the level: there is one
+ * alert per crossing, not one per order while the stock stays low. The level is only read from the store
+ * the first time a row is checked, if the backend never reported it. When the re-stock threshold was
+ * crossed, the RestockScheduler is asked to replenish the product to MAX_CAPACITY in the background; the
+ * alert is only sent when the request was queued, not when the row was already waiting. The alerts go
+ * through the AlertManager, which holds back repeats of the same alert for the same warehouse and product
+ * within its window; the alerts sent are also published to the low-stock and restock topics of the
+ * EventFeed.
+ *
+ * @param store The inventory backend holding the warehouse stock.
+ * @param pedidoJson The JSON object representing the order.
+ * @param alerts Output vector receiving the low stock and re-stock alerts.
+ * @return Number of alerts appended.
+ */
+std::size_t collectStockAlerts(InventoryStore& store, const Json::Value& pedidoJson, std::vector<std::string>& alerts);
+
+/**
+ * @brief Publishes a summary returned by AlertManager::flush() to the EventFeed.
+ *
+ * The summary goes to the low-stock or restock topic according to the name of
+ * the alert it stands for, like the alerts it held back would have.
+ *
+ * @param summary The JSON summary.
+ * @return true if the summary is about a stock alert, false otherwise.
+ */
+bool publishAlertSummary(const std::string& summary);
 
 #endif // LOW_STOCK_CHECKER_HPP
@@ -12,12 +12,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_OPTIONS 5 /**< The maximum number of options in each menu. */
+#define MAX_OPTIONS 7 /**< The maximum number of options in each menu. */
 #define PORT 8080 /**< The port used for server communication. */
 #define BUFFER_PASS_USER 110 /**< The buffer size for menu input. */
 #define BUFFER_SIZE_MENU 1024 /**< The buffer size for server communication. */
+#define ORDERS_PER_PAGE 10 /**< Orders per QUERY_ORDERS page, the server's default limit. */
 
-#define DISCONNECT 5 /**< Constant for disconnecting from the server. */
+#define DISCONNECT 7 /**< Constant for disconnecting from the server. */
 
 /**
  * @struct Command
@@ -125,6 +126,22 @@ void list_connected_clients();
  */
 void show_message_reports();
 
+/**
+ * @brief Queries the stock of many locations and products at once.
+ *
+ * Asks for optional location type, location IDs and product filters and
+ * sends a GET_STOCK command to the server.
+ */
+void query_stock();
+
+/**
+ * @brief Searches the stored orders.
+ *
+ * Asks for optional product, source, destination, client and priority filters
+ * and a page number, and sends a QUERY_ORDERS command to the server.
+ */
+void query_orders();
+
 /**
  * @brief Logs the user out and terminates the session.
  *
@@ -0,0 +1,128 @@
+/**
+ * @file orderBatch.hpp
+ * @brief Validation of the quantity limits of many decoded orders at once.
+ *
+ * Bulk imports decode their orders into an OrderBatch, a structure of arrays
+ * with the client type, product class and quantity of every order, and check
+ * them all with validateOrderBatch(). The result has one pass bit per order and
+ * the ERR_* code of every rejected one, the same codes validateOrderLimits()
+ * reports for a single order.
+ *
+ * The limits are compared for 8 orders per instruction with AVX2, or 4 with
+ * SSE2 on x86 processors without AVX2. Other architectures run the scalar loop,
+ * which is also the reference the vector versions are tested against.
+ */
+
+#ifndef ORDER_BATCH_HPP
+#define ORDER_BATCH_HPP
+
+#include "orderRules.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @enum BatchIsa
+ * @brief Instruction set used to validate a batch, from slowest to fastest.
+ */
+enum class BatchIsa
+{
+    SCALAR, /**< One order at a time. */
+    SSE2,   /**< 4 orders per instruction. */
+    AVX2    /**< 8 orders per instruction, with gathers from the rule table. */
+};
+
+/**
+ * @brief Gets the fastest instruction set of the processor.
+ * @return AVX2 or SSE2 on x86, SCALAR elsewhere.
+ */
+BatchIsa detectBatchIsa();
+
+/**
+ * @struct OrderBatch
+ * @brief Decoded orders stored as a structure of arrays.
+ */
+struct OrderBatch
+{
+    std::vector<std::int32_t> clients;    /**< Client type index of the OrderRuleTable, -1 if unknown. */
+    std::vector<std::int32_t> critical;   /**< Non-zero if the product is critical. */
+    std::vector<std::int32_t> quantities; /**< Ordered quantity. */
+
+    /**
+     * @brief Appends an order.
+     *
+     * @param client Client type index returned by OrderRuleTable::clientIndex().
+     * @param isCritical Whether the product is critical.
+     * @param quantity Ordered quantity.
+     */
+    void add(int client, bool isCritical, int quantity);
+
+    /**
+     * @brief Appends an order, looking its client type up.
+     *
+     * @param rules Table the batch will be validated against.
+     * @param clientType Client type of the order.
+     * @param isCritical Whether the product is critical.
+     * @param quantity Ordered quantity.
+     */
+    void add(const OrderRuleTable& rules, std::string_view clientType, bool isCritical, int quantity);
+
+    /**
+     * @brief Reserves room for a number of orders.
+     * @param orders Expected size of the batch.
+     */
+    void reserve(std::size_t orders);
+
+    /**
+     * @brief Removes every order.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of orders.
+     * @return Order count.
+     */
+    std::size_t size() const
+    {
+        return quantities.size();
+    }
+};
+
+/**
+ * @struct OrderBatchResult
+ * @brief Outcome of every order of a batch.
+ */
+struct OrderBatchResult
+{
+    std::vector<std::uint64_t> passed; /**< Bit i % 64 of word i / 64 is set if order i passed. */
+    std::vector<std::int32_t> errors;  /**< ERR_* code of every order, 0 if it passed. */
+    std::size_t failed = 0;            /**< Number of rejected orders. */
+
+    /**
+     * @brief Checks whether an order passed.
+     * @param order Index of the order in the batch.
+     * @return true if the order meets the limits.
+     */
+    bool ok(std::size_t order) const
+    {
+        return (passed[order / 64] >> (order % 64)) & 1;
+    }
+};
+
+/**
+ * @brief Validates the quantity limits of every order of a batch.
+ *
+ * A quantity that is not positive is rejected with ERR_INVALID_VALUES and an
+ * unknown client type with ERR_UNKNOWN_CLIENT_TYPE, before the limits of the
+ * rules are checked, in the order of validateOrderLimits().
+ *
+ * @param rules Rule table, e.g. OrderRules::getInstance().current().
+ * @param batch Decoded orders.
+ * @param result Output parameter receiving the outcome of every order.
+ * @param isa Instruction set to use; lowered to detectBatchIsa() if the processor lacks it.
+ */
+void validateOrderBatch(const OrderRuleTable& rules, const OrderBatch& batch, OrderBatchResult& result,
+                        BatchIsa isa = detectBatchIsa());
+
+#endif // ORDER_BATCH_HPP
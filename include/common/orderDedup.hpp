@@ -0,0 +1,199 @@
+/**
+ * @file orderDedup.hpp
+ * @brief Idempotent order ingestion keyed by client and general_info.id.
+ *
+ * Clients retry an order when its response does not arrive in time, with the
+ * same general_info.id. IDs are chosen by the clients, so orders are keyed by
+ * the client that sent them too (makeKey()): two clients reusing an ID never
+ * see each other's replies. The server remembers the IDs it received during the
+ * last ttl seconds together with the replies sent for them: a retry of an
+ * order still being processed is told so, and a retry of a finished order gets
+ * the replies of the original again, without touching the inventory.
+ *
+ * IDs are first looked up in a Bloom filter, so the new orders (nearly all of
+ * them) are recognised without probing the table of remembered orders. The
+ * filter cannot forget single IDs, so it has two generations: IDs are added to
+ * the current one, which becomes the previous one every ttl seconds, when the
+ * expired orders are also dropped from the table. An ID stays in the filter at
+ * least as long as its order is remembered.
+ *
+ * Orders rejected with "retry later" are forgotten at once, so their retries
+ * are processed.
+ */
+
+#ifndef ORDER_DEDUP_HPP
+#define ORDER_DEDUP_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Default seconds an order ID is remembered after its last reply.
+#define ORDER_DEDUP_TTL_SECONDS 600
+/// Default number of orders per ttl the Bloom filter is sized for, at about 1% false positives.
+#define ORDER_DEDUP_EXPECTED_ORDERS 100000
+/// Number of hash functions of the Bloom filter.
+#define ORDER_DEDUP_BLOOM_HASHES 7
+/// Bits of the Bloom filter per expected order.
+#define ORDER_DEDUP_BLOOM_BITS_PER_ORDER 10
+
+/**
+ * @struct OrderDedupConfig
+ * @brief How long order IDs are remembered and how many are expected.
+ */
+struct OrderDedupConfig
+{
+    std::chrono::seconds ttl{ORDER_DEDUP_TTL_SECONDS};        /**< Time an ID is remembered. */
+    std::size_t expectedOrders = ORDER_DEDUP_EXPECTED_ORDERS; /**< Orders per ttl the filter is sized for. */
+};
+
+/**
+ * @brief Reads the deduplication settings from the environment.
+ *
+ * - ORDER_DEDUP_TTL_SECONDS: seconds an order ID is remembered.
+ * - ORDER_DEDUP_EXPECTED_ORDERS: orders per ttl the Bloom filter is sized for.
+ *
+ * @return The parsed configuration.
+ */
+OrderDedupConfig loadOrderDedupConfig();
+
+/**
+ * @class BloomFilter
+ * @brief Set of hashes that may report false positives but never false negatives.
+ */
+class BloomFilter
+{
+  public:
+    /**
+     * @brief Creates an empty filter.
+     * @param expected Number of hashes added before the false positive rate rises above about 1%.
+     */
+    explicit BloomFilter(std::size_t expected);
+
+    /**
+     * @brief Adds a hash.
+     * @param hash 64-bit hash of the element.
+     */
+    void add(std::uint64_t hash);
+
+    /**
+     * @brief Checks whether a hash may have been added.
+     * @param hash 64-bit hash of the element.
+     * @return false if the hash was never added.
+     */
+    bool mightContain(std::uint64_t hash) const;
+
+    /**
+     * @brief Removes every hash.
+     */
+    void clear();
+
+  private:
+    std::vector<std::uint64_t> words; /**< Bit array. */
+};
+
+/**
+ * @enum DedupState
+ * @brief What the server already knows about an order ID.
+ */
+enum class DedupState
+{
+    NEW,     /**< First time the ID is seen; the order must be processed. */
+    PENDING, /**< The original order is still being processed. */
+    DONE     /**< The original order finished; its replies are returned. */
+};
+
+/**
+ * @class OrderDedup
+ * @brief Thread-safe, time-bounded record of the orders received and of their replies.
+ */
+class OrderDedup
+{
+  public:
+    /**
+     * @brief Creates an empty record.
+     * @param config Time IDs are remembered and expected number of orders.
+     */
+    explicit OrderDedup(const OrderDedupConfig& config = OrderDedupConfig());
+
+    /**
+     * @brief Gets the record of the server.
+     * @return The process-wide record, configured from the environment.
+     */
+    static OrderDedup& getInstance();
+
+    /**
+     * @brief Builds the key an order is remembered under.
+     *
+     * @param clientId ID of the client that sent the order.
+     * @param protocol Protocol used by the client.
+     * @param id The general_info.id of the order.
+     * @return The key, or an empty string when the order has no ID.
+     */
+    static std::string makeKey(int clientId, const std::string& protocol, const std::string& id);
+
+    /**
+     * @brief Looks up an order, and starts remembering it if it is new.
+     *
+     * @param id Key of the order, from makeKey().
+     * @param replies Output parameter receiving the replies of the original order when it is DONE.
+     * @return What is known about the ID.
+     */
+    DedupState begin(const std::string& id, std::vector<std::string>& replies);
+
+    /**
+     * @brief Remembers a reply sent for an order.
+     *
+     * @param id ID of an order returned as NEW by begin().
+     * @param reply The message sent to the client.
+     */
+    void record(const std::string& id, const std::string& reply);
+
+    /**
+     * @brief Marks an order as finished, so retries get its replies.
+     *
+     * An order that recorded no reply is forgotten instead, like forget().
+     *
+     * @param id ID of the order; ignored if empty.
+     */
+    void finish(const std::string& id);
+
+    /**
+     * @brief Forgets an order, so a retry is processed again.
+     * @param id ID of the order; ignored if empty.
+     */
+    void forget(const std::string& id);
+
+    /**
+     * @brief Gets the number of remembered orders.
+     * @return Order count, expired ones included until the next rotation.
+     */
+    std::size_t size() const;
+
+  private:
+    /**
+     * @struct Entry
+     * @brief A remembered order.
+     */
+    struct Entry
+    {
+        bool done = false;                             /**< Whether the original order finished. */
+        std::vector<std::string> replies;              /**< Replies sent for the original order. */
+        std::chrono::steady_clock::time_point expires; /**< Moment the order is forgotten. */
+    };
+
+    void rotateLocked(std::chrono::steady_clock::time_point now);
+
+    const OrderDedupConfig config;                  /**< Time IDs are remembered and expected orders. */
+    mutable std::mutex mutex;                       /**< Guards everything below. */
+    BloomFilter current;                            /**< IDs seen since the last rotation. */
+    BloomFilter previous;                           /**< IDs seen during the ttl before it. */
+    std::chrono::steady_clock::time_point rotated;  /**< Moment of the last rotation. */
+    std::unordered_map<std::string, Entry> entries; /**< Remembered orders by ID. */
+};
+
+#endif // ORDER_DEDUP_HPP
@@ -0,0 +1,258 @@
+/**
+ * @file orderIndex.hpp
+ * @brief Secondary indexes over the order journal and the QUERY_ORDERS command.
+ *
+ * For every value of the indexed fields (product, source location, destination
+ * location, client and priority) the index keeps the sequence numbers of the
+ * matching journal records as a posting list: ascending, delta-encoded as
+ * LEB128 varints, so most orders cost one or two bytes per field. A query
+ * intersects the lists of its filters and reads only the matching records
+ * from the journal:
+ *
+ *     QUERY_ORDERS [product=<name>] [source=<type>:<id>] [destination=<type>:<id>]
+ *                  [client=<id>] [priority=<level>] [offset=<n>] [limit=<n>]
+ *
+ * Values are compared case-insensitively. Results are returned newest first,
+ * ORDER_QUERY_DEFAULT_LIMIT at a time unless a limit is given.
+ */
+
+#ifndef ORDER_INDEX_HPP
+#define ORDER_INDEX_HPP
+
+#include "errorHandler.hpp"
+#include "orderReport.hpp"
+#include "orderSnapshot.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Name of the order search command.
+#define QUERY_ORDERS_COMMAND "QUERY_ORDERS"
+
+/// Error code for a malformed QUERY_ORDERS command.
+#define ERR_INVALID_ORDER_QUERY 1012
+
+/// Orders returned when the query sets no limit.
+#define ORDER_QUERY_DEFAULT_LIMIT 10
+/// Largest accepted limit.
+#define ORDER_QUERY_MAX_LIMIT 50
+
+/**
+ * @enum OrderField
+ * @brief Indexed fields of an order.
+ */
+enum class OrderField
+{
+    PRODUCT,     /**< Product name. */
+    SOURCE,      /**< Source location, "<type> <id>". */
+    DESTINATION, /**< Destination location, "<type> <id>". */
+    CLIENT,      /**< ID of the client that sent the order. */
+    PRIORITY     /**< Priority from the order metadata. */
+};
+
+/// Number of OrderField values.
+#define ORDER_FIELD_COUNT 5
+
+/**
+ * @struct OrderQuery
+ * @brief Filters and page of a QUERY_ORDERS command.
+ */
+struct OrderQuery
+{
+    std::vector<std::pair<OrderField, std::string>> filters; /**< Every filter must match. */
+    std::size_t offset = 0;                                  /**< Matches skipped, newest first. */
+    std::size_t limit = ORDER_QUERY_DEFAULT_LIMIT;           /**< Maximum orders returned. */
+};
+
+/**
+ * @brief Parses a QUERY_ORDERS command.
+ *
+ * @param command The raw command received from the client.
+ * @param query Output parameter receiving the filters and page.
+ * @param error Output parameter receiving a JSON error when the command is malformed.
+ * @return true if the command is valid, false otherwise.
+ */
+bool parseOrderQuery(const std::string& command, OrderQuery& query, std::string& error);
+
+/**
+ * @class PostingList
+ * @brief Ascending sequence numbers, delta-encoded as varints.
+ */
+class PostingList
+{
+  public:
+    /**
+     * @brief Adds a sequence number.
+     *
+     * Appending a number larger than every stored one is O(1); an out-of-order
+     * number, left by two threads racing between the journal and the index,
+     * only re-encodes the numbers stored after it.
+     *
+     * @param sequence Sequence number to add.
+     */
+    void add(std::uint64_t sequence);
+
+    /**
+     * @brief Decodes the list.
+     * @return Sequence numbers, ascending.
+     */
+    std::vector<std::uint64_t> decode() const;
+
+    /**
+     * @brief Gets the number of stored sequence numbers.
+     * @return Entry count.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the encoded size of the list.
+     * @return Size in bytes.
+     */
+    std::size_t bytes() const;
+
+    /**
+     * @brief Appends a list whose numbers are all larger than the ones of this list.
+     * @param later List to append; copied without decoding.
+     */
+    void extend(const PostingList& later);
+
+    /**
+     * @brief Removes the numbers smaller than a sequence number.
+     * @param sequence Smallest number kept.
+     */
+    void dropBefore(std::uint64_t sequence);
+
+    /**
+     * @brief Writes the encoded list to a snapshot.
+     * @param writer Snapshot being written.
+     */
+    void save(SnapshotWriter& writer) const;
+
+    /**
+     * @brief Replaces the list with one written by save().
+     * @param reader Snapshot positioned at the list.
+     * @return false if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& reader);
+
+  private:
+    void append(std::uint64_t delta);
+
+    std::size_t readVarint(std::size_t offset, std::uint64_t& value) const;
+
+    std::size_t varintStart(std::size_t end) const;
+
+    std::vector<unsigned char> data; /**< Varint-encoded deltas. */
+    std::uint64_t last = 0;          /**< Largest stored number. */
+    std::size_t count = 0;           /**< Number of stored numbers. */
+};
+
+/**
+ * @struct OrderPage
+ * @brief One page of matching orders.
+ */
+struct OrderPage
+{
+    std::size_t total = 0;                                     /**< Matches over every page. */
+    std::vector<std::pair<std::uint64_t, std::string>> orders; /**< Sequence and raw order, newest first. */
+};
+
+/**
+ * @class OrderIndex
+ * @brief Thread-safe posting lists of the stored orders, per indexed field value.
+ */
+class OrderIndex
+{
+  public:
+    /**
+     * @brief Gets the index of the stored orders.
+     * @return The process-wide index.
+     */
+    static OrderIndex& getInstance();
+
+    /**
+     * @brief Indexes a journal record.
+     *
+     * Empty fields are not indexed; the record is always part of the unfiltered results.
+     *
+     * @param sequence Sequence number of the record.
+     * @param client ID of the client that sent the order, 0 if none.
+     * @param facts Fields of the order.
+     */
+    void add(std::uint64_t sequence, std::uint32_t client, const OrderFacts& facts);
+
+    /**
+     * @brief Finds the records matching every filter.
+     *
+     * @param filters Field values; none matches every record.
+     * @return Sequence numbers, ascending.
+     */
+    std::vector<std::uint64_t> find(const std::vector<std::pair<OrderField, std::string>>& filters) const;
+
+    /**
+     * @brief Gets the encoded size of every posting list.
+     * @return Size in bytes.
+     */
+    std::size_t bytes() const;
+
+    /**
+     * @brief Drops every posting list.
+     */
+    void clear();
+
+    /**
+     * @brief Appends the lists of an index holding only records later than the ones of this index.
+     *
+     * Used to merge indexes built in parallel over consecutive parts of the journal.
+     *
+     * @param later Index of the later records.
+     */
+    void extend(const OrderIndex& later);
+
+    /**
+     * @brief Forgets the records removed from the journal by retention.
+     *
+     * Lists left empty are dropped, so the index shrinks with the journal.
+     *
+     * @param sequence First sequence number still in the journal.
+     */
+    void dropBefore(std::uint64_t sequence);
+
+    /**
+     * @brief Writes every posting list to a snapshot.
+     * @param writer Snapshot being written.
+     */
+    void save(SnapshotWriter& writer) const;
+
+    /**
+     * @brief Replaces every posting list with the ones of a snapshot.
+     * @param reader Snapshot positioned where save() wrote the lists.
+     * @return false if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& reader);
+
+  private:
+    static std::string normalize(const std::string& value);
+
+    void addLocked(OrderField field, const std::string& value, std::uint64_t sequence);
+
+    mutable std::shared_mutex mutex;                                                    /**< Guards the lists. */
+    std::array<std::unordered_map<std::string, PostingList>, ORDER_FIELD_COUNT> fields; /**< Lists per value. */
+    PostingList all;                                                                    /**< Every indexed record. */
+};
+
+/**
+ * @brief Builds the QUERY_ORDERS response.
+ *
+ * @param query Filters and page of the query.
+ * @param page Matching orders.
+ * @return The response sent to the client.
+ */
+std::string formatOrderPage(const OrderQuery& query, const OrderPage& page);
+
+#endif // ORDER_INDEX_HPP
@@ -0,0 +1,394 @@
+/**
+ * @file orderJournal.hpp
+ * @brief Persistent, append-only journal of the orders received by the server.
+ *
+ * Orders are appended as records to segment files that are memory-mapped while
+ * they are written. A segment is a fixed-size file named after the sequence
+ * number of its first record; when the next record does not fit, the segment
+ * is sealed (truncated to its used length and unmapped) and a new one is
+ * started. Only the active segment stays mapped, so memory use does not grow
+ * with the number of orders.
+ *
+ * Every record starts with a fixed 32-byte header followed by the raw order,
+ * padded to 8 bytes:
+ *
+ * | Offset | Size | Field                                           |
+ * |--------|------|-------------------------------------------------|
+ * | 0      | 4    | magic (ORDER_JOURNAL_MAGIC)                     |
+ * | 4      | 4    | payload length in bytes                         |
+ * | 8      | 4    | CRC-32 of sequence, timestamp and payload       |
+ * | 12     | 4    | ID of the client that sent the order, 0 if none |
+ * | 16     | 8    | sequence number (1-based, consecutive)          |
+ * | 24     | 8    | timestamp, milliseconds since the Unix epoch    |
+ *
+ * When the journal is opened, each segment is scanned up to the first record
+ * that is incomplete, fails its checksum or breaks the sequence; anything after
+ * it in the last segment is discarded.
+ *
+ * Sealed segments older than the most recent ones are compressed by a
+ * background thread into single zstd frames (`.zst`), using a dictionary
+ * trained on the first segment compressed and kept next to the segments.
+ * Readers decompress them transparently; the active segment and the most
+ * recent sealed ones stay uncompressed.
+ *
+ * Whenever a segment is sealed or a snapshot written, and when the journal is
+ * opened, the oldest sealed segments are deleted while the journal is over its
+ * size limit or they were sealed longer ago than its age limit. Only segments
+ * whose records are all covered by the snapshot are deleted, so the state
+ * rebuilt at startup never misses an order. The journal then starts at the
+ * first record of the oldest segment kept.
+ *
+ * The journal also keeps one snapshot of state derived from its records
+ * (ORDER_JOURNAL_SNAPSHOT_FILE): a 24-byte header (magic, CRC-32 of the state,
+ * sequence of the last record included, state length) followed by the opaque
+ * state. It is replaced atomically, deleted by clear(), and only handed back
+ * while the journal still reaches that sequence.
+ *
+ * Readers copy the segment list, and the records of the active segment when
+ * they need them, under the journal lock and visit them without it, so a
+ * slow visitor never holds back append().
+ */
+
+#ifndef ORDER_JOURNAL_HPP
+#define ORDER_JOURNAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/// Default directory holding the journal segments.
+#define ORDER_JOURNAL_DIR "order_journal"
+/// Default size of a segment file in bytes.
+#define ORDER_JOURNAL_SEGMENT_BYTES (4 * 1024 * 1024)
+/// Smallest accepted segment size in bytes.
+#define ORDER_JOURNAL_MIN_SEGMENT_BYTES 4096
+/// Default maximum time, in milliseconds, between two syncs with the "interval" policy.
+#define ORDER_JOURNAL_FSYNC_MS 100
+/// Marks the start of a record ("ORDR").
+#define ORDER_JOURNAL_MAGIC 0x5244524fu
+/// Default zstd compression level of sealed segments.
+#define ORDER_JOURNAL_ZSTD_LEVEL 3
+/// Default number of most recent sealed segments kept uncompressed.
+#define ORDER_JOURNAL_HOT_SEGMENTS 1
+/// Default maximum size of the segment files in bytes, 0 for no limit.
+#define ORDER_JOURNAL_RETENTION_BYTES (1024ull * 1024 * 1024)
+/// Default maximum age of a sealed segment in hours, 0 for no limit; matches the longest report window.
+#define ORDER_JOURNAL_RETENTION_HOURS (24 * 31)
+/// Maximum size of the trained compression dictionary in bytes.
+#define ORDER_JOURNAL_DICT_BYTES (16 * 1024)
+/// Name of the dictionary file in the journal directory.
+#define ORDER_JOURNAL_DICT_FILE "dictionary.zdict"
+/// Name of the snapshot file in the journal directory.
+#define ORDER_JOURNAL_SNAPSHOT_FILE "orders.snapshot"
+/// Marks the start of the snapshot file ("OSNP").
+#define ORDER_SNAPSHOT_MAGIC 0x504e534fu
+
+/**
+ * @enum JournalSync
+ * @brief When appended records are flushed to disk.
+ */
+enum class JournalSync
+{
+    ALWAYS,   /**< Sync every record before append() returns. */
+    INTERVAL, /**< Sync at most the interval after a record is appended, even if no other record follows. */
+    NEVER     /**< Leave write-back to the operating system. */
+};
+
+/**
+ * @struct OrderJournalConfig
+ * @brief Settings of the order journal.
+ */
+struct OrderJournalConfig
+{
+    std::string directory = ORDER_JOURNAL_DIR;                    /**< Directory holding the segments. */
+    std::size_t segmentBytes = ORDER_JOURNAL_SEGMENT_BYTES;       /**< Size of a segment file. */
+    JournalSync sync = JournalSync::INTERVAL;                     /**< Fsync policy. */
+    int syncIntervalMs = ORDER_JOURNAL_FSYNC_MS;                  /**< Interval of the "interval" policy. */
+    bool compress = true;                                         /**< Whether cold segments are compressed. */
+    int compressionLevel = ORDER_JOURNAL_ZSTD_LEVEL;              /**< zstd compression level. */
+    int hotSegments = ORDER_JOURNAL_HOT_SEGMENTS;                 /**< Sealed segments kept uncompressed. */
+    std::uint64_t retentionBytes = ORDER_JOURNAL_RETENTION_BYTES; /**< Size limit of the segments, 0 for none. */
+    int retentionHours = ORDER_JOURNAL_RETENTION_HOURS;           /**< Age limit of sealed segments, 0 for none. */
+};
+
+/**
+ * @brief Reads the journal settings from the environment.
+ *
+ * - ORDER_JOURNAL_DIR: directory holding the segments.
+ * - ORDER_JOURNAL_SEGMENT_BYTES: size of a segment file.
+ * - ORDER_JOURNAL_FSYNC: "always", "interval" (default) or "never".
+ * - ORDER_JOURNAL_FSYNC_MS: interval of the "interval" policy.
+ * - ORDER_JOURNAL_COMPRESS: "0" keeps sealed segments uncompressed.
+ * - ORDER_JOURNAL_ZSTD_LEVEL: zstd compression level.
+ * - ORDER_JOURNAL_HOT_SEGMENTS: most recent sealed segments kept uncompressed.
+ * - ORDER_JOURNAL_RETENTION_BYTES: size limit of the segment files, 0 for none.
+ * - ORDER_JOURNAL_RETENTION_HOURS: age limit of sealed segments, 0 for none.
+ *
+ * @return The parsed configuration.
+ */
+OrderJournalConfig loadOrderJournalConfig();
+
+/**
+ * @struct OrderRecord
+ * @brief A journal record as seen by readers.
+ *
+ * The payload points into the mapped segment and is only valid during the visit.
+ */
+struct OrderRecord
+{
+    std::uint64_t sequence;   /**< Sequence number of the order. */
+    std::int64_t timestamp;   /**< Time the order was appended, in milliseconds since the epoch. */
+    std::uint32_t client;     /**< ID of the client that sent the order, 0 if none. */
+    std::string_view payload; /**< Raw order. */
+};
+
+/**
+ * @class OrderJournal
+ * @brief Thread-safe append-only order log made of memory-mapped segment files.
+ */
+class OrderJournal
+{
+  public:
+    /**
+     * @brief Function receiving the records of the journal, in sequence order.
+     */
+    using RecordVisitor = std::function<void(const OrderRecord&)>;
+
+    /**
+     * @brief Function receiving the records of one part of the journal and the index of that part.
+     */
+    using PartVisitor = std::function<void(std::size_t, const OrderRecord&)>;
+
+    OrderJournal() = default;
+
+    ~OrderJournal();
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    /**
+     * @brief Gets the process-wide journal instance.
+     * @return The journal used by the order storage.
+     */
+    static OrderJournal& getInstance();
+
+    /**
+     * @brief Opens (or creates) the journal in the configured directory.
+     *
+     * @param config Journal settings.
+     * @return true if the journal can be appended to, false otherwise.
+     */
+    bool open(const OrderJournalConfig& config);
+
+    /**
+     * @brief Stops the background threads, then syncs and unmaps the active segment.
+     */
+    void close();
+
+    /**
+     * @brief Tells whether the journal is open.
+     * @return true if records can be appended.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Appends an order.
+     *
+     * @param payload Raw order.
+     * @param client ID of the client that sent the order, 0 if none.
+     * @return Sequence number of the record, or 0 if it could not be written.
+     */
+    std::uint64_t append(std::string_view payload, std::uint32_t client = 0);
+
+    /**
+     * @brief Calls a visitor for every record, oldest first.
+     *
+     * @param visitor Function receiving each record.
+     */
+    void forEach(const RecordVisitor& visitor) const;
+
+    /**
+     * @brief Calls a visitor for the records with the given sequence numbers.
+     *
+     * Only the segments holding one of them are read.
+     *
+     * @param sequences Sequence numbers, in ascending order.
+     * @param visitor Function receiving each record found, in sequence order.
+     */
+    void forEachOf(const std::vector<std::uint64_t>& sequences, const RecordVisitor& visitor) const;
+
+    /**
+     * @brief Gets the number of parts forEachAfter() splits the records after a sequence number in.
+     *
+     * @param sequence Last sequence number skipped.
+     * @return Number of segments holding later records.
+     */
+    std::size_t segmentsAfter(std::uint64_t sequence) const;
+
+    /**
+     * @brief Calls a visitor for every record after a sequence number, reading several segments at once.
+     *
+     * Part i is the i-th segment holding such records. Each part is visited by a
+     * single thread in sequence order, but different parts are visited
+     * concurrently, so the visitor must be thread-safe.
+     *
+     * @param sequence Last sequence number skipped, 0 for every record.
+     * @param threads Maximum number of threads reading segments.
+     * @param visitor Function receiving the part index and each record.
+     */
+    void forEachAfter(std::uint64_t sequence, std::size_t threads, const PartVisitor& visitor) const;
+
+    /**
+     * @brief Gets the number of records in the journal.
+     * @return Record count.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * @brief Gets the sequence number of the oldest record kept.
+     * @return First sequence number; the next one to be appended if the journal is empty.
+     */
+    std::uint64_t firstSequence() const;
+
+    /**
+     * @brief Gets the sequence number of the newest record.
+     * @return Last sequence number, 0 if the journal is empty.
+     */
+    std::uint64_t lastSequence() const;
+
+    /**
+     * @brief Replaces the snapshot of the state built from the records.
+     *
+     * @param sequence Last record the state includes.
+     * @param state Serialized state.
+     * @return true if the snapshot was written.
+     */
+    bool writeSnapshot(std::uint64_t sequence, std::string_view state);
+
+    /**
+     * @brief Reads the snapshot of the state built from the records.
+     *
+     * @param sequence Output parameter receiving the last record the state includes.
+     * @param state Output parameter receiving the serialized state.
+     * @return false if there is no snapshot, it is damaged or it is ahead of the journal.
+     */
+    bool readSnapshot(std::uint64_t& sequence, std::string& state) const;
+
+    /**
+     * @brief Deletes every segment and starts again from sequence 1.
+     *
+     * @return true if the journal was emptied and can be appended to.
+     */
+    bool clear();
+
+    /**
+     * @brief Flushes the active segment to disk.
+     */
+    void sync();
+
+    /**
+     * @brief Gets the bytes appended to the active segment and not synced yet.
+     * @return Unsynced byte count.
+     */
+    std::size_t unsyncedBytes() const;
+
+    /**
+     * @brief Gets the number of segments stored compressed.
+     * @return Compressed segment count.
+     */
+    std::size_t compressedSegments() const;
+
+  private:
+    /**
+     * @struct Segment
+     * @brief A segment file, identified by the sequence of its first record.
+     */
+    struct Segment
+    {
+        std::string path;             /**< File path. */
+        std::uint64_t firstSequence;  /**< Sequence of its first record. */
+        std::uint64_t records;        /**< Number of valid records. */
+        std::size_t usedBytes;        /**< Bytes taken by the valid records. */
+        bool compressed;              /**< Whether the file is a zstd frame. */
+    };
+
+    static std::size_t scan(const unsigned char* data, std::size_t length, std::uint64_t firstSequence,
+                            const RecordVisitor* visitor, std::uint64_t& records);
+
+    /**
+     * @struct View
+     * @brief Segments copied under the lock, so readers can visit them without it.
+     */
+    struct View
+    {
+        std::string directory;         /**< Directory holding the segments. */
+        std::vector<Segment> segments; /**< Segments to visit, oldest first. */
+        bool hasActive = false;        /**< Whether the last segment is the active one. */
+        std::string active;            /**< Records of the active segment when it is visited. */
+        std::string dictionary;        /**< Dictionary of the compressed segments. */
+    };
+
+    static std::string segmentPath(const std::string& directory, std::uint64_t firstSequence, bool compressed);
+
+    static bool readSegment(const Segment& segment, const std::string& dictionary, std::string& contents);
+
+    View takeView(std::size_t first, bool withActive) const;
+
+    void visitSegment(const View& view, std::size_t index, const RecordVisitor& visitor) const;
+
+    std::size_t firstSegmentAfter(std::uint64_t sequence) const;
+
+    std::string snapshotPath() const;
+
+    void compressLoop();
+
+    bool compressSegment(const Segment& segment, std::string& tmpPath);
+
+    bool loadDictionary();
+
+    void syncLoop();
+
+    void stopThreads();
+
+    bool openLocked();
+
+    bool mapActive(const std::string& path, bool create);
+
+    bool startSegment();
+
+    void sealActive();
+
+    void unmapActive();
+
+    void syncLocked();
+
+    void enforceRetention();
+
+    mutable std::mutex mutex;                              /**< Guards everything below. */
+    OrderJournalConfig config;                             /**< Current settings. */
+    std::vector<Segment> segments;                         /**< Every segment, oldest first; the last is active. */
+    int activeFd = -1;                                     /**< File descriptor of the active segment. */
+    unsigned char* activeData = nullptr;                   /**< Mapping of the active segment. */
+    std::size_t activeCapacity = 0;                        /**< Size of the active mapping. */
+    std::size_t syncedBytes = 0;                           /**< Bytes of the active segment already synced. */
+    std::uint64_t nextSequence = 1;                        /**< Sequence of the next record. */
+    std::uint64_t recordCount = 0;                         /**< Records in the journal. */
+    std::chrono::steady_clock::time_point lastSync;        /**< Time of the last sync. */
+    std::string dictionary;                                /**< Trained zstd dictionary, empty until trained. */
+    std::thread compressor;                                /**< Background compression thread. */
+    std::condition_variable compressWork;                  /**< Wakes the compression thread. */
+    std::thread syncer;                                    /**< Background sync thread of the "interval" policy. */
+    std::condition_variable syncTimer;                     /**< Wakes the sync thread when it must exit. */
+    bool stopping = false;                                 /**< Tells the background threads to exit. */
+    std::uint64_t generation = 0;                          /**< Bumped on clear(), invalidates running compressions. */
+    std::uint64_t snapshotSequence = 0;                    /**< Last record covered by the snapshot, 0 if none. */
+};
+
+#endif // ORDER_JOURNAL_HPP
@@ -0,0 +1,226 @@
+/**
+ * @file orderReport.hpp
+ * @brief Time-bucketed order rollups and the SHOW_REPORT command.
+ *
+ * Every stored order is added, on ingest, to a per-minute and a per-hour
+ * bucket and to the all-time totals, each holding the number of orders and
+ * units per product, destination location and priority. A windowed report
+ * merges the buckets covering the window instead of reading the orders:
+ *
+ *     SHOW_REPORT [window=<N>m|<N>h|<N>d|<N>] [group=product|location|priority]
+ *
+ * A bare window is in hours; without a window the report covers every order.
+ * Minute buckets are kept for the last ROLLUP_MINUTE_BUCKETS minutes and hour
+ * buckets for the last ROLLUP_HOUR_BUCKETS hours. The oldest minutes of a
+ * longer window are counted at hour granularity, so its start is rounded down
+ * to the hour.
+ *
+ * The buckets are split in ORDER_STATS_SHARDS shards with a lock each; a
+ * thread records into its own shard and reports merge every shard.
+ */
+
+#ifndef ORDER_REPORT_HPP
+#define ORDER_REPORT_HPP
+
+#include "errorHandler.hpp"
+#include "productCounters.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <json/json.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Name of the order report command.
+#define SHOW_REPORT_COMMAND "SHOW_REPORT"
+
+/// Error code for a malformed SHOW_REPORT command.
+#define ERR_INVALID_REPORT_QUERY 1011
+
+/// Number of minute buckets kept (two hours).
+#define ROLLUP_MINUTE_BUCKETS 120
+/// Number of hour buckets kept (31 days).
+#define ROLLUP_HOUR_BUCKETS (24 * 31)
+
+/**
+ * @enum ReportGroup
+ * @brief Dimension the order report is grouped by.
+ */
+enum class ReportGroup
+{
+    PRODUCT,  /**< Product name. */
+    LOCATION, /**< Destination location, e.g. "hub 2". */
+    PRIORITY  /**< Priority from the order metadata. */
+};
+
+/**
+ * @struct ReportQuery
+ * @brief Parameters of a SHOW_REPORT command.
+ */
+struct ReportQuery
+{
+    int windowMinutes = 0;                    /**< Length of the window, 0 for every order. */
+    ReportGroup group = ReportGroup::PRODUCT; /**< Grouping of the totals. */
+};
+
+/**
+ * @brief Parses a SHOW_REPORT command.
+ *
+ * @param command The raw command received from the client.
+ * @param query Output parameter receiving the parameters.
+ * @param error Output parameter receiving a JSON error when the command is malformed.
+ * @return true if the command is valid, false otherwise.
+ */
+bool parseReportQuery(const std::string& command, ReportQuery& query, std::string& error);
+
+/**
+ * @struct OrderFacts
+ * @brief Fields of an order the rollups are grouped by.
+ */
+struct OrderFacts
+{
+    std::string product;  /**< Product name. */
+    std::string source;   /**< Source, as "<type> <id>". */
+    std::string location; /**< Destination, as "<type> <id>". */
+    std::string priority; /**< Priority from the order metadata. */
+    int quantity;         /**< Ordered quantity. */
+};
+
+/**
+ * @brief Extracts the rollup fields of an order.
+ *
+ * @param order Parsed order.
+ * @param facts Output parameter receiving the fields.
+ * @return true if the order names a product and a positive quantity.
+ */
+bool extractOrderFacts(const Json::Value& order, OrderFacts& facts);
+
+/**
+ * @struct RollupTotal
+ * @brief Orders and units counted for one group.
+ */
+struct RollupTotal
+{
+    long long orders = 0;   /**< Number of orders. */
+    long long quantity = 0; /**< Units ordered. */
+};
+
+/**
+ * @brief Totals of a report, keyed by group value.
+ */
+using RollupTotals = std::map<std::string, RollupTotal>;
+
+/**
+ * @class OrderRollup
+ * @brief Thread-safe, sharded ring buffers of per-minute and per-hour order totals.
+ */
+class OrderRollup
+{
+  public:
+    /**
+     * @brief Creates empty rollups.
+     * @param minuteBuckets Number of minute buckets kept.
+     * @param hourBuckets Number of hour buckets kept.
+     */
+    explicit OrderRollup(std::size_t minuteBuckets = ROLLUP_MINUTE_BUCKETS,
+                         std::size_t hourBuckets = ROLLUP_HOUR_BUCKETS);
+
+    /**
+     * @brief Gets the rollups of the stored orders.
+     * @return The process-wide rollups.
+     */
+    static OrderRollup& getInstance();
+
+    /**
+     * @brief Adds an order to the buckets of its time.
+     *
+     * Orders older than a ring are only added to the rings that still cover them.
+     *
+     * @param timestampMs Time of the order, in milliseconds since the epoch.
+     * @param facts Fields of the order.
+     */
+    void record(std::int64_t timestampMs, const OrderFacts& facts);
+
+    /**
+     * @brief Merges the buckets covering the window of a query.
+     *
+     * @param query Window and grouping.
+     * @param nowMs Current time, in milliseconds since the epoch.
+     * @return Totals per group value.
+     */
+    RollupTotals query(const ReportQuery& query, std::int64_t nowMs) const;
+
+    /**
+     * @brief Empties every bucket.
+     */
+    void clear();
+
+    /**
+     * @brief Writes the buckets of every shard to a snapshot.
+     * @param writer Snapshot being written.
+     */
+    void save(SnapshotWriter& writer) const;
+
+    /**
+     * @brief Adds the buckets of a snapshot.
+     *
+     * Buckets that left the rings since the snapshot was taken are skipped.
+     *
+     * @param reader Snapshot positioned where save() wrote the buckets.
+     * @return false if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& reader);
+
+  private:
+    /**
+     * @struct Bucket
+     * @brief Totals of one minute or hour, per group.
+     */
+    struct Bucket
+    {
+        std::int64_t index = -1;                                            /**< Minute or hour, -1 if empty. */
+        std::array<std::unordered_map<std::string, RollupTotal>, 3> groups; /**< Totals per ReportGroup. */
+    };
+
+    /**
+     * @struct Shard
+     * @brief Buckets written by the threads of one shard.
+     */
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;    /**< Guards the buckets of the shard. */
+        std::vector<Bucket> minutes; /**< Minute ring, indexed by minute modulo its size. */
+        std::vector<Bucket> hours;   /**< Hour ring, indexed by hour modulo its size. */
+        Bucket allTime;              /**< Totals of every order. */
+    };
+
+    static void add(std::vector<Bucket>& ring, std::int64_t index, const OrderFacts& facts);
+
+    static void add(Bucket& bucket, const OrderFacts& facts);
+
+    static void absorb(std::vector<Bucket>& ring, const Bucket& bucket);
+
+    static void absorb(Bucket& into, const Bucket& from);
+
+    static void save(SnapshotWriter& writer, std::uint64_t ring, const Bucket& bucket);
+
+    static void merge(const std::vector<Bucket>& ring, std::int64_t index, ReportGroup group, RollupTotals& totals);
+
+    static void merge(const Bucket& bucket, ReportGroup group, RollupTotals& totals);
+
+    std::array<Shard, ORDER_STATS_SHARDS> shards; /**< Buckets, one set per shard. */
+};
+
+/**
+ * @brief Builds the SHOW_REPORT response, largest groups first.
+ *
+ * @param query Window and grouping of the report.
+ * @param totals Totals per group value.
+ * @return The report sent to the client.
+ */
+std::string formatOrderReport(const ReportQuery& query, const RollupTotals& totals);
+
+#endif // ORDER_REPORT_HPP
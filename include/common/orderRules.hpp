@@ -0,0 +1,199 @@
+/**
+ * @file orderRules.hpp
+ * @brief Quantity rules of the orders, loaded from a file and swapped at runtime.
+ *
+ * The rules are read from a JSON file (ORDER_RULES_FILE, ../config/order_rules.json
+ * by default) with one entry per client type and product class:
+ *
+ *     {"rules": [{"client": "hub", "product": "critical", "min": 20, "max": 100,
+ *                 "min_error": 1005, "min_message": "...",
+ *                 "max_error": 1005, "max_message": "..."}, ...]}
+ *
+ * and compiled into an OrderRuleTable, a flat array of cells indexed by client
+ * type and product class. Each cell holds the bounds and, per outcome (accepted,
+ * below the minimum, above the maximum), the error to report. Checking a
+ * quantity reads one cell and turns two comparisons into the outcome index,
+ * without branching.
+ *
+ * Tables never change once compiled. OrderRules publishes the current one with
+ * an atomic shared_ptr: reloading the file does not block validation, and every
+ * order is checked against a single version of the rules. A file that does not
+ * compile is reported and the previous rules stay in place. Without a file the
+ * built-in rules, the MIN_ and MAX_ limits of orderValidation.hpp, apply.
+ */
+
+#ifndef ORDER_RULES_HPP
+#define ORDER_RULES_HPP
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <json/json.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Default path of the rules file, relative to the build directory like the client configuration.
+#define ORDER_RULES_PATH "../config/order_rules.json"
+/// Product classes of the table: non-critical and critical.
+#define ORDER_RULE_PRODUCT_CLASSES 2
+
+/**
+ * @struct QuantityRule
+ * @brief A cell of the decision table: the limits for one client type and product class.
+ */
+struct QuantityRule
+{
+    int min = 1;                           /**< Smallest quantity accepted. */
+    int max = 0;                           /**< Largest quantity accepted. */
+    std::array<int, 4> errors{};           /**< Error per outcome (bit 0: below min, bit 1: above max), 0 if none. */
+    std::array<std::string, 4> messages{}; /**< Error description per outcome. */
+};
+
+/**
+ * @struct RuleViolation
+ * @brief Result of checking a quantity.
+ */
+struct RuleViolation
+{
+    int code;                 /**< Error code, 0 if the quantity is accepted. */
+    std::string_view message; /**< Error description, valid while the table is alive. */
+};
+
+/**
+ * @class OrderRuleTable
+ * @brief Compiled quantity rules, indexed by client type and product class.
+ */
+class OrderRuleTable
+{
+  public:
+    /**
+     * @brief Builds the rules that applied before they were configurable.
+     * @return Table with the "hub" and "external" client types.
+     */
+    static OrderRuleTable builtin();
+
+    /**
+     * @brief Compiles the rules of a parsed configuration.
+     *
+     * Every client type named in the rules needs one rule per product class,
+     * and min must not be greater than max.
+     *
+     * @param config Parsed configuration, with a "rules" array.
+     * @param table Output parameter receiving the compiled rules.
+     * @param error Output parameter receiving why the configuration was rejected.
+     * @return false if the configuration is invalid; table is left untouched.
+     */
+    static bool compile(const Json::Value& config, OrderRuleTable& table, std::string& error);
+
+    /**
+     * @brief Finds a client type.
+     * @param type Client type of the order.
+     * @return Index of the client type, -1 if the rules do not know it.
+     */
+    int clientIndex(std::string_view type) const;
+
+    /**
+     * @brief Lists the client types for error messages.
+     * @return The types quoted and joined, e.g. "'hub' or 'external'".
+     */
+    std::string clientList() const;
+
+    /**
+     * @brief Gets the number of client types.
+     * @return Rows of the table; valid client indexes are below it.
+     */
+    std::size_t clientCount() const
+    {
+        return clients.size();
+    }
+
+    /**
+     * @brief Gets a cell of the table.
+     *
+     * @param client Index returned by clientIndex().
+     * @param critical Whether the product is critical.
+     * @return The limits and errors of the client type and product class.
+     */
+    const QuantityRule& rule(std::size_t client, bool critical) const
+    {
+        return rules[client * ORDER_RULE_PRODUCT_CLASSES + static_cast<std::size_t>(critical)];
+    }
+
+    /**
+     * @brief Checks a quantity against the rule of a client type and product class.
+     *
+     * @param client Index returned by clientIndex().
+     * @param critical Whether the product is critical.
+     * @param quantity Ordered quantity.
+     * @return The error to report, with code 0 if the quantity is accepted.
+     */
+    RuleViolation check(std::size_t client, bool critical, int quantity) const
+    {
+        const QuantityRule& cell = rule(client, critical);
+        std::size_t outcome =
+            static_cast<std::size_t>(quantity < cell.min) | static_cast<std::size_t>(quantity > cell.max) << 1;
+        return {cell.errors[outcome], cell.messages[outcome]};
+    }
+
+  private:
+    std::vector<std::string> clients; /**< Client types, in the order of the table rows. */
+    std::vector<QuantityRule> rules;  /**< One cell per client type and product class. */
+};
+
+/**
+ * @class OrderRules
+ * @brief Current rule table of the server, reloaded from its file when it changes.
+ */
+class OrderRules
+{
+  public:
+    /**
+     * @brief Starts with the built-in rules and loads the file if it exists.
+     * @param path Rules file; empty to use only the built-in rules.
+     */
+    explicit OrderRules(const std::string& path = "");
+
+    /**
+     * @brief Gets the rules of the server.
+     * @return The process-wide rules, read from ORDER_RULES_FILE or ORDER_RULES_PATH.
+     */
+    static OrderRules& getInstance();
+
+    /**
+     * @brief Gets the table in use.
+     * @return The current table; it stays valid while the pointer is held, even after a reload.
+     */
+    std::shared_ptr<const OrderRuleTable> current() const;
+
+    /**
+     * @brief Replaces the table in use.
+     * @param rules New rules, seen by the orders validated from now on.
+     */
+    void publish(std::shared_ptr<const OrderRuleTable> rules);
+
+    /**
+     * @brief Compiles the file and publishes it.
+     * @param error Output parameter receiving why the file was rejected.
+     * @return false if the file cannot be read or compiled; the previous rules are kept.
+     */
+    bool reload(std::string& error);
+
+    /**
+     * @brief Reloads the file if it was modified since it was last read.
+     * @return true if new rules were published.
+     */
+    bool reloadIfChanged();
+
+  private:
+    bool reloadLocked(std::string& error);
+
+    const std::string path;                      /**< Rules file, empty if there is none. */
+    std::shared_ptr<const OrderRuleTable> table; /**< Current rules; only read and written atomically. */
+    std::mutex reloadMutex;                      /**< Serializes reloads. */
+    std::filesystem::file_time_type loaded{};    /**< Modification time of the file last read. */
+};
+
+#endif // ORDER_RULES_HPP
@@ -0,0 +1,133 @@
+/**
+ * @file orderSnapshot.hpp
+ * @brief Binary encoding of the order statistics for journal snapshots.
+ *
+ * The product totals, rollups and indexes are rebuilt from the order journal
+ * at startup. Replaying every record makes the time to ready grow with the
+ * history, so the storage periodically saves them, together with the
+ * sequence of the last record they include, through
+ * OrderJournal::writeSnapshot(). At startup the snapshot is loaded and only
+ * the records after it are replayed, by several threads.
+ *
+ * Values are written in native byte order: a snapshot is only read back by the
+ * server that wrote it.
+ */
+
+#ifndef ORDER_SNAPSHOT_HPP
+#define ORDER_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// Version of the snapshot encoding; snapshots of another version are ignored.
+#define ORDER_SNAPSHOT_VERSION 1
+/// Default number of stored orders between two snapshots.
+#define ORDER_SNAPSHOT_EVERY 10000
+
+/**
+ * @struct OrderSnapshotConfig
+ * @brief When snapshots are taken and how the journal tail is replayed.
+ */
+struct OrderSnapshotConfig
+{
+    std::uint64_t everyOrders = ORDER_SNAPSHOT_EVERY; /**< Orders between two snapshots, 0 disables them. */
+    std::size_t replayThreads = 0;                    /**< Threads replaying the journal, 0 for one per core. */
+};
+
+/**
+ * @brief Reads the snapshot settings from the environment.
+ *
+ * - ORDER_SNAPSHOT_EVERY: stored orders between two snapshots, 0 disables them.
+ * - ORDER_REPLAY_THREADS: threads replaying the journal at startup.
+ *
+ * @return The parsed configuration.
+ */
+OrderSnapshotConfig loadOrderSnapshotConfig();
+
+/**
+ * @class SnapshotWriter
+ * @brief Appends values to a snapshot.
+ */
+class SnapshotWriter
+{
+  public:
+    /**
+     * @brief Appends an unsigned integer.
+     * @param value Value to append.
+     */
+    void putU64(std::uint64_t value);
+
+    /**
+     * @brief Appends a signed integer.
+     * @param value Value to append.
+     */
+    void putI64(std::int64_t value);
+
+    /**
+     * @brief Appends a length-prefixed string.
+     * @param value Value to append.
+     */
+    void putString(std::string_view value);
+
+    /**
+     * @brief Gets the encoded snapshot.
+     * @return Every value appended so far.
+     */
+    const std::string& data() const;
+
+  private:
+    std::string buffer; /**< Encoded values. */
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Reads back the values of a snapshot, in the order they were written.
+ *
+ * Every getter returns false, and keeps failing, once the snapshot is exhausted.
+ */
+class SnapshotReader
+{
+  public:
+    /**
+     * @brief Starts reading a snapshot.
+     * @param data Encoded snapshot; must outlive the reader.
+     */
+    explicit SnapshotReader(std::string_view data);
+
+    /**
+     * @brief Reads an unsigned integer.
+     * @param value Output parameter receiving the value.
+     * @return true if the value was read.
+     */
+    bool getU64(std::uint64_t& value);
+
+    /**
+     * @brief Reads a signed integer.
+     * @param value Output parameter receiving the value.
+     * @return true if the value was read.
+     */
+    bool getI64(std::int64_t& value);
+
+    /**
+     * @brief Reads a length-prefixed string.
+     * @param value Output parameter receiving the value.
+     * @return true if the value was read.
+     */
+    bool getString(std::string& value);
+
+    /**
+     * @brief Tells whether every value was read without error.
+     * @return true if the whole snapshot was consumed.
+     */
+    bool done() const;
+
+  private:
+    bool take(void* value, std::size_t length);
+
+    std::string_view data; /**< Values not read yet. */
+    bool failed = false;   /**< Whether a read ran past the end. */
+};
+
+#endif // ORDER_SNAPSHOT_HPP
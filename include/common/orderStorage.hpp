@@ -1,55 +1,91 @@
 /**
  * @file orderStorage.hpp
  * @brief Header file for order storage.
+ *
+ * Orders are kept in the persistent OrderJournal rather than in memory, so
+ * the history survives restarts. The sharded ProductCounters and the
+ * time-bucketed OrderRollup are rebuilt from the journal when it is opened,
+ * together with the OrderIndex that QUERY_ORDERS searches.
+ *
+ * Orders are parsed before any lock is taken; storing one only locks the
+ * journal for the copy into its segment and the shard of the calling thread.
+ *
+ * Every ORDER_SNAPSHOT_EVERY orders the statistics are saved in the background
+ * as a journal snapshot, so a restart loads it and replays only the newer
+ * records, spread over several threads, instead of the whole history.
+ *
+ * Memory does not grow with the history: raw orders stay on disk, within the
+ * journal retention limits, except for the RecentOrders ring of the newest ones.
  */
 
 #ifndef ORDER_STORAGE_H
 #define ORDER_STORAGE_H
 
+#include "orderIndex.hpp"
+#include "orderJournal.hpp"
+#include "orderSnapshot.hpp"
+#include "productCounters.hpp"
+#include "recentOrders.hpp"
 #include <iostream>
 #include <json/json.h>
-#include <mutex>
 #include <string>
-#include <unordered_map>
-#include <vector>
 
 /**
- * @brief Stores all the orders as JSON-formatted strings.
+ * @brief Opens the order journal and rebuilds the product totals from it.
+ *
+ * Called lazily by the functions below; the server calls it at startup so the
+ * reports include the orders of previous runs. The statistics are loaded from
+ * the latest snapshot and only the journal records after it are replayed.
  *
- * Each string represents a serialized JSON order received by the system.
+ * @return Number of orders in the journal, or -1 if it could not be opened.
  */
-extern std::vector<std::string> storedOrders;
+long long loadStoredOrders();
 
 /**
- * @brief Tracks the total quantity of each product.
+ * @brief Stores a JSON order and updates product quantity tracking.
  *
- * The key is the product name, and the value is the cumulative quantity.
+ * Parses the input JSON string, extracts the product name and quantity,
+ * appends the order to the journal, and updates the product totals, rollups and indexes.
+ *
+ * @param json_str A string containing the JSON-formatted order.
+ * @param clientId ID of the client that sent the order, 0 if none.
  */
-extern std::unordered_map<std::string, int> productQuantities;
+void storeOrder(const std::string& json_str, int clientId = 0);
 
 /**
- * @brief Mutex for synchronizing access to the orders and product data.
+ * @brief Prints all stored orders to the standard output.
  *
- * Ensures thread-safe operations when storing orders or modifying quantities.
+ * Outputs each stored order JSON string with its sequence number, reading them from the journal.
  */
-extern std::mutex ordersMutex;
+void printAllOrders();
 
 /**
- * @brief Stores a JSON order and updates product quantity tracking.
+ * @brief Saves the product totals, rollups and indexes as a journal snapshot.
  *
- * Parses the input JSON string, extracts the product name and quantity,
- * stores the order, and updates internal product count data.
+ * Called every ORDER_SNAPSHOT_EVERY stored orders, on a background thread so the
+ * order that reaches the threshold does not wait for it, and when the server stops.
+ * Stores wait only while the statistics are copied, not while the file is written.
  *
- * @param json_str A string containing the JSON-formatted order.
+ * @return true if the snapshot was written.
  */
-void storeOrder(const std::string& json_str);
+bool saveOrderSnapshot();
 
 /**
- * @brief Prints all stored orders to the standard output.
+ * @brief Waits for the background snapshot being written and stops its thread.
  *
- * Outputs each stored order JSON string with its index.
+ * Snapshots due afterwards are not written; the server calls saveOrderSnapshot() itself when it stops.
  */
-void printAllOrders();
+void stopOrderSnapshots();
+
+/**
+ * @brief Finds the stored orders matching a QUERY_ORDERS command.
+ *
+ * Only the records of the requested page are read from the journal.
+ *
+ * @param query Filters and page of the query.
+ * @return The page of matching orders, newest first, and the number of matches.
+ */
+OrderPage queryStoredOrders(const OrderQuery& query);
 
 /**
  * @brief Prints a report of the total quantities of each product.
@@ -61,7 +97,7 @@ void printProductReport();
 /**
  * @brief Clears all stored orders and product data.
  *
- * Resets the internal storage of orders and product quantity tracking.
+ * Deletes the journal segments and snapshot and resets product quantity tracking, rollups and indexes.
  */
 void clearStoredOrders();
 
@@ -1,10 +1,12 @@
 #ifndef ORDER_VALIDATION_HPP
 #define ORDER_VALIDATION_HPP
 
+#include "orderRules.hpp"
+#include "productCatalog.hpp"
 #include <json/json.h>
 #include <string>
-#include <unordered_map>
 
+// Built-in quantity limits, used when there is no rules file (see orderRules.hpp)
 #define MIN_CRITICAL_HUB_QUANTITY       20
 #define MAX_CRITICAL_HUB_QUANTITY       100
 #define MIN_NONCRITICAL_HUB_QUANTITY    50
@@ -21,21 +23,15 @@
 #define ERR_INVALID_QTY_EXT_ANY      1008
 #define ERR_UNKNOWN_CLIENT_TYPE      1009
 
-/**
- * @brief A map of critical products and their status.
- *
- */
-inline const std::unordered_map<std::string, bool> criticalProducts = {
-    {"Water", true}, {"Medicines", true}, {"Meat", false}, {"Weapons", false}, {"Clothes", false}};
-
 /**
  * @brief Validates the quantity limits per product order, based on client type
  * and whether the product is critical.
  *
- * This function checks if the order meets the established minimum and maximum
- * constraints for hubs and external clients, taking into account whether the
- * requested product is critical or not. It also validates the existence and
- * correct format of the required fields. In case of an error, a JSON-formatted
+ * This function checks if the order meets the minimum and maximum constraints
+ * of the current OrderRules for its client type, taking into account whether
+ * the requested product is critical or not. It also validates the existence and
+ * correct format of the required fields, and rejects products missing from the
+ * ProductCatalog with ERR_INVALID_VALUES. In case of an error, a JSON-formatted
  * message describing the issue will be returned.
  *
  * @param orderJson A Json::Value object containing the parsed order.
@@ -0,0 +1,177 @@
+/**
+ * @file productCatalog.hpp
+ * @brief Products accepted in orders and whether they are critical.
+ *
+ * The built-in products are a constexpr table with a perfect hash computed
+ * by the compiler: a seed is searched so that every built-in name lands in its
+ * own slot of a PRODUCT_TABLE_SLOTS array. Looking a name up hashes its bytes
+ * once, reads one slot and compares one name, without allocating.
+ *
+ * Products added at runtime, with ProductCatalog::registerProduct() or the
+ * ORDER_EXTRA_PRODUCTS variable ("Fuel:1,Tools:0", 1 for critical), live in a
+ * hash map that is only searched when a name is not built in.
+ */
+
+#ifndef PRODUCT_CATALOG_HPP
+#define PRODUCT_CATALOG_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// Slots of the built-in product table; a power of two at least as large as the number of products.
+#define PRODUCT_TABLE_SLOTS 8
+
+/**
+ * @struct ProductInfo
+ * @brief A product of the catalog.
+ */
+struct ProductInfo
+{
+    std::string_view name; /**< Product name, case-sensitive. */
+    bool critical;         /**< Whether the stricter quantity limits apply. */
+};
+
+/// Products known at compile time.
+inline constexpr std::array<ProductInfo, 5> BUILTIN_PRODUCTS = {{
+    {"Water", true},
+    {"Medicines", true},
+    {"Meat", false},
+    {"Weapons", false},
+    {"Clothes", false},
+}};
+
+static_assert(BUILTIN_PRODUCTS.size() <= PRODUCT_TABLE_SLOTS, "PRODUCT_TABLE_SLOTS is smaller than the catalog");
+
+/**
+ * @brief Hashes a product name with a seed (FNV-1a followed by a finalizer that mixes the high bits down).
+ *
+ * @param name Product name.
+ * @param seed Selects one hash function of the family.
+ * @return 32-bit hash.
+ */
+constexpr std::uint32_t productHash(std::string_view name, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (char c : name)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+/**
+ * @struct ProductTable
+ * @brief Perfect hash of the built-in products.
+ */
+struct ProductTable
+{
+    std::uint32_t seed = 0;                               /**< Seed giving every product its own slot. */
+    bool found = false;                                   /**< Whether such a seed was found. */
+    std::array<std::int8_t, PRODUCT_TABLE_SLOTS> slots{}; /**< Index in BUILTIN_PRODUCTS per slot, -1 if empty. */
+};
+
+/**
+ * @brief Searches the first seed for which the built-in products do not collide.
+ * @return The table; found is false if no seed below 65536 works.
+ */
+constexpr ProductTable buildProductTable()
+{
+    ProductTable table;
+    for (std::uint32_t seed = 0; seed < 65536; seed++)
+    {
+        for (std::size_t slot = 0; slot < PRODUCT_TABLE_SLOTS; slot++)
+        {
+            table.slots[slot] = -1;
+        }
+
+        bool collision = false;
+        for (std::size_t i = 0; i < BUILTIN_PRODUCTS.size() && !collision; i++)
+        {
+            std::size_t slot = productHash(BUILTIN_PRODUCTS[i].name, seed) % PRODUCT_TABLE_SLOTS;
+            collision = table.slots[slot] != -1;
+            table.slots[slot] = static_cast<std::int8_t>(i);
+        }
+
+        if (!collision)
+        {
+            table.seed = seed;
+            table.found = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+/// Perfect hash of the built-in products, computed by the compiler.
+inline constexpr ProductTable PRODUCT_TABLE = buildProductTable();
+
+static_assert(PRODUCT_TABLE.found, "No perfect hash seed for BUILTIN_PRODUCTS; increase PRODUCT_TABLE_SLOTS");
+
+/**
+ * @brief Finds a built-in product.
+ *
+ * @param name Product name.
+ * @return Index in BUILTIN_PRODUCTS, -1 if the product is not built in.
+ */
+constexpr int builtinProductIndex(std::string_view name)
+{
+    int index = PRODUCT_TABLE.slots[productHash(name, PRODUCT_TABLE.seed) % PRODUCT_TABLE_SLOTS];
+    return index >= 0 && BUILTIN_PRODUCTS[static_cast<std::size_t>(index)].name == name ? index : -1;
+}
+
+static_assert(builtinProductIndex("Water") == 0 && builtinProductIndex("Clothes") == 4, "Broken product table");
+static_assert(builtinProductIndex("water") == -1 && builtinProductIndex("") == -1, "Broken product table");
+
+/**
+ * @class ProductCatalog
+ * @brief Thread-safe catalog of the built-in products and of the ones added at runtime.
+ */
+class ProductCatalog
+{
+  public:
+    /**
+     * @brief Gets the catalog of the server.
+     * @return The process-wide catalog, with the products of ORDER_EXTRA_PRODUCTS registered.
+     */
+    static ProductCatalog& getInstance();
+
+    /**
+     * @brief Looks a product up.
+     *
+     * @param name Product name, case-sensitive.
+     * @param critical Output parameter receiving whether the product is critical.
+     * @return false if the product is not in the catalog.
+     */
+    bool find(std::string_view name, bool& critical) const;
+
+    /**
+     * @brief Adds a product, or changes whether a product added before is critical.
+     *
+     * @param name Product name.
+     * @param critical Whether the product is critical.
+     * @return false if the name is empty or a built-in product, which cannot be changed.
+     */
+    bool registerProduct(const std::string& name, bool critical);
+
+    /**
+     * @brief Registers the products listed in a "name:critical,..." string.
+     *
+     * @param list Comma-separated products; critical is 1 or 0.
+     * @return Number of products registered; malformed entries are skipped.
+     */
+    std::size_t registerProducts(const std::string& list);
+
+  private:
+    mutable std::shared_mutex mutex;             /**< Guards extra. */
+    std::unordered_map<std::string, bool> extra; /**< Products added at runtime. */
+};
+
+#endif // PRODUCT_CATALOG_HPP
@@ -0,0 +1,120 @@
+/**
+ * @file productCounters.hpp
+ * @brief Per-product order totals that worker threads update without a shared lock.
+ *
+ * Each product gets a dense numeric ID the first time it is seen, and its total
+ * is split in ORDER_STATS_SHARDS cache-line sized atomic cells. A thread always
+ * adds to the cell of its own shard, so threads ingesting orders at the same
+ * time never write the same cache line; readers merge the cells. Each thread
+ * remembers the counters it already looked up, so only the first order of a
+ * product in a thread takes the index lock.
+ */
+
+#ifndef PRODUCT_COUNTERS_HPP
+#define PRODUCT_COUNTERS_HPP
+
+#include "orderSnapshot.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+/// Number of shards of the order statistics; threads are spread over them round-robin.
+#define ORDER_STATS_SHARDS 16
+
+/**
+ * @brief Gets the shard the calling thread writes order statistics to.
+ * @return Index in [0, ORDER_STATS_SHARDS).
+ */
+std::size_t orderStatsShard();
+
+/**
+ * @class ProductCounters
+ * @brief Thread-safe sharded totals of the ordered quantity of each product.
+ */
+class ProductCounters
+{
+  public:
+    ProductCounters();
+
+    ProductCounters(const ProductCounters&) = delete;
+    ProductCounters& operator=(const ProductCounters&) = delete;
+
+    /**
+     * @brief Gets the totals of the stored orders.
+     * @return The process-wide counters.
+     */
+    static ProductCounters& getInstance();
+
+    /**
+     * @brief Adds an ordered quantity to a product.
+     *
+     * @param product Name of the product.
+     * @param quantity Quantity to add.
+     */
+    void add(const std::string& product, long long quantity);
+
+    /**
+     * @brief Merges the shards of every product.
+     * @return Total per product name; products reset by clear() are left out.
+     */
+    std::map<std::string, long long> totals() const;
+
+    /**
+     * @brief Resets every total to zero.
+     *
+     * Product IDs are kept, so concurrent writers never see a counter disappear.
+     */
+    void clear();
+
+    /**
+     * @brief Writes the totals to a snapshot.
+     * @param writer Snapshot being written.
+     */
+    void save(SnapshotWriter& writer) const;
+
+    /**
+     * @brief Adds the totals of a snapshot.
+     * @param reader Snapshot positioned where save() wrote the totals.
+     * @return false if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& reader);
+
+  private:
+    /**
+     * @struct Cell
+     * @brief One shard of a total, alone on its cache line.
+     */
+    struct alignas(64) Cell
+    {
+        std::atomic<long long> value{0}; /**< Partial total. */
+    };
+
+    /**
+     * @struct Counter
+     * @brief Sharded total of one product.
+     */
+    struct Counter
+    {
+        std::string product;                         /**< Product name. */
+        std::array<Cell, ORDER_STATS_SHARDS> shards; /**< Partial totals, one per shard. */
+
+        explicit Counter(const std::string& name) : product(name)
+        {
+        }
+    };
+
+    Counter& counterFor(const std::string& product);
+
+    const std::uint64_t instance;                     /**< Distinguishes instances in the per-thread caches. */
+    mutable std::shared_mutex mutex;                  /**< Guards ids and counters, not the totals. */
+    std::unordered_map<std::string, std::size_t> ids; /**< Product ID of each name. */
+    std::deque<Counter> counters;                     /**< Counters indexed by product ID; never moved. */
+};
+
+#endif // PRODUCT_COUNTERS_HPP
@@ -0,0 +1,98 @@
+/**
+ * @file recentOrders.hpp
+ * @brief Fixed-capacity in-memory ring of the most recent stored orders.
+ *
+ * The order journal keeps the full history on disk, within its retention
+ * limits; this ring keeps a copy of the last RECENT_ORDERS_CAPACITY orders so
+ * the newest pages of QUERY_ORDERS are served without reading segments.
+ *
+ * Order N lives in slot N modulo the capacity, each slot with its own lock, so
+ * threads storing different orders never wait for each other. A slot reuses
+ * its string when it is overwritten: after warm-up the ring allocates nothing
+ * and its memory stays at the capacity times the largest order it held.
+ */
+
+#ifndef RECENT_ORDERS_HPP
+#define RECENT_ORDERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Default number of orders kept in memory.
+#define RECENT_ORDERS_CAPACITY 4096
+
+/**
+ * @brief Reads the ring capacity from ORDER_RING_CAPACITY.
+ * @return Number of orders kept in memory, at least 1.
+ */
+std::size_t loadRecentOrdersCapacity();
+
+/**
+ * @class RecentOrders
+ * @brief Thread-safe ring of the most recent orders, indexed by journal sequence number.
+ */
+class RecentOrders
+{
+  public:
+    /**
+     * @brief Creates an empty ring.
+     * @param capacity Number of orders kept.
+     */
+    explicit RecentOrders(std::size_t capacity = RECENT_ORDERS_CAPACITY);
+
+    /**
+     * @brief Gets the ring of the stored orders.
+     * @return The process-wide ring.
+     */
+    static RecentOrders& getInstance();
+
+    /**
+     * @brief Keeps an order, replacing the one capacity() sequence numbers older.
+     *
+     * An order older than the one already in its slot is ignored.
+     *
+     * @param sequence Journal sequence number of the order.
+     * @param payload Raw order.
+     */
+    void add(std::uint64_t sequence, std::string_view payload);
+
+    /**
+     * @brief Copies an order if it is still in the ring.
+     *
+     * @param sequence Journal sequence number of the order.
+     * @param payload Output parameter receiving the raw order.
+     * @return true if the order was found.
+     */
+    bool get(std::uint64_t sequence, std::string& payload) const;
+
+    /**
+     * @brief Gets the number of orders the ring holds.
+     * @return The capacity.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief Empties every slot, keeping their memory.
+     */
+    void clear();
+
+  private:
+    /**
+     * @struct Slot
+     * @brief One order of the ring, alone on its cache line.
+     */
+    struct alignas(64) Slot
+    {
+        mutable std::mutex mutex;   /**< Guards the slot. */
+        std::uint64_t sequence = 0; /**< Sequence of the order held, 0 if empty. */
+        std::string payload;        /**< Raw order. */
+    };
+
+    std::vector<Slot> slots; /**< Slot of order N is N modulo the capacity. */
+};
+
+#endif // RECENT_ORDERS_HPP
@@ -0,0 +1,158 @@
+/**
+ * @file responseChunks.hpp
+ * @brief Chunked delivery of responses larger than one client read.
+ *
+ * Reports such as SHOW_REPORT or LIST_CLIENTS grow with the data they cover,
+ * but a client reads at most BUFFER_SIZE_CLIENT bytes at a time and a UDP
+ * datagram cannot carry more than about 64 KiB. A response longer than
+ * RESPONSE_CHUNK_SIZE is therefore split into chunks, each sent as one frame:
+ *
+ *     @CHUNK <stream> <index> <count> <length> <cursor>\n<payload>
+ *
+ * where payload is exactly length bytes. Over TCP every frame is written at
+ * once. Over UDP the server sends RESPONSE_CHUNK_WINDOW frames and the last
+ * one carries a cursor "<stream>:<index>"; the client asks for the next
+ * frames with
+ *
+ *     CONTINUE <stream>:<index>
+ *
+ * Every other frame carries "-" as cursor. A client that missed a datagram
+ * sends the same command with the first index it lacks. Streams are kept
+ * for RESPONSE_STREAM_TTL_SECONDS after their last request.
+ */
+
+#ifndef RESPONSE_CHUNKS_HPP
+#define RESPONSE_CHUNKS_HPP
+
+#include "errorHandler.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Name of the command requesting the next frames of a chunked response.
+#define CONTINUE_COMMAND "CONTINUE"
+
+/// Error code for an unknown, expired or malformed CONTINUE cursor.
+#define ERR_INVALID_CURSOR 1013
+
+/// First bytes of every chunk frame.
+#define CHUNK_FRAME_PREFIX "@CHUNK"
+
+/// Largest payload of a frame; with its header a frame fits one Ethernet MTU.
+#define RESPONSE_CHUNK_SIZE 1400
+
+/// Frames sent over UDP before the server waits for a CONTINUE.
+#define RESPONSE_CHUNK_WINDOW 16
+
+/// Seconds a UDP stream is kept after its last request.
+#define RESPONSE_STREAM_TTL_SECONDS 60
+
+/// Largest number of UDP streams kept; the oldest one is dropped first.
+#define RESPONSE_STREAMS_MAX 64
+
+/**
+ * @brief Splits a response into chunks.
+ *
+ * @param response The full response.
+ * @param chunkSize Largest chunk, in bytes.
+ * @return The chunks, in order; one empty chunk for an empty response.
+ */
+std::vector<std::string> splitResponse(const std::string& response, std::size_t chunkSize = RESPONSE_CHUNK_SIZE);
+
+/**
+ * @brief Builds one chunk frame.
+ *
+ * @param stream ID of the response.
+ * @param index Position of the chunk, from 0.
+ * @param count Number of chunks of the response.
+ * @param payload The chunk.
+ * @param cursor Cursor of the next frames, "-" if the client must not ask for them.
+ * @return The frame.
+ */
+std::string formatChunkFrame(std::uint64_t stream, std::size_t index, std::size_t count, const std::string& payload,
+                             const std::string& cursor = "-");
+
+/**
+ * @class ResponseStreams
+ * @brief Thread-safe chunked responses waiting for CONTINUE commands.
+ */
+class ResponseStreams
+{
+  public:
+    /**
+     * @brief Creates an empty set of streams.
+     * @param ttl Time a stream is kept after its last request.
+     */
+    explicit ResponseStreams(std::chrono::seconds ttl = std::chrono::seconds(RESPONSE_STREAM_TTL_SECONDS));
+
+    /**
+     * @brief Gets the streams of the server.
+     * @return The process-wide streams.
+     */
+    static ResponseStreams& getInstance();
+
+    /**
+     * @brief Gets the messages that start sending a response.
+     *
+     * A response of at most RESPONSE_CHUNK_SIZE bytes is returned as is. A
+     * longer one is split into frames; with a window the stream is kept so
+     * the client can ask for the rest.
+     *
+     * @param clientId ID of the client receiving the response.
+     * @param protocol Protocol used by the client.
+     * @param response The full response.
+     * @param window Frames returned now; 0 returns every frame and keeps nothing.
+     * @return The messages to send, in order.
+     */
+    std::vector<std::string> start(int clientId, const std::string& protocol, const std::string& response,
+                                   std::size_t window);
+
+    /**
+     * @brief Gets the frames requested by a CONTINUE command.
+     *
+     * @param clientId ID of the client sending the command; must own the stream.
+     * @param protocol Protocol used by the client.
+     * @param command The raw CONTINUE command.
+     * @param window Largest number of frames returned.
+     * @param frames Output parameter receiving the frames, in order.
+     * @param error Output parameter receiving a JSON error when the cursor is not valid.
+     * @return true if the cursor is valid, false otherwise.
+     */
+    bool resume(int clientId, const std::string& protocol, const std::string& command, std::size_t window,
+                std::vector<std::string>& frames, std::string& error);
+
+    /**
+     * @brief Gets the number of streams kept.
+     * @return Stream count, expired ones included until the next call to start() or resume().
+     */
+    std::size_t pending() const;
+
+  private:
+    /**
+     * @struct Stream
+     * @brief Chunks of one response sent over UDP.
+     */
+    struct Stream
+    {
+        int clientId;                                  /**< Client receiving the response. */
+        std::string protocol;                          /**< Protocol used by the client. */
+        std::vector<std::string> chunks;               /**< Every chunk of the response. */
+        std::chrono::steady_clock::time_point expires; /**< Moment the stream is dropped. */
+    };
+
+    static std::vector<std::string> framesOf(std::uint64_t id, const Stream& stream, std::size_t from,
+                                             std::size_t window);
+
+    void expireLocked(std::chrono::steady_clock::time_point now);
+
+    const std::chrono::seconds ttl;          /**< Time a stream is kept after its last request. */
+    mutable std::mutex mutex;                /**< Guards streams and nextStream. */
+    std::map<std::uint64_t, Stream> streams; /**< Kept streams by ID, oldest first. */
+    std::uint64_t nextStream = 1;            /**< ID of the next response. */
+};
+
+#endif // RESPONSE_CHUNKS_HPP
@@ -0,0 +1,65 @@
+/**
+ * @file stockQuery.hpp
+ * @brief Parsing and formatting of the GET_STOCK command.
+ *
+ * The command reads stock for many locations and products at once:
+ *
+ *     GET_STOCK [type=hub|warehouse] [location=1,2,...] [product=Name]
+ *
+ * Every filter is optional; without filters the whole inventory is returned.
+ * A value with spaces is written between double quotes: product="Canned Food".
+ */
+
+#ifndef STOCK_QUERY_HPP
+#define STOCK_QUERY_HPP
+
+#include "errorHandler.hpp"
+#include "inventoryCache.hpp"
+#include <string>
+#include <vector>
+
+/// Name of the bulk stock query command.
+#define GET_STOCK_COMMAND "GET_STOCK"
+
+/// Error code for a malformed GET_STOCK command.
+#define ERR_INVALID_STOCK_QUERY 1010
+
+/**
+ * @struct StockQuery
+ * @brief Filters of a GET_STOCK command.
+ */
+struct StockQuery
+{
+    std::vector<LocationType> types; /**< Location types to read (both when not filtered). */
+    std::vector<int> locations;      /**< Location IDs to read (every location when empty). */
+    std::string product;             /**< Product name, compared case-insensitively (any when empty). */
+};
+
+/**
+ * @brief Parses a GET_STOCK command.
+ *
+ * @param command The raw command received from the client.
+ * @param query Output parameter receiving the filters.
+ * @param error Output parameter receiving a JSON error when the command is malformed.
+ * @return true if the command is valid, false otherwise.
+ */
+bool parseStockQuery(const std::string& command, StockQuery& query, std::string& error);
+
+/**
+ * @brief Tells whether a stock row passes the product filter of a query.
+ *
+ * @param query Parsed filters.
+ * @param level Stock row.
+ * @return true if the row must be included in the response.
+ */
+bool matchesStockQuery(const StockQuery& query, const StockLevel& level);
+
+/**
+ * @brief Builds the GET_STOCK response, sorted by location type, location and product.
+ *
+ * @param levels Stock rows to report.
+ * @return The report sent to the client.
+ */
+std::string formatStockReport(std::vector<StockLevel> levels);
+
+#endif // STOCK_QUERY_HPP
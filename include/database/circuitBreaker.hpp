@@ -0,0 +1,137 @@
+/**
+ * @file circuitBreaker.hpp
+ * @brief Circuit breaker guarding the inventory database.
+ *
+ * The breaker watches the outcome and latency of the last database calls.
+ * When too many of them fail or are too slow it opens: database calls fail
+ * fast instead of blocking until the connector gives up, stock reads are
+ * answered from the last known levels in the inventory cache, and orders are
+ * told to retry later. After a cool-down a single probe call is let through
+ * (half-open); if it succeeds the breaker closes again.
+ */
+
+#ifndef CIRCUIT_BREAKER_HPP
+#define CIRCUIT_BREAKER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/// Number of recent calls the error rate is computed over.
+#define BREAKER_WINDOW 20
+/// Minimum number of calls in the window before the breaker may open.
+#define BREAKER_MIN_CALLS 5
+/// Percentage of failed or slow calls that opens the breaker.
+#define BREAKER_ERROR_RATE 50
+/// Latency, in milliseconds, above which a successful call counts as failed.
+#define BREAKER_SLOW_CALL_MS 1000
+/// Time, in milliseconds, the breaker stays open before letting a probe through.
+#define BREAKER_OPEN_MS 5000
+
+/**
+ * @enum BreakerState
+ * @brief State of a circuit breaker.
+ */
+enum class BreakerState
+{
+    CLOSED,   /**< Calls go through; outcomes are recorded. */
+    OPEN,     /**< Calls fail fast until the cool-down elapses. */
+    HALF_OPEN /**< A single probe call is in flight. */
+};
+
+/**
+ * @struct CircuitBreakerConfig
+ * @brief Thresholds of a circuit breaker.
+ */
+struct CircuitBreakerConfig
+{
+    std::size_t window = BREAKER_WINDOW;       /**< Calls in the sliding window. */
+    std::size_t minCalls = BREAKER_MIN_CALLS;  /**< Calls needed before opening. */
+    int errorRatePercent = BREAKER_ERROR_RATE; /**< Failure percentage that opens the breaker. */
+    int slowCallMs = BREAKER_SLOW_CALL_MS;     /**< Latency counted as a failure. */
+    int openMs = BREAKER_OPEN_MS;              /**< Cool-down before a probe. */
+};
+
+/**
+ * @class CircuitBreaker
+ * @brief Thread-safe closed / open / half-open state machine.
+ */
+class CircuitBreaker
+{
+  public:
+    /**
+     * @brief Creates a closed breaker.
+     * @param config Thresholds.
+     */
+    explicit CircuitBreaker(const CircuitBreakerConfig& config = CircuitBreakerConfig());
+
+    /**
+     * @brief Gets the breaker guarding the inventory database.
+     * @return The process-wide inventory breaker.
+     */
+    static CircuitBreaker& getInstance();
+
+    /**
+     * @brief Asks whether a call may reach the database.
+     *
+     * Every call allowed through must be followed by recordSuccess() or recordFailure().
+     *
+     * @return true if the call may proceed, false if it must fail fast.
+     */
+    bool allowRequest();
+
+    /**
+     * @brief Tells whether allowRequest() would let a call through, without taking the probe slot.
+     *
+     * Callers in front of the database (e.g. the order path) use it to fail fast while
+     * leaving the probe to the database call itself.
+     *
+     * @return true if the breaker is closed or its cool-down elapsed, false otherwise.
+     */
+    bool wouldAllowRequest() const;
+
+    /**
+     * @brief Records a call that completed.
+     * @param latency Duration of the call; slow calls count as failures.
+     */
+    void recordSuccess(std::chrono::milliseconds latency);
+
+    /**
+     * @brief Records a call that failed.
+     */
+    void recordFailure();
+
+    /**
+     * @brief Gets the current state.
+     *
+     * An open breaker whose cool-down elapsed is still reported as OPEN until a probe is allowed.
+     *
+     * @return The breaker state.
+     */
+    BreakerState getState() const;
+
+    /**
+     * @brief Closes the breaker and forgets the recorded calls.
+     */
+    void reset();
+
+    /**
+     * @brief Replaces the thresholds and closes the breaker.
+     * @param config New thresholds.
+     */
+    void configure(const CircuitBreakerConfig& config);
+
+  private:
+    void record(bool failed);
+    void open();
+
+    mutable std::mutex mutex;                       /**< Guards the fields below. */
+    CircuitBreakerConfig config;                    /**< Thresholds. */
+    BreakerState state = BreakerState::CLOSED;      /**< Current state. */
+    std::deque<bool> outcomes;                      /**< Recent calls, true when failed. */
+    std::size_t failures = 0;                       /**< Failed calls in outcomes. */
+    std::chrono::steady_clock::time_point openedAt; /**< When the breaker last opened. */
+};
+
+#endif // CIRCUIT_BREAKER_HPP
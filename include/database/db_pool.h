@@ -0,0 +1,91 @@
+/**
+ * @file db_pool.h
+ * @brief Connection pool for the client's user database.
+ *
+ * Logins and user management borrow an open connection from the pool instead of
+ * connecting to MySQL on every call. Each pooled connection prepares its user
+ * statements once, the first time they are needed, and keeps them until the
+ * connection is closed.
+ */
+
+#ifndef DB_POOL_H
+#define DB_POOL_H
+
+#include "user_db.h"
+#include <mysql.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#define DB_POOL_SIZE 4 /**< Default maximum number of pooled connections. */
+
+/**
+ * @enum DbStatement
+ * @brief Statements prepared on every pooled connection.
+ */
+typedef enum
+{
+    DB_STMT_LOGIN,       /**< SELECT name, password, role FROM user WHERE email = ? */
+    DB_STMT_INSERT_USER, /**< INSERT INTO user (name, password, email, role) VALUES (?, ?, ?, ?) */
+    DB_STMT_DELETE_USER, /**< DELETE FROM user WHERE email = ? */
+    DB_STMT_LIST_USERS,  /**< SELECT name, email, role FROM user */
+    DB_STMT_COUNT        /**< Number of statements, not a statement. */
+} DbStatement;
+
+/**
+ * @struct DbConnection
+ * @brief Pooled MySQL connection with its prepared statements.
+ */
+typedef struct
+{
+    MYSQL* conn;                        /**< Open connection, or NULL if it must be reopened. */
+    MYSQL_STMT* stmts[DB_STMT_COUNT];   /**< Prepared statements, NULL until first used. */
+    bool inUse;                         /**< Whether a caller currently holds the connection. */
+} DbConnection;
+
+/**
+ * @brief Reads the pool size from the environment.
+ *
+ * DB_POOL_SIZE overrides the default; values below 1 are ignored.
+ *
+ * @return Maximum number of pooled connections.
+ */
+int loadDbPoolSize(void);
+
+/**
+ * @brief Borrows a connection from the pool.
+ *
+ * Connections are opened lazily, up to the pool size. When every connection is
+ * busy the caller waits until one is released.
+ *
+ * @return The connection, or NULL if a new connection could not be opened.
+ */
+DbConnection* acquireDbConnection(void);
+
+/**
+ * @brief Returns a connection to the pool.
+ *
+ * Pending results of its statements are discarded. A connection released as
+ * broken is closed and reopened by the next caller that needs it.
+ *
+ * @param connection Connection obtained from acquireDbConnection().
+ * @param broken true if a query failed and the connection should not be reused.
+ */
+void releaseDbConnection(DbConnection* connection, bool broken);
+
+/**
+ * @brief Gets one of the connection's statements, preparing it on first use.
+ *
+ * @param connection Borrowed connection.
+ * @param statement Statement to get.
+ * @return The prepared statement, or NULL if it could not be prepared.
+ */
+MYSQL_STMT* getDbStatement(DbConnection* connection, DbStatement statement);
+
+/**
+ * @brief Closes every idle connection of the pool.
+ *
+ * Registered with atexit() when the pool is first used.
+ */
+void closeDbPool(void);
+
+#endif /* DB_POOL_H */
@@ -0,0 +1,126 @@
+/**
+ * @file embeddedInventoryStore.hpp
+ * @brief In-process inventory engine for deployments without a MySQL server.
+ *
+ * Stock lives in memory and every order is applied as one transaction: either
+ * both sides of a transfer change or none does. When a data file is opened,
+ * each change is appended to it as a single line and synced to disk before it
+ * is applied, so a crash can at most lose the line being written, which is
+ * ignored on the next start. Opening the file replays it and rewrites it
+ * compacted, one line per row.
+ *
+ * A store without rows is seeded with the locations and products of
+ * database/database.sql, so the server never starts with an empty inventory.
+ *
+ * Data file lines (the product name is last and may contain spaces):
+ * - `set <type> <location> <quantity> <product>`
+ * - `add <type> <location> <delta> <product>`
+ * - `move <source type> <source location> <destination type> <destination location> <quantity> <product>`
+ */
+
+#ifndef EMBEDDED_INVENTORY_STORE_HPP
+#define EMBEDDED_INVENTORY_STORE_HPP
+
+#include "inventoryStore.hpp"
+#include <cstddef>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// Hubs and warehouses created by seed(), numbered from 1 as in database/database.sql.
+#define EMBEDDED_SEED_LOCATIONS 3
+
+/**
+ * @class EmbeddedInventoryStore
+ * @brief Thread-safe, optionally persistent, in-memory InventoryStore.
+ */
+class EmbeddedInventoryStore : public InventoryStore
+{
+  public:
+    EmbeddedInventoryStore() = default;
+
+    ~EmbeddedInventoryStore() override;
+
+    EmbeddedInventoryStore(const EmbeddedInventoryStore&) = delete;
+    EmbeddedInventoryStore& operator=(const EmbeddedInventoryStore&) = delete;
+
+    /**
+     * @brief Loads the rows of a data file and persists every later change to it.
+     *
+     * A missing file is created empty.
+     *
+     * @param path Data file.
+     * @return true if the file was loaded and can be written, false otherwise.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Creates a row or overwrites its quantity.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param quantity Available quantity.
+     * @return true if the row was stored, false if the quantity is negative or it could not be persisted.
+     */
+    bool put(LocationType type, int locationId, const std::string& product, int quantity);
+
+    /**
+     * @brief Fills an empty store with the rows of database/database.sql.
+     *
+     * Every hub and warehouse up to EMBEDDED_SEED_LOCATIONS gets the five bundled
+     * products with no stock, like a freshly created MySQL inventory.
+     *
+     * @return Number of rows created; 0 if the store already had rows or a row could not be persisted.
+     */
+    std::size_t seed();
+
+    /**
+     * @brief Gets the number of stored rows.
+     * @return Number of (location, product) rows.
+     */
+    std::size_t size() const;
+
+    int getQuantity(LocationType type, int locationId, const std::string& product) override;
+
+    int addQuantity(LocationType type, int locationId, const std::string& product, int delta) override;
+
+    int raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity) override;
+
+    int transfer(const InventoryTransfer& transfer) override;
+
+    int getSnapshot(LocationType type, const std::vector<int>& locationIds, std::vector<StockLevel>& levels) override;
+
+  private:
+    /**
+     * @brief Row key: location type, location ID and lower-cased product name.
+     */
+    using Key = std::tuple<LocationType, int, std::string>;
+
+    /**
+     * @struct Entry
+     * @brief Stored row: available quantity plus the product name with its original casing.
+     */
+    struct Entry
+    {
+        int quantity;            /**< Available quantity. */
+        std::string productName; /**< Product name as first stored. */
+    };
+
+    static Key makeKey(LocationType type, int locationId, const std::string& product);
+
+    bool replay(const std::string& line);
+
+    bool compact();
+
+    bool append(const std::string& line);
+
+    mutable std::shared_mutex mutex; /**< Guards rows and the data file. */
+    std::map<Key, Entry> rows;       /**< Inventory rows. */
+    std::string path;                /**< Data file, empty when kept in memory only. */
+    int fd = -1;                     /**< Data file opened for appending, or -1. */
+};
+
+#endif // EMBEDDED_INVENTORY_STORE_HPP
@@ -0,0 +1,185 @@
+/**
+ * @file inventoryCache.hpp
+ * @brief In-process, write-through cache of the hub and warehouse inventory.
+ *
+ * The whole `hubs` and `warehouses` dataset is small enough to live in memory.
+ * The cache is warmed once at startup from MySQL and kept current by the
+ * inventory update functions, which apply every successful update to it
+ * (write-through). Once warm, it is authoritative: stock reads are answered
+ * from memory and never reach the database.
+ */
+
+#ifndef INVENTORY_CACHE_HPP
+#define INVENTORY_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @enum LocationType
+ * @brief Kind of storage location an inventory row belongs to.
+ */
+enum class LocationType
+{
+    HUB,      /**< Row of the `hubs` table. */
+    WAREHOUSE /**< Row of the `warehouses` table. */
+};
+
+/**
+ * @brief Parses the location type used in the order JSON ("hub" / "warehouse").
+ *
+ * @param name Location type as it appears in the order.
+ * @param type Output parameter receiving the parsed type.
+ * @return true if the name is a known location type, false otherwise.
+ */
+bool parseLocationType(const std::string& name, LocationType& type);
+
+/**
+ * @brief Gets the name of a location type as used in the order JSON.
+ *
+ * @param type Location type.
+ * @return "hub" or "warehouse".
+ */
+std::string locationTypeName(LocationType type);
+
+/**
+ * @struct StockLevel
+ * @brief Available quantity of one product at one location.
+ */
+struct StockLevel
+{
+    LocationType type;   /**< Location type. */
+    int locationId;      /**< ID of the hub or warehouse. */
+    std::string product; /**< Name of the product. */
+    int quantity;        /**< Available quantity. */
+};
+
+/**
+ * @class InventoryCache
+ * @brief Thread-safe map of (location type, location ID, product) to available quantity.
+ *
+ * Product names are compared case-insensitively, like the database collation does.
+ * Reads take a shared lock, so concurrent stock checks never serialize on each other.
+ */
+class InventoryCache
+{
+  public:
+    /**
+     * @brief Gets the process-wide cache instance.
+     * @return The single InventoryCache instance.
+     */
+    static InventoryCache& getInstance();
+
+    /**
+     * @brief Stores the absolute quantity of a product at a location.
+     *
+     * Used while warming the cache from the database.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param quantity Available quantity.
+     */
+    void load(LocationType type, int locationId, const std::string& product, int quantity);
+
+    /**
+     * @brief Marks the cache as warm, making it the authoritative source for reads.
+     */
+    void markWarm();
+
+    /**
+     * @brief Tells whether the cache has been warmed from the database.
+     * @return true if reads can be served from the cache.
+     */
+    bool isWarm() const;
+
+    /**
+     * @brief Looks up the available quantity of a product at a location.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param quantity Output parameter receiving the available quantity.
+     * @return true if the row exists, false otherwise.
+     */
+    bool get(LocationType type, int locationId, const std::string& product, int& quantity) const;
+
+    /**
+     * @brief Applies a quantity delta to a cached row (write-through).
+     *
+     * The delta is rejected if the row is unknown or if the resulting quantity
+     * would be negative, mirroring the guard in the update stored procedures.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param delta Quantity to add (negative to subtract).
+     * @return true if the delta was applied, false otherwise.
+     */
+    bool applyDelta(LocationType type, int locationId, const std::string& product, int delta);
+
+    /**
+     * @brief Calls a visitor for every cached row, under a shared lock.
+     *
+     * @param visitor Function receiving type, location ID, product name and quantity.
+     */
+    void forEach(const std::function<void(LocationType, int, const std::string&, int)>& visitor) const;
+
+    /**
+     * @brief Gets the number of cached rows.
+     * @return Number of (location, product) rows in the cache.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Drops every row and marks the cache as cold.
+     */
+    void clear();
+
+  private:
+    /**
+     * @struct Key
+     * @brief Cache key: location type, location ID and lower-cased product name.
+     */
+    struct Key
+    {
+        LocationType type;   /**< Location type. */
+        int locationId;      /**< ID of the hub or warehouse. */
+        std::string product; /**< Lower-cased product name. */
+
+        bool operator==(const Key& other) const;
+    };
+
+    /**
+     * @struct KeyHash
+     * @brief Hash functor for Key.
+     */
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /**
+     * @struct Entry
+     * @brief Cached row: available quantity plus the product name as stored in the database.
+     */
+    struct Entry
+    {
+        int quantity;            /**< Available quantity. */
+        std::string productName; /**< Product name with its original casing. */
+    };
+
+    InventoryCache() = default;
+
+    static Key makeKey(LocationType type, int locationId, const std::string& product);
+
+    mutable std::shared_mutex mutex;                /**< Guards levels. */
+    std::unordered_map<Key, Entry, KeyHash> levels; /**< Cached inventory rows. */
+    std::atomic<bool> warm{false};                  /**< Whether the cache is authoritative. */
+};
+
+#endif // INVENTORY_CACHE_HPP
@@ -1,6 +1,14 @@
 #ifndef INVENTORY_DB_HPP
 #define INVENTORY_DB_HPP
 
+#include "circuitBreaker.hpp"
+#include "inventoryCache.hpp"
+#include "inventoryExecutor.hpp"
+#include "inventoryStatements.hpp"
+#include "inventoryStore.hpp"
+#include "inventoryWriteBehind.hpp"
+#include <functional>
+#include <future>
 #include <iostream>
 #include <json/json.h>
 #include <mysqlx/xdevapi.h>
@@ -17,6 +25,10 @@
  * This file contains declarations of functions that allow establishing a
  * connection to the MySQL database, as well as retrieving and updating product
  * stock in hubs and warehouses.
+ *
+ * Database calls go through the inventory CircuitBreaker. While it is open,
+ * updates fail fast with -1 and reads return the last level read from the
+ * database (degraded read-only mode).
  */
 
 /**
@@ -26,9 +38,34 @@
  */
 mysqlx::Session connectToDb();
 
+/**
+ * @brief Resolves a product name to its integer ID.
+ *
+ * Inventory rows are keyed by (location ID, product ID). Names are resolved once
+ * and memoized; the cache warm-up pre-populates every known product.
+ *
+ * @param session Active MySQL session.
+ * @param product Name of the product (case-insensitive).
+ * @return int Product ID, or -1 if the product is unknown.
+ */
+int resolveProductId(mysqlx::Session& session, const std::string& product);
+
+/**
+ * @brief Warms the in-process inventory cache with every hub and warehouse row.
+ *
+ * Once the cache is warm, the get functions below are answered from memory and
+ * the update functions write through to it after the database accepts them.
+ *
+ * @param session Active MySQL session.
+ * @return int Number of rows loaded, or -1 on error (the cache stays cold).
+ */
+int loadInventoryCache(mysqlx::Session& session);
+
 /**
  * @brief Retrieves the available quantity of a product in a warehouse.
  *
+ * Served from the inventory cache when it is warm.
+ *
  * @param session Active MySQL session.
  * @param warehouseId ID of the warehouse.
  * @param product Name of the product.
@@ -50,6 +87,8 @@ int updateWarehouseInventory(mysqlx::Session& session, int warehouseId, const st
 /**
  * @brief Retrieves the available quantity of a product in a hub.
  *
+ * Served from the inventory cache when it is warm.
+ *
  * @param session Active MySQL session.
  * @param hubId ID of the hub.
  * @param product Name of the product.
@@ -68,15 +107,133 @@ int getHubInventory(mysqlx::Session& session, int hubId, const std::string& prod
  */
 int updateHubInventory(mysqlx::Session& session, int hubId, const std::string& product, int quantity);
 
+/**
+ * @brief Reads every product row of a set of locations in a single query.
+ *
+ * Served from the inventory cache when it is warm. Rows are appended to
+ * @p levels.
+ *
+ * @param session Active MySQL session.
+ * @param type Location type.
+ * @param locationIds IDs of the hubs or warehouses; empty means every location.
+ * @param levels Output vector receiving the rows.
+ * @return int Number of rows appended, or -1 on error.
+ */
+int getInventorySnapshot(mysqlx::Session& session, LocationType type, const std::vector<int>& locationIds,
+                         std::vector<StockLevel>& levels);
+
+/**
+ * @brief Commits a merged batch of inventory deltas in a single transaction.
+ *
+ * Used by the write-behind flusher. The deltas are not applied to the inventory
+ * cache, which already holds them. If any row cannot be updated the whole
+ * transaction is rolled back.
+ *
+ * @param session Active MySQL session.
+ * @param deltas Merged deltas to commit.
+ * @return int 1 if every delta was committed, 0 if a row was rejected (unknown
+ *         product or location), -1 if the database could not be reached.
+ */
+int commitInventoryDeltas(mysqlx::Session& session, const std::vector<InventoryDelta>& deltas);
+
 /**
  * @brief Updates source and destination inventories based on a transaction.
  *
+ * When write-behind mode is running, the deltas go to the in-memory ledger
+ * and are committed later as part of a group commit.
+ *
+ * Otherwise the source is debited first and the destination is only credited
+ * once the debit succeeded; a failed credit is compensated.
+ *
  * @param session Active MySQL session.
  * @param request JSON with transaction details.
- * @return int 1 if success, 0 on failure.
+ * @return int 1 if success, 0/-1 on failure, TRANSFER_COMPENSATION_FAILED if
+ *         the source kept the debit of a failed transfer.
  */
 int realTimeUpdate(mysqlx::Session& session, const Json::Value& request);
 
+/**
+ * @class MySqlInventoryStore
+ * @brief InventoryStore backed by the MySQL functions above.
+ *
+ * Wraps a session it does not own, so it is cheap to create for every task
+ * a database worker runs.
+ */
+class MySqlInventoryStore : public InventoryStore
+{
+  public:
+    /**
+     * @brief Creates a store on top of an open session.
+     * @param session Active MySQL session; must outlive the store.
+     */
+    explicit MySqlInventoryStore(mysqlx::Session& session);
+
+    int getQuantity(LocationType type, int locationId, const std::string& product) override;
+
+    int addQuantity(LocationType type, int locationId, const std::string& product, int delta) override;
+
+    int raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity) override;
+
+    int transfer(const InventoryTransfer& transfer) override;
+
+    int getSnapshot(LocationType type, const std::vector<int>& locationIds, std::vector<StockLevel>& levels) override;
+
+  private:
+    mysqlx::Session& session; /**< Session every call runs on. */
+};
+
+/**
+ * @brief Completion callback of an asynchronous inventory update.
+ *
+ * Runs on the database worker that finished the update; the session is that
+ * worker's, so follow-up queries can be issued without another hop.
+ */
+using InventoryCallback = std::function<void(int result, mysqlx::Session& session)>;
+
+/**
+ * @brief Retrieves the available quantity of a product in a warehouse without blocking.
+ *
+ * Answered immediately from the inventory cache when it is warm, otherwise on a database worker.
+ *
+ * @param warehouseId ID of the warehouse.
+ * @param product Name of the product.
+ * @return Future receiving the quantity available or -1 on error.
+ */
+std::future<int> getWarehouseInventoryAsync(int warehouseId, const std::string& product);
+
+/**
+ * @brief Retrieves the available quantity of a product in a hub without blocking.
+ *
+ * Answered immediately from the inventory cache when it is warm, otherwise on a database worker.
+ *
+ * @param hubId ID of the hub.
+ * @param product Name of the product.
+ * @return Future receiving the quantity available or -1 on error.
+ */
+std::future<int> getHubInventoryAsync(int hubId, const std::string& product);
+
+/**
+ * @brief Updates source and destination inventories on the database workers.
+ *
+ * The source is debited first and the destination is only credited once the
+ * debit succeeded. If the credit fails the debit is compensated, so a failed
+ * transfer leaves both rows unchanged; when the compensation fails too the
+ * result is TRANSFER_COMPENSATION_FAILED.
+ *
+ * @param request JSON with transaction details.
+ * @param onComplete Called with 1 on success, 0/-1 or TRANSFER_COMPENSATION_FAILED on failure.
+ * @return true if the update was queued, false if the executor is not running (onComplete is not called).
+ */
+bool realTimeUpdateAsync(const Json::Value& request, InventoryCallback onComplete);
+
+/**
+ * @brief Future-returning variant of realTimeUpdateAsync().
+ *
+ * @param request JSON with transaction details.
+ * @return Future receiving 1 on success, 0/-1 on failure (-1 if the executor is not running).
+ */
+std::future<int> realTimeUpdateAsync(const Json::Value& request);
+
 /**
  * @brief Displays the inventory menu.
  */
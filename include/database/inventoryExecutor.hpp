@@ -0,0 +1,133 @@
+/**
+ * @file inventoryExecutor.hpp
+ * @brief Dedicated thread group that runs inventory queries off the network threads.
+ *
+ * Every worker owns its own MySQL session, so queries submitted from the UDP and
+ * TCP handlers never block them, and independent queries (e.g. the stock reads
+ * of different orders) can run in parallel on different workers.
+ * Worker sessions are attached to the InventoryStatements cache.
+ */
+
+#ifndef INVENTORY_EXECUTOR_HPP
+#define INVENTORY_EXECUTOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <mysqlx/xdevapi.h>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// Default number of database worker threads.
+#define DB_THREADS 4
+
+/**
+ * @brief Reads the number of database worker threads from the environment.
+ *
+ * DB_THREADS overrides the default; values below 1 are ignored.
+ *
+ * @return Number of worker threads to start.
+ */
+int loadDbThreads();
+
+/**
+ * @class InventoryExecutor
+ * @brief Fixed-size pool of database workers fed by a FIFO task queue.
+ */
+class InventoryExecutor
+{
+  public:
+    /**
+     * @brief Unit of work; receives the session of the worker running it.
+     */
+    using Task = std::function<void(mysqlx::Session&)>;
+
+    /**
+     * @brief Opens a new MySQL session for a worker.
+     */
+    using SessionFactory = std::function<mysqlx::Session()>;
+
+    /**
+     * @brief Gets the process-wide executor instance.
+     * @return The single InventoryExecutor instance.
+     */
+    static InventoryExecutor& getInstance();
+
+    /**
+     * @brief Opens one session per worker and starts the workers.
+     *
+     * @param threads Number of workers.
+     * @param sessionFactory Function that opens a worker session.
+     * @return true if the workers were started, false if already running or a session could not be opened.
+     */
+    bool start(int threads, SessionFactory sessionFactory);
+
+    /**
+     * @brief Runs the tasks already queued and stops the workers.
+     */
+    void stop();
+
+    /**
+     * @brief Tells whether the workers are accepting tasks.
+     * @return true if the executor is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Queues a task without waiting for it.
+     *
+     * @param task Task to run on a worker.
+     * @return true if the task was queued, false if the executor is not running.
+     */
+    bool post(Task task);
+
+    /**
+     * @brief Queues a task and returns a future with its result.
+     *
+     * If the executor is not running the future holds a std::runtime_error.
+     *
+     * @param function Callable taking a mysqlx::Session&.
+     * @return Future receiving the value returned by the callable.
+     */
+    template <typename Function>
+    std::future<std::invoke_result_t<Function, mysqlx::Session&>> submit(Function&& function)
+    {
+        using Result = std::invoke_result_t<Function, mysqlx::Session&>;
+        auto task = std::make_shared<std::packaged_task<Result(mysqlx::Session&)>>(std::forward<Function>(function));
+        std::future<Result> future = task->get_future();
+        if (!post([task](mysqlx::Session& session) { (*task)(session); }))
+        {
+            std::promise<Result> rejected;
+            rejected.set_exception(std::make_exception_ptr(std::runtime_error("Inventory executor is not running")));
+            return rejected.get_future();
+        }
+        return future;
+    }
+
+    /**
+     * @brief Gets the number of tasks waiting for a worker.
+     * @return Queue length.
+     */
+    std::size_t queueSize() const;
+
+  private:
+    InventoryExecutor() = default;
+
+    void workerLoop(mysqlx::Session& session);
+
+    mutable std::mutex mutex;                               /**< Guards tasks. */
+    std::condition_variable taskAvailable;                  /**< Wakes idle workers. */
+    std::deque<Task> tasks;                                 /**< Tasks waiting for a worker. */
+    std::atomic<bool> running{false};                       /**< Whether tasks are accepted. */
+    std::vector<std::unique_ptr<mysqlx::Session>> sessions; /**< One session per worker. */
+    std::vector<std::thread> workers;                       /**< Worker threads. */
+};
+
+#endif // INVENTORY_EXECUTOR_HPP
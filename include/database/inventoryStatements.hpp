@@ -0,0 +1,97 @@
+/**
+ * @file inventoryStatements.hpp
+ * @brief Per-session cache of reusable inventory statements.
+ *
+ * Statements sent with session.sql() are plain text that MySQL parses on every
+ * call. X Protocol CRUD statements, on the other hand, are prepared server-side
+ * the second time the same statement object is executed, and from then on only
+ * the bound values travel. Long-lived sessions (the inventory executor workers
+ * and the write-behind flusher) are attached to this cache, so each of them
+ * builds the hot-path statements once and afterwards only re-binds them.
+ */
+
+#ifndef INVENTORY_STATEMENTS_HPP
+#define INVENTORY_STATEMENTS_HPP
+
+#include "inventoryCache.hpp"
+#include <cstdint>
+#include <memory>
+#include <mysqlx/xdevapi.h>
+
+/// Schema holding the inventory tables.
+#define INVENTORY_SCHEMA "manage_system"
+
+/**
+ * @class InventoryStatements
+ * @brief Select and update statements on `hubs` and `warehouses` owned by one session.
+ *
+ * The statements use the same (location ID, product ID) primary key lookup as
+ * the `...ById` stored procedures. An instance must only be used by the thread
+ * that owns its session.
+ */
+class InventoryStatements
+{
+  public:
+    /**
+     * @brief Gives a long-lived session its own statement cache.
+     * @param session Session that will reuse the statements.
+     */
+    static void attach(mysqlx::Session& session);
+
+    /**
+     * @brief Drops the statement cache of a session; must be called before the session is destroyed.
+     * @param session Previously attached session.
+     */
+    static void detach(mysqlx::Session& session);
+
+    /**
+     * @brief Gets the statement cache of a session.
+     * @param session Session to look up.
+     * @return The cache, or nullptr if the session is not attached.
+     */
+    static InventoryStatements* forSession(mysqlx::Session& session);
+
+    /**
+     * @brief Reads the available quantity of a product at a location.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param productId ID of the product.
+     * @return Available quantity, or -1 if the row does not exist.
+     * @throws mysqlx::Error on database errors.
+     */
+    int selectQuantity(LocationType type, int locationId, int productId);
+
+    /**
+     * @brief Adds a delta to the available quantity, refusing to go below zero.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param productId ID of the product.
+     * @param delta Quantity to add (negative to subtract).
+     * @return Number of rows updated (0 or 1).
+     * @throws mysqlx::Error on database errors.
+     */
+    uint64_t addQuantity(LocationType type, int locationId, int productId, int delta);
+
+  private:
+    /**
+     * @struct TableStatements
+     * @brief Reusable statements of one inventory table.
+     */
+    struct TableStatements
+    {
+        mysqlx::TableSelect select; /**< Quantity lookup by primary key. */
+        mysqlx::TableUpdate update; /**< Guarded quantity delta by primary key. */
+    };
+
+    explicit InventoryStatements(mysqlx::Session& session);
+
+    TableStatements& statementsFor(LocationType type);
+
+    mysqlx::Session& session;                    /**< Session owning the statements. */
+    std::unique_ptr<TableStatements> hubs;       /**< Built on first use. */
+    std::unique_ptr<TableStatements> warehouses; /**< Built on first use. */
+};
+
+#endif // INVENTORY_STATEMENTS_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file inventoryStore.hpp
+ * @brief Storage backend interface of the inventory logic.
+ *
+ * Stock checks, alerts, re-stocks and order transfers only talk to an
+ * InventoryStore, so the same logic runs on MySQL (MySqlInventoryStore) or on
+ * the in-process EmbeddedInventoryStore, which needs no database server.
+ */
+
+#ifndef INVENTORY_STORE_HPP
+#define INVENTORY_STORE_HPP
+
+#include "inventoryCache.hpp"
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+/// Value of INVENTORY_BACKEND selecting the MySQL backend (default).
+#define INVENTORY_BACKEND_MYSQL "mysql"
+/// Value of INVENTORY_BACKEND selecting the embedded backend.
+#define INVENTORY_BACKEND_EMBEDDED "embedded"
+
+/// Result of a transfer whose source was debited and could not be restored after the credit failed.
+#define TRANSFER_COMPENSATION_FAILED -2
+
+/**
+ * @enum InventoryBackend
+ * @brief Storage engine holding the inventory.
+ */
+enum class InventoryBackend
+{
+    MYSQL,   /**< The `hubs` and `warehouses` tables of the MySQL server. */
+    EMBEDDED /**< In-process engine, optionally persisted to a local file. */
+};
+
+/**
+ * @struct InventoryBackendConfig
+ * @brief Settings of the inventory storage backend.
+ */
+struct InventoryBackendConfig
+{
+    InventoryBackend backend = InventoryBackend::MYSQL; /**< Selected engine. */
+    std::string path;                                   /**< Data file of the embedded engine; empty keeps it in memory. */
+};
+
+/**
+ * @brief Reads the backend settings from the environment.
+ *
+ * - INVENTORY_BACKEND: "mysql" (default) or "embedded".
+ * - INVENTORY_FILE: data file of the embedded engine.
+ *
+ * @return The parsed configuration.
+ */
+InventoryBackendConfig loadInventoryBackendConfig();
+
+/**
+ * @struct InventoryTransfer
+ * @brief Stock movement of one order: a product leaves the source and enters the destination.
+ */
+struct InventoryTransfer
+{
+    LocationType sourceType;      /**< Source location type. */
+    int sourceLocation;           /**< Source location ID. */
+    LocationType destinationType; /**< Destination location type. */
+    int destinationLocation;      /**< Destination location ID. */
+    std::string product;          /**< Name of the product. */
+    int quantity;                 /**< Units moved. */
+};
+
+/**
+ * @brief Reads the transfer described by an order.
+ *
+ * @param request JSON with transaction details.
+ * @param transfer Output parameter receiving the transfer.
+ * @return true if the source and destination types are known, false otherwise.
+ */
+bool parseInventoryTransfer(const Json::Value& request, InventoryTransfer& transfer);
+
+/**
+ * @class InventoryStore
+ * @brief Hub and warehouse stock, keyed by location and product name.
+ *
+ * Product names are compared case-insensitively. Quantities never go negative:
+ * a change that would make them negative is rejected.
+ */
+class InventoryStore
+{
+  public:
+    virtual ~InventoryStore() = default;
+
+    /**
+     * @brief Retrieves the available quantity of a product at a location.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @return int Quantity available, or -1 if the row is unknown or cannot be read.
+     */
+    virtual int getQuantity(LocationType type, int locationId, const std::string& product) = 0;
+
+    /**
+     * @brief Adds a quantity to a product at a location.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param delta Quantity to add/subtract.
+     * @return int 1 if success, -1 on error.
+     */
+    virtual int addQuantity(LocationType type, int locationId, const std::string& product, int delta) = 0;
+
+    /**
+     * @brief Tops a product at a location up to a level, reading and writing the row in one step.
+     *
+     * A row already at or above the level is left unchanged, so stock credited
+     * between the caller's decision and this call is never pushed over it.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param capacity Level the row is raised to.
+     * @return int Units added (0 if the row was full), or -1 on error.
+     */
+    virtual int raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity) = 0;
+
+    /**
+     * @brief Moves stock from the source to the destination of an order.
+     *
+     * @param transfer Movement to apply.
+     * @return int 1 if success, 0/-1 on failure, TRANSFER_COMPENSATION_FAILED if
+     *         the source kept the debit of a failed transfer.
+     */
+    virtual int transfer(const InventoryTransfer& transfer) = 0;
+
+    /**
+     * @brief Reads every product row of a set of locations.
+     *
+     * @param type Location type.
+     * @param locationIds IDs of the hubs or warehouses; empty means every location.
+     * @param levels Output vector receiving the rows.
+     * @return int Number of rows appended, or -1 on error.
+     */
+    virtual int getSnapshot(LocationType type, const std::vector<int>& locationIds,
+                            std::vector<StockLevel>& levels) = 0;
+};
+
+/**
+ * @brief Updates source and destination inventories based on a transaction.
+ *
+ * @param store Inventory backend.
+ * @param request JSON with transaction details.
+ * @return int 1 if success, 0/-1 on failure.
+ */
+int realTimeUpdate(InventoryStore& store, const Json::Value& request);
+
+#endif // INVENTORY_STORE_HPP
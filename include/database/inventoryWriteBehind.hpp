@@ -0,0 +1,226 @@
+/**
+ * @file inventoryWriteBehind.hpp
+ * @brief Optional write-behind mode for inventory updates with group commit.
+ *
+ * In write-behind mode an order's inventory deltas are applied to the in-memory
+ * ledger (the warm inventory cache) right away. The deltas are merged per
+ * (location, product) and flushed to MySQL in a single transaction every few
+ * milliseconds or every N orders, whichever comes first.
+ *
+ * The durability knob decides when the order is acknowledged:
+ * - GROUP_COMMIT: the caller waits until the batch holding its deltas commits.
+ * - ACK_IMMEDIATELY: the caller returns as soon as the ledger accepts the deltas;
+ *   a batch that fails to commit is kept and retried on the next flush.
+ *
+ * A batch the database is unavailable for is retried as a whole. A batch it
+ * rejects is retried one delta at a time, so one bad row does not hold back the
+ * others; a delta rejected WRITE_BEHIND_MAX_REJECTIONS times is dead-lettered
+ * and reverted in the ledger. If a revert cannot be applied the ledger no longer
+ * matches MySQL: the cache is marked cold and reloaded once the pending deltas
+ * are flushed. Until then orders are turned away with WRITE_BEHIND_RETRY_LATER.
+ */
+
+#ifndef INVENTORY_WRITE_BEHIND_HPP
+#define INVENTORY_WRITE_BEHIND_HPP
+
+#include "inventoryCache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/// Default maximum time, in milliseconds, a delta waits in the ledger before being flushed.
+#define WRITE_BEHIND_FLUSH_MS 5
+/// Default number of orders that triggers a flush before the interval elapses.
+#define WRITE_BEHIND_FLUSH_ORDERS 64
+/// Commits that may reject a delta before it is dropped from the ledger.
+#define WRITE_BEHIND_MAX_REJECTIONS 3
+/// Minimum time, in milliseconds, between two attempts to reload a cold ledger.
+#define WRITE_BEHIND_RELOAD_RETRY_MS 1000
+/// Result of submit() while a failed revert waits for the reload; nothing was applied and the order may be retried.
+#define WRITE_BEHIND_RETRY_LATER -3
+
+/**
+ * @enum WriteBehindDurability
+ * @brief When an order is acknowledged in write-behind mode.
+ */
+enum class WriteBehindDurability
+{
+    GROUP_COMMIT,   /**< Wait for the transaction holding the order's deltas to commit. */
+    ACK_IMMEDIATELY /**< Acknowledge once the deltas are in the in-memory ledger. */
+};
+
+/**
+ * @struct WriteBehindConfig
+ * @brief Settings of the write-behind mode.
+ */
+struct WriteBehindConfig
+{
+    bool enabled = false;                                                   /**< Whether write-behind is used. */
+    int flushIntervalMs = WRITE_BEHIND_FLUSH_MS;                            /**< Flush period in milliseconds. */
+    int flushOrders = WRITE_BEHIND_FLUSH_ORDERS;                            /**< Orders that force a flush. */
+    WriteBehindDurability durability = WriteBehindDurability::GROUP_COMMIT; /**< Acknowledge policy. */
+};
+
+/**
+ * @brief Reads the write-behind settings from the environment.
+ *
+ * - INVENTORY_WRITE_BEHIND: "1" enables the mode (disabled by default).
+ * - INVENTORY_FLUSH_MS: flush period in milliseconds.
+ * - INVENTORY_FLUSH_ORDERS: number of orders that forces a flush.
+ * - INVENTORY_DURABILITY: "group_commit" (default) or "ack".
+ *
+ * @return The parsed configuration.
+ */
+WriteBehindConfig loadWriteBehindConfig();
+
+/**
+ * @struct InventoryDelta
+ * @brief Quantity change for one product at one location.
+ */
+struct InventoryDelta
+{
+    LocationType type;   /**< Location type. */
+    int locationId;      /**< ID of the hub or warehouse. */
+    std::string product; /**< Name of the product. */
+    int delta;           /**< Quantity to add (negative to subtract). */
+};
+
+/**
+ * @class InventoryWriteBehind
+ * @brief In-memory ledger of pending inventory deltas plus its background flusher.
+ */
+class InventoryWriteBehind
+{
+  public:
+    /**
+     * @brief Function that commits a merged batch of deltas in one transaction.
+     *
+     * Must return 1 if every delta was committed, 0 if the database rejected a
+     * delta, or -1 if the database could not be reached.
+     */
+    using FlushFunction = std::function<int(const std::vector<InventoryDelta>&)>;
+
+    /**
+     * @brief Function that reloads the inventory cache from the database.
+     *
+     * Must return true if the cache was loaded and marked warm.
+     */
+    using ReloadFunction = std::function<bool()>;
+
+    /**
+     * @brief Gets the process-wide write-behind instance.
+     * @return The single InventoryWriteBehind instance.
+     */
+    static InventoryWriteBehind& getInstance();
+
+    /**
+     * @brief Starts the background flusher.
+     *
+     * The in-memory ledger is the inventory cache, so it must be warm before starting.
+     *
+     * @param config Write-behind settings.
+     * @param flushFunction Function that commits a merged batch.
+     * @param reloadFunction Function that reloads the cache after a failed revert; the cache
+     *                       stays cold when none is given.
+     * @return true if the flusher was started, false if already running or the cache is cold.
+     */
+    bool start(const WriteBehindConfig& config, FlushFunction flushFunction, ReloadFunction reloadFunction = nullptr);
+
+    /**
+     * @brief Flushes the remaining deltas and stops the background flusher.
+     */
+    void stop();
+
+    /**
+     * @brief Tells whether inventory updates should go through the ledger.
+     * @return true if the flusher is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Applies the deltas of one order to the ledger.
+     *
+     * The deltas are applied all-or-nothing: if any of them would leave a
+     * negative or unknown row, none is applied.
+     *
+     * @param deltas Deltas of the order.
+     * @return int 1 if the order was accepted (and committed, under GROUP_COMMIT), WRITE_BEHIND_RETRY_LATER
+     *         while the ledger waits to be reloaded, -1 otherwise.
+     */
+    int submit(const std::vector<InventoryDelta>& deltas);
+
+    /**
+     * @brief Tops a row up to a level through the ledger.
+     *
+     * The level is read from the ledger, which counts the deltas not flushed
+     * yet, and the missing units are applied like the deltas of an order.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product.
+     * @param capacity Level the row is raised to.
+     * @return int Units added (0 if the row was full), or -1 if the row is unknown or the delta was not accepted.
+     */
+    int raiseToCapacity(LocationType type, int locationId, const std::string& product, int capacity);
+
+    /**
+     * @brief Gets the number of distinct (location, product) rows waiting to be flushed.
+     * @return Number of pending merged deltas.
+     */
+    std::size_t pendingCount() const;
+
+    /**
+     * @brief Gets the number of deltas dropped because the database kept rejecting them.
+     * @return Number of dead-lettered deltas since the process started.
+     */
+    std::size_t deadLetterCount() const;
+
+  private:
+    /**
+     * @struct Batch
+     * @brief Completion state shared by every order of one group commit.
+     */
+    struct Batch
+    {
+        bool done = false;      /**< Whether the batch was flushed. */
+        bool committed = false; /**< Whether the flush committed. */
+    };
+
+    using DeltaKey = std::tuple<LocationType, int, std::string>;
+
+    InventoryWriteBehind() = default;
+
+    int acceptLocked(const std::vector<InventoryDelta>& deltas, std::unique_lock<std::mutex>& lock);
+    void flushLoop();
+    void flushPending(std::unique_lock<std::mutex>& lock);
+    void settle(const InventoryDelta& delta, int result);
+    void reloadIfNeeded();
+    void revert(const std::vector<InventoryDelta>& deltas);
+
+    mutable std::mutex mutex;                         /**< Guards the ledger state below. */
+    std::condition_variable flushRequested;           /**< Wakes the flusher early. */
+    std::condition_variable batchDone;                /**< Wakes GROUP_COMMIT waiters. */
+    std::map<DeltaKey, int> pending;                  /**< Merged deltas waiting to be flushed. */
+    std::map<DeltaKey, int> rejections;               /**< Rejected commits per row since its last success. */
+    std::size_t deadLetters = 0;                      /**< Deltas dropped after too many rejections. */
+    bool reloadNeeded = false;                        /**< Whether a failed revert left the cache cold. */
+    std::chrono::steady_clock::time_point lastReload; /**< Last reload attempt. */
+    std::shared_ptr<Batch> currentBatch;              /**< Batch collecting new deltas. */
+    int ordersSinceFlush = 0;                         /**< Orders accepted since the last flush. */
+    std::atomic<bool> running{false};                 /**< Whether the flusher is running. */
+    WriteBehindConfig config;                         /**< Active settings. */
+    FlushFunction flushFunction;                      /**< Commits a merged batch. */
+    ReloadFunction reloadFunction;                    /**< Reloads the cache after a failed revert. */
+    std::thread flusher;                              /**< Background flusher thread. */
+};
+
+#endif // INVENTORY_WRITE_BEHIND_HPP
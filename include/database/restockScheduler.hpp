@@ -0,0 +1,166 @@
+/**
+ * @file restockScheduler.hpp
+ * @brief Background re-stocks of warehouse rows, off the order path.
+ *
+ * An order that takes a warehouse row to the re-stock threshold only requests
+ * the re-stock; the scheduler applies it later, so the order does not pay for
+ * the extra write. Requests are deduplicated per (warehouse, product): a row
+ * already waiting or being re-stocked is not requested twice, so concurrent
+ * orders cannot both refill it. Pending requests are grouped per warehouse and
+ * each group is applied as one inventory task, which raises every product of
+ * the warehouse to capacity with InventoryStore::raiseToCapacity(). The store
+ * reads and writes the row in one step, so stock credited by an order running
+ * at the same time is counted and never pushed over capacity.
+ *
+ * The last RESTOCK_HISTORY_MAX re-stocks applied are kept with the pending
+ * ones for the RESTOCK_STATUS command.
+ */
+
+#ifndef RESTOCK_SCHEDULER_HPP
+#define RESTOCK_SCHEDULER_HPP
+
+#include "inventoryStore.hpp"
+#include "stockLevelMonitor.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Name of the command listing the pending and completed re-stocks.
+#define RESTOCK_STATUS_COMMAND "RESTOCK_STATUS"
+
+/// Milliseconds the scheduler waits after the first request, so the re-stocks of a burst are applied together.
+#define RESTOCK_BATCH_DELAY_MS 50
+
+/// Number of completed re-stocks kept for RESTOCK_STATUS.
+#define RESTOCK_HISTORY_MAX 100
+
+/**
+ * @struct RestockRecord
+ * @brief One re-stock of a warehouse row, pending or completed.
+ */
+struct RestockRecord
+{
+    int warehouseId = 0;                             /**< ID of the warehouse. */
+    std::string product;                             /**< Name of the product. */
+    std::chrono::steady_clock::time_point requested; /**< Moment the re-stock was requested. */
+    std::chrono::steady_clock::time_point completed; /**< Moment it was applied; unset while pending. */
+    int added = 0;                                   /**< Units added to reach the capacity. */
+    bool ok = false;                                 /**< Whether the re-stock was applied. */
+};
+
+/**
+ * @brief Builds the RESTOCK_STATUS response.
+ *
+ * @param pending Re-stocks waiting or being applied.
+ * @param completed Re-stocks applied, oldest first.
+ * @return The report sent to the client.
+ */
+std::string formatRestockStatus(const std::vector<RestockRecord>& pending, const std::vector<RestockRecord>& completed);
+
+/**
+ * @class RestockScheduler
+ * @brief Thread-safe queue of re-stock requests and the thread applying them.
+ */
+class RestockScheduler
+{
+  public:
+    /**
+     * @brief Runs an inventory task on a thread that owns a store; returns false if it cannot run.
+     */
+    using RunFunction = std::function<bool(std::function<void(InventoryStore&)>)>;
+
+    /**
+     * @brief Creates a scheduler without requests.
+     * @param capacity Level a re-stocked row is topped up to.
+     * @param batchDelay Time waited after the first request of a batch.
+     * @param historyMax Completed re-stocks kept.
+     */
+    explicit RestockScheduler(int capacity = MAX_CAPACITY,
+                              std::chrono::milliseconds batchDelay = std::chrono::milliseconds(RESTOCK_BATCH_DELAY_MS),
+                              std::size_t historyMax = RESTOCK_HISTORY_MAX);
+
+    /**
+     * @brief Stops the scheduler thread.
+     */
+    ~RestockScheduler();
+
+    /**
+     * @brief Gets the scheduler of the server.
+     * @return The process-wide scheduler.
+     */
+    static RestockScheduler& getInstance();
+
+    /**
+     * @brief Requests the re-stock of a warehouse row.
+     *
+     * @param warehouseId ID of the warehouse.
+     * @param product Name of the product, compared case-insensitively.
+     * @return true if the request was queued, false if the row is already waiting or being re-stocked.
+     */
+    bool request(int warehouseId, const std::string& product);
+
+    /**
+     * @brief Applies every queued request on the calling thread.
+     *
+     * @param store Inventory backend holding the warehouse stock.
+     * @return Number of re-stocks applied successfully.
+     */
+    std::size_t applyPending(InventoryStore& store);
+
+    /**
+     * @brief Starts the thread applying the requests.
+     * @param run Function running each warehouse batch as an inventory task.
+     * @return true if the thread started, false if it was already running.
+     */
+    bool start(RunFunction run);
+
+    /**
+     * @brief Hands the queued requests to the run function and stops the thread.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the re-stocks waiting or being applied.
+     * @return The records, by warehouse and product.
+     */
+    std::vector<RestockRecord> pending() const;
+
+    /**
+     * @brief Gets the last re-stocks applied or failed.
+     * @return The records, oldest first.
+     */
+    std::vector<RestockRecord> completed() const;
+
+  private:
+    using Key = std::pair<int, std::string>;
+    using Batch = std::vector<RestockRecord>;
+    using Queue = std::map<int, std::map<std::string, RestockRecord>>;
+
+    static Key makeKey(int warehouseId, const std::string& product);
+
+    std::vector<Batch> takeBatches();
+    std::size_t applyBatch(InventoryStore& store, Batch batch);
+    void finish(const Batch& batch);
+    void run(RunFunction runTask);
+
+    const int capacity;                         /**< Level a re-stocked row is topped up to. */
+    const std::chrono::milliseconds batchDelay; /**< Wait after the first request of a batch. */
+    const std::size_t historyMax;               /**< Completed re-stocks kept. */
+    mutable std::mutex mutex;                   /**< Guards queued, inFlight, history and stopping. */
+    std::condition_variable ready;              /**< Signalled when a request is queued or the thread stops. */
+    Queue queued;                               /**< Waiting requests by warehouse and lower-cased product. */
+    std::map<Key, RestockRecord> inFlight;      /**< Requests taken by a batch not applied yet. */
+    std::deque<RestockRecord> history;          /**< Completed re-stocks, oldest first. */
+    bool stopping = false;                      /**< Whether the thread must exit. */
+    std::thread worker;                         /**< Thread handing the batches to the run function. */
+};
+
+#endif // RESTOCK_SCHEDULER_HPP
@@ -0,0 +1,136 @@
+/**
+ * @file stockLevelMonitor.hpp
+ * @brief Detection of warehouse stock crossing the low stock and re-stock thresholds.
+ *
+ * The inventory backends report every warehouse level they write or load
+ * (InventoryCache for MySQL, EmbeddedInventoryStore), so thresholds are
+ * checked where the stock changes instead of reading it again after each
+ * order. A threshold fires once when a level falls to it or below, and only
+ * fires again after the level climbed more than STOCK_HYSTERESIS units above
+ * it, so stock hovering around a threshold does not repeat the alert.
+ *
+ * Crossings stay pending until the server takes them, usually right after the
+ * order that caused them; a pending crossing is dropped if the level recovers
+ * before.
+ */
+
+#ifndef STOCK_LEVEL_MONITOR_HPP
+#define STOCK_LEVEL_MONITOR_HPP
+
+#include "inventoryCache.hpp"
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/// Maximum capacity of the warehouse for a product.
+#define MAX_CAPACITY 1000
+/// Threshold value for low stock alerts (20% of max stock, assumed to be 1000 units per product).
+#define STOCK_THRESHOLD 200
+/// Threshold value for restock alerts (10% of max stock, assumed to be 1000 units per product).
+#define RESTOCK_THRESHOLD 100
+/// Units a level must climb above a threshold before the threshold can fire again.
+#define STOCK_HYSTERESIS 50
+
+/**
+ * @struct StockThresholds
+ * @brief Levels checked by the monitor.
+ */
+struct StockThresholds
+{
+    int low = STOCK_THRESHOLD;         /**< Low stock alert at or below this level. */
+    int restock = RESTOCK_THRESHOLD;   /**< Re-stock at or below this level. */
+    int hysteresis = STOCK_HYSTERESIS; /**< Rise above a threshold that re-arms it. */
+};
+
+/**
+ * @struct StockCrossing
+ * @brief Pending crossings of a warehouse row.
+ */
+struct StockCrossing
+{
+    bool low = false;     /**< The level fell to the low stock threshold. */
+    bool restock = false; /**< The level fell to the re-stock threshold. */
+    int quantity = -1;    /**< Last level observed. */
+};
+
+/**
+ * @class StockLevelMonitor
+ * @brief Thread-safe threshold state of every warehouse row.
+ */
+class StockLevelMonitor
+{
+  public:
+    /**
+     * @brief Creates a monitor that has seen no levels.
+     * @param thresholds Levels to check.
+     */
+    explicit StockLevelMonitor(const StockThresholds& thresholds = StockThresholds());
+
+    /**
+     * @brief Gets the monitor fed by the inventory backends.
+     * @return The process-wide monitor.
+     */
+    static StockLevelMonitor& getInstance();
+
+    /**
+     * @brief Records the new level of a row; hub rows are ignored.
+     *
+     * The first level seen of a row counts as a crossing if it is already at a threshold.
+     *
+     * @param type Location type.
+     * @param locationId ID of the hub or warehouse.
+     * @param product Name of the product, compared case-insensitively.
+     * @param quantity Available quantity after the change.
+     */
+    void observe(LocationType type, int locationId, const std::string& product, int quantity);
+
+    /**
+     * @brief Takes the pending crossings of a warehouse row, so each is reported once.
+     *
+     * @param warehouseId ID of the warehouse.
+     * @param product Name of the product.
+     * @param crossing Output parameter receiving the pending crossings and the last level.
+     * @return false if no level of the row was ever observed.
+     */
+    bool take(int warehouseId, const std::string& product, StockCrossing& crossing);
+
+    /**
+     * @brief Forgets a warehouse row, so its next level is checked as if it were the first.
+     *
+     * @param warehouseId ID of the warehouse.
+     * @param product Name of the product.
+     */
+    void forget(int warehouseId, const std::string& product);
+
+    /**
+     * @brief Gets the number of rows with a pending crossing.
+     * @return Row count.
+     */
+    std::size_t pending() const;
+
+  private:
+    /**
+     * @struct Row
+     * @brief Threshold state of a warehouse row.
+     */
+    struct Row
+    {
+        int quantity = -1;           /**< Last level observed. */
+        bool lowArmed = true;        /**< Whether the low stock threshold can fire. */
+        bool restockArmed = true;    /**< Whether the re-stock threshold can fire. */
+        bool lowPending = false;     /**< Low stock crossing not taken yet. */
+        bool restockPending = false; /**< Re-stock crossing not taken yet. */
+    };
+
+    using Key = std::pair<int, std::string>;
+
+    static Key makeKey(int warehouseId, const std::string& product);
+
+    const StockThresholds thresholds; /**< Levels checked. */
+    mutable std::mutex mutex;         /**< Guards rows. */
+    std::map<Key, Row> rows;          /**< Warehouse rows by ID and lower-cased product name. */
+};
+
+#endif // STOCK_LEVEL_MONITOR_HPP
@@ -8,10 +8,18 @@
 
 #include "alertHandler.hpp"
 #include "anomalieHandler.hpp"
+#include "embeddedInventoryStore.hpp"
 #include "errorHandler.hpp"
+#include "eventFeed.hpp"
+#include "inventoryDb.hpp"
 #include "lowStockChecker.hpp"
+#include "orderDedup.hpp"
+#include "orderIndex.hpp"
+#include "orderReport.hpp"
 #include "orderStorage.hpp"
 #include "orderValidation.hpp"
+#include "responseChunks.hpp"
+#include "stockQuery.hpp"
 #include "json/allocator.h"
 #include "json/assertions.h"
 #include "json/config.h"
@@ -27,8 +35,10 @@
 #include <atomic>
 #include <chrono>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <netinet/in.h>
 #include <sstream>
@@ -73,6 +83,42 @@
  */
 #define PORT 8080
 
+/**
+* @class TcpConnection
+* @brief Socket of a TCP client, shared by every thread that replies to it.
+*
+* The network thread, the inventory workers and the event feed dispatcher all
+* write to the client. Writes and close() are serialized and nothing is written
+* once the connection is closed, so a late reply never reaches a descriptor the
+* kernel already reused for another client.
+*/
+class TcpConnection
+{
+  public:
+    /**
+    * @brief Wraps an open socket.
+    * @param socket_fd The socket file descriptor for the client.
+    */
+    explicit TcpConnection(int socket_fd);
+
+    /**
+    * @brief Writes a message to the client.
+    * @param message The message to send.
+    * @return true if the message was written, false if the connection is closed or the write failed.
+    */
+    bool send(const std::string& message);
+
+    /**
+    * @brief Closes the socket; later sends are dropped.
+    */
+    void close();
+
+  private:
+    std::mutex mutex;    /**< Serializes writes and close(). */
+    int socket_fd;       /**< File descriptor for the client's socket. */
+    bool closed = false; /**< Whether the socket was closed. */
+};
+
 /**
 * @struct ClientInfo
 * @brief Structure to store information about connected clients.
@@ -89,6 +135,7 @@ struct ClientInfo
     std::string ip_address;       /**< IP address of the client. */
     std::string protocol;         /**< Protocol used by the client: "UDP" or "TCP". */
     std::chrono::steady_clock::time_point last_seen; /**< Timestamp of the last activity from the client. */
+    std::shared_ptr<TcpConnection> connection; /**< Shared socket of a TCP client; null for UDP clients. */
 };
 
 /**
@@ -109,6 +156,15 @@ extern std::map<int, ClientInfo> clientMapUdp;
 */
 extern std::map<int, ClientInfo> clientMapTcp;
 
+/**
+* @var clientMapMutex
+* @brief Guards clientMapUdp and clientMapTcp.
+*
+* The maps are read by the inventory workers and the event feed dispatcher while
+* the network threads register and remove clients.
+*/
+extern std::mutex clientMapMutex;
+
 /**
 * @class Server
 * @brief A class to manage server functionality for handling TCP/UDP client connections.
@@ -124,6 +180,7 @@ class Server
     int socketUdpFd;         /**< File descriptor for the UDP socket. */
     int socketTcpFd;         /**< File descriptor for the TCP socket. */
     std::atomic<bool> running; /**< A flag indicating whether the server is running or not. */
+    std::shared_ptr<InventoryStore> inventoryStore; /**< In-process inventory backend; null when MySQL is used. */
 
     /**
     * @brief Private constructor for the Server class.
@@ -162,6 +219,43 @@ class Server
     void handleTcpClient(int client_sockfd, struct sockaddr_in cli_addr);
 
   public:
+    /**
+    * @brief Sends a message back to the client that placed an order.
+    */
+    using ReplyFunction = std::function<void(const std::string&)>;
+
+    /**
+    * @brief Runs the order pipeline shared by UDP and TCP clients.
+    *
+    * Parsing and limit validation run on the calling network thread; the stock
+    * check, inventory update and stock alerts run on the inventory executor,
+    * so the network thread never waits on MySQL. With the in-process backend
+    * they run on the network thread.
+    *
+    * An order whose general_info.id was already received from the same client is
+    * not applied again: the client gets the replies of the original, or is told it
+    * is still in progress. An order is journaled once it gets its final answer; one
+    * that was not applied and may be retried is forgotten instead, so only the
+    * retry that settles it is journaled.
+    *
+    * @param order The raw JSON order.
+    * @param protocol The protocol used by the client ("UDP" or "TCP").
+    * @param client_id The client ID that placed the order.
+    * @param reply Function sending a message back to the client.
+    */
+    void handleOrder(const std::string& order, const std::string& protocol, int client_id, ReplyFunction reply);
+
+    /**
+    * @brief Runs an inventory task against the configured backend.
+    *
+    * With the in-process backend the task runs right away on the calling thread;
+    * with MySQL it is queued on the inventory executor.
+    *
+    * @param task Function receiving the inventory store.
+    * @return true if the task ran or was queued, false if the executor is not running.
+    */
+    bool runInventoryTask(std::function<void(InventoryStore&)> task);
+
     /**
     * @brief Gets the singleton instance of the Server class.
     * @param port The port to be used for the server instance.
@@ -169,6 +263,12 @@ class Server
     */
     static Server* getInstance(int port);
 
+    /**
+    * @brief Uses an in-process inventory backend instead of MySQL.
+    * @param store The backend; null switches back to MySQL.
+    */
+    void setInventoryStore(std::shared_ptr<InventoryStore> store);
+
     /**
     * @brief Handles communication with UDP clients.
     */
@@ -202,11 +302,65 @@ class Server
     void handleListClientsRequest(const std::string& protocol, int client_pid);
 
     /**
-    * @brief Handles requests to show a report based on a client's ID.
-    * @param protocol The protocol used ("UDP" or "TCP").
-    * @param client_id The client ID for which to show the report.
+    * @brief Handles SHOW_REPORT requests: order totals over a time window, grouped by one dimension.
+    *
+    * The totals are merged from the order rollups, so the cost does not depend on the number of orders.
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID requesting the report.
+    * @param command The raw command, with its optional window and group parameters.
     */
-    void handleShowReportRequest(const std::string& protocol, int client_id);
+    void handleShowReportRequest(const std::string& protocol, int client_id, const std::string& command);
+
+    /**
+    * @brief Handles QUERY_ORDERS requests: one page of the stored orders matching every filter.
+    *
+    * The matches come from the order indexes; only the orders of the page are read from the journal.
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID requesting the orders.
+    * @param command The raw command, with its filters and page.
+    */
+    void handleQueryOrdersRequest(const std::string& protocol, int client_id, const std::string& command);
+
+    /**
+    * @brief Handles CONTINUE requests: the next frames of a chunked response.
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID that received the first frames.
+    * @param command The raw command, with the cursor of the last frame received.
+    */
+    void handleContinueRequest(const std::string& protocol, int client_id, const std::string& command);
+
+    /**
+    * @brief Handles GET_STOCK requests: stock of many locations and products in one response.
+    *
+    * The rows come from a bulk inventory snapshot (the warm cache, or one query per location type).
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID requesting the stock.
+    * @param command The raw command, with its optional filters.
+    */
+    void handleGetStockRequest(const std::string& protocol, int client_id, const std::string& command);
+
+    /**
+    * @brief Handles SUBSCRIBE and UNSUBSCRIBE requests: the topics of the event feed the client receives.
+    *
+    * The events are sent by the feed dispatcher, batched per client, never on the order path.
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID changing its subscriptions.
+    * @param command The raw command, with its topics.
+    */
+    void handleSubscribeRequest(const std::string& protocol, int client_id, const std::string& command);
+
+    /**
+    * @brief Handles RESTOCK_STATUS requests: the re-stocks waiting in the scheduler and the last ones applied.
+    *
+    * @param protocol The protocol used ("udp" or "tcp").
+    * @param client_id The client ID requesting the status.
+    */
+    void handleRestockStatusRequest(const std::string& protocol, int client_id);
 
     /**
     * @brief Cleans up inactive UDP clients that have not sent messages within the given timeout.
@@ -220,12 +374,17 @@ class Server
     * @param protocol The protocol used by the client ("UDP" or "TCP").
     * @param addr The address information of the client.
     * @param socket_fd The socket file descriptor for the client.
+    * @param connection Shared socket of a TCP client; created from socket_fd when null.
     * @return The client ID assigned to the newly registered client.
     */
-    int registerClient(int pid, const std::string& protocol, struct sockaddr_in addr, int socket_fd);
+    int registerClient(int pid, const std::string& protocol, struct sockaddr_in addr, int socket_fd,
+                       std::shared_ptr<TcpConnection> connection = nullptr);
 
     /**
     * @brief Finds a client by their client ID and protocol.
+    *
+    * The caller must hold clientMapMutex while it uses the returned pointer.
+    *
     * @param clientId The client ID to search for.
     * @param protocol The protocol used by the client ("UDP" or "TCP").
     * @return A pointer to the `ClientInfo` structure for the client, or `nullptr` if not found.
@@ -248,6 +407,18 @@ class Server
     */
     void forwardMessageToClient(const std::string& message, int targetClientId, const std::string& protocol);
 
+    /**
+    * @brief Sends a response that may be longer than one client read.
+    *
+    * Responses over RESPONSE_CHUNK_SIZE bytes are sent as chunk frames; over UDP
+    * only the first RESPONSE_CHUNK_WINDOW frames go out until the client sends CONTINUE.
+    *
+    * @param response The full response.
+    * @param targetClientId The client ID to which the response should be sent.
+    * @param protocol The protocol used by the target client ("udp" or "tcp").
+    */
+    void sendResponse(const std::string& response, int targetClientId, const std::string& protocol);
+
     /**
     * @brief Prints the server's logo.
     * @return An integer indicating the success or failure of printing the logo.
@@ -5,6 +5,220 @@
 
 #include "client.h"
 
+void chunk_assembler_init(struct chunk_assembler* assembler)
+{
+    memset(assembler, 0, sizeof(*assembler));
+}
+
+void chunk_assembler_free(struct chunk_assembler* assembler)
+{
+    free(assembler->data);
+    assembler->data = NULL;
+    assembler->length = 0;
+    assembler->count = 0;
+    assembler->next_index = 0;
+}
+
+int chunk_assembler_feed(struct chunk_assembler* assembler, const char* data, size_t length, size_t* consumed)
+{
+    char header[CHUNK_HEADER_MAX];
+    char cursor[32];
+    unsigned long stream;
+    size_t index, count, payload;
+
+    *consumed = 0;
+    const char* newline = memchr(data, '\n', length < CHUNK_HEADER_MAX ? length : CHUNK_HEADER_MAX);
+    if (newline == NULL)
+    {
+        return length < CHUNK_HEADER_MAX ? CHUNK_INCOMPLETE : CHUNK_INVALID;
+    }
+
+    size_t header_length = (size_t)(newline - data);
+    memcpy(header, data, header_length);
+    header[header_length] = '\0';
+    if (sscanf(header, CHUNK_FRAME_PREFIX "%lu %zu %zu %zu %31s", &stream, &index, &count, &payload, cursor) != 5 ||
+        index >= count || payload > CHUNK_RESPONSE_MAX)
+    {
+        *consumed = header_length + 1;
+        return CHUNK_INVALID;
+    }
+    if (length - header_length - 1 < payload)
+    {
+        return CHUNK_INCOMPLETE;
+    }
+    *consumed = header_length + 1 + payload;
+
+    if (assembler->count == 0 || stream != assembler->stream)
+    {
+        if (stream == assembler->finished)
+        {
+            return CHUNK_IGNORED;
+        }
+        // A new stream replaces a partial one; if its first frames were lost they are asked for again
+        chunk_assembler_free(assembler);
+        assembler->stream = stream;
+        assembler->count = count;
+        assembler->requested = (size_t)-1;
+    }
+
+    if (index < assembler->next_index)
+    {
+        return CHUNK_IGNORED;
+    }
+    if (index > assembler->next_index)
+    {
+        if (assembler->requested == assembler->next_index)
+        {
+            return CHUNK_IGNORED;
+        }
+        assembler->requested = assembler->next_index;
+        return CHUNK_GAP;
+    }
+
+    if (assembler->length + payload > CHUNK_RESPONSE_MAX)
+    {
+        chunk_assembler_free(assembler);
+        return CHUNK_INVALID;
+    }
+    char* grown = realloc(assembler->data, assembler->length + payload + 1);
+    if (grown == NULL)
+    {
+        chunk_assembler_free(assembler);
+        return CHUNK_INVALID;
+    }
+    assembler->data = grown;
+    memcpy(assembler->data + assembler->length, newline + 1, payload);
+    assembler->length += payload;
+    assembler->data[assembler->length] = '\0';
+    assembler->next_index++;
+
+    if (assembler->next_index == assembler->count)
+    {
+        return CHUNK_DONE;
+    }
+    return strcmp(cursor, "-") != 0 ? CHUNK_CONTINUE : CHUNK_STORED;
+}
+
+int chunk_assembler_request(const struct chunk_assembler* assembler, char* request, size_t size)
+{
+    if (assembler->count == 0)
+    {
+        return -1;
+    }
+    return snprintf(request, size, "CONTINUE %lu:%zu", assembler->stream, assembler->next_index);
+}
+
+char* chunk_assembler_take(struct chunk_assembler* assembler)
+{
+    char* message = assembler->data != NULL ? assembler->data : calloc(1, 1);
+    assembler->finished = assembler->stream;
+    assembler->data = NULL;
+    chunk_assembler_free(assembler);
+    return message;
+}
+
+// Prints a server or forwarded message and restores the input prompt
+static void print_received_message(const char* message)
+{
+    // Check if it's a forwarded message from another client
+    if (strstr(message, "FORWARDED_MESSAGE: ") != NULL)
+    {
+        printf("\n\n[INCOMING MESSAGE]: %s\n", message);
+    }
+    else
+    {
+        printf("\n\n[SERVER MESSAGE]: %s\n", message);
+    }
+    printf("Your input > ");
+    fflush(stdout);
+}
+
+// Asks the server for the first chunk the assembler is missing
+static void request_next_chunks(struct receiver_data* data, const struct chunk_assembler* assembler)
+{
+    char request[64];
+    int length = chunk_assembler_request(assembler, request, sizeof(request));
+    if (length < 0)
+    {
+        return;
+    }
+
+    ssize_t sent;
+    if (strcmp(data->protocol, "udp") == 0)
+    {
+        sent = sendto(data->sockfd, request, (size_t)length, 0, (struct sockaddr*)data->addr, sizeof(*data->addr));
+    }
+    else
+    {
+        sent = send(data->sockfd, request, (size_t)length, 0);
+    }
+    if (sent < 0)
+    {
+        perror("ERROR requesting the next chunks");
+    }
+}
+
+// Prints the plain messages and reassembles the chunk frames of the received data; returns the bytes used
+static size_t process_received(struct receiver_data* data, struct chunk_assembler* assembler, char* buffer,
+                               size_t length)
+{
+    size_t prefix_length = strlen(CHUNK_FRAME_PREFIX);
+    size_t offset = 0;
+
+    while (offset < length)
+    {
+        char* start = buffer + offset;
+        size_t available = length - offset;
+
+        if (strncmp(start, CHUNK_FRAME_PREFIX, available < prefix_length ? available : prefix_length) == 0)
+        {
+            size_t consumed = 0;
+            int status = available < prefix_length ? CHUNK_INCOMPLETE
+                                                   : chunk_assembler_feed(assembler, start, available, &consumed);
+            if (status == CHUNK_INCOMPLETE)
+            {
+                break;
+            }
+            offset += consumed > 0 ? consumed : available;
+
+            if (status == CHUNK_DONE)
+            {
+                char* message = chunk_assembler_take(assembler);
+                print_received_message(message);
+                free(message);
+            }
+            else if (status == CHUNK_CONTINUE || status == CHUNK_GAP)
+            {
+                request_next_chunks(data, assembler);
+            }
+            else if (status == CHUNK_INVALID)
+            {
+                fprintf(stderr, "ERROR: Malformed response chunk dropped\n");
+            }
+            continue;
+        }
+
+        // Plain text up to the next frame, if any, is one message
+        char* frame = strstr(start, CHUNK_FRAME_PREFIX);
+        size_t text_length = frame != NULL ? (size_t)(frame - start) : available;
+        for (size_t keep = prefix_length - 1; frame == NULL && keep > 0; keep--)
+        {
+            // Keep the start of a frame cut by the end of the read
+            if (keep < available && strncmp(start + available - keep, CHUNK_FRAME_PREFIX, keep) == 0)
+            {
+                text_length = available - keep;
+                break;
+            }
+        }
+        char saved = start[text_length];
+        start[text_length] = '\0';
+        print_received_message(start);
+        start[text_length] = saved;
+        offset += text_length;
+    }
+    return offset;
+}
+
 /**
  * @brief Thread function that listens for incoming messages from other clients via server
  *
@@ -18,13 +232,17 @@ void* receive_messages_thread(void* arg)
     struct sockaddr_in* addr = data->addr;
     const char* protocol = data->protocol;
 
-    char buffer[BUFFER_SIZE_CLIENT];
+    // TCP frames can span reads, so unused bytes stay in the buffer until the rest arrives
+    char buffer[2 * BUFFER_SIZE_CLIENT];
+    size_t pending = 0;
     int addr_size = sizeof(*addr);
+    int stalled = 0;
+
+    struct chunk_assembler assembler;
+    chunk_assembler_init(&assembler);
 
     while (1)
     {
-        memset(buffer, 0, BUFFER_SIZE_CLIENT);
-
         if (strcmp(protocol, "udp") == 0)
         {
             // UDP receiving logic
@@ -34,7 +252,16 @@ void* receive_messages_thread(void* arg)
             {
                 if (errno == EAGAIN || errno == EWOULDBLOCK)
                 {
-                    // Timeout, continue listening
+                    // Timeout: ask again for a chunked response that stopped arriving, then give up on it
+                    if (assembler.count != 0 && ++stalled > MAX_RETRIES)
+                    {
+                        fprintf(stderr, "\nERROR: Incomplete response from the server dropped\n");
+                        chunk_assembler_free(&assembler);
+                    }
+                    else if (assembler.count != 0)
+                    {
+                        request_next_chunks(data, &assembler);
+                    }
                     continue;
                 }
                 else
@@ -44,26 +271,15 @@ void* receive_messages_thread(void* arg)
                 }
             }
 
-            // Process received message
+            // Each datagram is one message or one frame
             buffer[n] = '\0';
-
-            // Check if it's a forwarded message from another client
-            if (strstr(buffer, "FORWARDED_MESSAGE: ") != NULL)
-            {
-                printf("\n\n[INCOMING MESSAGE]: %s\n", buffer);
-            }
-            else
-            {
-                printf("\n\n[SERVER MESSAGE]: %s\n", buffer);
-            }
-
-            printf("Your input > ");
-            fflush(stdout);
+            stalled = 0;
+            process_received(data, &assembler, buffer, (size_t)n);
         }
         else if (strcmp(protocol, "tcp") == 0)
         {
             // TCP receiving logic - we'll use recv with MSG_DONTWAIT for non-blocking
-            int n = recv(sockfd, buffer, BUFFER_SIZE_CLIENT - 1, MSG_DONTWAIT);
+            int n = recv(sockfd, buffer + pending, BUFFER_SIZE_CLIENT - 1, MSG_DONTWAIT);
 
             if (n < 0)
             {
@@ -87,22 +303,22 @@ void* receive_messages_thread(void* arg)
             }
 
             // Process received message
-            buffer[n] = '\0';
+            pending += (size_t)n;
+            buffer[pending] = '\0';
 
-            // Check if it's a forwarded message from another client
-            if (strstr(buffer, "FORWARDED_MESSAGE: ") != NULL)
-            {
-                printf("\n\n[INCOMING MESSAGE]: %s\n", buffer);
-            }
-            else
+            size_t used = process_received(data, &assembler, buffer, pending);
+            memmove(buffer, buffer + used, pending - used);
+            pending -= used;
+            if (pending >= BUFFER_SIZE_CLIENT)
             {
-                printf("\n\n[SERVER MESSAGE]: %s\n", buffer);
+                // Never the start of a valid frame, which is shorter than one read
+                fprintf(stderr, "ERROR: Malformed response chunk dropped\n");
+                pending = 0;
             }
-            printf("Your input > ");
-            fflush(stdout);
         }
     }
 
+    chunk_assembler_free(&assembler);
     free(data); // Free the allocated structure
     return NULL;
 }
@@ -12,3 +12,20 @@ std::string AlertHandler::generateAlert(const std::string& name, const std::stri
     Json::StreamWriterBuilder writer;
     return Json::writeString(writer, alertJson);
 }
+
+std::string AlertHandler::generateAlertSummary(const std::string& name, const std::string& message, int productId,
+                                               const std::string& productName, const std::string& location,
+                                               std::size_t count, long long windowSeconds)
+{
+    Json::Value alertJson;
+    alertJson["alert"]["name"] = name;
+    alertJson["alert"]["message"] = message;
+    alertJson["alert"]["product_id"] = productId;
+    alertJson["alert"]["product_name"] = productName;
+    alertJson["alert"]["location"] = location;
+    alertJson["alert"]["count"] = static_cast<Json::UInt64>(count);
+    alertJson["alert"]["window_seconds"] = static_cast<Json::Int64>(windowSeconds);
+
+    Json::StreamWriterBuilder writer;
+    return Json::writeString(writer, alertJson);
+}
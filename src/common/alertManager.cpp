@@ -0,0 +1,105 @@
+#include "alertManager.hpp"
+#include "alertHandler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+
+AlertManagerConfig loadAlertManagerConfig()
+{
+    AlertManagerConfig config;
+
+    const char* window = std::getenv("ALERT_COALESCE_WINDOW_SECONDS");
+    if (window != nullptr)
+    {
+        try
+        {
+            config.window = std::chrono::seconds(std::max(0, std::stoi(window)));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ALERT_COALESCE_WINDOW_SECONDS, using "
+                      << std::chrono::duration_cast<std::chrono::seconds>(config.window).count() << std::endl;
+        }
+    }
+
+    return config;
+}
+
+AlertManager::AlertManager(const AlertManagerConfig& config) : config(config)
+{
+}
+
+AlertManager& AlertManager::getInstance()
+{
+    static AlertManager instance(loadAlertManagerConfig());
+    return instance;
+}
+
+std::string AlertManager::summaryOf(const Key& key, const Window& window, std::size_t count) const
+{
+    return AlertHandler::generateAlertSummary(std::get<2>(key), window.message, window.productId, window.productName,
+                                              std::get<0>(key), count,
+                                              std::chrono::duration_cast<std::chrono::seconds>(config.window).count());
+}
+
+bool AlertManager::submit(const std::string& location, const std::string& name, const std::string& message,
+                          int productId, const std::string& productName, std::string& alertOut)
+{
+    Key key{location, productName, name};
+    std::transform(std::get<1>(key).begin(), std::get<1>(key).end(), std::get<1>(key).begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = windows.find(key);
+    if (it != windows.end() && now - it->second.start < config.window)
+    {
+        it->second.suppressed++;
+        it->second.message = message;
+        it->second.productId = productId;
+        it->second.productName = productName;
+        return false;
+    }
+
+    std::size_t carried = it != windows.end() ? it->second.suppressed : 0;
+    Window& window = windows[key];
+    window = Window{now, 0, message, productId, productName};
+    // The occurrences counted in the previous window travel with this alert
+    alertOut = carried == 0 ? AlertHandler::generateAlert(name, message, productId, productName)
+                            : summaryOf(key, window, carried + 1);
+    return true;
+}
+
+std::vector<std::string> AlertManager::flush()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> summaries;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = windows.begin(); it != windows.end();)
+    {
+        if (now - it->second.start < config.window)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second.suppressed > 0)
+        {
+            summaries.push_back(summaryOf(it->first, it->second, it->second.suppressed));
+        }
+        it = windows.erase(it);
+    }
+    return summaries;
+}
+
+std::size_t AlertManager::suppressed() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t total = 0;
+    for (const auto& pair : windows)
+    {
+        total += pair.second.suppressed;
+    }
+    return total;
+}
@@ -1,6 +1,6 @@
 #include "anomalieHandler.hpp"
 
-bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage, mysqlx::Session& session)
+bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage, InventoryStore& store)
 {
     const Json::Value& generalInfo = orderJson["general_info"];
     if (generalInfo.isNull())
@@ -60,11 +60,11 @@ bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage,
     int availableStock = -1;
     if (sourceType == "hub")
     {
-        availableStock = getHubInventory(session, sourceId, productName);
+        availableStock = store.getQuantity(LocationType::HUB, sourceId, productName);
     }
     else if (sourceType == "warehouse")
     {
-        availableStock = getWarehouseInventory(session, sourceId, productName);
+        availableStock = store.getQuantity(LocationType::WAREHOUSE, sourceId, productName);
     }
     else
     {
@@ -78,7 +78,7 @@ bool checkProductStock(const Json::Value& orderJson, std::string& errorMessage,
     {
         errorMessage =
             ErrorHandler::generateError(ERROR_INSUFFICIENT_STOCK, "Inventory fetch failure",
-                                        "Could not retrieve current stock from the database.", ErrorLevel::ERROR);
+                                        "Could not retrieve current stock from the inventory.", ErrorLevel::ERROR);
         return false;
     }
 
@@ -3,25 +3,15 @@
 // Function to authenticate user
 bool authenticate(AuthProxy* proxy, const char* email, const char* password)
 {
-    MYSQL* conn = connectToDb();
-    if (!conn)
+    DbConnection* connection = acquireDbConnection();
+    if (!connection)
         return false;
 
-    // Prevent SQL injection with prepared statements
-    MYSQL_STMT* stmt = mysql_stmt_init(conn);
+    // Prevent SQL injection with prepared statements, prepared once per pooled connection
+    MYSQL_STMT* stmt = getDbStatement(connection, DB_STMT_LOGIN);
     if (!stmt)
     {
-        fprintf(stderr, "❌ mysql_stmt_init() failed\n");
-        mysql_close(conn);
-        return false;
-    }
-
-    const char* query = "SELECT name, password, role FROM user WHERE email = ?";
-    if (mysql_stmt_prepare(stmt, query, strlen(query)))
-    {
-        fprintf(stderr, "❌ mysql_stmt_prepare() failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        mysql_close(conn);
+        releaseDbConnection(connection, true);
         return false;
     }
 
@@ -38,17 +28,15 @@ bool authenticate(AuthProxy* proxy, const char* email, const char* password)
     if (mysql_stmt_bind_param(stmt, bind_param))
     {
         fprintf(stderr, "❌ mysql_stmt_bind_param() failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        mysql_close(conn);
+        releaseDbConnection(connection, false);
         return false;
     }
 
-    // Execute query
-    if (mysql_stmt_execute(stmt))
+    // Execute query and buffer the row so the statement is free for the next login
+    if (mysql_stmt_execute(stmt) || mysql_stmt_store_result(stmt))
     {
         fprintf(stderr, "❌ mysql_stmt_execute() failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        mysql_close(conn);
+        releaseDbConnection(connection, true);
         return false;
     }
 
@@ -88,8 +76,7 @@ bool authenticate(AuthProxy* proxy, const char* email, const char* password)
     if (mysql_stmt_bind_result(stmt, bind_result))
     {
         fprintf(stderr, "❌ mysql_stmt_bind_result() failed: %s\n", mysql_stmt_error(stmt));
-        mysql_stmt_close(stmt);
-        mysql_close(conn);
+        releaseDbConnection(connection, false);
         return false;
     }
 
@@ -127,8 +114,7 @@ bool authenticate(AuthProxy* proxy, const char* email, const char* password)
         printf("❌ User not found\n");
     }
 
-    mysql_stmt_close(stmt);
-    mysql_close(conn);
+    releaseDbConnection(connection, false);
     return auth_success;
 }
 
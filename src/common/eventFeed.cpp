@@ -0,0 +1,293 @@
+#include "eventFeed.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+std::string stockTopic(const std::string& locationType, int locationId)
+{
+    return std::string(EVENT_TOPIC_STOCK) + ":" + locationType + ":" + std::to_string(locationId);
+}
+
+static bool invalidSubscription(const std::string& description, std::string& error)
+{
+    error = ErrorHandler::generateError(ERR_INVALID_SUBSCRIPTION, "Invalid subscription", description,
+                                        ErrorLevel::ERROR);
+    return false;
+}
+
+static bool validTopic(const std::string& topic)
+{
+    if (topic == EVENT_TOPIC_LOW_STOCK || topic == EVENT_TOPIC_RESTOCK || topic == EVENT_TOPIC_STOCK)
+    {
+        return true;
+    }
+
+    // stock:<type> or stock:<type>:<id>
+    std::istringstream stream(topic);
+    std::string family, type, id, rest;
+    std::getline(stream, family, ':');
+    std::getline(stream, type, ':');
+    bool hasId = static_cast<bool>(std::getline(stream, id, ':'));
+    if (family != EVENT_TOPIC_STOCK || (type != "hub" && type != "warehouse") || std::getline(stream, rest))
+    {
+        return false;
+    }
+    return !hasId || (!id.empty() && id.size() < 10 && std::all_of(id.begin(), id.end(), [](unsigned char c) {
+                          return std::isdigit(c) != 0;
+                      }));
+}
+
+bool parseSubscription(const std::string& command, std::vector<std::string>& topics, std::string& error)
+{
+    topics.clear();
+
+    std::istringstream stream(command);
+    std::string token;
+    stream >> token;
+    if (token != SUBSCRIBE_COMMAND && token != UNSUBSCRIBE_COMMAND)
+    {
+        return invalidSubscription("Unknown command '" + token + "'.", error);
+    }
+    bool subscribing = token == SUBSCRIBE_COMMAND;
+
+    while (stream >> token)
+    {
+        std::transform(token.begin(), token.end(), token.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (!validTopic(token))
+        {
+            return invalidSubscription("Unknown topic '" + token +
+                                           "'. Use low-stock, restock, stock, stock:<type> or stock:<type>:<id>.",
+                                       error);
+        }
+        if (std::find(topics.begin(), topics.end(), token) == topics.end())
+        {
+            topics.push_back(token);
+        }
+    }
+
+    if (subscribing && topics.empty())
+    {
+        return invalidSubscription("SUBSCRIBE needs at least one topic.", error);
+    }
+    return true;
+}
+
+EventFeed::EventFeed(std::size_t queueMax, std::chrono::milliseconds batchDelay)
+    : queueMax(std::max<std::size_t>(queueMax, 1)), batchDelay(batchDelay)
+{
+}
+
+EventFeed::~EventFeed()
+{
+    stop();
+}
+
+EventFeed& EventFeed::getInstance()
+{
+    static EventFeed instance;
+    return instance;
+}
+
+EventFeed::Key EventFeed::makeKey(int clientId, const std::string& protocol)
+{
+    Key key{clientId, protocol};
+    std::transform(key.second.begin(), key.second.end(), key.second.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+bool EventFeed::covers(const std::set<std::string>& topics, const std::string& topic)
+{
+    // A subscription covers its topic and every topic below it: "stock" covers "stock:hub:1"
+    for (std::size_t end = topic.find(':'); end != std::string::npos; end = topic.find(':', end + 1))
+    {
+        if (topics.count(topic.substr(0, end)) > 0)
+        {
+            return true;
+        }
+    }
+    return topics.count(topic) > 0;
+}
+
+std::vector<std::string> EventFeed::subscribe(int clientId, const std::string& protocol,
+                                              const std::vector<std::string>& topics)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Subscriber& subscriber = clients[makeKey(clientId, protocol)];
+    subscriber.topics.insert(topics.begin(), topics.end());
+    count = clients.size();
+    return std::vector<std::string>(subscriber.topics.begin(), subscriber.topics.end());
+}
+
+std::vector<std::string> EventFeed::unsubscribe(int clientId, const std::string& protocol,
+                                                const std::vector<std::string>& topics)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = clients.find(makeKey(clientId, protocol));
+    if (it == clients.end())
+    {
+        return {};
+    }
+
+    for (const std::string& topic : topics)
+    {
+        it->second.topics.erase(topic);
+    }
+    if (!topics.empty() && !it->second.topics.empty())
+    {
+        return std::vector<std::string>(it->second.topics.begin(), it->second.topics.end());
+    }
+
+    queued -= it->second.queue.size();
+    clients.erase(it);
+    count = clients.size();
+    return {};
+}
+
+void EventFeed::removeClient(int clientId, const std::string& protocol)
+{
+    unsubscribe(clientId, protocol, {});
+}
+
+bool EventFeed::wants(const std::string& topic) const
+{
+    if (count == 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::any_of(clients.begin(), clients.end(),
+                       [&topic](const auto& pair) { return covers(pair.second.topics, topic); });
+}
+
+std::size_t EventFeed::publish(const std::string& topic, const Json::Value& data)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Serialized once, on the publisher thread, and shared by every queue
+    Json::Value event;
+    event["topic"] = topic;
+    event["data"] = data;
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    std::string line = Json::writeString(writer, event);
+
+    std::size_t reached = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& pair : clients)
+        {
+            Subscriber& subscriber = pair.second;
+            if (!covers(subscriber.topics, topic))
+            {
+                continue;
+            }
+
+            // A subscriber that cannot keep up loses its oldest events instead of growing without bound
+            if (subscriber.queue.size() >= queueMax)
+            {
+                subscriber.queue.pop_front();
+                subscriber.dropped++;
+                queued--;
+            }
+            subscriber.queue.push_back(line);
+            queued++;
+            reached++;
+        }
+    }
+
+    if (reached > 0)
+    {
+        ready.notify_one();
+    }
+    return reached;
+}
+
+std::vector<EventBatch> EventFeed::drain()
+{
+    std::vector<EventBatch> batches;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& pair : clients)
+    {
+        Subscriber& subscriber = pair.second;
+        if (subscriber.queue.empty())
+        {
+            continue;
+        }
+
+        std::string message = std::string(EVENT_FRAME_PREFIX) + " " + std::to_string(subscriber.queue.size()) + " " +
+                              std::to_string(subscriber.dropped);
+        for (const std::string& line : subscriber.queue)
+        {
+            message += "\n" + line;
+        }
+        batches.push_back(EventBatch{pair.first.first, pair.first.second, std::move(message)});
+
+        subscriber.queue.clear();
+        subscriber.dropped = 0;
+    }
+    queued = 0;
+    return batches;
+}
+
+bool EventFeed::start(SendFunction send)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (dispatcher.joinable())
+    {
+        return false;
+    }
+
+    stopping = false;
+    dispatcher = std::thread(&EventFeed::run, this, std::move(send));
+    return true;
+}
+
+void EventFeed::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!dispatcher.joinable())
+        {
+            return;
+        }
+        stopping = true;
+    }
+    ready.notify_all();
+    dispatcher.join();
+}
+
+std::size_t EventFeed::subscribers() const
+{
+    return count;
+}
+
+void EventFeed::run(SendFunction send)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        ready.wait(lock, [this]() { return stopping || queued > 0; });
+        // Events published during the delay join the same batch
+        ready.wait_for(lock, batchDelay, [this]() { return stopping; });
+        bool exiting = stopping;
+
+        lock.unlock();
+        for (const EventBatch& batch : drain())
+        {
+            send(batch);
+        }
+        lock.lock();
+
+        if (exiting)
+        {
+            break;
+        }
+    }
+}
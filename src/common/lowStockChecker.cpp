@@ -1,6 +1,7 @@
 #include "lowStockChecker.hpp"
+#include <memory>
 
-bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson, std::string& alertOut)
+bool checkLowStockAlert(InventoryStore& store, const Json::Value& pedidoJson, std::string& alertOut)
 {
     const auto& source = pedidoJson["general_info"]["source"];
     if (source["type"].asString() != "warehouse")
@@ -12,7 +13,7 @@ bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson,
     std::string productName = pedidoJson["general_info"]["action"]["product"]["name"].asString();
     int productId = std::stoi(pedidoJson["general_info"]["action"]["product"]["id"].asString());
 
-    int currentStock = getWarehouseInventory(session, warehouseId, productName);
+    int currentStock = store.getQuantity(LocationType::WAREHOUSE, warehouseId, productName);
 
     if (currentStock == -1)
     {
@@ -22,7 +23,7 @@ bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson,
 
     if (currentStock <= STOCK_THRESHOLD)
     {
-        alertOut = AlertHandler::generateAlert("Low Stock Alert: ", "Stock levels are <= 20 per cent of max capacity",
+        alertOut = AlertHandler::generateAlert(LOW_STOCK_ALERT_NAME, "Stock levels are <= 20 per cent of max capacity",
                                                productId, productName);
         return true;
     }
@@ -30,7 +31,7 @@ bool checkLowStockAlert(mysqlx::Session& session, const Json::Value& pedidoJson,
     return false;
 }
 
-bool reStock(mysqlx::Session& session, const Json::Value& pedidoJson, std::string& alertOut)
+bool reStock(InventoryStore& store, const Json::Value& pedidoJson, std::string& alertOut)
 {
     const auto& source = pedidoJson["general_info"]["source"];
     if (source["type"].asString() != "warehouse")
@@ -42,7 +43,7 @@ bool reStock(mysqlx::Session& session, const Json::Value& pedidoJson, std::strin
     std::string productName = pedidoJson["general_info"]["action"]["product"]["name"].asString();
     int productId = std::stoi(pedidoJson["general_info"]["action"]["product"]["id"].asString());
 
-    int currentStock = getWarehouseInventory(session, warehouseId, productName);
+    int currentStock = store.getQuantity(LocationType::WAREHOUSE, warehouseId, productName);
 
     if (currentStock == -1)
     {
@@ -54,12 +55,12 @@ bool reStock(mysqlx::Session& session, const Json::Value& pedidoJson, std::strin
 
     if (currentStock <= RESTOCK_THRESHOLD)
     {
-        int updateResult = updateWarehouseInventory(session, warehouseId, productName, ammountToRestock);
+        int updateResult = store.addQuantity(LocationType::WAREHOUSE, warehouseId, productName, ammountToRestock);
 
         if (updateResult == 1)
         {
             alertOut = AlertHandler::generateAlert(
-                "Re-stock Alert: ", "Stock replenished to full capacity (1000 units)", productId, productName);
+                RESTOCK_ALERT_NAME, "Stock replenished to full capacity (1000 units)", productId, productName);
             return true;
         }
         else
@@ -71,3 +72,102 @@ bool reStock(mysqlx::Session& session, const Json::Value& pedidoJson, std::strin
 
     return true;
 }
+
+static void publishAlert(const char* topic, const std::string& alert, const std::string& location)
+{
+    EventFeed& feed = EventFeed::getInstance();
+    if (!feed.wants(topic))
+    {
+        return;
+    }
+
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (reader->parse(alert.data(), alert.data() + alert.size(), &root, nullptr))
+    {
+        Json::Value data = root["alert"];
+        data["location"] = location;
+        feed.publish(topic, data);
+    }
+}
+
+std::size_t collectStockAlerts(InventoryStore& store, const Json::Value& pedidoJson, std::vector<std::string>& alerts)
+{
+    const auto& source = pedidoJson["general_info"]["source"];
+    if (source["type"].asString() != "warehouse")
+    {
+        return 0;
+    }
+
+    int warehouseId = std::stoi(source["location"].asString());
+    std::string productName = pedidoJson["general_info"]["action"]["product"]["name"].asString();
+    int productId = std::stoi(pedidoJson["general_info"]["action"]["product"]["id"].asString());
+
+    StockLevelMonitor& monitor = StockLevelMonitor::getInstance();
+    StockCrossing crossing;
+    if (!monitor.take(warehouseId, productName, crossing))
+    {
+        int currentStock = store.getQuantity(LocationType::WAREHOUSE, warehouseId, productName);
+        if (currentStock == -1)
+        {
+            std::cerr << "❌ Error trying to get warehouse inventory" << std::endl;
+            return 0;
+        }
+        monitor.observe(LocationType::WAREHOUSE, warehouseId, productName, currentStock);
+        monitor.take(warehouseId, productName, crossing);
+    }
+
+    // Repeated alerts of the same row are coalesced by the AlertManager
+    AlertManager& alertManager = AlertManager::getInstance();
+    std::string location = "warehouse " + std::to_string(warehouseId);
+    std::string alert;
+    std::size_t before = alerts.size();
+    if (crossing.low && alertManager.submit(location, LOW_STOCK_ALERT_NAME,
+                                            "Stock levels are <= 20 per cent of max capacity", productId,
+                                            productName, alert))
+    {
+        alerts.push_back(alert);
+        publishAlert(EVENT_TOPIC_LOW_STOCK, alert, location);
+    }
+
+    // The re-stock is applied by the scheduler in the background; a row already queued is not requested twice
+    if (crossing.restock && RestockScheduler::getInstance().request(warehouseId, productName) &&
+        alertManager.submit(location, RESTOCK_ALERT_NAME, "Re-stock to full capacity (1000 units) scheduled", productId,
+                            productName, alert))
+    {
+        alerts.push_back(alert);
+        publishAlert(EVENT_TOPIC_RESTOCK, alert, location);
+    }
+
+    return alerts.size() - before;
+}
+
+bool publishAlertSummary(const std::string& summary)
+{
+    Json::Value root;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!reader->parse(summary.data(), summary.data() + summary.size(), &root, nullptr) || !root.isObject() ||
+        !root["alert"].isObject())
+    {
+        return false;
+    }
+
+    std::string name = root["alert"]["name"].asString();
+    const char* topic = name == LOW_STOCK_ALERT_NAME ? EVENT_TOPIC_LOW_STOCK
+                        : name == RESTOCK_ALERT_NAME ? EVENT_TOPIC_RESTOCK
+                                                     : nullptr;
+    if (topic == nullptr)
+    {
+        return false;
+    }
+
+    // Summaries already carry the location they are about
+    EventFeed& feed = EventFeed::getInstance();
+    if (feed.wants(topic))
+    {
+        feed.publish(topic, root["alert"]);
+    }
+    return true;
+}
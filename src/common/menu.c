@@ -263,6 +263,18 @@ void list_connected_clients()
     }
 }
 
+static void read_filter(const char* prompt, char* value, size_t size)
+{
+    printf("%s", prompt);
+    fflush(stdout);
+    if (fgets(value, (int)size, stdin) == NULL)
+    {
+        value[0] = '\0';
+        return;
+    }
+    value[strcspn(value, "\n")] = '\0';
+}
+
 void show_message_reports()
 {
     if (!is_connected)
@@ -271,7 +283,21 @@ void show_message_reports()
         return;
     }
 
-    const char* msg = "SHOW_REPORT";
+    char window[BUFFER_PASS_USER], group[BUFFER_PASS_USER];
+    char msg[BUFFER_SIZE_MENU];
+
+    read_filter("Window (e.g. 30m, 6h, 2d, Enter for all time): ", window, sizeof(window));
+    read_filter("Group by (product/location/priority, Enter for product): ", group, sizeof(group));
+
+    int len = snprintf(msg, sizeof(msg), "SHOW_REPORT");
+    if (window[0] != '\0')
+    {
+        len += snprintf(msg + len, sizeof(msg) - len, " window=%s", window);
+    }
+    if (group[0] != '\0')
+    {
+        snprintf(msg + len, sizeof(msg) - len, " group=%s", group);
+    }
 
     if (option_selected == 1) // UDP
     {
@@ -305,6 +331,125 @@ void show_message_reports()
     }
 }
 
+void query_stock()
+{
+    if (!is_connected)
+    {
+        printf("Error: No active connection.\n");
+        return;
+    }
+
+    char type[BUFFER_PASS_USER], locations[BUFFER_PASS_USER], product[BUFFER_PASS_USER];
+    char msg[BUFFER_SIZE_MENU];
+
+    read_filter("Location type (hub/warehouse, Enter for all): ", type, sizeof(type));
+    read_filter("Location IDs (e.g. 1,2, Enter for all): ", locations, sizeof(locations));
+    read_filter("Product (Enter for all): ", product, sizeof(product));
+
+    int len = snprintf(msg, sizeof(msg), "GET_STOCK");
+    if (type[0] != '\0')
+    {
+        len += snprintf(msg + len, sizeof(msg) - len, " type=%s", type);
+    }
+    if (locations[0] != '\0')
+    {
+        len += snprintf(msg + len, sizeof(msg) - len, " location=%s", locations);
+    }
+    if (product[0] != '\0')
+    {
+        snprintf(msg + len, sizeof(msg) - len, " product=%s", product);
+    }
+
+    if (option_selected == 1) // UDP
+    {
+        ssize_t sent = sendto(sockfd, msg, strlen(msg), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+
+        if (sent < 0)
+        {
+            perror("Error sending GET_STOCK via UDP");
+        }
+        else
+        {
+            printf("Sent GET_STOCK request via UDP.\n");
+        }
+    }
+    else if (option_selected == 2) // TCP
+    {
+        ssize_t sent = send(sockfd, msg, strlen(msg), 0);
+
+        if (sent < 0)
+        {
+            perror("Error sending GET_STOCK via TCP");
+        }
+        else
+        {
+            printf("Sent GET_STOCK request via TCP.\n");
+        }
+    }
+}
+
+void query_orders()
+{
+    if (!is_connected)
+    {
+        printf("Error: No active connection.\n");
+        return;
+    }
+
+    char product[BUFFER_PASS_USER], source[BUFFER_PASS_USER], destination[BUFFER_PASS_USER];
+    char client[BUFFER_PASS_USER], priority[BUFFER_PASS_USER], page[BUFFER_PASS_USER];
+    char msg[BUFFER_SIZE_MENU];
+
+    read_filter("Product (Enter for any): ", product, sizeof(product));
+    read_filter("Source (e.g. warehouse:1, Enter for any): ", source, sizeof(source));
+    read_filter("Destination (e.g. hub:2, Enter for any): ", destination, sizeof(destination));
+    read_filter("Client ID (Enter for any): ", client, sizeof(client));
+    read_filter("Priority (Enter for any): ", priority, sizeof(priority));
+    read_filter("Page (Enter for the newest orders): ", page, sizeof(page));
+
+    int len = snprintf(msg, sizeof(msg), "QUERY_ORDERS");
+    const char* names[] = {"product", "source", "destination", "client", "priority"};
+    const char* values[] = {product, source, destination, client, priority};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (values[i][0] != '\0')
+        {
+            len += snprintf(msg + len, sizeof(msg) - len, " %s=%s", names[i], values[i]);
+        }
+    }
+    if (atoi(page) > 1)
+    {
+        snprintf(msg + len, sizeof(msg) - len, " offset=%d", (atoi(page) - 1) * ORDERS_PER_PAGE);
+    }
+
+    if (option_selected == 1) // UDP
+    {
+        ssize_t sent = sendto(sockfd, msg, strlen(msg), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
+
+        if (sent < 0)
+        {
+            perror("Error sending QUERY_ORDERS via UDP");
+        }
+        else
+        {
+            printf("Sent QUERY_ORDERS request via UDP.\n");
+        }
+    }
+    else if (option_selected == 2) // TCP
+    {
+        ssize_t sent = send(sockfd, msg, strlen(msg), 0);
+
+        if (sent < 0)
+        {
+            perror("Error sending QUERY_ORDERS via TCP");
+        }
+        else
+        {
+            printf("Sent QUERY_ORDERS request via TCP.\n");
+        }
+    }
+}
+
 void disconnect()
 {
     if (is_connected)
@@ -423,9 +568,11 @@ void show_connected_menu()
         printf("1. Send message\n");
         printf("2. View connected clients\n");
         printf("3. Show message reports\n");
-        printf("4. Log out\n");
-        printf("5. Disconnect\n");
-        printf("Choose an option (1-5): ");
+        printf("4. Query stock\n");
+        printf("5. Query orders\n");
+        printf("6. Log out\n");
+        printf("7. Disconnect\n");
+        printf("Choose an option (1-7): ");
         fflush(stdout);
 
         option = get_int_input(1, DISCONNECT);
@@ -442,6 +589,12 @@ void show_connected_menu()
             show_message_reports();
             break;
         case 4:
+            query_stock();
+            break;
+        case 5:
+            query_orders();
+            break;
+        case 6:
             logout();
             if (!is_logged_in && is_connected)
             {
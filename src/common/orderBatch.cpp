@@ -0,0 +1,217 @@
+#include "orderBatch.hpp"
+#include "orderValidation.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ORDER_BATCH_X86 1
+#endif
+
+static_assert(ORDER_RULE_PRODUCT_CLASSES == 2, "The vector loops compute the cell as client * 2 + critical");
+
+BatchIsa detectBatchIsa()
+{
+#ifdef ORDER_BATCH_X86
+    return __builtin_cpu_supports("avx2") ? BatchIsa::AVX2 : BatchIsa::SSE2;
+#else
+    return BatchIsa::SCALAR;
+#endif
+}
+
+void OrderBatch::add(int client, bool isCritical, int quantity)
+{
+    clients.push_back(client);
+    critical.push_back(isCritical);
+    quantities.push_back(quantity);
+}
+
+void OrderBatch::add(const OrderRuleTable& rules, std::string_view clientType, bool isCritical, int quantity)
+{
+    add(rules.clientIndex(clientType), isCritical, quantity);
+}
+
+void OrderBatch::reserve(std::size_t orders)
+{
+    clients.reserve(orders);
+    critical.reserve(orders);
+    quantities.reserve(orders);
+}
+
+void OrderBatch::clear()
+{
+    clients.clear();
+    critical.clear();
+    quantities.clear();
+}
+
+static std::size_t validateScalar(const OrderRuleTable& rules, const OrderBatch& batch, std::size_t from,
+                                  OrderBatchResult& result)
+{
+    std::size_t failed = 0;
+    for (std::size_t i = from; i < batch.size(); i++)
+    {
+        int client = batch.clients[i];
+        int code;
+        if (batch.quantities[i] <= 0)
+        {
+            code = ERR_INVALID_VALUES;
+        }
+        else if (client < 0 || static_cast<std::size_t>(client) >= rules.clientCount())
+        {
+            code = ERR_UNKNOWN_CLIENT_TYPE;
+        }
+        else
+        {
+            code = rules.check(static_cast<std::size_t>(client), batch.critical[i] != 0, batch.quantities[i]).code;
+        }
+
+        result.errors[i] = code;
+        result.passed[i / 64] |= static_cast<std::uint64_t>(code == 0) << (i % 64);
+        failed += code != 0;
+    }
+    return failed;
+}
+
+#ifdef ORDER_BATCH_X86
+/**
+ * @struct RuleColumns
+ * @brief The cells of a rule table as flat arrays the vector loops can index.
+ */
+struct RuleColumns
+{
+    std::int32_t clients;             /**< Number of client types. */
+    std::vector<std::int32_t> mins;   /**< Minimum per cell. */
+    std::vector<std::int32_t> maxs;   /**< Maximum per cell. */
+    std::vector<std::int32_t> below;  /**< Error below the minimum per cell. */
+    std::vector<std::int32_t> above;  /**< Error above the maximum per cell. */
+};
+
+static RuleColumns columnsOf(const OrderRuleTable& rules)
+{
+    RuleColumns columns;
+    columns.clients = static_cast<std::int32_t>(rules.clientCount());
+    for (std::size_t client = 0; client < rules.clientCount(); client++)
+    {
+        for (bool critical : {false, true})
+        {
+            const QuantityRule& rule = rules.rule(client, critical);
+            columns.mins.push_back(rule.min);
+            columns.maxs.push_back(rule.max);
+            columns.below.push_back(rule.errors[1]);
+            columns.above.push_back(rule.errors[2]);
+        }
+    }
+    return columns;
+}
+
+static std::size_t validateSse2(const RuleColumns& columns, const OrderBatch& batch, std::size_t& done,
+                                OrderBatchResult& result)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i clientCount = _mm_set1_epi32(columns.clients);
+    const __m128i invalidValues = _mm_set1_epi32(ERR_INVALID_VALUES);
+    const __m128i unknownClient = _mm_set1_epi32(ERR_UNKNOWN_CLIENT_TYPE);
+
+    std::size_t failed = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= batch.size(); i += 4)
+    {
+        __m128i quantity = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.quantities[i]));
+        __m128i client = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.clients[i]));
+        __m128i critical = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&batch.critical[i]));
+
+        // Unknown clients read cell 0, their error is replaced below
+        __m128i known = _mm_andnot_si128(_mm_cmpgt_epi32(zero, client), _mm_cmpgt_epi32(clientCount, client));
+        __m128i criticalBit = _mm_andnot_si128(_mm_cmpeq_epi32(critical, zero), one);
+        __m128i cell = _mm_and_si128(known, _mm_add_epi32(_mm_slli_epi32(client, 1), criticalBit));
+
+        // SSE2 has no gather: the cells are read one by one and the comparisons run on all lanes
+        alignas(16) std::int32_t cells[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(cells), cell);
+        __m128i min = _mm_setr_epi32(columns.mins[cells[0]], columns.mins[cells[1]], columns.mins[cells[2]],
+                                     columns.mins[cells[3]]);
+        __m128i max = _mm_setr_epi32(columns.maxs[cells[0]], columns.maxs[cells[1]], columns.maxs[cells[2]],
+                                     columns.maxs[cells[3]]);
+        __m128i below = _mm_setr_epi32(columns.below[cells[0]], columns.below[cells[1]], columns.below[cells[2]],
+                                       columns.below[cells[3]]);
+        __m128i above = _mm_setr_epi32(columns.above[cells[0]], columns.above[cells[1]], columns.above[cells[2]],
+                                       columns.above[cells[3]]);
+
+        __m128i code = _mm_or_si128(_mm_and_si128(_mm_cmpgt_epi32(min, quantity), below),
+                                    _mm_and_si128(_mm_cmpgt_epi32(quantity, max), above));
+        code = _mm_or_si128(_mm_and_si128(known, code), _mm_andnot_si128(known, unknownClient));
+        __m128i positive = _mm_cmpgt_epi32(quantity, zero);
+        code = _mm_or_si128(_mm_and_si128(positive, code), _mm_andnot_si128(positive, invalidValues));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&result.errors[i]), code);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(code, zero))));
+        result.passed[i / 64] |= static_cast<std::uint64_t>(mask) << (i % 64);
+        failed += 4 - static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    done = i;
+    return failed;
+}
+
+__attribute__((target("avx2"))) static std::size_t validateAvx2(const RuleColumns& columns, const OrderBatch& batch,
+                                                                std::size_t& done, OrderBatchResult& result)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i clientCount = _mm256_set1_epi32(columns.clients);
+    const __m256i invalidValues = _mm256_set1_epi32(ERR_INVALID_VALUES);
+    const __m256i unknownClient = _mm256_set1_epi32(ERR_UNKNOWN_CLIENT_TYPE);
+
+    std::size_t failed = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= batch.size(); i += 8)
+    {
+        __m256i quantity = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.quantities[i]));
+        __m256i client = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.clients[i]));
+        __m256i critical = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.critical[i]));
+
+        __m256i known =
+            _mm256_andnot_si256(_mm256_cmpgt_epi32(zero, client), _mm256_cmpgt_epi32(clientCount, client));
+        __m256i criticalBit = _mm256_andnot_si256(_mm256_cmpeq_epi32(critical, zero), one);
+        __m256i cell = _mm256_and_si256(known, _mm256_add_epi32(_mm256_slli_epi32(client, 1), criticalBit));
+
+        __m256i min = _mm256_i32gather_epi32(columns.mins.data(), cell, 4);
+        __m256i max = _mm256_i32gather_epi32(columns.maxs.data(), cell, 4);
+        __m256i below = _mm256_i32gather_epi32(columns.below.data(), cell, 4);
+        __m256i above = _mm256_i32gather_epi32(columns.above.data(), cell, 4);
+
+        __m256i code = _mm256_or_si256(_mm256_and_si256(_mm256_cmpgt_epi32(min, quantity), below),
+                                       _mm256_and_si256(_mm256_cmpgt_epi32(quantity, max), above));
+        code = _mm256_blendv_epi8(unknownClient, code, known);
+        code = _mm256_blendv_epi8(invalidValues, code, _mm256_cmpgt_epi32(quantity, zero));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&result.errors[i]), code);
+        unsigned mask =
+            static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(code, zero))));
+        result.passed[i / 64] |= static_cast<std::uint64_t>(mask) << (i % 64);
+        failed += 8 - static_cast<std::size_t>(__builtin_popcount(mask));
+    }
+    done = i;
+    return failed;
+}
+#endif
+
+void validateOrderBatch(const OrderRuleTable& rules, const OrderBatch& batch, OrderBatchResult& result, BatchIsa isa)
+{
+    result.passed.assign((batch.size() + 63) / 64, 0);
+    result.errors.assign(batch.size(), 0);
+    result.failed = 0;
+
+    std::size_t done = 0;
+    isa = std::min(isa, detectBatchIsa());
+#ifdef ORDER_BATCH_X86
+    if (isa != BatchIsa::SCALAR)
+    {
+        RuleColumns columns = columnsOf(rules);
+        result.failed = isa == BatchIsa::AVX2 ? validateAvx2(columns, batch, done, result)
+                                              : validateSse2(columns, batch, done, result);
+    }
+#endif
+    // The orders left over by the vector loop, or all of them without one
+    result.failed += validateScalar(rules, batch, done, result);
+}
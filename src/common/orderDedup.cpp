@@ -0,0 +1,192 @@
+#include "orderDedup.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+OrderDedupConfig loadOrderDedupConfig()
+{
+    OrderDedupConfig config;
+
+    const char* ttl = std::getenv("ORDER_DEDUP_TTL_SECONDS");
+    if (ttl != nullptr)
+    {
+        try
+        {
+            config.ttl = std::chrono::seconds(std::max(1, std::stoi(ttl)));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_DEDUP_TTL_SECONDS, using " << config.ttl.count() << std::endl;
+        }
+    }
+
+    const char* expected = std::getenv("ORDER_DEDUP_EXPECTED_ORDERS");
+    if (expected != nullptr)
+    {
+        try
+        {
+            config.expectedOrders = static_cast<std::size_t>(std::max(1, std::stoi(expected)));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_DEDUP_EXPECTED_ORDERS, using " << config.expectedOrders << std::endl;
+        }
+    }
+
+    return config;
+}
+
+BloomFilter::BloomFilter(std::size_t expected)
+    : words((std::max<std::size_t>(expected, 1) * ORDER_DEDUP_BLOOM_BITS_PER_ORDER + 63) / 64)
+{
+}
+
+void BloomFilter::add(std::uint64_t hash)
+{
+    // Double hashing: the k bit positions are h1 + i * h2, with h2 odd so they never collapse
+    std::uint64_t bits = words.size() * 64;
+    std::uint64_t step = ((hash >> 32) | (hash << 32)) * 0x9e3779b97f4a7c15ull | 1;
+    for (int i = 0; i < ORDER_DEDUP_BLOOM_HASHES; i++, hash += step)
+    {
+        std::uint64_t bit = hash % bits;
+        words[bit / 64] |= 1ull << (bit % 64);
+    }
+}
+
+bool BloomFilter::mightContain(std::uint64_t hash) const
+{
+    std::uint64_t bits = words.size() * 64;
+    std::uint64_t step = ((hash >> 32) | (hash << 32)) * 0x9e3779b97f4a7c15ull | 1;
+    for (int i = 0; i < ORDER_DEDUP_BLOOM_HASHES; i++, hash += step)
+    {
+        std::uint64_t bit = hash % bits;
+        if (!(words[bit / 64] & (1ull << (bit % 64))))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+OrderDedup::OrderDedup(const OrderDedupConfig& config)
+    : config(config), current(config.expectedOrders), previous(config.expectedOrders),
+      rotated(std::chrono::steady_clock::now())
+{
+}
+
+OrderDedup& OrderDedup::getInstance()
+{
+    static OrderDedup instance(loadOrderDedupConfig());
+    return instance;
+}
+
+std::string OrderDedup::makeKey(int clientId, const std::string& protocol, const std::string& id)
+{
+    if (id.empty())
+    {
+        return "";
+    }
+    return protocol + ":" + std::to_string(clientId) + ":" + id;
+}
+
+void OrderDedup::rotateLocked(std::chrono::steady_clock::time_point now)
+{
+    if (now - rotated < config.ttl)
+    {
+        return;
+    }
+
+    std::swap(current, previous);
+    current.clear();
+    rotated = now;
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        it = it->second.expires <= now ? entries.erase(it) : std::next(it);
+    }
+}
+
+DedupState OrderDedup::begin(const std::string& id, std::vector<std::string>& replies)
+{
+    std::uint64_t hash = std::hash<std::string>()(id);
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    rotateLocked(now);
+
+    if (current.mightContain(hash) || previous.mightContain(hash))
+    {
+        auto it = entries.find(id);
+        if (it != entries.end() && it->second.expires > now)
+        {
+            if (!it->second.done)
+            {
+                return DedupState::PENDING;
+            }
+            replies = it->second.replies;
+            return DedupState::DONE;
+        }
+    }
+
+    current.add(hash);
+    Entry& entry = entries[id];
+    entry = Entry();
+    entry.expires = now + config.ttl;
+    return DedupState::NEW;
+}
+
+void OrderDedup::record(const std::string& id, const std::string& reply)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(id);
+    if (it != entries.end())
+    {
+        it->second.replies.push_back(reply);
+    }
+}
+
+void OrderDedup::finish(const std::string& id)
+{
+    if (id.empty())
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(id);
+    if (it != entries.end() && it->second.replies.empty())
+    {
+        // A retry would be answered with nothing, so it is processed instead
+        entries.erase(it);
+    }
+    else if (it != entries.end())
+    {
+        // Added again so the filter keeps the ID for as long as the entry lives
+        current.add(std::hash<std::string>()(id));
+        it->second.done = true;
+        it->second.expires = now + config.ttl;
+    }
+}
+
+void OrderDedup::forget(const std::string& id)
+{
+    if (id.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(id);
+}
+
+std::size_t OrderDedup::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
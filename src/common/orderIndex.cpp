@@ -0,0 +1,460 @@
+#include "orderIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static bool invalidFilter(const std::string& filter, std::string& error)
+{
+    error = ErrorHandler::generateError(
+        ERR_INVALID_ORDER_QUERY, "Invalid QUERY_ORDERS filter",
+        "Unsupported filter '" + filter +
+            "'. Use product=<name>, source=<type>:<id>, destination=<type>:<id>, client=<id>, priority=<level>, "
+            "offset=<n> and limit=<1-" +
+            std::to_string(ORDER_QUERY_MAX_LIMIT) + ">.",
+        ErrorLevel::ERROR);
+    return false;
+}
+
+static bool parseCount(const std::string& value, std::size_t& count)
+{
+    try
+    {
+        std::size_t consumed = 0;
+        long long parsed = std::stoll(value, &consumed);
+        if (consumed != value.size() || parsed < 0)
+        {
+            return false;
+        }
+        count = static_cast<std::size_t>(parsed);
+        return true;
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+}
+
+bool parseOrderQuery(const std::string& command, OrderQuery& query, std::string& error)
+{
+    query = OrderQuery();
+
+    std::istringstream stream(command);
+    std::string token;
+    stream >> token;
+    if (token != QUERY_ORDERS_COMMAND)
+    {
+        return invalidFilter(token, error);
+    }
+
+    while (stream >> token)
+    {
+        std::size_t separator = token.find('=');
+        if (separator == std::string::npos || separator + 1 == token.size())
+        {
+            return invalidFilter(token, error);
+        }
+
+        std::string key = toLower(token.substr(0, separator));
+        std::string value = token.substr(separator + 1);
+
+        if (key == "product")
+        {
+            query.filters.emplace_back(OrderField::PRODUCT, value);
+        }
+        else if (key == "source" || key == "destination")
+        {
+            // Locations are written "<type>:<id>" so they fit in one token
+            std::size_t colon = value.find(':');
+            if (colon == std::string::npos || colon == 0 || colon + 1 == value.size())
+            {
+                return invalidFilter(token, error);
+            }
+            query.filters.emplace_back(key == "source" ? OrderField::SOURCE : OrderField::DESTINATION,
+                                       value.substr(0, colon) + " " + value.substr(colon + 1));
+        }
+        else if (key == "client")
+        {
+            std::size_t client;
+            if (!parseCount(value, client))
+            {
+                return invalidFilter(token, error);
+            }
+            query.filters.emplace_back(OrderField::CLIENT, std::to_string(client));
+        }
+        else if (key == "priority")
+        {
+            query.filters.emplace_back(OrderField::PRIORITY, value);
+        }
+        else if (key == "offset")
+        {
+            if (!parseCount(value, query.offset))
+            {
+                return invalidFilter(token, error);
+            }
+        }
+        else if (key == "limit")
+        {
+            if (!parseCount(value, query.limit) || query.limit == 0 || query.limit > ORDER_QUERY_MAX_LIMIT)
+            {
+                return invalidFilter(token, error);
+            }
+        }
+        else
+        {
+            return invalidFilter(token, error);
+        }
+    }
+    return true;
+}
+
+void PostingList::append(std::uint64_t delta)
+{
+    while (delta >= 0x80)
+    {
+        data.push_back(static_cast<unsigned char>(delta | 0x80));
+        delta >>= 7;
+    }
+    data.push_back(static_cast<unsigned char>(delta));
+}
+
+void PostingList::add(std::uint64_t sequence)
+{
+    if (sequence > last || count == 0)
+    {
+        append(sequence - last);
+        last = sequence;
+        count++;
+        return;
+    }
+
+    // Late numbers land near the end, so walk the deltas back from the last number and re-encode only the ones after it
+    std::vector<std::uint64_t> after;
+    std::size_t offset = data.size();
+    std::uint64_t value = last;
+    while (offset > 0 && value > sequence)
+    {
+        std::size_t start = varintStart(offset);
+        std::uint64_t delta;
+        readVarint(start, delta);
+        after.push_back(value);
+        value -= delta;
+        offset = start;
+    }
+    if (offset > 0 && value == sequence)
+    {
+        return;
+    }
+
+    data.resize(offset);
+    append(sequence - value);
+    value = sequence;
+    for (auto it = after.rbegin(); it != after.rend(); ++it)
+    {
+        append(*it - value);
+        value = *it;
+    }
+    count++;
+}
+
+std::size_t PostingList::varintStart(std::size_t end) const
+{
+    // Only the last byte of a varint has the high bit clear
+    std::size_t start = end - 1;
+    while (start > 0 && (data[start - 1] & 0x80))
+    {
+        start--;
+    }
+    return start;
+}
+
+std::size_t PostingList::readVarint(std::size_t offset, std::uint64_t& value) const
+{
+    value = 0;
+    for (int shift = 0; offset < data.size(); shift += 7)
+    {
+        unsigned char byte = data[offset++];
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            break;
+        }
+    }
+    return offset;
+}
+
+std::vector<std::uint64_t> PostingList::decode() const
+{
+    std::vector<std::uint64_t> sequences;
+    sequences.reserve(count);
+    std::uint64_t value = 0;
+    for (std::size_t offset = 0; offset < data.size();)
+    {
+        std::uint64_t delta;
+        offset = readVarint(offset, delta);
+        value += delta;
+        sequences.push_back(value);
+    }
+    return sequences;
+}
+
+std::size_t PostingList::size() const
+{
+    return count;
+}
+
+std::size_t PostingList::bytes() const
+{
+    return data.size();
+}
+
+void PostingList::extend(const PostingList& later)
+{
+    if (later.count == 0)
+    {
+        return;
+    }
+    if (count == 0)
+    {
+        *this = later;
+        return;
+    }
+
+    // The first delta of the later list is its first number; re-encode it relative to our last one
+    std::uint64_t first;
+    std::size_t firstLength = later.readVarint(0, first);
+    append(first - last);
+    data.insert(data.end(), later.data.begin() + static_cast<std::ptrdiff_t>(firstLength), later.data.end());
+    last = later.last;
+    count += later.count;
+}
+
+void PostingList::dropBefore(std::uint64_t sequence)
+{
+    if (count == 0 || last < sequence)
+    {
+        *this = PostingList();
+        return;
+    }
+
+    std::uint64_t first;
+    readVarint(0, first);
+    if (first >= sequence)
+    {
+        return;
+    }
+
+    std::vector<std::uint64_t> sequences = decode();
+    PostingList kept;
+    for (auto it = std::lower_bound(sequences.begin(), sequences.end(), sequence); it != sequences.end(); ++it)
+    {
+        kept.add(*it);
+    }
+    *this = std::move(kept);
+}
+
+void PostingList::save(SnapshotWriter& writer) const
+{
+    writer.putU64(count);
+    writer.putU64(last);
+    writer.putString(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+}
+
+bool PostingList::load(SnapshotReader& reader)
+{
+    std::uint64_t entries;
+    std::string encoded;
+    if (!reader.getU64(entries) || !reader.getU64(last) || !reader.getString(encoded))
+    {
+        return false;
+    }
+    count = static_cast<std::size_t>(entries);
+    data.assign(encoded.begin(), encoded.end());
+    return true;
+}
+
+OrderIndex& OrderIndex::getInstance()
+{
+    static OrderIndex instance;
+    return instance;
+}
+
+std::string OrderIndex::normalize(const std::string& value)
+{
+    return toLower(value);
+}
+
+void OrderIndex::addLocked(OrderField field, const std::string& value, std::uint64_t sequence)
+{
+    if (!value.empty())
+    {
+        fields[static_cast<std::size_t>(field)][normalize(value)].add(sequence);
+    }
+}
+
+void OrderIndex::add(std::uint64_t sequence, std::uint32_t client, const OrderFacts& facts)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    all.add(sequence);
+    addLocked(OrderField::PRODUCT, facts.product, sequence);
+    addLocked(OrderField::SOURCE, facts.source, sequence);
+    addLocked(OrderField::DESTINATION, facts.location, sequence);
+    addLocked(OrderField::CLIENT, client != 0 ? std::to_string(client) : "", sequence);
+    addLocked(OrderField::PRIORITY, facts.priority, sequence);
+}
+
+std::vector<std::uint64_t> OrderIndex::find(const std::vector<std::pair<OrderField, std::string>>& filters) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (filters.empty())
+    {
+        return all.decode();
+    }
+
+    // Start from the shortest list so every intersection is at most that long
+    std::vector<const PostingList*> lists;
+    for (const auto& filter : filters)
+    {
+        const auto& values = fields[static_cast<std::size_t>(filter.first)];
+        auto it = values.find(normalize(filter.second));
+        if (it == values.end())
+        {
+            return {};
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+
+    std::vector<std::uint64_t> result = lists.front()->decode();
+    for (std::size_t i = 1; i < lists.size() && !result.empty(); i++)
+    {
+        std::vector<std::uint64_t> other = lists[i]->decode();
+        std::vector<std::uint64_t> merged;
+        std::set_intersection(result.begin(), result.end(), other.begin(), other.end(), std::back_inserter(merged));
+        result.swap(merged);
+    }
+    return result;
+}
+
+std::size_t OrderIndex::bytes() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::size_t total = all.bytes();
+    for (const auto& values : fields)
+    {
+        for (const auto& entry : values)
+        {
+            total += entry.second.bytes();
+        }
+    }
+    return total;
+}
+
+void OrderIndex::clear()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (auto& values : fields)
+    {
+        values.clear();
+    }
+    all = PostingList();
+}
+
+void OrderIndex::extend(const OrderIndex& later)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    std::shared_lock<std::shared_mutex> laterLock(later.mutex);
+    all.extend(later.all);
+    for (std::size_t field = 0; field < fields.size(); field++)
+    {
+        for (const auto& entry : later.fields[field])
+        {
+            fields[field][entry.first].extend(entry.second);
+        }
+    }
+}
+
+void OrderIndex::dropBefore(std::uint64_t sequence)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    all.dropBefore(sequence);
+    for (auto& values : fields)
+    {
+        for (auto it = values.begin(); it != values.end();)
+        {
+            it->second.dropBefore(sequence);
+            it = it->second.size() == 0 ? values.erase(it) : std::next(it);
+        }
+    }
+}
+
+void OrderIndex::save(SnapshotWriter& writer) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    all.save(writer);
+    for (const auto& values : fields)
+    {
+        writer.putU64(values.size());
+        for (const auto& entry : values)
+        {
+            writer.putString(entry.first);
+            entry.second.save(writer);
+        }
+    }
+}
+
+bool OrderIndex::load(SnapshotReader& reader)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!all.load(reader))
+    {
+        return false;
+    }
+    for (auto& values : fields)
+    {
+        values.clear();
+        std::uint64_t count;
+        if (!reader.getU64(count))
+        {
+            return false;
+        }
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            std::string value;
+            if (!reader.getString(value) || !values[value].load(reader))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string formatOrderPage(const OrderQuery& query, const OrderPage& page)
+{
+    if (page.orders.empty())
+    {
+        return page.total == 0 ? "No orders match the query.\n"
+                               : "No orders past offset " + std::to_string(query.offset) + " (" +
+                                     std::to_string(page.total) + " matches).\n";
+    }
+
+    std::ostringstream msgStream;
+    msgStream << "\n----- Orders " << query.offset + 1 << "-" << query.offset + page.orders.size() << " of "
+              << page.total << " -----\n";
+    for (const auto& order : page.orders)
+    {
+        msgStream << "[" << order.first << "] " << order.second << "\n";
+    }
+    msgStream << "-------------------------";
+    return msgStream.str();
+}
@@ -0,0 +1,1274 @@
+#include "orderJournal.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zdict.h>
+#include <zstd.h>
+
+namespace fs = std::filesystem;
+
+/**
+ * @struct RecordHeader
+ * @brief On-disk header of a journal record (see orderJournal.hpp).
+ */
+struct RecordHeader
+{
+    std::uint32_t magic;    /**< ORDER_JOURNAL_MAGIC. */
+    std::uint32_t length;   /**< Payload length in bytes. */
+    std::uint32_t checksum; /**< CRC-32 of sequence, timestamp and payload. */
+    std::uint32_t client;   /**< ID of the sending client, 0 if none. */
+    std::uint64_t sequence; /**< Sequence number. */
+    std::int64_t timestamp; /**< Milliseconds since the epoch. */
+};
+
+static_assert(sizeof(RecordHeader) == 32, "journal record header must be 32 bytes");
+
+/**
+ * @struct SnapshotHeader
+ * @brief On-disk header of the snapshot file (see orderJournal.hpp).
+ */
+struct SnapshotHeader
+{
+    std::uint32_t magic;    /**< ORDER_SNAPSHOT_MAGIC. */
+    std::uint32_t checksum; /**< CRC-32 of the state. */
+    std::uint64_t sequence; /**< Last record included in the state. */
+    std::uint64_t length;   /**< State length in bytes. */
+};
+
+static_assert(sizeof(SnapshotHeader) == 24, "snapshot header must be 24 bytes");
+
+static bool readSnapshotHeader(std::ifstream& file, SnapshotHeader& header)
+{
+    return file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == ORDER_SNAPSHOT_MAGIC;
+}
+
+static const char* SEGMENT_EXTENSION = ".seg";
+static const char* COMPRESSED_EXTENSION = ".zst";
+static const char* TEMPORARY_EXTENSION = ".tmp";
+
+// Below this many records a segment is compressed without training a dictionary
+static const std::size_t DICT_MIN_SAMPLES = 64;
+
+static std::uint32_t crc32Update(std::uint32_t crc, const void* data, std::size_t length)
+{
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t i = 0; i < 256; i++)
+        {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            values[i] = value;
+        }
+        return values;
+    }();
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < length; i++)
+    {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static std::uint32_t recordChecksum(const RecordHeader& header, const void* payload)
+{
+    std::uint32_t crc = 0xFFFFFFFFu;
+    crc = crc32Update(crc, &header.sequence, sizeof(header.sequence) + sizeof(header.timestamp));
+    crc = crc32Update(crc, payload, header.length);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static std::size_t recordSize(std::size_t payloadLength)
+{
+    return (sizeof(RecordHeader) + payloadLength + 7) & ~static_cast<std::size_t>(7);
+}
+
+/**
+ * @struct MappedFile
+ * @brief Read-only mapping of a sealed segment, released on destruction.
+ */
+struct MappedFile
+{
+    unsigned char* data = nullptr; /**< Mapped bytes, or nullptr. */
+    std::size_t length = 0;        /**< Mapped length. */
+
+    explicit MappedFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void* mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = static_cast<unsigned char*>(mapped);
+                length = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (data != nullptr)
+        {
+            munmap(data, length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// Writes a whole file under a temporary name and renames it, so readers never see it half written
+static bool writeFileAtomically(const std::string& path, const void* data, std::size_t length, bool durable)
+{
+    std::string tmpPath = path + TEMPORARY_EXTENSION;
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    const char* cursor = static_cast<const char*>(data);
+    std::size_t remaining = length;
+    while (remaining > 0)
+    {
+        ssize_t written = write(fd, cursor, remaining);
+        if (written < 0)
+        {
+            ::close(fd);
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        cursor += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+    if (durable)
+    {
+        fsync(fd);
+    }
+    ::close(fd);
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+OrderJournalConfig loadOrderJournalConfig()
+{
+    OrderJournalConfig config;
+
+    const char* directory = std::getenv("ORDER_JOURNAL_DIR");
+    if (directory != nullptr && *directory != '\0')
+    {
+        config.directory = directory;
+    }
+
+    const char* segmentBytes = std::getenv("ORDER_JOURNAL_SEGMENT_BYTES");
+    if (segmentBytes != nullptr)
+    {
+        try
+        {
+            config.segmentBytes = std::stoull(segmentBytes);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_SEGMENT_BYTES, using " << config.segmentBytes << std::endl;
+        }
+    }
+
+    const char* sync = std::getenv("ORDER_JOURNAL_FSYNC");
+    if (sync != nullptr)
+    {
+        std::string policy(sync);
+        if (policy == "always")
+        {
+            config.sync = JournalSync::ALWAYS;
+        }
+        else if (policy == "never")
+        {
+            config.sync = JournalSync::NEVER;
+        }
+    }
+
+    const char* syncMs = std::getenv("ORDER_JOURNAL_FSYNC_MS");
+    if (syncMs != nullptr)
+    {
+        try
+        {
+            config.syncIntervalMs = std::max(0, std::stoi(syncMs));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_FSYNC_MS, using " << config.syncIntervalMs << std::endl;
+        }
+    }
+
+    const char* compress = std::getenv("ORDER_JOURNAL_COMPRESS");
+    if (compress != nullptr && std::string(compress) == "0")
+    {
+        config.compress = false;
+    }
+
+    const char* level = std::getenv("ORDER_JOURNAL_ZSTD_LEVEL");
+    if (level != nullptr)
+    {
+        try
+        {
+            config.compressionLevel = std::stoi(level);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_ZSTD_LEVEL, using " << config.compressionLevel << std::endl;
+        }
+    }
+
+    const char* hotSegments = std::getenv("ORDER_JOURNAL_HOT_SEGMENTS");
+    if (hotSegments != nullptr)
+    {
+        try
+        {
+            config.hotSegments = std::max(0, std::stoi(hotSegments));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_HOT_SEGMENTS, using " << config.hotSegments << std::endl;
+        }
+    }
+
+    const char* retentionBytes = std::getenv("ORDER_JOURNAL_RETENTION_BYTES");
+    if (retentionBytes != nullptr)
+    {
+        try
+        {
+            config.retentionBytes = std::stoull(retentionBytes);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_RETENTION_BYTES, using " << config.retentionBytes << std::endl;
+        }
+    }
+
+    const char* retentionHours = std::getenv("ORDER_JOURNAL_RETENTION_HOURS");
+    if (retentionHours != nullptr)
+    {
+        try
+        {
+            config.retentionHours = std::max(0, std::stoi(retentionHours));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_JOURNAL_RETENTION_HOURS, using " << config.retentionHours << std::endl;
+        }
+    }
+
+    return config;
+}
+
+OrderJournal::~OrderJournal()
+{
+    close();
+}
+
+OrderJournal& OrderJournal::getInstance()
+{
+    static OrderJournal instance;
+    return instance;
+}
+
+std::string OrderJournal::segmentPath(const std::string& directory, std::uint64_t firstSequence, bool compressed)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu", static_cast<unsigned long long>(firstSequence));
+    return (fs::path(directory) / (std::string(name) + (compressed ? COMPRESSED_EXTENSION : SEGMENT_EXTENSION)))
+        .string();
+}
+
+std::size_t OrderJournal::scan(const unsigned char* data, std::size_t length, std::uint64_t firstSequence,
+                               const RecordVisitor* visitor, std::uint64_t& records)
+{
+    std::size_t offset = 0;
+    records = 0;
+    while (offset + sizeof(RecordHeader) <= length)
+    {
+        RecordHeader header;
+        std::memcpy(&header, data + offset, sizeof(header));
+        if (header.magic != ORDER_JOURNAL_MAGIC || header.length > length - offset - sizeof(RecordHeader) ||
+            header.sequence != firstSequence + records)
+        {
+            break;
+        }
+
+        const unsigned char* payload = data + offset + sizeof(RecordHeader);
+        if (recordChecksum(header, payload) != header.checksum)
+        {
+            break;
+        }
+
+        if (visitor != nullptr)
+        {
+            (*visitor)(OrderRecord{header.sequence, header.timestamp, header.client,
+                                   std::string_view(reinterpret_cast<const char*>(payload), header.length)});
+        }
+        offset += std::min(recordSize(header.length), length - offset);
+        records++;
+    }
+    return offset;
+}
+
+bool OrderJournal::readSegment(const Segment& segment, const std::string& dictionary, std::string& contents)
+{
+    MappedFile file(segment.path);
+    if (file.data == nullptr)
+    {
+        return false;
+    }
+    if (!segment.compressed)
+    {
+        contents.assign(reinterpret_cast<const char*>(file.data), std::min(file.length, segment.usedBytes));
+        return true;
+    }
+
+    unsigned long long length = ZSTD_getFrameContentSize(file.data, file.length);
+    if (length == ZSTD_CONTENTSIZE_ERROR || length == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+        std::cerr << "❌ Order journal segment " << segment.path << " is not a valid zstd frame" << std::endl;
+        return false;
+    }
+
+    // Frames compressed before the dictionary was trained carry no dictionary ID
+    bool usesDictionary = ZSTD_getDictID_fromFrame(file.data, file.length) != 0;
+    if (usesDictionary && dictionary.empty())
+    {
+        std::cerr << "❌ Missing " << ORDER_JOURNAL_DICT_FILE << " to read " << segment.path << std::endl;
+        return false;
+    }
+
+    contents.resize(static_cast<std::size_t>(length));
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    std::size_t result =
+        ZSTD_decompress_usingDict(context, contents.data(), contents.size(), file.data, file.length,
+                                  usesDictionary ? dictionary.data() : nullptr, usesDictionary ? dictionary.size() : 0);
+    ZSTD_freeDCtx(context);
+    if (ZSTD_isError(result) || result != contents.size())
+    {
+        std::cerr << "❌ Could not decompress order journal segment " << segment.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool OrderJournal::loadDictionary()
+{
+    dictionary.clear();
+    std::string path = (fs::path(config.directory) / ORDER_JOURNAL_DICT_FILE).string();
+    MappedFile file(path);
+    if (file.data != nullptr)
+    {
+        if (ZSTD_getDictID_fromDict(file.data, file.length) == 0)
+        {
+            std::cerr << "❌ Invalid order journal dictionary " << path << std::endl;
+            return false;
+        }
+        dictionary.assign(reinterpret_cast<const char*>(file.data), file.length);
+    }
+    return true;
+}
+
+bool OrderJournal::compressSegment(const Segment& segment, std::string& tmpPath)
+{
+    std::string contents;
+    if (!readSegment(segment, dictionary, contents))
+    {
+        return false;
+    }
+
+    // Only this thread writes the dictionary, so reading it unlocked is safe
+    std::string trained = dictionary;
+    if (trained.empty())
+    {
+        std::string samples;
+        std::vector<std::size_t> sampleSizes;
+        RecordVisitor collect = [&samples, &sampleSizes](const OrderRecord& record) {
+            samples.append(record.payload);
+            sampleSizes.push_back(record.payload.size());
+        };
+        std::uint64_t records = 0;
+        scan(reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), segment.firstSequence,
+             &collect, records);
+
+        if (sampleSizes.size() >= DICT_MIN_SAMPLES)
+        {
+            trained.resize(ORDER_JOURNAL_DICT_BYTES);
+            std::size_t size = ZDICT_trainFromBuffer(trained.data(), trained.size(), samples.data(),
+                                                     sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+            std::string path = (fs::path(config.directory) / ORDER_JOURNAL_DICT_FILE).string();
+            if (ZDICT_isError(size))
+            {
+                std::cerr << "⚠️ Could not train the order journal dictionary: " << ZDICT_getErrorName(size)
+                          << std::endl;
+                trained.clear();
+            }
+            else if (!writeFileAtomically(path, trained.data(), size, config.sync != JournalSync::NEVER))
+            {
+                std::cerr << "⚠️ Could not write order journal dictionary " << path << std::endl;
+                trained.clear();
+            }
+            else
+            {
+                trained.resize(size);
+                std::lock_guard<std::mutex> lock(mutex);
+                dictionary = trained;
+            }
+        }
+    }
+
+    std::string compressed(ZSTD_compressBound(contents.size()), '\0');
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    std::size_t size = ZSTD_compress_usingDict(context, compressed.data(), compressed.size(), contents.data(),
+                                               contents.size(), trained.empty() ? nullptr : trained.data(),
+                                               trained.size(), std::clamp(config.compressionLevel, 1, ZSTD_maxCLevel()));
+    ZSTD_freeCCtx(context);
+    if (ZSTD_isError(size))
+    {
+        std::cerr << "❌ Could not compress order journal segment " << segment.path << ": " << ZSTD_getErrorName(size)
+                  << std::endl;
+        return false;
+    }
+
+    tmpPath = segmentPath(config.directory, segment.firstSequence, true) + TEMPORARY_EXTENSION;
+    if (!writeFileAtomically(tmpPath, compressed.data(), size, config.sync != JournalSync::NEVER))
+    {
+        std::cerr << "❌ Could not write " << tmpPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void OrderJournal::compressLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping)
+    {
+        // The active segment and the most recent sealed ones stay uncompressed
+        std::size_t hot = static_cast<std::size_t>(config.hotSegments) + 1;
+        auto cold = std::find_if(segments.begin(), segments.end() - std::min(hot, segments.size()),
+                                 [](const Segment& segment) { return !segment.compressed; });
+        if (cold == segments.end() - std::min(hot, segments.size()))
+        {
+            compressWork.wait(lock);
+            continue;
+        }
+
+        Segment segment = *cold;
+        std::uint64_t startGeneration = generation;
+        lock.unlock();
+        std::string tmpPath;
+        bool compressed = compressSegment(segment, tmpPath);
+        lock.lock();
+        if (!compressed)
+        {
+            // Retry when the next segment is sealed rather than spinning on the same failure
+            compressWork.wait(lock);
+            continue;
+        }
+
+        // The journal may have been cleared while the segment was compressed
+        auto current = std::find_if(segments.begin(), segments.end(), [&segment](const Segment& candidate) {
+            return candidate.firstSequence == segment.firstSequence && !candidate.compressed;
+        });
+        std::string compressedPath = segmentPath(config.directory, segment.firstSequence, true);
+        if (generation != startGeneration || current == segments.end() ||
+            std::rename(tmpPath.c_str(), compressedPath.c_str()) != 0)
+        {
+            std::remove(tmpPath.c_str());
+            continue;
+        }
+        // Retention ages segments by modification time, which must stay the time the segment was sealed
+        struct stat sealed;
+        if (stat(segment.path.c_str(), &sealed) == 0)
+        {
+            struct timespec times[2] = {sealed.st_atim, sealed.st_mtim};
+            utimensat(AT_FDCWD, compressedPath.c_str(), times, 0);
+        }
+        std::remove(segment.path.c_str());
+        current->path = compressedPath;
+        current->compressed = true;
+    }
+}
+
+void OrderJournal::syncLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto interval = std::chrono::milliseconds(std::max(config.syncIntervalMs, 1));
+    while (!stopping)
+    {
+        // The last records before traffic stops have no later append to sync them, so the timer does
+        if (syncTimer.wait_until(lock, lastSync + interval, [this]() { return stopping; }))
+        {
+            break;
+        }
+        if (std::chrono::steady_clock::now() - lastSync >= interval)
+        {
+            syncLocked();
+        }
+    }
+}
+
+void OrderJournal::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    compressWork.notify_all();
+    syncTimer.notify_all();
+    if (compressor.joinable())
+    {
+        compressor.join();
+    }
+    if (syncer.joinable())
+    {
+        syncer.join();
+    }
+    stopping = false;
+}
+
+bool OrderJournal::open(const OrderJournalConfig& newConfig)
+{
+    stopThreads();
+    std::lock_guard<std::mutex> lock(mutex);
+    unmapActive();
+    config = newConfig;
+    config.segmentBytes = std::max<std::size_t>(config.segmentBytes, ORDER_JOURNAL_MIN_SEGMENT_BYTES);
+    if (!openLocked())
+    {
+        return false;
+    }
+    if (config.compress)
+    {
+        compressor = std::thread(&OrderJournal::compressLoop, this);
+    }
+    if (config.sync == JournalSync::INTERVAL)
+    {
+        syncer = std::thread(&OrderJournal::syncLoop, this);
+    }
+    return true;
+}
+
+bool OrderJournal::openLocked()
+{
+    segments.clear();
+    nextSequence = 1;
+    recordCount = 0;
+
+    std::error_code error;
+    fs::create_directories(config.directory, error);
+    if (error)
+    {
+        std::cerr << "❌ Could not create order journal directory " << config.directory << ": " << error.message()
+                  << std::endl;
+        return false;
+    }
+
+    if (!loadDictionary())
+    {
+        return false;
+    }
+
+    std::vector<Segment> files;
+    for (const auto& entry : fs::directory_iterator(config.directory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == TEMPORARY_EXTENSION)
+        {
+            // Left behind by a compression interrupted before its rename
+            fs::remove(entry.path(), error);
+            continue;
+        }
+        bool compressed = entry.path().extension() == COMPRESSED_EXTENSION;
+        if (!entry.is_regular_file() || (!compressed && entry.path().extension() != SEGMENT_EXTENSION))
+        {
+            continue;
+        }
+        try
+        {
+            files.push_back(Segment{entry.path().string(), std::stoull(entry.path().stem().string()), 0, 0, compressed});
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "⚠️ Ignoring unexpected file " << entry.path() << " in the order journal" << std::endl;
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const Segment& left, const Segment& right) {
+        return left.firstSequence != right.firstSequence ? left.firstSequence < right.firstSequence
+                                                         : !left.compressed && right.compressed;
+    });
+
+    // A crash between renaming a compressed segment and removing the original leaves both: keep the original
+    std::vector<Segment> unique;
+    for (const Segment& file : files)
+    {
+        if (!unique.empty() && unique.back().firstSequence == file.firstSequence)
+        {
+            std::remove(file.path.c_str());
+            continue;
+        }
+        unique.push_back(file);
+    }
+    files.swap(unique);
+
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        Segment segment = files[i];
+        if (segment.firstSequence < nextSequence)
+        {
+            std::cerr << "⚠️ Ignoring overlapping order journal segment " << segment.path << std::endl;
+            continue;
+        }
+        if (segment.firstSequence > nextSequence && nextSequence > 1)
+        {
+            std::cerr << "⚠️ Orders " << nextSequence << " to " << segment.firstSequence - 1
+                      << " are missing from the order journal" << std::endl;
+        }
+
+        if (segment.compressed && i + 1 < files.size())
+        {
+            // Only whole sealed segments are compressed, so the next one starts right after it
+            MappedFile file(segment.path);
+            unsigned long long length = ZSTD_getFrameContentSize(file.data, file.length);
+            segment.usedBytes = length == ZSTD_CONTENTSIZE_ERROR || length == ZSTD_CONTENTSIZE_UNKNOWN
+                                    ? 0
+                                    : static_cast<std::size_t>(length);
+            segment.records = files[i + 1].firstSequence - segment.firstSequence;
+            segments.push_back(segment);
+        }
+        else if (segment.compressed)
+        {
+            std::string contents;
+            if (readSegment(segment, dictionary, contents))
+            {
+                segment.usedBytes = contents.size();
+                scan(reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), segment.firstSequence,
+                     nullptr, segment.records);
+            }
+            segments.push_back(segment);
+        }
+        else if (i + 1 < files.size())
+        {
+            MappedFile file(segment.path);
+            segment.usedBytes = scan(file.data, file.length, segment.firstSequence, nullptr, segment.records);
+            if (segment.usedBytes < file.length)
+            {
+                std::cerr << "⚠️ Order journal segment " << segment.path << " is damaged after record "
+                          << segment.firstSequence + segment.records << std::endl;
+            }
+            segments.push_back(segment);
+        }
+        else
+        {
+            segments.push_back(segment);
+            if (!mapActive(segment.path, false))
+            {
+                segments.clear();
+                return false;
+            }
+        }
+        recordCount += segments.back().records;
+        nextSequence = segments.back().firstSequence + segments.back().records;
+    }
+
+    lastSync = std::chrono::steady_clock::now();
+    if (activeData == nullptr && !startSegment())
+    {
+        return false;
+    }
+
+    std::ifstream snapshot(snapshotPath(), std::ios::binary);
+    SnapshotHeader header{};
+    snapshotSequence = readSnapshotHeader(snapshot, header) && header.sequence < nextSequence ? header.sequence : 0;
+    enforceRetention();
+    return true;
+}
+
+bool OrderJournal::mapActive(const std::string& path, bool create)
+{
+    int fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "❌ Could not open order journal segment " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    std::size_t capacity = std::max(static_cast<std::size_t>(info.st_size), config.segmentBytes);
+    if (static_cast<std::size_t>(info.st_size) < capacity && ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+    {
+        std::cerr << "❌ Could not size order journal segment " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        std::cerr << "❌ Could not map order journal segment " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    activeFd = fd;
+    activeData = static_cast<unsigned char*>(mapped);
+    activeCapacity = capacity;
+
+    Segment& segment = segments.back();
+    if (create)
+    {
+        syncedBytes = 0;
+        return true;
+    }
+    segment.usedBytes = scan(activeData, activeCapacity, segment.firstSequence, nullptr, segment.records);
+
+    // Wipe what follows the last valid record, so a torn write can never be mistaken for a record later
+    std::size_t dirtyEnd = segment.usedBytes;
+    for (std::size_t i = segment.usedBytes; i < activeCapacity; i++)
+    {
+        if (activeData[i] != 0)
+        {
+            dirtyEnd = i + 1;
+        }
+    }
+    if (dirtyEnd > segment.usedBytes)
+    {
+        std::cerr << "⚠️ Discarding " << dirtyEnd - segment.usedBytes << " bytes after order "
+                  << segment.firstSequence + segment.records - 1 << " in " << path << std::endl;
+        std::memset(activeData + segment.usedBytes, 0, dirtyEnd - segment.usedBytes);
+    }
+    syncedBytes = dirtyEnd > segment.usedBytes ? 0 : segment.usedBytes;
+    return true;
+}
+
+bool OrderJournal::startSegment()
+{
+    segments.push_back(Segment{segmentPath(config.directory, nextSequence, false), nextSequence, 0, 0, false});
+    if (!mapActive(segments.back().path, true))
+    {
+        segments.pop_back();
+        return false;
+    }
+    return true;
+}
+
+void OrderJournal::syncLocked()
+{
+    if (activeData == nullptr || segments.empty())
+    {
+        return;
+    }
+
+    std::size_t used = segments.back().usedBytes;
+    if (used > syncedBytes)
+    {
+        std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t start = syncedBytes - syncedBytes % pageSize;
+        msync(activeData + start, used - start, MS_SYNC);
+        syncedBytes = used;
+    }
+    lastSync = std::chrono::steady_clock::now();
+}
+
+void OrderJournal::sync()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    syncLocked();
+}
+
+void OrderJournal::unmapActive()
+{
+    if (activeData == nullptr)
+    {
+        return;
+    }
+    syncLocked();
+    munmap(activeData, activeCapacity);
+    ::close(activeFd);
+    activeData = nullptr;
+    activeFd = -1;
+    activeCapacity = 0;
+    syncedBytes = 0;
+}
+
+void OrderJournal::sealActive()
+{
+    if (activeData == nullptr)
+    {
+        return;
+    }
+    syncLocked();
+    munmap(activeData, activeCapacity);
+    if (ftruncate(activeFd, static_cast<off_t>(segments.back().usedBytes)) != 0)
+    {
+        std::cerr << "⚠️ Could not truncate sealed order journal segment " << segments.back().path << std::endl;
+    }
+    if (config.sync != JournalSync::NEVER)
+    {
+        fsync(activeFd);
+    }
+    ::close(activeFd);
+    activeData = nullptr;
+    activeFd = -1;
+    activeCapacity = 0;
+    syncedBytes = 0;
+}
+
+void OrderJournal::enforceRetention()
+{
+    if (config.retentionBytes == 0 && config.retentionHours <= 0)
+    {
+        return;
+    }
+
+    std::int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    std::int64_t maxAgeMs = static_cast<std::int64_t>(config.retentionHours) * 60 * 60 * 1000;
+
+    // Sizes and seal times of the sealed segments; the active one is never deleted
+    std::vector<std::pair<std::uint64_t, std::int64_t>> sealed;
+    std::uint64_t total = segments.back().usedBytes;
+    for (std::size_t i = 0; i + 1 < segments.size(); i++)
+    {
+        struct stat info;
+        if (stat(segments[i].path.c_str(), &info) != 0)
+        {
+            sealed.emplace_back(0, now);
+            continue;
+        }
+        sealed.emplace_back(static_cast<std::uint64_t>(info.st_size),
+                            static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000 + info.st_mtim.tv_nsec / 1000000);
+        total += sealed.back().first;
+    }
+
+    // Records not covered by the snapshot yet are kept, or a restart would miss them
+    std::size_t expired = 0;
+    while (expired < sealed.size() &&
+           segments[expired].firstSequence + segments[expired].records - 1 <= snapshotSequence)
+    {
+        bool tooOld = maxAgeMs > 0 && now - sealed[expired].second > maxAgeMs;
+        bool tooLarge = config.retentionBytes > 0 && total > config.retentionBytes;
+        if (!tooOld && !tooLarge)
+        {
+            break;
+        }
+        total -= sealed[expired].first;
+        expired++;
+    }
+    if (expired == 0)
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < expired; i++)
+    {
+        std::error_code error;
+        fs::remove(segments[i].path, error);
+        recordCount -= segments[i].records;
+    }
+    segments.erase(segments.begin(), segments.begin() + static_cast<std::ptrdiff_t>(expired));
+    std::cout << "Order journal retention removed " << expired << " segments, orders before "
+              << segments.front().firstSequence << " are no longer kept" << std::endl;
+}
+
+void OrderJournal::close()
+{
+    stopThreads();
+    std::lock_guard<std::mutex> lock(mutex);
+    unmapActive();
+    segments.clear();
+}
+
+bool OrderJournal::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return activeData != nullptr;
+}
+
+std::uint64_t OrderJournal::append(std::string_view payload, std::uint32_t client)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (activeData == nullptr)
+    {
+        return 0;
+    }
+
+    std::size_t bytes = recordSize(payload.size());
+    if (bytes > config.segmentBytes)
+    {
+        std::cerr << "❌ Order of " << payload.size() << " bytes does not fit in an order journal segment"
+                  << std::endl;
+        return 0;
+    }
+
+    if (segments.back().usedBytes + bytes > activeCapacity)
+    {
+        sealActive();
+        compressWork.notify_one();
+        if (!startSegment())
+        {
+            return 0;
+        }
+        enforceRetention();
+    }
+
+    Segment& segment = segments.back();
+    RecordHeader header{};
+    header.magic = ORDER_JOURNAL_MAGIC;
+    header.length = static_cast<std::uint32_t>(payload.size());
+    header.client = client;
+    header.sequence = nextSequence;
+    header.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    header.checksum = recordChecksum(header, payload.data());
+
+    unsigned char* target = activeData + segment.usedBytes;
+    std::memcpy(target + sizeof(RecordHeader), payload.data(), payload.size());
+    std::memcpy(target, &header, sizeof(header));
+    segment.usedBytes += bytes;
+    segment.records++;
+    recordCount++;
+    nextSequence++;
+
+    if (config.sync == JournalSync::ALWAYS ||
+        (config.sync == JournalSync::INTERVAL &&
+         std::chrono::steady_clock::now() - lastSync >= std::chrono::milliseconds(config.syncIntervalMs)))
+    {
+        syncLocked();
+    }
+    return header.sequence;
+}
+
+OrderJournal::View OrderJournal::takeView(std::size_t first, bool withActive) const
+{
+    View view;
+    view.directory = config.directory;
+    std::size_t last = segments.size();
+    view.hasActive = withActive && activeData != nullptr && first < last;
+    if (!view.hasActive && activeData != nullptr && first < last)
+    {
+        last--;
+    }
+    view.segments.assign(segments.begin() + static_cast<std::ptrdiff_t>(std::min(first, last)),
+                         segments.begin() + static_cast<std::ptrdiff_t>(last));
+    if (view.hasActive)
+    {
+        view.active.assign(reinterpret_cast<const char*>(activeData), segments.back().usedBytes);
+    }
+    // Any sealed segment may be compressed before it is read
+    if (config.compress && view.segments.size() > (view.hasActive ? 1u : 0u))
+    {
+        view.dictionary = dictionary;
+    }
+    return view;
+}
+
+void OrderJournal::visitSegment(const View& view, std::size_t index, const RecordVisitor& visitor) const
+{
+    const Segment& segment = view.segments[index];
+    std::uint64_t records = 0;
+    if (view.hasActive && index + 1 == view.segments.size())
+    {
+        scan(reinterpret_cast<const unsigned char*>(view.active.data()), view.active.size(), segment.firstSequence,
+             &visitor, records);
+        return;
+    }
+
+    std::string contents;
+    if (!segment.compressed)
+    {
+        MappedFile file(segment.path);
+        if (file.data != nullptr)
+        {
+            scan(file.data, std::min(file.length, segment.usedBytes), segment.firstSequence, &visitor, records);
+            return;
+        }
+    }
+
+    // A segment compressed since the view was taken is read from its new file
+    Segment current = segment;
+    current.path = segmentPath(view.directory, segment.firstSequence, true);
+    current.compressed = true;
+    std::string trained = view.dictionary;
+    if (!segment.compressed && trained.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        trained = dictionary;
+    }
+    if (readSegment(current, trained, contents))
+    {
+        scan(reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), segment.firstSequence,
+             &visitor, records);
+    }
+}
+
+void OrderJournal::forEach(const RecordVisitor& visitor) const
+{
+    View view;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        view = takeView(0, true);
+    }
+    for (std::size_t i = 0; i < view.segments.size(); i++)
+    {
+        visitSegment(view, i, visitor);
+    }
+}
+
+void OrderJournal::forEachOf(const std::vector<std::uint64_t>& sequences, const RecordVisitor& visitor) const
+{
+    if (sequences.empty())
+    {
+        return;
+    }
+
+    View view;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // The active segment is only copied when a wanted record may be in it
+        view = takeView(firstSegmentAfter(sequences.front() - 1),
+                        !segments.empty() && sequences.back() >= segments.back().firstSequence);
+    }
+
+    auto wanted = sequences.begin();
+    for (std::size_t i = 0; i < view.segments.size() && wanted != sequences.end(); i++)
+    {
+        const Segment& segment = view.segments[i];
+        std::uint64_t end = segment.firstSequence + segment.records;
+        wanted = std::lower_bound(wanted, sequences.end(), segment.firstSequence);
+        if (wanted == sequences.end() || *wanted >= end)
+        {
+            continue;
+        }
+
+        visitSegment(view, i, [&wanted, &sequences, &visitor](const OrderRecord& record) {
+            while (wanted != sequences.end() && *wanted < record.sequence)
+            {
+                ++wanted;
+            }
+            if (wanted != sequences.end() && *wanted == record.sequence)
+            {
+                visitor(record);
+                ++wanted;
+            }
+        });
+    }
+}
+
+std::size_t OrderJournal::firstSegmentAfter(std::uint64_t sequence) const
+{
+    std::size_t index = 0;
+    while (index < segments.size() && segments[index].firstSequence + segments[index].records <= sequence + 1)
+    {
+        index++;
+    }
+    return index;
+}
+
+std::size_t OrderJournal::segmentsAfter(std::uint64_t sequence) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return segments.size() - firstSegmentAfter(sequence);
+}
+
+void OrderJournal::forEachAfter(std::uint64_t sequence, std::size_t threads, const PartVisitor& visitor) const
+{
+    View view;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        view = takeView(firstSegmentAfter(sequence), true);
+    }
+    std::atomic<std::size_t> next{0};
+
+    // Each thread takes the next unread segment, so a slow compressed segment does not hold back the others
+    auto work = [this, sequence, &view, &next, &visitor]() {
+        for (std::size_t part = next.fetch_add(1); part < view.segments.size(); part = next.fetch_add(1))
+        {
+            visitSegment(view, part, [sequence, part, &visitor](const OrderRecord& record) {
+                if (record.sequence > sequence)
+                {
+                    visitor(part, record);
+                }
+            });
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < std::min(threads, view.segments.size()); t++)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t OrderJournal::unsyncedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return activeData == nullptr || segments.empty() ? 0 : segments.back().usedBytes - syncedBytes;
+}
+
+std::size_t OrderJournal::compressedSegments() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<std::size_t>(std::count_if(segments.begin(), segments.end(),
+                                                  [](const Segment& segment) { return segment.compressed; }));
+}
+
+std::uint64_t OrderJournal::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return recordCount;
+}
+
+std::uint64_t OrderJournal::firstSequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return segments.empty() ? nextSequence : segments.front().firstSequence;
+}
+
+std::uint64_t OrderJournal::lastSequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence - 1;
+}
+
+std::string OrderJournal::snapshotPath() const
+{
+    return (fs::path(config.directory) / ORDER_JOURNAL_SNAPSHOT_FILE).string();
+}
+
+bool OrderJournal::writeSnapshot(std::uint64_t sequence, std::string_view state)
+{
+    std::string path;
+    bool durable;
+    std::uint64_t startGeneration;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (activeData == nullptr || sequence >= nextSequence)
+        {
+            return false;
+        }
+        path = snapshotPath();
+        durable = config.sync != JournalSync::NEVER;
+        startGeneration = generation;
+    }
+
+    SnapshotHeader header{};
+    header.magic = ORDER_SNAPSHOT_MAGIC;
+    header.length = state.size();
+    header.sequence = sequence;
+    header.checksum = crc32Update(0xFFFFFFFFu, state.data(), state.size()) ^ 0xFFFFFFFFu;
+
+    std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+    contents.append(state);
+    if (!writeFileAtomically(path, contents.data(), contents.size(), durable))
+    {
+        return false;
+    }
+
+    // The records the snapshot covers may now be removed by retention
+    std::lock_guard<std::mutex> lock(mutex);
+    if (generation == startGeneration && activeData != nullptr)
+    {
+        snapshotSequence = sequence;
+        enforceRetention();
+    }
+    return true;
+}
+
+bool OrderJournal::readSnapshot(std::uint64_t& sequence, std::string& state) const
+{
+    std::string path;
+    std::uint64_t last;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = snapshotPath();
+        last = nextSequence - 1;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    SnapshotHeader header{};
+    if (!readSnapshotHeader(file, header))
+    {
+        return false;
+    }
+    // A snapshot ahead of the journal belongs to records that were lost or cleared
+    if (header.sequence > last)
+    {
+        return false;
+    }
+    // The length comes from the disk, so a damaged header must not decide how much is allocated
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(path, error);
+    if (error || header.length > size - sizeof(header))
+    {
+        return false;
+    }
+
+    state.assign(header.length, '\0');
+    if (!file.read(&state[0], static_cast<std::streamsize>(header.length)) ||
+        (crc32Update(0xFFFFFFFFu, state.data(), state.size()) ^ 0xFFFFFFFFu) != header.checksum)
+    {
+        state.clear();
+        return false;
+    }
+    sequence = header.sequence;
+    return true;
+}
+
+bool OrderJournal::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unmapActive();
+    for (const Segment& segment : segments)
+    {
+        std::error_code error;
+        fs::remove(segment.path, error);
+    }
+    segments.clear();
+    std::error_code error;
+    fs::remove(snapshotPath(), error);
+    snapshotSequence = 0;
+    generation++;
+    nextSequence = 1;
+    recordCount = 0;
+    return startSegment();
+}
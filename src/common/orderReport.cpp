@@ -0,0 +1,451 @@
+#include "orderReport.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+static const std::int64_t MS_PER_MINUTE = 60 * 1000;
+static const std::int64_t MINUTES_PER_HOUR = 60;
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static bool invalidParameter(const std::string& parameter, std::string& error)
+{
+    error = ErrorHandler::generateError(ERR_INVALID_REPORT_QUERY, "Invalid SHOW_REPORT parameter",
+                                        "Unsupported parameter '" + parameter +
+                                            "'. Use window=<N>m|<N>h|<N>d (up to " +
+                                            std::to_string(ROLLUP_HOUR_BUCKETS / 24) +
+                                            " days) and group=product|location|priority.",
+                                        ErrorLevel::ERROR);
+    return false;
+}
+
+static bool parseWindow(const std::string& value, int& minutes)
+{
+    std::size_t consumed = 0;
+    long long amount;
+    try
+    {
+        amount = std::stoll(value, &consumed);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    std::string unit = toLower(value.substr(consumed));
+    long long scale;
+    if (unit == "m")
+    {
+        scale = 1;
+    }
+    else if (unit.empty() || unit == "h")
+    {
+        scale = MINUTES_PER_HOUR;
+    }
+    else if (unit == "d")
+    {
+        scale = 24 * MINUTES_PER_HOUR;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (amount <= 0 || amount > static_cast<long long>(ROLLUP_HOUR_BUCKETS) * MINUTES_PER_HOUR / scale)
+    {
+        return false;
+    }
+    minutes = static_cast<int>(amount * scale);
+    return true;
+}
+
+static const char* groupName(ReportGroup group)
+{
+    switch (group)
+    {
+    case ReportGroup::LOCATION:
+        return "location";
+    case ReportGroup::PRIORITY:
+        return "priority";
+    default:
+        return "product";
+    }
+}
+
+bool parseReportQuery(const std::string& command, ReportQuery& query, std::string& error)
+{
+    query = ReportQuery();
+
+    std::istringstream stream(command);
+    std::string token;
+    stream >> token;
+    if (token != SHOW_REPORT_COMMAND)
+    {
+        return invalidParameter(token, error);
+    }
+
+    while (stream >> token)
+    {
+        std::size_t separator = token.find('=');
+        if (separator == std::string::npos || separator + 1 == token.size())
+        {
+            return invalidParameter(token, error);
+        }
+
+        std::string key = toLower(token.substr(0, separator));
+        std::string value = toLower(token.substr(separator + 1));
+
+        if (key == "window")
+        {
+            if (!parseWindow(value, query.windowMinutes))
+            {
+                return invalidParameter(token, error);
+            }
+        }
+        else if (key == "group")
+        {
+            if (value == "product")
+            {
+                query.group = ReportGroup::PRODUCT;
+            }
+            else if (value == "location")
+            {
+                query.group = ReportGroup::LOCATION;
+            }
+            else if (value == "priority")
+            {
+                query.group = ReportGroup::PRIORITY;
+            }
+            else
+            {
+                return invalidParameter(token, error);
+            }
+        }
+        else
+        {
+            return invalidParameter(token, error);
+        }
+    }
+    return true;
+}
+
+// Formats an endpoint of an order as "<type> <id>", or "" when it has no type
+static std::string locationOf(const Json::Value& endpoint)
+{
+    if (!endpoint["type"].isString())
+    {
+        return "";
+    }
+    const Json::Value& location = endpoint["location"];
+    return endpoint["type"].asString() + " " +
+           (location.isString() ? location.asString() : std::to_string(location.asInt()));
+}
+
+bool extractOrderFacts(const Json::Value& order, OrderFacts& facts)
+{
+    const Json::Value& generalInfo = order["general_info"];
+    const Json::Value& product = generalInfo["action"]["product"];
+
+    facts.product = product["name"].asString();
+    facts.quantity = product["quantity"].asInt();
+    facts.source = locationOf(generalInfo["source"]);
+    facts.location = locationOf(generalInfo["destination"]);
+    facts.priority = generalInfo["metadata"]["priority"].asString();
+    if (facts.priority.empty())
+    {
+        facts.priority = "none";
+    }
+    return !facts.product.empty() && facts.quantity > 0;
+}
+
+OrderRollup::OrderRollup(std::size_t minuteBuckets, std::size_t hourBuckets)
+{
+    for (Shard& shard : shards)
+    {
+        shard.minutes.resize(std::max<std::size_t>(minuteBuckets, 1));
+        shard.hours.resize(std::max<std::size_t>(hourBuckets, 1));
+    }
+}
+
+OrderRollup& OrderRollup::getInstance()
+{
+    static OrderRollup instance;
+    return instance;
+}
+
+void OrderRollup::add(Bucket& bucket, const OrderFacts& facts)
+{
+    for (const auto& [group, key] : {std::make_pair(ReportGroup::PRODUCT, &facts.product),
+                                     std::make_pair(ReportGroup::LOCATION, &facts.location),
+                                     std::make_pair(ReportGroup::PRIORITY, &facts.priority)})
+    {
+        RollupTotal& total = bucket.groups[static_cast<std::size_t>(group)][*key];
+        total.orders++;
+        total.quantity += facts.quantity;
+    }
+}
+
+void OrderRollup::add(std::vector<Bucket>& ring, std::int64_t index, const OrderFacts& facts)
+{
+    Bucket& bucket = ring[static_cast<std::size_t>(index) % ring.size()];
+    if (bucket.index > index)
+    {
+        // The slot already holds a later period, so this one has left the ring
+        return;
+    }
+    if (bucket.index < index)
+    {
+        bucket.index = index;
+        for (auto& totals : bucket.groups)
+        {
+            totals.clear();
+        }
+    }
+    add(bucket, facts);
+}
+
+void OrderRollup::merge(const Bucket& bucket, ReportGroup group, RollupTotals& totals)
+{
+    for (const auto& entry : bucket.groups[static_cast<std::size_t>(group)])
+    {
+        totals[entry.first].orders += entry.second.orders;
+        totals[entry.first].quantity += entry.second.quantity;
+    }
+}
+
+void OrderRollup::merge(const std::vector<Bucket>& ring, std::int64_t index, ReportGroup group,
+                        RollupTotals& totals)
+{
+    const Bucket& bucket = ring[static_cast<std::size_t>(index) % ring.size()];
+    if (bucket.index == index)
+    {
+        merge(bucket, group, totals);
+    }
+}
+
+void OrderRollup::record(std::int64_t timestampMs, const OrderFacts& facts)
+{
+    std::int64_t minute = timestampMs / MS_PER_MINUTE;
+    Shard& shard = shards[orderStatsShard()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    add(shard.minutes, minute, facts);
+    add(shard.hours, minute / MINUTES_PER_HOUR, facts);
+    add(shard.allTime, facts);
+}
+
+RollupTotals OrderRollup::query(const ReportQuery& query, std::int64_t nowMs) const
+{
+    RollupTotals totals;
+    std::int64_t now = nowMs / MS_PER_MINUTE;
+
+    for (const Shard& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (query.windowMinutes <= 0)
+        {
+            merge(shard.allTime, query.group, totals);
+            continue;
+        }
+
+        // Whole hours come from the hour ring, the rest from the minute ring while it still covers them
+        std::int64_t oldestMinute = now - static_cast<std::int64_t>(shard.minutes.size()) + 1;
+        std::int64_t minute = now - query.windowMinutes + 1;
+        while (minute <= now)
+        {
+            bool hourStart = minute % MINUTES_PER_HOUR == 0;
+            if ((hourStart && minute + MINUTES_PER_HOUR - 1 <= now) || minute < oldestMinute)
+            {
+                merge(shard.hours, minute / MINUTES_PER_HOUR, query.group, totals);
+                minute = (minute / MINUTES_PER_HOUR + 1) * MINUTES_PER_HOUR;
+            }
+            else
+            {
+                merge(shard.minutes, minute, query.group, totals);
+                minute++;
+            }
+        }
+    }
+    return totals;
+}
+
+void OrderRollup::clear()
+{
+    for (Shard& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (std::vector<Bucket>* ring : {&shard.minutes, &shard.hours})
+        {
+            std::fill(ring->begin(), ring->end(), Bucket());
+        }
+        shard.allTime = Bucket();
+    }
+}
+
+void OrderRollup::absorb(Bucket& into, const Bucket& from)
+{
+    for (std::size_t group = 0; group < from.groups.size(); group++)
+    {
+        for (const auto& entry : from.groups[group])
+        {
+            RollupTotal& total = into.groups[group][entry.first];
+            total.orders += entry.second.orders;
+            total.quantity += entry.second.quantity;
+        }
+    }
+}
+
+void OrderRollup::absorb(std::vector<Bucket>& ring, const Bucket& bucket)
+{
+    Bucket& slot = ring[static_cast<std::size_t>(bucket.index) % ring.size()];
+    if (slot.index > bucket.index)
+    {
+        return;
+    }
+    if (slot.index < bucket.index)
+    {
+        slot = Bucket();
+        slot.index = bucket.index;
+    }
+    absorb(slot, bucket);
+}
+
+void OrderRollup::save(SnapshotWriter& writer, std::uint64_t ring, const Bucket& bucket)
+{
+    writer.putU64(ring);
+    writer.putI64(bucket.index);
+    for (const auto& totals : bucket.groups)
+    {
+        writer.putU64(totals.size());
+        for (const auto& entry : totals)
+        {
+            writer.putString(entry.first);
+            writer.putI64(entry.second.orders);
+            writer.putI64(entry.second.quantity);
+        }
+    }
+}
+
+void OrderRollup::save(SnapshotWriter& writer) const
+{
+    // Ring 0 holds minutes, 1 hours and 2 the all-time totals
+    std::vector<std::pair<std::uint64_t, const Bucket*>> buckets;
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (const Shard& shard : shards)
+    {
+        locks.emplace_back(shard.mutex);
+        for (const Bucket& bucket : shard.minutes)
+        {
+            if (bucket.index >= 0)
+            {
+                buckets.emplace_back(0, &bucket);
+            }
+        }
+        for (const Bucket& bucket : shard.hours)
+        {
+            if (bucket.index >= 0)
+            {
+                buckets.emplace_back(1, &bucket);
+            }
+        }
+        buckets.emplace_back(2, &shard.allTime);
+    }
+
+    writer.putU64(buckets.size());
+    for (const auto& bucket : buckets)
+    {
+        save(writer, bucket.first, *bucket.second);
+    }
+}
+
+bool OrderRollup::load(SnapshotReader& reader)
+{
+    std::uint64_t count;
+    if (!reader.getU64(count))
+    {
+        return false;
+    }
+
+    Shard& shard = shards[orderStatsShard()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        std::uint64_t ring;
+        Bucket bucket;
+        if (!reader.getU64(ring) || ring > 2 || !reader.getI64(bucket.index))
+        {
+            return false;
+        }
+        for (auto& totals : bucket.groups)
+        {
+            std::uint64_t entries;
+            if (!reader.getU64(entries))
+            {
+                return false;
+            }
+            for (std::uint64_t e = 0; e < entries; e++)
+            {
+                std::string key;
+                std::int64_t orders, quantity;
+                if (!reader.getString(key) || !reader.getI64(orders) || !reader.getI64(quantity))
+                {
+                    return false;
+                }
+                totals[key] = RollupTotal{orders, quantity};
+            }
+        }
+
+        if (ring == 2)
+        {
+            absorb(shard.allTime, bucket);
+        }
+        else if (bucket.index >= 0)
+        {
+            absorb(ring == 0 ? shard.minutes : shard.hours, bucket);
+        }
+    }
+    return true;
+}
+
+static std::string describeWindow(int windowMinutes)
+{
+    if (windowMinutes % (24 * MINUTES_PER_HOUR) == 0)
+    {
+        return std::to_string(windowMinutes / (24 * MINUTES_PER_HOUR)) + "d";
+    }
+    if (windowMinutes % MINUTES_PER_HOUR == 0)
+    {
+        return std::to_string(windowMinutes / MINUTES_PER_HOUR) + "h";
+    }
+    return std::to_string(windowMinutes) + "m";
+}
+
+std::string formatOrderReport(const ReportQuery& query, const RollupTotals& totals)
+{
+    if (totals.empty())
+    {
+        return query.windowMinutes > 0 ? "No orders in the last " + describeWindow(query.windowMinutes) + ".\n"
+                                       : "No product data stored yet.\n";
+    }
+
+    std::vector<std::pair<std::string, RollupTotal>> rows(totals.begin(), totals.end());
+    std::stable_sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second.quantity > b.second.quantity;
+    });
+
+    std::ostringstream msgStream;
+    msgStream << "\n----- Order Report (" << (query.windowMinutes > 0 ? "last " + describeWindow(query.windowMinutes)
+                                                                       : std::string("all time"))
+              << ", by " << groupName(query.group) << ") -----\n";
+    for (const auto& row : rows)
+    {
+        msgStream << "- " << row.first << ": " << row.second.quantity << " units in " << row.second.orders
+                  << (row.second.orders == 1 ? " order\n" : " orders\n");
+    }
+    msgStream << "-----------------------------------";
+    return msgStream.str();
+}
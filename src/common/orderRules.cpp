@@ -0,0 +1,269 @@
+#include "orderRules.hpp"
+#include "orderValidation.hpp"
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+static QuantityRule makeRule(int min, int minError, const std::string& minMessage, int max, int maxError,
+                             const std::string& maxMessage)
+{
+    QuantityRule rule;
+    rule.min = min;
+    rule.max = max;
+    rule.errors = {0, minError, maxError, maxError};
+    rule.messages = {"", minMessage, maxMessage, maxMessage};
+    return rule;
+}
+
+OrderRuleTable OrderRuleTable::builtin()
+{
+    const std::string hubCritical = "Hubs must order between " + std::to_string(MIN_CRITICAL_HUB_QUANTITY) + " and " +
+                                    std::to_string(MAX_CRITICAL_HUB_QUANTITY) + " units of critical products.";
+    const std::string externalAny =
+        "External clients must order at least " + std::to_string(MIN_EXTERNAL_QUANTITY) + " units of any product.";
+
+    OrderRuleTable table;
+    table.clients = {"hub", "external"};
+    table.rules = {
+        makeRule(MIN_NONCRITICAL_HUB_QUANTITY, ERR_INVALID_QTY_HUB_NONCRIT,
+                 "Hubs must order at least " + std::to_string(MIN_NONCRITICAL_HUB_QUANTITY) +
+                     " units of non-critical products.",
+                 INT_MAX, 0, ""),
+        makeRule(MIN_CRITICAL_HUB_QUANTITY, ERR_INVALID_QTY_HUB_CRIT, hubCritical, MAX_CRITICAL_HUB_QUANTITY,
+                 ERR_INVALID_QTY_HUB_CRIT, hubCritical),
+        makeRule(MIN_EXTERNAL_QUANTITY, ERR_INVALID_QTY_EXT_ANY, externalAny, INT_MAX, 0, ""),
+        makeRule(MIN_EXTERNAL_QUANTITY, ERR_INVALID_QTY_EXT_ANY, externalAny, MAX_CRITICAL_EXTERNAL_QUANTITY,
+                 ERR_INVALID_QTY_EXT_CRIT,
+                 "External clients can order up to " + std::to_string(MAX_CRITICAL_EXTERNAL_QUANTITY) +
+                     " units of critical products."),
+    };
+    return table;
+}
+
+static bool readBound(const Json::Value& rule, const char* bound, int fallback, int& value, int& code,
+                      std::string& message, std::string& error)
+{
+    const std::string name(bound);
+    value = fallback;
+    code = 0;
+    message.clear();
+    if (!rule.isMember(name))
+    {
+        return true;
+    }
+
+    const Json::Value& errorCode = rule[name + "_error"];
+    if (!rule[name].isInt() || !errorCode.isInt() || errorCode.asInt() <= 0)
+    {
+        error = "'" + name + "' must be an integer with a positive '" + name + "_error' code";
+        return false;
+    }
+
+    value = rule[name].asInt();
+    code = errorCode.asInt();
+    message = rule.get(name + "_message", "").asString();
+    if (message.empty())
+    {
+        message = "Quantity must be " + std::string(name == "min" ? "at least " : "at most ") +
+                  std::to_string(value) + ".";
+    }
+    return true;
+}
+
+bool OrderRuleTable::compile(const Json::Value& config, OrderRuleTable& table, std::string& error)
+{
+    const Json::Value& entries = config["rules"];
+    if (!entries.isArray() || entries.empty())
+    {
+        error = "'rules' must be a non-empty array";
+        return false;
+    }
+
+    OrderRuleTable compiled;
+    for (const Json::Value& entry : entries)
+    {
+        const std::string client = entry["client"].asString();
+        if (!entry["client"].isString() || client.empty())
+        {
+            error = "every rule needs a 'client' type";
+            return false;
+        }
+        if (compiled.clientIndex(client) < 0)
+        {
+            compiled.clients.push_back(client);
+        }
+    }
+
+    std::vector<bool> filled(compiled.clients.size() * ORDER_RULE_PRODUCT_CLASSES, false);
+    compiled.rules.resize(filled.size());
+    for (const Json::Value& entry : entries)
+    {
+        const std::string client = entry["client"].asString();
+        const std::string product = entry["product"].asString();
+        if (product != "critical" && product != "non_critical")
+        {
+            error = "rule for '" + client + "': 'product' must be 'critical' or 'non_critical'";
+            return false;
+        }
+
+        std::size_t cell = static_cast<std::size_t>(compiled.clientIndex(client)) * ORDER_RULE_PRODUCT_CLASSES +
+                           static_cast<std::size_t>(product == "critical");
+        if (filled[cell])
+        {
+            error = "duplicate rule for '" + client + "', " + product;
+            return false;
+        }
+
+        int min, minError, max, maxError;
+        std::string minMessage, maxMessage, boundError;
+        if (!readBound(entry, "min", 1, min, minError, minMessage, boundError) ||
+            !readBound(entry, "max", INT_MAX, max, maxError, maxMessage, boundError))
+        {
+            error = "rule for '" + client + "', " + product + ": " + boundError;
+            return false;
+        }
+        if (min > max)
+        {
+            error = "rule for '" + client + "', " + product + ": 'min' is greater than 'max'";
+            return false;
+        }
+
+        compiled.rules[cell] = makeRule(min, minError, minMessage, max, maxError, maxMessage);
+        filled[cell] = true;
+    }
+
+    for (std::size_t cell = 0; cell < filled.size(); cell++)
+    {
+        if (!filled[cell])
+        {
+            error = "missing rule for '" + compiled.clients[cell / ORDER_RULE_PRODUCT_CLASSES] + "', " +
+                    (cell % ORDER_RULE_PRODUCT_CLASSES ? "critical" : "non_critical");
+            return false;
+        }
+    }
+
+    table = std::move(compiled);
+    return true;
+}
+
+int OrderRuleTable::clientIndex(std::string_view type) const
+{
+    for (std::size_t i = 0; i < clients.size(); i++)
+    {
+        if (clients[i] == type)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::string OrderRuleTable::clientList() const
+{
+    std::string list;
+    for (std::size_t i = 0; i < clients.size(); i++)
+    {
+        if (i > 0)
+        {
+            list += i + 1 == clients.size() ? " or " : ", ";
+        }
+        list += "'" + clients[i] + "'";
+    }
+    return list;
+}
+
+OrderRules::OrderRules(const std::string& path)
+    : path(path), table(std::make_shared<const OrderRuleTable>(OrderRuleTable::builtin()))
+{
+    std::error_code ec;
+    if (path.empty() || !fs::exists(path, ec))
+    {
+        return;
+    }
+
+    std::string error;
+    if (!reload(error))
+    {
+        std::cerr << "Invalid order rules in " << path << " (" << error << "), using the built-in rules"
+                  << std::endl;
+    }
+}
+
+OrderRules& OrderRules::getInstance()
+{
+    const char* path = std::getenv("ORDER_RULES_FILE");
+    static OrderRules instance(path != nullptr ? path : ORDER_RULES_PATH);
+    return instance;
+}
+
+std::shared_ptr<const OrderRuleTable> OrderRules::current() const
+{
+    return std::atomic_load(&table);
+}
+
+void OrderRules::publish(std::shared_ptr<const OrderRuleTable> rules)
+{
+    std::atomic_store(&table, std::move(rules));
+}
+
+bool OrderRules::reloadLocked(std::string& error)
+{
+    std::error_code ec;
+    fs::file_time_type modified = fs::last_write_time(path, ec);
+    std::ifstream file(path);
+    if (path.empty() || ec || !file)
+    {
+        error = "cannot read the file";
+        return false;
+    }
+    // Remembered even if the file is rejected, so a broken file is reported once and not on every poll
+    loaded = modified;
+
+    Json::Value config;
+    Json::CharReaderBuilder reader;
+    std::string parseErrors;
+    if (!Json::parseFromStream(reader, file, &config, &parseErrors))
+    {
+        error = parseErrors;
+        return false;
+    }
+
+    OrderRuleTable compiled;
+    if (!OrderRuleTable::compile(config, compiled, error))
+    {
+        return false;
+    }
+
+    publish(std::make_shared<const OrderRuleTable>(std::move(compiled)));
+    return true;
+}
+
+bool OrderRules::reload(std::string& error)
+{
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    return reloadLocked(error);
+}
+
+bool OrderRules::reloadIfChanged()
+{
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    std::error_code ec;
+    if (path.empty() || fs::last_write_time(path, ec) == loaded || ec)
+    {
+        return false;
+    }
+
+    std::string error;
+    if (!reloadLocked(error))
+    {
+        std::cerr << "Invalid order rules in " << path << " (" << error << "), keeping the previous rules"
+                  << std::endl;
+        return false;
+    }
+
+    std::cout << "Order rules reloaded from " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,103 @@
+#include "orderSnapshot.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+OrderSnapshotConfig loadOrderSnapshotConfig()
+{
+    OrderSnapshotConfig config;
+
+    const char* every = std::getenv("ORDER_SNAPSHOT_EVERY");
+    if (every != nullptr)
+    {
+        try
+        {
+            config.everyOrders = std::stoull(every);
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_SNAPSHOT_EVERY, using " << config.everyOrders << std::endl;
+        }
+    }
+
+    const char* threads = std::getenv("ORDER_REPLAY_THREADS");
+    if (threads != nullptr)
+    {
+        try
+        {
+            config.replayThreads = static_cast<std::size_t>(std::max(0, std::stoi(threads)));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_REPLAY_THREADS, using one thread per core" << std::endl;
+        }
+    }
+
+    return config;
+}
+
+void SnapshotWriter::putU64(std::uint64_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SnapshotWriter::putI64(std::int64_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SnapshotWriter::putString(std::string_view value)
+{
+    putU64(value.size());
+    buffer.append(value.data(), value.size());
+}
+
+const std::string& SnapshotWriter::data() const
+{
+    return buffer;
+}
+
+SnapshotReader::SnapshotReader(std::string_view data) : data(data)
+{
+}
+
+bool SnapshotReader::take(void* value, std::size_t length)
+{
+    if (failed || data.size() < length)
+    {
+        failed = true;
+        return false;
+    }
+    std::memcpy(value, data.data(), length);
+    data.remove_prefix(length);
+    return true;
+}
+
+bool SnapshotReader::getU64(std::uint64_t& value)
+{
+    return take(&value, sizeof(value));
+}
+
+bool SnapshotReader::getI64(std::int64_t& value)
+{
+    return take(&value, sizeof(value));
+}
+
+bool SnapshotReader::getString(std::string& value)
+{
+    std::uint64_t length;
+    if (!getU64(length) || length > data.size())
+    {
+        failed = true;
+        return false;
+    }
+    value.assign(data.data(), static_cast<std::size_t>(length));
+    data.remove_prefix(static_cast<std::size_t>(length));
+    return true;
+}
+
+bool SnapshotReader::done() const
+{
+    return !failed && data.empty();
+}
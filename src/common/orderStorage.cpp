@@ -1,67 +1,365 @@
 #include "orderStorage.hpp"
+#include "orderReport.hpp"
+#include "recentOrders.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
 
-std::vector<std::string> storedOrders;
-std::unordered_map<std::string, int> productQuantities;
-std::mutex ordersMutex;
+static std::mutex journalOpenMutex;
+static std::atomic<bool> journalReady{false};
 
-void storeOrder(const std::string& json_str)
+// Stores hold it shared from the append to the last statistic, so a snapshot never sees half an order
+static std::shared_mutex snapshotMutex;
+static std::mutex snapshotWriteMutex;
+static OrderSnapshotConfig snapshotConfig;
+static std::atomic<std::uint64_t> nextSnapshotAt{0};
+
+/**
+ * @class SnapshotWorker
+ * @brief Thread writing the snapshots requested by storeOrder(), so no order waits for one.
+ */
+class SnapshotWorker
 {
-    std::unique_lock<std::mutex> lock(ordersMutex);
-    storedOrders.push_back(json_str);
+  public:
+    ~SnapshotWorker()
+    {
+        stop();
+    }
+
+    // Built on the first request, after the journal, so it is destroyed (and joined) before it
+    static SnapshotWorker& getInstance()
+    {
+        static SnapshotWorker instance;
+        return instance;
+    }
+
+    void request()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping)
+            {
+                return;
+            }
+            if (!worker.joinable())
+            {
+                worker = std::thread(&SnapshotWorker::run, this);
+            }
+            requested = true;
+        }
+        wanted.notify_one();
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wanted.notify_one();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+  private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wanted.wait(lock, [this]() { return stopping || requested; });
+            // A snapshot still due when the thread stops is left to the caller of stopOrderSnapshots()
+            if (stopping)
+            {
+                break;
+            }
+            requested = false;
+
+            lock.unlock();
+            saveOrderSnapshot();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex;               /**< Guards requested and stopping. */
+    std::condition_variable wanted; /**< Signalled when a snapshot is requested or the thread stops. */
+    bool requested = false;         /**< Whether a snapshot is due. */
+    bool stopping = false;          /**< Whether the thread must exit; later requests are dropped. */
+    std::thread worker;             /**< Thread writing the snapshots. */
+};
 
+// Parses an order into the fields the statistics are kept by; takes no lock
+static bool parseOrder(std::string_view json_str, OrderFacts& facts)
+{
     Json::CharReaderBuilder builder;
     builder["collectComments"] = false;
     Json::Value root;
     std::string errs;
 
-    std::istringstream iss(json_str);
-    if (!Json::parseFromStream(builder, iss, &root, &errs))
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!reader->parse(json_str.data(), json_str.data() + json_str.size(), &root, &errs))
     {
         std::cerr << "Error parsing JSON: " << errs << "\n";
+        return false;
+    }
+    return extractOrderFacts(root, facts);
+}
+
+// Adds an order to the product totals and the rollups of its time
+static void countOrder(const OrderFacts& facts, std::int64_t timestampMs)
+{
+    ProductCounters::getInstance().add(facts.product, facts.quantity);
+    OrderRollup::getInstance().record(timestampMs, facts);
+}
+
+static void resetStatistics()
+{
+    ProductCounters::getInstance().clear();
+    OrderRollup::getInstance().clear();
+    OrderIndex::getInstance().clear();
+    RecentOrders::getInstance().clear();
+}
+
+static bool restoreStatistics(const std::string& state)
+{
+    SnapshotReader reader(state);
+    std::uint64_t version;
+    return reader.getU64(version) && version == ORDER_SNAPSHOT_VERSION && ProductCounters::getInstance().load(reader) &&
+           OrderRollup::getInstance().load(reader) && OrderIndex::getInstance().load(reader) && reader.done();
+}
+
+// Replays the records after a sequence; each segment is indexed apart and the parts appended in order
+static void replayJournal(std::uint64_t after)
+{
+    OrderJournal& journal = OrderJournal::getInstance();
+    std::size_t threads = snapshotConfig.replayThreads > 0
+                              ? snapshotConfig.replayThreads
+                              : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::uint64_t recentFrom = journal.lastSequence() - std::min<std::uint64_t>(journal.lastSequence(),
+                                                                                    RecentOrders::getInstance().capacity());
+    std::deque<OrderIndex> parts(journal.segmentsAfter(after));
+    journal.forEachAfter(after, threads, [&parts, recentFrom](std::size_t part, const OrderRecord& record) {
+        OrderFacts facts;
+        if (parseOrder(record.payload, facts))
+        {
+            countOrder(facts, record.timestamp);
+        }
+        parts[part].add(record.sequence, record.client, facts);
+        if (record.sequence > recentFrom)
+        {
+            RecentOrders::getInstance().add(record.sequence, record.payload);
+        }
+    });
+    for (const OrderIndex& part : parts)
+    {
+        OrderIndex::getInstance().extend(part);
+    }
+}
+
+// Opens the journal on first use and replays it before any other thread may count orders
+static bool ensureJournalOpen()
+{
+    if (journalReady.load(std::memory_order_acquire))
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(journalOpenMutex);
+    if (journalReady.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+
+    OrderJournal& journal = OrderJournal::getInstance();
+    if (!journal.open(loadOrderJournalConfig()))
+    {
+        std::cerr << "❌ Could not open the order journal, orders will not be stored.\n";
+        return false;
+    }
+
+    snapshotConfig = loadOrderSnapshotConfig();
+    resetStatistics();
+    std::uint64_t after = 0;
+    std::string state;
+    if (journal.readSnapshot(after, state) && !restoreStatistics(state))
+    {
+        std::cerr << "⚠️ Order snapshot could not be read, replaying the whole journal.\n";
+        resetStatistics();
+        after = 0;
+    }
+    replayJournal(after);
+    OrderIndex::getInstance().dropBefore(journal.firstSequence());
+
+    nextSnapshotAt.store(journal.lastSequence() + snapshotConfig.everyOrders, std::memory_order_relaxed);
+    journalReady.store(true, std::memory_order_release);
+    return true;
+}
+
+long long loadStoredOrders()
+{
+    if (!ensureJournalOpen())
+    {
+        return -1;
+    }
+    return static_cast<long long>(OrderJournal::getInstance().size());
+}
+
+void storeOrder(const std::string& json_str, int clientId)
+{
+    OrderFacts facts;
+    bool valid = parseOrder(json_str, facts);
+
+    std::uint32_t client = clientId > 0 ? static_cast<std::uint32_t>(clientId) : 0;
+    std::uint64_t sequence = 0;
+    if (ensureJournalOpen())
+    {
+        std::shared_lock<std::shared_mutex> lock(snapshotMutex);
+        sequence = OrderJournal::getInstance().append(json_str, client);
+        if (sequence != 0)
+        {
+            OrderIndex::getInstance().add(sequence, client, facts);
+            RecentOrders::getInstance().add(sequence, json_str);
+        }
+        if (valid)
+        {
+            countOrder(facts, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count());
+        }
+    }
+    if (sequence == 0)
+    {
+        std::cerr << "❌ Order could not be written to the journal.\n";
         return;
     }
 
-    const Json::Value& general_info = root["general_info"];
-    const Json::Value& action = general_info["action"];
-    const Json::Value& product = action["product"];
-    const std::string productName = product["name"].asString();
-    const int qty = product["quantity"].asInt();
+    // The thread that crosses the threshold only hands the snapshot to the worker; the others move on
+    std::uint64_t due = nextSnapshotAt.load(std::memory_order_relaxed);
+    if (snapshotConfig.everyOrders > 0 && sequence >= due &&
+        nextSnapshotAt.compare_exchange_strong(due, sequence + snapshotConfig.everyOrders))
+    {
+        SnapshotWorker::getInstance().request();
+    }
+}
 
-    if (!productName.empty() && qty > 0)
+bool saveOrderSnapshot()
+{
+    if (!ensureJournalOpen())
     {
-        productQuantities[productName] += qty;
+        return false;
     }
+
+    std::lock_guard<std::mutex> writeLock(snapshotWriteMutex);
+    std::uint64_t sequence;
+    SnapshotWriter writer;
+    {
+        std::unique_lock<std::shared_mutex> lock(snapshotMutex);
+        sequence = OrderJournal::getInstance().lastSequence();
+        OrderIndex::getInstance().dropBefore(OrderJournal::getInstance().firstSequence());
+        writer.putU64(ORDER_SNAPSHOT_VERSION);
+        ProductCounters::getInstance().save(writer);
+        OrderRollup::getInstance().save(writer);
+        OrderIndex::getInstance().save(writer);
+    }
+
+    if (!OrderJournal::getInstance().writeSnapshot(sequence, writer.data()))
+    {
+        std::cerr << "❌ Order snapshot could not be written.\n";
+        return false;
+    }
+    return true;
+}
+
+void stopOrderSnapshots()
+{
+    SnapshotWorker::getInstance().stop();
 }
 
 void printAllOrders()
 {
-    std::lock_guard<std::mutex> lock(ordersMutex);
+    OrderJournal& journal = OrderJournal::getInstance();
 
-    if (storedOrders.empty())
+    if (!ensureJournalOpen() || journal.size() == 0)
     {
         std::cout << "No orders stored yet.\n";
         return;
     }
 
     std::cout << "Stored Orders:\n";
-    for (size_t i = 0; i < storedOrders.size(); ++i)
+    journal.forEach([](const OrderRecord& record) {
+        std::cout << "[" << record.sequence << "] " << record.payload << "\n";
+    });
+}
+
+OrderPage queryStoredOrders(const OrderQuery& query)
+{
+    OrderPage page;
+    if (!ensureJournalOpen())
     {
-        std::cout << "[" << i + 1 << "] " << storedOrders[i] << "\n";
+        return page;
     }
+
+    // Records removed by retention stay in the index until the next snapshot prunes it
+    std::vector<std::uint64_t> matches = OrderIndex::getInstance().find(query.filters);
+    matches.erase(matches.begin(), std::lower_bound(matches.begin(), matches.end(),
+                                                    OrderJournal::getInstance().firstSequence()));
+    page.total = matches.size();
+    if (query.offset >= matches.size())
+    {
+        return page;
+    }
+
+    // Pages count from the newest match, which is the end of the ascending list
+    std::size_t end = matches.size() - query.offset;
+    std::size_t begin = end - std::min(query.limit, end);
+
+    // Recent orders come from the ring; only older ones are read from the journal
+    std::vector<std::uint64_t> older;
+    for (std::size_t i = end; i > begin; i--)
+    {
+        std::string payload;
+        if (RecentOrders::getInstance().get(matches[i - 1], payload))
+        {
+            page.orders.emplace_back(matches[i - 1], std::move(payload));
+        }
+        else
+        {
+            older.assign(matches.begin() + begin, matches.begin() + i);
+            break;
+        }
+    }
+
+    std::vector<std::pair<std::uint64_t, std::string>> fromJournal;
+    OrderJournal::getInstance().forEachOf(older, [&fromJournal](const OrderRecord& record) {
+        fromJournal.emplace_back(record.sequence, std::string(record.payload));
+    });
+    page.orders.insert(page.orders.end(), fromJournal.rbegin(), fromJournal.rend());
+    return page;
 }
 
 void printProductReport()
 {
-    std::lock_guard<std::mutex> lock(ordersMutex);
+    ensureJournalOpen();
 
-    if (productQuantities.empty())
+    std::map<std::string, long long> totals = ProductCounters::getInstance().totals();
+    if (totals.empty())
     {
         std::cout << "No product data stored yet.\n";
         return;
     }
 
     std::cout << "Product Quantity Report:\n";
-    for (const auto& pair : productQuantities)
+    for (const auto& pair : totals)
     {
         std::cout << "- " << pair.first << ": " << pair.second << "\n";
     }
@@ -69,7 +367,13 @@ void printProductReport()
 
 void clearStoredOrders()
 {
-    std::lock_guard<std::mutex> lock(ordersMutex);
-    storedOrders.clear();
-    productQuantities.clear();
+    bool open = ensureJournalOpen();
+    std::lock_guard<std::mutex> writeLock(snapshotWriteMutex);
+    std::unique_lock<std::shared_mutex> lock(snapshotMutex);
+    if (open)
+    {
+        OrderJournal::getInstance().clear();
+    }
+    resetStatistics();
+    nextSnapshotAt.store(snapshotConfig.everyOrders, std::memory_order_relaxed);
 }
@@ -1,7 +1,7 @@
 #include "orderValidation.hpp"
 #include "errorHandler.hpp"
 #include <json/json.h>
-#include <unordered_map>
+#include <string_view>
 
 bool validateOrderLimits(const Json::Value& root, std::string& error)
 {
@@ -28,9 +28,17 @@ bool validateOrderLimits(const Json::Value& root, std::string& error)
 
     std::string clientType = destination["type"].asString();
     std::string actionType = action["type"].asString();
-    std::string productName = product["name"].asString();
     int quantity = product["quantity"].asInt();
 
+    // The name is read in place, the catalog lookup never copies it
+    const char* nameBegin = nullptr;
+    const char* nameEnd = nullptr;
+    std::string_view productName;
+    if (product["name"].getString(&nameBegin, &nameEnd))
+    {
+        productName = std::string_view(nameBegin, static_cast<std::size_t>(nameEnd - nameBegin));
+    }
+
     if (clientType.empty() || actionType.empty() || productName.empty() || quantity <= 0)
     {
         error = ErrorHandler::generateError(ERR_INVALID_VALUES, "Invalid or missing values",
@@ -47,46 +55,29 @@ bool validateOrderLimits(const Json::Value& root, std::string& error)
         return false;
     }
 
-    bool isCritical = criticalProducts.at(productName);
-
-    if (clientType == "hub")
+    bool isCritical;
+    if (!ProductCatalog::getInstance().find(productName, isCritical))
     {
-        if (isCritical && (quantity < MIN_CRITICAL_HUB_QUANTITY || quantity > MAX_CRITICAL_HUB_QUANTITY))
-        {
-            error = ErrorHandler::generateError(ERR_INVALID_QTY_HUB_CRIT, "Invalid quantity",
-                                                "Hubs must order between 20 and 100 units of critical products.",
-                                                ErrorLevel::ERROR);
-            return false;
-        }
-        else if (!isCritical && quantity < MIN_NONCRITICAL_HUB_QUANTITY)
-        {
-            error = ErrorHandler::generateError(ERR_INVALID_QTY_HUB_NONCRIT, "Invalid quantity",
-                                                "Hubs must order at least 50 units of non-critical products.",
-                                                ErrorLevel::ERROR);
-            return false;
-        }
+        error = ErrorHandler::generateError(ERR_INVALID_VALUES, "Unknown product",
+                                            "Product '" + std::string(productName) + "' is not in the catalog.",
+                                            ErrorLevel::ERROR);
+        return false;
     }
-    else if (clientType == "external")
+
+    // The rules are held for the whole check, a reload in between does not mix two versions
+    std::shared_ptr<const OrderRuleTable> rules = OrderRules::getInstance().current();
+    int client = rules->clientIndex(clientType);
+    if (client < 0)
     {
-        if (isCritical && quantity > MAX_CRITICAL_EXTERNAL_QUANTITY)
-        {
-            error = ErrorHandler::generateError(ERR_INVALID_QTY_EXT_CRIT, "Invalid quantity",
-                                                "External clients can order up to 25 units of critical products.",
-                                                ErrorLevel::ERROR);
-            return false;
-        }
-        else if (quantity < MIN_EXTERNAL_QUANTITY)
-        {
-            error = ErrorHandler::generateError(ERR_INVALID_QTY_EXT_ANY, "Invalid quantity",
-                                                "External clients must order at least 5 units of any product.",
-                                                ErrorLevel::ERROR);
-            return false;
-        }
+        error = ErrorHandler::generateError(ERR_UNKNOWN_CLIENT_TYPE, "Unknown client type",
+                                            "Client type must be " + rules->clientList() + ".", ErrorLevel::ERROR);
+        return false;
     }
-    else
+
+    RuleViolation violation = rules->check(static_cast<std::size_t>(client), isCritical, quantity);
+    if (violation.code != 0)
     {
-        error = ErrorHandler::generateError(ERR_UNKNOWN_CLIENT_TYPE, "Unknown client type",
-                                            "Client type must be 'hub' or 'external'.",
+        error = ErrorHandler::generateError(violation.code, "Invalid quantity", std::string(violation.message),
                                             ErrorLevel::ERROR);
         return false;
     }
@@ -0,0 +1,73 @@
+#include "productCatalog.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+ProductCatalog& ProductCatalog::getInstance()
+{
+    static ProductCatalog instance;
+    static std::once_flag loaded;
+    std::call_once(loaded, [] {
+        const char* products = std::getenv("ORDER_EXTRA_PRODUCTS");
+        if (products != nullptr)
+        {
+            instance.registerProducts(products);
+        }
+    });
+    return instance;
+}
+
+bool ProductCatalog::find(std::string_view name, bool& critical) const
+{
+    int index = builtinProductIndex(name);
+    if (index >= 0)
+    {
+        critical = BUILTIN_PRODUCTS[static_cast<std::size_t>(index)].critical;
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (extra.empty())
+    {
+        return false;
+    }
+    auto it = extra.find(std::string(name));
+    if (it == extra.end())
+    {
+        return false;
+    }
+    critical = it->second;
+    return true;
+}
+
+bool ProductCatalog::registerProduct(const std::string& name, bool critical)
+{
+    if (name.empty() || builtinProductIndex(name) >= 0)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    extra[name] = critical;
+    return true;
+}
+
+std::size_t ProductCatalog::registerProducts(const std::string& list)
+{
+    std::size_t registered = 0;
+    std::istringstream stream(list);
+    std::string entry;
+    while (std::getline(stream, entry, ','))
+    {
+        std::size_t colon = entry.rfind(':');
+        std::string flag = colon == std::string::npos ? "" : entry.substr(colon + 1);
+        if ((flag != "0" && flag != "1") || !registerProduct(entry.substr(0, colon), flag == "1"))
+        {
+            std::cerr << "Invalid product '" << entry << "' in ORDER_EXTRA_PRODUCTS, skipped" << std::endl;
+            continue;
+        }
+        registered++;
+    }
+    return registered;
+}
@@ -0,0 +1,120 @@
+#include "productCounters.hpp"
+#include <mutex>
+
+std::size_t orderStatsShard()
+{
+    static std::atomic<std::size_t> nextShard{0};
+    thread_local std::size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % ORDER_STATS_SHARDS;
+    return shard;
+}
+
+static std::atomic<std::uint64_t> nextInstance{0};
+
+ProductCounters::ProductCounters() : instance(nextInstance.fetch_add(1, std::memory_order_relaxed))
+{
+}
+
+ProductCounters& ProductCounters::getInstance()
+{
+    static ProductCounters instance;
+    return instance;
+}
+
+ProductCounters::Counter& ProductCounters::counterFor(const std::string& product)
+{
+    // Counters are never freed while their instance lives, so the cached pointers stay valid
+    thread_local std::unordered_map<std::uint64_t, std::unordered_map<std::string, Counter*>> cache;
+    std::unordered_map<std::string, Counter*>& known = cache[instance];
+    auto cached = known.find(product);
+    if (cached != known.end())
+    {
+        return *cached->second;
+    }
+
+    Counter* counter;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(product);
+        counter = it != ids.end() ? &counters[it->second] : nullptr;
+    }
+    if (counter == nullptr)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(product);
+        if (it == ids.end())
+        {
+            it = ids.emplace(product, counters.size()).first;
+            counters.emplace_back(product);
+        }
+        counter = &counters[it->second];
+    }
+    known.emplace(product, counter);
+    return *counter;
+}
+
+void ProductCounters::add(const std::string& product, long long quantity)
+{
+    counterFor(product).shards[orderStatsShard()].value.fetch_add(quantity, std::memory_order_relaxed);
+}
+
+std::map<std::string, long long> ProductCounters::totals() const
+{
+    std::map<std::string, long long> result;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const Counter& counter : counters)
+    {
+        long long total = 0;
+        for (const Cell& cell : counter.shards)
+        {
+            total += cell.value.load(std::memory_order_relaxed);
+        }
+        if (total != 0)
+        {
+            result[counter.product] = total;
+        }
+    }
+    return result;
+}
+
+void ProductCounters::clear()
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (Counter& counter : counters)
+    {
+        for (Cell& cell : counter.shards)
+        {
+            cell.value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ProductCounters::save(SnapshotWriter& writer) const
+{
+    std::map<std::string, long long> current = totals();
+    writer.putU64(current.size());
+    for (const auto& entry : current)
+    {
+        writer.putString(entry.first);
+        writer.putI64(entry.second);
+    }
+}
+
+bool ProductCounters::load(SnapshotReader& reader)
+{
+    std::uint64_t count;
+    if (!reader.getU64(count))
+    {
+        return false;
+    }
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        std::string product;
+        std::int64_t total;
+        if (!reader.getString(product) || !reader.getI64(total))
+        {
+            return false;
+        }
+        add(product, total);
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#include "recentOrders.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+std::size_t loadRecentOrdersCapacity()
+{
+    std::size_t capacity = RECENT_ORDERS_CAPACITY;
+    const char* value = std::getenv("ORDER_RING_CAPACITY");
+    if (value != nullptr)
+    {
+        try
+        {
+            capacity = std::max(1, std::stoi(value));
+        }
+        catch (const std::exception&)
+        {
+            std::cerr << "Invalid ORDER_RING_CAPACITY, using " << capacity << std::endl;
+        }
+    }
+    return capacity;
+}
+
+RecentOrders::RecentOrders(std::size_t capacity) : slots(std::max<std::size_t>(capacity, 1))
+{
+}
+
+RecentOrders& RecentOrders::getInstance()
+{
+    static RecentOrders instance(loadRecentOrdersCapacity());
+    return instance;
+}
+
+void RecentOrders::add(std::uint64_t sequence, std::string_view payload)
+{
+    Slot& slot = slots[sequence % slots.size()];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (slot.sequence > sequence)
+    {
+        return;
+    }
+    slot.sequence = sequence;
+    slot.payload.assign(payload.data(), payload.size());
+}
+
+bool RecentOrders::get(std::uint64_t sequence, std::string& payload) const
+{
+    const Slot& slot = slots[sequence % slots.size()];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (sequence == 0 || slot.sequence != sequence)
+    {
+        return false;
+    }
+    payload = slot.payload;
+    return true;
+}
+
+std::size_t RecentOrders::capacity() const
+{
+    return slots.size();
+}
+
+void RecentOrders::clear()
+{
+    for (Slot& slot : slots)
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.sequence = 0;
+        slot.payload.clear();
+    }
+}
@@ -0,0 +1,139 @@
+#include "responseChunks.hpp"
+#include <algorithm>
+#include <sstream>
+
+static bool invalidCursor(const std::string& cursor, std::string& error)
+{
+    error = ErrorHandler::generateError(ERR_INVALID_CURSOR, "Invalid CONTINUE cursor",
+                                        "Unknown or expired cursor '" + cursor +
+                                            "'. Use CONTINUE <stream>:<index> or request the report again.",
+                                        ErrorLevel::ERROR);
+    return false;
+}
+
+std::vector<std::string> splitResponse(const std::string& response, std::size_t chunkSize)
+{
+    std::vector<std::string> chunks;
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    for (std::size_t offset = 0; offset < response.size(); offset += chunkSize)
+    {
+        chunks.push_back(response.substr(offset, chunkSize));
+    }
+    if (chunks.empty())
+    {
+        chunks.emplace_back();
+    }
+    return chunks;
+}
+
+std::string formatChunkFrame(std::uint64_t stream, std::size_t index, std::size_t count, const std::string& payload,
+                             const std::string& cursor)
+{
+    std::ostringstream frame;
+    frame << CHUNK_FRAME_PREFIX << " " << stream << " " << index << " " << count << " " << payload.size() << " "
+          << cursor << "\n"
+          << payload;
+    return frame.str();
+}
+
+ResponseStreams::ResponseStreams(std::chrono::seconds ttl) : ttl(ttl)
+{
+}
+
+ResponseStreams& ResponseStreams::getInstance()
+{
+    static ResponseStreams instance;
+    return instance;
+}
+
+std::vector<std::string> ResponseStreams::framesOf(std::uint64_t id, const Stream& stream, std::size_t from,
+                                                   std::size_t window)
+{
+    std::size_t count = stream.chunks.size();
+    std::size_t to = window == 0 ? count : std::min(count, from + window);
+
+    std::vector<std::string> result;
+    for (std::size_t index = from; index < to; index++)
+    {
+        // Only the last frame of a window tells the client where to continue
+        std::string cursor = index + 1 == to && to < count ? std::to_string(id) + ":" + std::to_string(to) : "-";
+        result.push_back(formatChunkFrame(id, index, count, stream.chunks[index], cursor));
+    }
+    return result;
+}
+
+void ResponseStreams::expireLocked(std::chrono::steady_clock::time_point now)
+{
+    for (auto it = streams.begin(); it != streams.end();)
+    {
+        it = it->second.expires <= now ? streams.erase(it) : std::next(it);
+    }
+}
+
+std::vector<std::string> ResponseStreams::start(int clientId, const std::string& protocol,
+                                                const std::string& response, std::size_t window)
+{
+    if (response.size() <= RESPONSE_CHUNK_SIZE)
+    {
+        return {response};
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    Stream stream{clientId, protocol, splitResponse(response), now + ttl};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::uint64_t id = nextStream++;
+    std::vector<std::string> result = framesOf(id, stream, 0, window);
+    if (window != 0)
+    {
+        expireLocked(now);
+        while (streams.size() >= RESPONSE_STREAMS_MAX)
+        {
+            streams.erase(streams.begin());
+        }
+        streams.emplace(id, std::move(stream));
+    }
+    return result;
+}
+
+bool ResponseStreams::resume(int clientId, const std::string& protocol, const std::string& command,
+                             std::size_t window, std::vector<std::string>& frames, std::string& error)
+{
+    frames.clear();
+
+    std::istringstream stream(command);
+    std::string token;
+    std::string cursor;
+    stream >> token >> cursor;
+
+    std::uint64_t id;
+    std::size_t index;
+    char separator;
+    std::istringstream cursorStream(cursor);
+    if (token != CONTINUE_COMMAND || !(cursorStream >> id >> separator >> index) || separator != ':' ||
+        !cursorStream.eof() || stream >> token)
+    {
+        return invalidCursor(cursor, error);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    expireLocked(now);
+
+    auto it = streams.find(id);
+    if (it == streams.end() || it->second.clientId != clientId || it->second.protocol != protocol ||
+        index >= it->second.chunks.size())
+    {
+        return invalidCursor(cursor, error);
+    }
+
+    it->second.expires = now + ttl;
+    frames = framesOf(id, it->second, index, window);
+    return true;
+}
+
+std::size_t ResponseStreams::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return streams.size();
+}
@@ -0,0 +1,174 @@
+#include "stockQuery.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+static std::string toLower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+static bool invalidFilter(const std::string& filter, std::string& error)
+{
+    error = ErrorHandler::generateError(ERR_INVALID_STOCK_QUERY, "Invalid GET_STOCK filter",
+                                        "Unsupported filter '" + filter +
+                                            "'. Use type=hub|warehouse, location=<id>[,<id>...] and product=<name> or product=\"<name>\".",
+                                        ErrorLevel::ERROR);
+    return false;
+}
+
+static bool parseLocations(const std::string& value, std::vector<int>& locations)
+{
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        try
+        {
+            std::size_t consumed = 0;
+            int location = std::stoi(item, &consumed);
+            if (consumed != item.size() || location < 0)
+            {
+                return false;
+            }
+            locations.push_back(location);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+    return !locations.empty();
+}
+
+static bool readFilter(std::istringstream& stream, std::string& token)
+{
+    if (!(stream >> token))
+    {
+        return false;
+    }
+
+    // A quoted value may contain spaces: product="Canned Food"
+    std::size_t separator = token.find('=');
+    bool opensQuote = separator != std::string::npos && separator + 1 < token.size() && token[separator + 1] == '"';
+    if (opensQuote && (token.size() == separator + 2 || token.back() != '"'))
+    {
+        std::string rest;
+        if (std::getline(stream, rest, '"') && !stream.eof())
+        {
+            token += rest + '"';
+        }
+    }
+    return true;
+}
+
+static bool unquote(std::string& value)
+{
+    if (value.front() != '"')
+    {
+        return true;
+    }
+    if (value.size() < 3 || value.back() != '"')
+    {
+        return false;
+    }
+    value = value.substr(1, value.size() - 2);
+    return value.find('"') == std::string::npos;
+}
+
+bool parseStockQuery(const std::string& command, StockQuery& query, std::string& error)
+{
+    query = StockQuery();
+
+    std::istringstream stream(command);
+    std::string token;
+    stream >> token;
+    if (token != GET_STOCK_COMMAND)
+    {
+        return invalidFilter(token, error);
+    }
+
+    while (readFilter(stream, token))
+    {
+        std::size_t separator = token.find('=');
+        if (separator == std::string::npos || separator + 1 == token.size())
+        {
+            return invalidFilter(token, error);
+        }
+
+        std::string key = toLower(token.substr(0, separator));
+        std::string value = token.substr(separator + 1);
+        if (!unquote(value))
+        {
+            return invalidFilter(token, error);
+        }
+
+        if (key == "type")
+        {
+            LocationType type;
+            if (!parseLocationType(toLower(value), type))
+            {
+                return invalidFilter(token, error);
+            }
+            query.types.push_back(type);
+        }
+        else if (key == "location")
+        {
+            if (!parseLocations(value, query.locations))
+            {
+                return invalidFilter(token, error);
+            }
+        }
+        else if (key == "product")
+        {
+            query.product = value;
+        }
+        else
+        {
+            return invalidFilter(token, error);
+        }
+    }
+
+    if (query.types.empty())
+    {
+        query.types = {LocationType::HUB, LocationType::WAREHOUSE};
+    }
+    return true;
+}
+
+bool matchesStockQuery(const StockQuery& query, const StockLevel& level)
+{
+    return query.product.empty() || toLower(query.product) == toLower(level.product);
+}
+
+std::string formatStockReport(std::vector<StockLevel> levels)
+{
+    if (levels.empty())
+    {
+        return "No stock matches the query.\n";
+    }
+
+    std::sort(levels.begin(), levels.end(), [](const StockLevel& a, const StockLevel& b) {
+        if (a.type != b.type)
+        {
+            return a.type < b.type;
+        }
+        if (a.locationId != b.locationId)
+        {
+            return a.locationId < b.locationId;
+        }
+        return a.product < b.product;
+    });
+
+    std::ostringstream msgStream;
+    msgStream << "\n----- Stock Report -----\n";
+    for (const auto& level : levels)
+    {
+        msgStream << "- " << locationTypeName(level.type) << " " << level.locationId << " " << level.product << ": "
+                  << level.quantity << "\n";
+    }
+    msgStream << "------------------------";
+    return msgStream.str();
+}
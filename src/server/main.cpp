@@ -1,5 +1,78 @@
 #include "server.hpp"
 
+// Inventario en MySQL: caché precargada, write-behind opcional e hilos dedicados a la base de datos
+static bool startMySqlInventory()
+{
+    // Precargar el inventario en memoria para que las consultas de stock no lleguen a la base de datos
+    try
+    {
+        mysqlx::Session session = connectToDb();
+        loadInventoryCache(session);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "No se pudo precargar el inventario, se consultará la base de datos: " << e.what() << std::endl;
+    }
+
+    // Modo write-behind: el flusher usa su propia sesión para los group commits
+    WriteBehindConfig writeBehindConfig = loadWriteBehindConfig();
+    if (writeBehindConfig.enabled)
+    {
+        try
+        {
+            auto flushSession = std::make_shared<mysqlx::Session>(connectToDb());
+            InventoryStatements::attach(*flushSession);
+            bool started = InventoryWriteBehind::getInstance().start(
+                writeBehindConfig,
+                [flushSession](const std::vector<InventoryDelta>& deltas) {
+                    return commitInventoryDeltas(*flushSession, deltas);
+                },
+                [flushSession]() { return loadInventoryCache(*flushSession) >= 0; });
+            if (!started)
+            {
+                std::cerr << "Write-behind requiere el inventario precargado, se usarán commits individuales."
+                          << std::endl;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "No se pudo iniciar el modo write-behind: " << e.what() << std::endl;
+        }
+    }
+
+    // Hilos dedicados a MySQL: cada uno tiene su propia sesión y los hilos de red nunca esperan a la base de datos
+    if (!InventoryExecutor::getInstance().start(loadDbThreads(), connectToDb))
+    {
+        std::cerr << "No se pudieron iniciar los hilos de base de datos." << std::endl;
+        InventoryWriteBehind::getInstance().stop();
+        return false;
+    }
+
+    return true;
+}
+
+// Inventario embebido: sin servidor MySQL, opcionalmente persistido en un archivo local
+static bool startEmbeddedInventory(Server* server, const InventoryBackendConfig& config)
+{
+    auto store = std::make_shared<EmbeddedInventoryStore>();
+    if (!config.path.empty() && !store->open(config.path))
+    {
+        std::cerr << "No se pudo abrir el archivo de inventario " << config.path << std::endl;
+        return false;
+    }
+
+    // Sin filas el servidor rechazaría todas las órdenes: se carga el inventario de database.sql
+    if (store->size() == 0 && store->seed() == 0)
+    {
+        std::cerr << "No se pudo cargar el inventario inicial." << std::endl;
+        return false;
+    }
+
+    server->setInventoryStore(store);
+    std::cout << "Inventario embebido con " << store->size() << " filas." << std::endl;
+    return true;
+}
+
 int main()
 {
     const char* portEnv = std::getenv("SERVER_PORT");
@@ -19,11 +92,52 @@ int main()
 
     Server* server = Server::getInstance(port);
 
+    // Cargar las reglas de cantidades antes de aceptar pedidos, para informar un archivo inválido al arrancar
+    OrderRules::getInstance();
+
+    // Reconstruir el historial de pedidos desde el último snapshot y el final del journal
+    auto loadStart = std::chrono::steady_clock::now();
+    long long storedOrders = loadStoredOrders();
+    if (storedOrders >= 0)
+    {
+        std::cout << "Journal de pedidos abierto con " << storedOrders << " pedidos en "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - loadStart)
+                         .count()
+                  << " ms." << std::endl;
+    }
+
+    InventoryBackendConfig backendConfig = loadInventoryBackendConfig();
+    bool inventoryStarted = backendConfig.backend == InventoryBackend::EMBEDDED
+                                ? startEmbeddedInventory(server, backendConfig)
+                                : startMySqlInventory();
+    if (!inventoryStarted)
+    {
+        server->closeServer();
+        return 1;
+    }
+
+    // Reponer los almacenes en segundo plano, fuera del camino de los pedidos
+    RestockScheduler::getInstance().start(
+        [server](std::function<void(InventoryStore&)> task) { return server->runInventoryTask(std::move(task)); });
+
+    // Enviar los eventos suscritos desde su propio hilo, para que un suscriptor lento no frene los pedidos
+    EventFeed::getInstance().start(
+        [server](const EventBatch& batch) { server->sendResponse(batch.message, batch.clientId, batch.protocol); });
+
     std::thread cleanupThread([&server]() {
         while (true)
         {
             std::this_thread::sleep_for(std::chrono::seconds(CHRONO_TIMEOUT_SECONDS));
             server->cleanupInactiveUdpClients(std::chrono::seconds(CHRONO_TIMEOUT));
+            // Recargar las reglas de cantidades si su archivo cambió, sin reiniciar el servidor
+            OrderRules::getInstance().reloadIfChanged();
+            // Resumir las alertas repetidas que se retuvieron durante la ventana que terminó
+            // y publicarlas en el tema de las alertas que resumen
+            for (const std::string& summary : AlertManager::getInstance().flush())
+            {
+                std::cout << "Alertas agrupadas: " << summary << std::endl;
+                publishAlertSummary(summary);
+            }
         }
     });
 
@@ -36,6 +150,14 @@ int main()
         std::cerr << "Error durante la ejecución del servidor: " << e.what() << std::endl;
     }
 
+    RestockScheduler::getInstance().stop();
+    InventoryExecutor::getInstance().stop();
+    EventFeed::getInstance().stop();
+    InventoryWriteBehind::getInstance().stop();
+    // Guardar las estadísticas de pedidos para que el próximo arranque no relea todo el journal
+    stopOrderSnapshots();
+    saveOrderSnapshot();
+    OrderJournal::getInstance().close();
     server->closeServer();
     cleanupThread.join();
 
@@ -6,6 +6,31 @@ int nextClientId_tcp = 1;
 
 std::map<int, ClientInfo> clientMapUdp; // PID -> ClientInfo
 std::map<int, ClientInfo> clientMapTcp; // PID -> ClientInfo
+std::mutex clientMapMutex;
+
+TcpConnection::TcpConnection(int socket_fd) : socket_fd(socket_fd)
+{
+}
+
+bool TcpConnection::send(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (closed)
+    {
+        return false;
+    }
+    return write(socket_fd, message.c_str(), message.size()) >= 0;
+}
+
+void TcpConnection::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!closed)
+    {
+        ::close(socket_fd);
+        closed = true;
+    }
+}
 
 Server::Server(int port)
 {
@@ -70,19 +95,24 @@ ClientInfo* Server::findClientById(int clientId, const std::string& protocol)
 
 void Server::forwardMessageToClient(const std::string& message, int targetClientId, const std::string& protocol)
 {
-    ClientInfo* targetClient = findClientById(targetClientId, protocol);
-
-    if (!targetClient)
+    // Copied under the lock: the client may disconnect while the message is being sent
+    ClientInfo targetClient;
     {
-        std::cerr << "Client ID " << targetClientId << " not found for protocol " << protocol << std::endl;
-        return;
+        std::lock_guard<std::mutex> lock(clientMapMutex);
+        ClientInfo* found = findClientById(targetClientId, protocol);
+        if (!found)
+        {
+            std::cerr << "Client ID " << targetClientId << " not found for protocol " << protocol << std::endl;
+            return;
+        }
+        targetClient = *found;
     }
 
     if (protocol == "udp")
     {
-        socklen_t addr_size = sizeof(targetClient->addr);
+        socklen_t addr_size = sizeof(targetClient.addr);
         int n =
-            sendto(socketUdpFd, message.c_str(), message.length(), 0, (struct sockaddr*)&targetClient->addr, addr_size);
+            sendto(socketUdpFd, message.c_str(), message.length(), 0, (struct sockaddr*)&targetClient.addr, addr_size);
         if (n < 0)
         {
             perror("ERROR forwarding message via UDP");
@@ -94,8 +124,7 @@ void Server::forwardMessageToClient(const std::string& message, int targetClient
     }
     else if (protocol == "tcp")
     {
-        int n = write(targetClient->socket_fd, message.c_str(), message.length());
-        if (n < 0)
+        if (!targetClient.connection || !targetClient.connection->send(message))
         {
             perror("ERROR forwarding message via TCP");
         }
@@ -110,8 +139,20 @@ void Server::forwardMessageToClient(const std::string& message, int targetClient
     }
 }
 
-int Server::registerClient(int pid, const std::string& protocol, struct sockaddr_in addr, int socket_fd)
+void Server::sendResponse(const std::string& response, int targetClientId, const std::string& protocol)
 {
+    // UDP clients pull the frames past the first window, so a long report never floods their socket
+    std::size_t window = protocol == "udp" ? RESPONSE_CHUNK_WINDOW : 0;
+    for (const std::string& message : ResponseStreams::getInstance().start(targetClientId, protocol, response, window))
+    {
+        forwardMessageToClient(message, targetClientId, protocol);
+    }
+}
+
+int Server::registerClient(int pid, const std::string& protocol, struct sockaddr_in addr, int socket_fd,
+                           std::shared_ptr<TcpConnection> connection)
+{
+    std::lock_guard<std::mutex> lock(clientMapMutex);
 
     // Check if the protocol is valid
     if (protocol != "UDP" && protocol != "TCP")
@@ -152,6 +193,7 @@ int Server::registerClient(int pid, const std::string& protocol, struct sockaddr
     }
     else
     {
+        info.connection = connection ? std::move(connection) : std::make_shared<TcpConnection>(socket_fd);
         clientMapTcp[pid] = info;
     }
 
@@ -163,22 +205,33 @@ int Server::registerClient(int pid, const std::string& protocol, struct sockaddr
 void Server::cleanupInactiveUdpClients(std::chrono::seconds timeout)
 {
     auto now = std::chrono::steady_clock::now();
-    for (auto it = clientMapUdp.begin(); it != clientMapUdp.end();)
+    std::vector<int> removed;
     {
-        if (now - it->second.last_seen > timeout)
+        std::lock_guard<std::mutex> lock(clientMapMutex);
+        for (auto it = clientMapUdp.begin(); it != clientMapUdp.end();)
         {
-            std::cout << "Removing inactive UDP client #" << it->second.client_id << std::endl;
-            it = clientMapUdp.erase(it); // borra y avanza el iterador correctamente
-        }
-        else
-        {
-            ++it;
+            if (now - it->second.last_seen > timeout)
+            {
+                std::cout << "Removing inactive UDP client #" << it->second.client_id << std::endl;
+                removed.push_back(it->second.client_id);
+                it = clientMapUdp.erase(it); // borra y avanza el iterador correctamente
+            }
+            else
+            {
+                ++it;
+            }
         }
     }
+
+    for (int clientId : removed)
+    {
+        EventFeed::getInstance().removeClient(clientId, "udp");
+    }
 }
 
 void Server::listConnectedClients()
 {
+    std::lock_guard<std::mutex> lock(clientMapMutex);
     std::cout << "\n----- Connected Clients -----" << std::endl;
     std::cout << "UDP Clients: " << clientMapUdp.size() << std::endl;
     for (const auto& pair : clientMapUdp)
@@ -274,13 +327,6 @@ void Server::handleUdpClients()
     char buffer[BUFFER_SIZE_SERVER];
     int n;
     int client_id = 0;
-    bool isValid = true;
-    bool productStock = true;
-    bool lowStock = false;
-    bool reStocked = false;
-    std::string alertOut;
-    std::string errorMessage;
-    mysqlx::Session session = connectToDb();
 
     while (running)
     {
@@ -295,7 +341,12 @@ void Server::handleUdpClients()
 
         int client_pid = atoi(buffer);
 
-        if (clientMapUdp.find(client_pid) == clientMapUdp.end() && client_pid != 0)
+        bool known;
+        {
+            std::lock_guard<std::mutex> lock(clientMapMutex);
+            known = clientMapUdp.find(client_pid) != clientMapUdp.end();
+        }
+        if (!known && client_pid != 0)
         {
             client_id = registerClient(client_pid, "UDP", cli_addr, 0);
             continue;
@@ -310,91 +361,16 @@ void Server::handleUdpClients()
 
         if (buffer[0] == '{')
         {
-            storeOrder(buffer);
-
-            // --- JSON parsing ---
-            Json::CharReaderBuilder builder;
-            Json::CharReader* reader = builder.newCharReader();
-            Json::Value root;
-            std::string parseErrors;
-
-            bool parsingSuccessful = reader->parse(buffer, buffer + strlen(buffer), &root, &parseErrors);
-            delete reader;
-
-            if (!parsingSuccessful)
-            {
-                std::cout << "Error parsing JSON: " << parseErrors << std::endl;
-                continue; // salta a la próxima iteración
-            }
-
-            isValid = validateOrderLimits(root, errorMessage);
-            if (!isValid)
-            {
-                std::cout << "\n\nError validating order limits: " << errorMessage << std::endl;
-                n = sendto(socketUdpFd, errorMessage.c_str(), errorMessage.size(), 0, (struct sockaddr*)&cli_addr,
-                           addr_size);
-                if (n < 0)
-                {
-                    perror("ERROR in sendto UDP");
-                }
-            }
-
-            productStock = checkProductStock(root, errorMessage, session);
-            if (!productStock)
-            {
-                std::cout << "\n\nError checking product stock: " << errorMessage << std::endl;
-                n = sendto(socketUdpFd, errorMessage.c_str(), errorMessage.size(), 0, (struct sockaddr*)&cli_addr,
-                           addr_size);
-                if (n < 0)
-                {
-                    perror("ERROR in sendto UDP");
-                }
-            }
-
-            if (productStock && isValid)
-            {
-                int result = realTimeUpdate(session, root);
-                if (result > 0)
-                {
-                    std::string orderSuccess = "Successful order!";
-                    n = sendto(socketUdpFd, orderSuccess.c_str(), orderSuccess.size(), 0, (struct sockaddr*)&cli_addr,
-                               addr_size);
-                    if (n < 0)
-                    {
-                        perror("ERROR in sendto UDP");
-                    }
-                }
-                else
-                {
-                    std::cout << "❌ Error updating inventory." << std::endl;
-                }
-            }
-
-            // Check for low stock
-            lowStock = checkLowStockAlert(session, root, alertOut);
-            if (lowStock)
-            {
-                std::cout << "\n\nLow stock alert: " << alertOut << std::endl;
-                n = sendto(socketUdpFd, alertOut.c_str(), alertOut.size(), 0, (struct sockaddr*)&cli_addr, addr_size);
-                if (n < 0)
+            handleOrder(buffer, "UDP", client_id, [this, cli_addr, addr_size](const std::string& message) {
+                int sent = sendto(socketUdpFd, message.c_str(), message.size(), 0, (struct sockaddr*)&cli_addr,
+                                  addr_size);
+                if (sent < 0)
                 {
                     perror("ERROR in sendto UDP");
                 }
-            }
-
-            // Check for re-stock
-            reStocked = reStock(session, root, alertOut);
-            if (reStocked)
-            {
-                std::cout << "\n\nRe-stock alert: " << alertOut << std::endl;
-                n = sendto(socketUdpFd, alertOut.c_str(), alertOut.size(), 0, (struct sockaddr*)&cli_addr, addr_size);
-                if (n < 0)
-                {
-                    perror("ERROR in sendto UDP");
-                }
-            }
+            });
         }
-        if (isValid && productStock)
+        else
         {
             processMessage(buffer, "UDP", client_id);
         }
@@ -428,13 +404,6 @@ void Server::handleTcpClient(int client_sockfd, struct sockaddr_in cli_addr)
     char buffer[BUFFER_SIZE_SERVER];
     int n;
     int client_id = 0;
-    bool isValid = true;
-    bool productStock = true;
-    bool lowStock = false;
-    bool reStocked = false;
-    std::string alertOut;
-    std::string errorMessage;
-    mysqlx::Session session = connectToDb();
 
     // Primera recepción para obtener el PID
     memset(buffer, 0, BUFFER_SIZE_SERVER);
@@ -446,10 +415,13 @@ void Server::handleTcpClient(int client_sockfd, struct sockaddr_in cli_addr)
         return;
     }
 
+    // Every reply goes through the shared connection, which is never written once closed
+    auto connection = std::make_shared<TcpConnection>(client_sockfd);
+
     int client_pid = atoi(buffer);
     if (client_pid != 0)
     {
-        client_id = registerClient(client_pid, "TCP", cli_addr, client_sockfd);
+        client_id = registerClient(client_pid, "TCP", cli_addr, client_sockfd, connection);
     }
 
     // Loop para recibir mensajes de este cliente
@@ -462,20 +434,25 @@ void Server::handleTcpClient(int client_sockfd, struct sockaddr_in cli_addr)
         {
             // Cliente desconectado o error
             std::cout << "TCP client disconnected (PID: " << client_pid << ")" << std::endl;
-            close(client_sockfd);
             // Eliminar cliente de la lista
             if (client_pid != 0)
             {
-                clientMapTcp.erase(client_pid);
+                std::lock_guard<std::mutex> lock(clientMapMutex);
+                auto it = clientMapTcp.find(client_pid);
+                if (it != clientMapTcp.end() && it->second.connection == connection)
+                {
+                    clientMapTcp.erase(it);
+                }
             }
+            connection->close();
+            EventFeed::getInstance().removeClient(client_id, "tcp");
             listConnectedClients();
             break;
         }
 
         // Respond to the client first
         std::string response = "TCP Server received your message.";
-        int written = write(client_sockfd, response.c_str(), response.size());
-        if (written < 0)
+        if (!connection->send(response))
         {
             perror("ERROR writing to TCP socket");
             continue;
@@ -483,96 +460,304 @@ void Server::handleTcpClient(int client_sockfd, struct sockaddr_in cli_addr)
 
         if (buffer[0] == '{')
         {
-            storeOrder(buffer);
+            handleOrder(buffer, "TCP", client_id, [connection](const std::string& message) {
+                if (!connection->send(message))
+                {
+                    perror("ERROR writing to TCP socket");
+                }
+            });
+        }
+        else
+        {
+            processMessage(buffer, "TCP", client_id);
+        }
+    }
+}
+
+void Server::setInventoryStore(std::shared_ptr<InventoryStore> store)
+{
+    inventoryStore = std::move(store);
+}
+
+bool Server::runInventoryTask(std::function<void(InventoryStore&)> task)
+{
+    if (inventoryStore)
+    {
+        task(*inventoryStore);
+        return true;
+    }
 
-            // --- JSON parsing ---
-            Json::CharReaderBuilder builder;
-            Json::CharReader* reader = builder.newCharReader();
-            Json::Value root;
-            std::string parseErrors;
+    return InventoryExecutor::getInstance().post([task](mysqlx::Session& session) {
+        MySqlInventoryStore store(session);
+        task(store);
+    });
+}
 
-            bool parsingSuccessful = reader->parse(buffer, buffer + strlen(buffer), &root, &parseErrors);
-            delete reader;
+static std::string retryLaterError()
+{
+    return ErrorHandler::generateError(ERROR_SERVICE_UNAVAILABLE, "Inventory temporarily unavailable",
+                                       "The inventory database is not responding. Please retry the order later.",
+                                       ErrorLevel::ERROR);
+}
 
-            if (!parsingSuccessful)
-            {
-                std::cout << "Error parsing JSON: " << parseErrors << std::endl;
-                continue; // salta a la próxima iteración
-            }
+static void checkStockAlerts(InventoryStore& store, const Json::Value& root, const Server::ReplyFunction& reply)
+{
+    // Low stock and re-stock alerts, once per threshold crossing; a malformed order only loses its alerts
+    std::vector<std::string> alerts;
+    try
+    {
+        collectStockAlerts(store, root, alerts);
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "❌ Error checking stock alerts: " << err.what() << std::endl;
+    }
+    for (const std::string& alert : alerts)
+    {
+        std::cout << "\n\nStock alert: " << alert << std::endl;
+        reply(alert);
+    }
+}
+
+static void publishStockChange(InventoryStore& store, const Json::Value& location, const std::string& product)
+{
+    // Without subscribers the order does not even parse the location
+    EventFeed& feed = EventFeed::getInstance();
+    if (feed.subscribers() == 0)
+    {
+        return;
+    }
+
+    std::string typeName = location["type"].asString();
+    LocationType type;
+    if (!parseLocationType(typeName, type))
+    {
+        return;
+    }
+
+    // Clients send the location as a number or a numeric string, like the inventory transfer accepts it
+    int locationId;
+    try
+    {
+        const Json::Value& value = location["location"];
+        locationId = value.isString() ? std::stoi(value.asString()) : value.asInt();
+    }
+    catch (const std::exception&)
+    {
+        return;
+    }
+
+    std::string topic = stockTopic(typeName, locationId);
+    // Without subscribers to this location the order does not pay for the extra read
+    if (!feed.wants(topic))
+    {
+        return;
+    }
+
+    int quantity = store.getQuantity(type, locationId, product);
+    if (quantity < 0)
+    {
+        return;
+    }
+
+    Json::Value data;
+    data["location_type"] = typeName;
+    data["location"] = locationId;
+    data["product"] = product;
+    data["quantity"] = quantity;
+    feed.publish(topic, data);
+}
+
+static void publishStockChanges(InventoryStore& store, const Json::Value& root)
+{
+    // Runs after the transfer was applied, so a field of the wrong type only skips the events
+    try
+    {
+        const Json::Value& general_info = root["general_info"];
+        std::string product = general_info["action"]["product"]["name"].asString();
+        publishStockChange(store, general_info["source"], product);
+        publishStockChange(store, general_info["destination"], product);
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "❌ Error publishing stock changes: " << err.what() << std::endl;
+    }
+}
 
-            isValid = validateOrderLimits(root, errorMessage);
-            if (!isValid)
+void Server::handleOrder(const std::string& order, const std::string& protocol, int client_id, ReplyFunction reply)
+{
+    // --- JSON parsing ---
+    Json::CharReaderBuilder builder;
+    Json::CharReader* reader = builder.newCharReader();
+    Json::Value root;
+    std::string parseErrors;
+
+    bool parsingSuccessful = reader->parse(order.data(), order.data() + order.size(), &root, &parseErrors);
+    delete reader;
+
+    // A retried order gets the replies of the original instead of being applied twice
+    std::string orderId;
+    if (parsingSuccessful && root.isObject() && root["general_info"].isObject() &&
+        root["general_info"]["id"].isString())
+    {
+        orderId = root["general_info"]["id"].asString();
+    }
+    // IDs are chosen by the clients, so the same one from another client is another order
+    std::string dedupKey = OrderDedup::makeKey(client_id, protocol, orderId);
+    if (!dedupKey.empty())
+    {
+        std::vector<std::string> replies;
+        DedupState state = OrderDedup::getInstance().begin(dedupKey, replies);
+        if (state == DedupState::PENDING)
+        {
+            std::cout << "Duplicate order " << orderId << " from client #" << client_id << ", still in progress."
+                      << std::endl;
+            reply("Order " + orderId + " is already being processed.");
+            return;
+        }
+        if (state == DedupState::DONE)
+        {
+            std::cout << "Duplicate order " << orderId << " from client #" << client_id << ", replaying its result."
+                      << std::endl;
+            for (const std::string& message : replies)
             {
-                std::cout << "\n\nError validating order limits: " << errorMessage << std::endl;
-                int written = write(client_sockfd, errorMessage.c_str(), errorMessage.size());
-                if (written < 0)
-                {
-                    perror("ERROR writing to TCP socket valid order");
-                    continue;
-                }
+                reply(message);
             }
+            return;
+        }
+
+        reply = [dedupKey, reply](const std::string& message) {
+            OrderDedup::getInstance().record(dedupKey, message);
+            reply(message);
+        };
+    }
+
+    // Fail fast while the inventory database is down instead of queuing orders that would block on it.
+    // Once the cool-down elapses the order goes through, and its inventory update is the half-open probe.
+    if (parsingSuccessful && !inventoryStore && !CircuitBreaker::getInstance().wouldAllowRequest())
+    {
+        std::cout << "❌ Inventory database unavailable, order from client #" << client_id << " rejected." << std::endl;
+        OrderDedup::getInstance().forget(dedupKey);
+        reply(retryLaterError());
+        return;
+    }
+
+    if (!parsingSuccessful)
+    {
+        storeOrder(order, client_id);
+        std::cout << "Error parsing JSON: " << parseErrors << std::endl;
+        return;
+    }
+
+    std::string errorMessage;
+    bool isValid = validateOrderLimits(root, errorMessage);
+    if (!isValid)
+    {
+        std::cout << "\n\nError validating order limits: " << errorMessage << std::endl;
+        reply(errorMessage);
+    }
 
-            productStock = checkProductStock(root, errorMessage, session);
+    // Only orders with a final answer are journaled; the ones told to retry are stored when a retry settles
+    auto settleOrder = [order, dedupKey, client_id]() {
+        storeOrder(order, client_id);
+        OrderDedup::getInstance().finish(dedupKey);
+    };
+    auto dropOrder = [orderId, dedupKey, reply](const std::string& error) {
+        std::cout << "❌ Order " << orderId << " was not applied, its retries will be processed." << std::endl;
+        OrderDedup::getInstance().forget(dedupKey);
+        reply(error);
+    };
+
+    // Everything below reads the inventory; with MySQL it runs on the inventory workers instead of the network thread
+    bool queued = runInventoryTask([this, order, orderId, protocol, client_id, reply, root, isValid, settleOrder,
+                                    dropOrder](InventoryStore& store) {
+        // Nothing before the transfer result changes the inventory, so a failure here is answered and forgotten
+        try
+        {
+            std::string stockError;
+            bool productStock = checkProductStock(root, stockError, store);
             if (!productStock)
             {
-                std::cout << "\n\nError checking product stock: " << errorMessage << std::endl;
-                int written = write(client_sockfd, errorMessage.c_str(), errorMessage.size());
-                if (written < 0)
-                {
-                    perror("ERROR writing to TCP socket check stock");
-                    continue;
-                }
+                std::cout << "\n\nError checking product stock: " << stockError << std::endl;
+                reply(stockError);
             }
 
-            if (productStock && isValid)
+            if (!productStock || !isValid)
             {
-                int result = realTimeUpdate(session, root);
+                checkStockAlerts(store, root, reply);
+                settleOrder();
+                return;
+            }
+
+            auto finishOrder = [this, order, orderId, protocol, client_id, reply, root, settleOrder,
+                                dropOrder](int result, InventoryStore& resultStore) {
                 if (result > 0)
                 {
-                    std::string orderSuccess = "Successful order!";
-                    int written = write(client_sockfd, orderSuccess.c_str(), orderSuccess.size());
-                    if (written < 0)
-                    {
-                        perror("ERROR writing to TCP socket order success");
-                        continue;
-                    }
+                    reply("Successful order!");
+                    publishStockChanges(resultStore, root);
+                }
+                else if (result == TRANSFER_COMPENSATION_FAILED)
+                {
+                    // Not retryable: the source already lost the units, a retry would take them twice
+                    std::cout << "❌ Order " << orderId << " left the inventory out of balance." << std::endl;
+                    reply(ErrorHandler::generateError(ERROR_CODE, "Inventory out of balance",
+                                                      "The order was not applied and its source stock is pending "
+                                                      "reconciliation. Do not retry it.",
+                                                      ErrorLevel::ERROR));
                 }
                 else
                 {
+                    // The transfer left both rows as they were: the database failed, or another order took the stock
                     std::cout << "❌ Error updating inventory." << std::endl;
+                    bool unavailable = result == WRITE_BEHIND_RETRY_LATER ||
+                                       CircuitBreaker::getInstance().getState() != BreakerState::CLOSED;
+                    dropOrder(unavailable ? retryLaterError()
+                                          : ErrorHandler::generateError(ERROR_CODE, "Order not applied",
+                                                                        "The inventory could not be updated, e.g. "
+                                                                        "because the stock changed. Please retry.",
+                                                                        ErrorLevel::ERROR));
+                    checkStockAlerts(resultStore, root, reply);
+                    return;
                 }
-            }
 
-            // Check for low stock
-            lowStock = checkLowStockAlert(session, root, alertOut);
-            if (lowStock)
+                checkStockAlerts(resultStore, root, reply);
+                settleOrder();
+
+                std::string message = order;
+                processMessage(&message[0], protocol, client_id);
+            };
+
+            // The in-process backend applies the whole transfer as one transaction
+            if (inventoryStore)
             {
-                std::cout << "\n\nLow stock alert: " << alertOut << std::endl;
-                int written = write(client_sockfd, alertOut.c_str(), alertOut.size());
-                if (written < 0)
-                {
-                    perror("ERROR writing to TCP socket low stock");
-                    continue;
-                }
+                finishOrder(realTimeUpdate(store, root), store);
+                return;
             }
 
-            // Check for re-stock
-            reStocked = reStock(session, root, alertOut);
-            if (reStocked)
+            bool updateQueued = realTimeUpdateAsync(root, [finishOrder](int result, mysqlx::Session& workerSession) {
+                MySqlInventoryStore workerStore(workerSession);
+                finishOrder(result, workerStore);
+            });
+            if (!updateQueued)
             {
-                std::cout << "\n\nRe-stock alert: " << alertOut << std::endl;
-                int written = write(client_sockfd, alertOut.c_str(), alertOut.size());
-                if (written < 0)
-                {
-                    perror("ERROR writing to TCP socket re stock");
-                    continue;
-                }
+                std::cout << "❌ Error updating inventory." << std::endl;
+                dropOrder(retryLaterError());
             }
         }
-        if (isValid && productStock)
+        catch (const std::exception& err)
         {
-            processMessage(buffer, "TCP", client_id);
+            std::cerr << "❌ Error processing order " << orderId << ": " << err.what() << std::endl;
+            dropOrder(ErrorHandler::generateError(ERROR_CODE, "Order not processed",
+                                                  "The order could not be processed. Please check it and retry.",
+                                                  ErrorLevel::ERROR));
         }
+    });
+
+    if (!queued)
+    {
+        std::cerr << "❌ Inventory executor is not running, order from client #" << client_id << " dropped."
+                  << std::endl;
+        dropOrder(retryLaterError());
     }
 }
 
@@ -582,6 +767,7 @@ void Server::handleListClientsRequest(const std::string& protocol, int client_id
 
     msgStream << "\n----- Connected Clients -----\n";
 
+    std::unique_lock<std::mutex> lock(clientMapMutex);
     msgStream << "UDP Clients: " << clientMapUdp.size() << "\n";
     for (const auto& pair : clientMapUdp)
     {
@@ -596,6 +782,7 @@ void Server::handleListClientsRequest(const std::string& protocol, int client_id
                   << " IP: " << pair.second.ip_address << "\n";
     }
 
+    lock.unlock();
     msgStream << "----------------------------";
 
     std::string response = msgStream.str();
@@ -605,37 +792,157 @@ void Server::handleListClientsRequest(const std::string& protocol, int client_id
     std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
 
     // Enviar respuesta al cliente que hizo la solicitud
-    forwardMessageToClient(response, client_id, protocol);
+    sendResponse(response, client_id, protocol);
 }
 
-void Server::handleShowReportRequest(const std::string& protocol, int client_id)
+void Server::handleShowReportRequest(const std::string& protocol, int client_id, const std::string& command)
 {
-    std::ostringstream msgStream;
-    std::lock_guard<std::mutex> lock(ordersMutex);
+    std::cout << "\nReceived " << command << " command via " << protocol << " from ID " << client_id << "." << std::endl;
 
-    if (productQuantities.empty())
+    ReportQuery query;
+    std::string errorMessage;
+    if (!parseReportQuery(command, query, errorMessage))
     {
-        msgStream << "No product data stored yet.\n";
+        forwardMessageToClient(errorMessage, client_id, protocol);
+        return;
     }
-    else
+
+    std::int64_t nowMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    std::string response = formatOrderReport(query, OrderRollup::getInstance().query(query, nowMs));
+
+    std::cout << response << std::endl;
+    std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
+
+    sendResponse(response, client_id, protocol);
+}
+
+void Server::handleContinueRequest(const std::string& protocol, int client_id, const std::string& command)
+{
+    std::vector<std::string> frames;
+    std::string errorMessage;
+    std::size_t window = protocol == "udp" ? RESPONSE_CHUNK_WINDOW : 0;
+    if (!ResponseStreams::getInstance().resume(client_id, protocol, command, window, frames, errorMessage))
+    {
+        forwardMessageToClient(errorMessage, client_id, protocol);
+        return;
+    }
+
+    for (const std::string& frame : frames)
+    {
+        forwardMessageToClient(frame, client_id, protocol);
+    }
+}
+
+void Server::handleQueryOrdersRequest(const std::string& protocol, int client_id, const std::string& command)
+{
+    std::cout << "\nReceived " << command << " command via " << protocol << " from ID " << client_id << "." << std::endl;
+
+    OrderQuery query;
+    std::string errorMessage;
+    if (!parseOrderQuery(command, query, errorMessage))
+    {
+        forwardMessageToClient(errorMessage, client_id, protocol);
+        return;
+    }
+
+    std::string response = formatOrderPage(query, queryStoredOrders(query));
+
+    std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
+
+    sendResponse(response, client_id, protocol);
+}
+
+void Server::handleGetStockRequest(const std::string& protocol, int client_id, const std::string& command)
+{
+    std::cout << "\nReceived " << command << " command via " << protocol << " from ID " << client_id << "." << std::endl;
+
+    StockQuery query;
+    std::string errorMessage;
+    if (!parseStockQuery(command, query, errorMessage))
     {
-        msgStream << "\n----- Product Quantity Report -----\n";
-        for (const auto& pair : productQuantities)
+        forwardMessageToClient(errorMessage, client_id, protocol);
+        return;
+    }
+
+    // A cold cache means one query per location type, which must not run on the network thread
+    bool queued = runInventoryTask([this, protocol, client_id, query](InventoryStore& store) {
+        std::vector<StockLevel> levels;
+        for (LocationType type : query.types)
+        {
+            if (store.getSnapshot(type, query.locations, levels) < 0)
+            {
+                forwardMessageToClient(ErrorHandler::generateError(ERROR_CODE, "Stock query failed",
+                                                                   "The inventory could not be read.",
+                                                                   ErrorLevel::ERROR),
+                                       client_id, protocol);
+                return;
+            }
+        }
+
+        levels.erase(std::remove_if(levels.begin(), levels.end(),
+                                    [&query](const StockLevel& level) { return !matchesStockQuery(query, level); }),
+                     levels.end());
+
+        std::string response = formatStockReport(levels);
+        if (!inventoryStore && !InventoryCache::getInstance().isWarm() &&
+            CircuitBreaker::getInstance().getState() != BreakerState::CLOSED)
         {
-            msgStream << "- " << pair.first << ": " << pair.second << "\n";
+            response = "Inventory database unavailable, showing last known stock.\n" + response;
         }
-        msgStream << "-----------------------------------";
+        std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
+        sendResponse(response, client_id, protocol);
+    });
+
+    if (!queued)
+    {
+        std::cerr << "❌ Inventory executor is not running, GET_STOCK from client #" << client_id << " dropped."
+                  << std::endl;
     }
+}
 
-    std::string response = msgStream.str();
+void Server::handleSubscribeRequest(const std::string& protocol, int client_id, const std::string& command)
+{
+    std::cout << "\nReceived " << command << " command via " << protocol << " from ID " << client_id << "." << std::endl;
 
-    std::cout << "\nReceived SHOW_REPORT command via " << protocol << " from ID " << client_id << "." << std::endl;
-    std::cout << response << std::endl;
-    std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
+    std::vector<std::string> topics;
+    std::string errorMessage;
+    if (!parseSubscription(command, topics, errorMessage))
+    {
+        forwardMessageToClient(errorMessage, client_id, protocol);
+        return;
+    }
 
+    EventFeed& feed = EventFeed::getInstance();
+    std::vector<std::string> subscribed = command.rfind(UNSUBSCRIBE_COMMAND, 0) == 0
+                                              ? feed.unsubscribe(client_id, protocol, topics)
+                                              : feed.subscribe(client_id, protocol, topics);
+
+    std::string response = "Subscribed topics:";
+    for (const std::string& topic : subscribed)
+    {
+        response += " " + topic;
+    }
+    if (subscribed.empty())
+    {
+        response += " none";
+    }
     forwardMessageToClient(response, client_id, protocol);
 }
 
+void Server::handleRestockStatusRequest(const std::string& protocol, int client_id)
+{
+    std::cout << "\nReceived RESTOCK_STATUS command via " << protocol << " from ID " << client_id << "." << std::endl;
+
+    RestockScheduler& scheduler = RestockScheduler::getInstance();
+    std::string response = formatRestockStatus(scheduler.pending(), scheduler.completed());
+
+    std::cout << "Sending message of length: " << response.length() << " bytes." << std::endl;
+
+    sendResponse(response, client_id, protocol);
+}
+
 void Server::processMessage(char buffer[BUFFER_SIZE_SERVER], const std::string& protocol, int client_id)
 {
     std::string msg(buffer);
@@ -649,12 +956,57 @@ void Server::processMessage(char buffer[BUFFER_SIZE_SERVER], const std::string&
         return;
     }
 
-    if (msg == "SHOW_REPORT")
+    if (msg.rfind(SHOW_REPORT_COMMAND, 0) == 0)
+    {
+        std::string lower_protocol = protocol;
+        std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
+
+        handleShowReportRequest(lower_protocol, client_id, msg);
+        return;
+    }
+
+    if (msg.rfind(QUERY_ORDERS_COMMAND, 0) == 0)
+    {
+        std::string lower_protocol = protocol;
+        std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
+
+        handleQueryOrdersRequest(lower_protocol, client_id, msg);
+        return;
+    }
+
+    if (msg.rfind(CONTINUE_COMMAND, 0) == 0)
+    {
+        std::string lower_protocol = protocol;
+        std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
+
+        handleContinueRequest(lower_protocol, client_id, msg);
+        return;
+    }
+
+    if (msg.rfind(GET_STOCK_COMMAND, 0) == 0)
+    {
+        std::string lower_protocol = protocol;
+        std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
+
+        handleGetStockRequest(lower_protocol, client_id, msg);
+        return;
+    }
+
+    if (msg == RESTOCK_STATUS_COMMAND)
+    {
+        std::string lower_protocol = protocol;
+        std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
+
+        handleRestockStatusRequest(lower_protocol, client_id);
+        return;
+    }
+
+    if (msg.rfind(SUBSCRIBE_COMMAND, 0) == 0 || msg.rfind(UNSUBSCRIBE_COMMAND, 0) == 0)
     {
         std::string lower_protocol = protocol;
         std::transform(lower_protocol.begin(), lower_protocol.end(), lower_protocol.begin(), ::tolower);
 
-        handleShowReportRequest(lower_protocol, client_id);
+        handleSubscribeRequest(lower_protocol, client_id, msg);
         return;
     }
 
@@ -0,0 +1,85 @@
+/**
+ * @file benchOrderBatch.cpp
+ * @brief Compares the batch order validation of every instruction set with the scalar loop.
+ *
+ * Usage: bench_order_batch [orders] [rounds]
+ */
+
+#include "orderBatch.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+/// Default number of orders per batch.
+#define BENCH_ORDERS 1000000
+/// Default number of times each batch is validated.
+#define BENCH_ROUNDS 20
+
+static const char* isaName(BatchIsa isa)
+{
+    switch (isa)
+    {
+    case BatchIsa::AVX2:
+        return "avx2";
+    case BatchIsa::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t orders = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : BENCH_ORDERS;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : BENCH_ROUNDS;
+
+    OrderRuleTable rules = OrderRuleTable::builtin();
+    OrderBatch batch;
+    batch.reserve(orders);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> client(0, static_cast<int>(rules.clientCount()) - 1);
+    std::uniform_int_distribution<int> quantity(1, 120);
+    for (std::size_t i = 0; i < orders; i++)
+    {
+        batch.add(client(random), random() % 2, quantity(random));
+    }
+
+    OrderBatchResult reference;
+    validateOrderBatch(rules, batch, reference, BatchIsa::SCALAR);
+    std::cout << orders << " orders, " << reference.failed << " rejected, best of " << rounds << " rounds"
+              << std::endl;
+
+    double scalarNs = 0;
+    for (BatchIsa isa : {BatchIsa::SCALAR, BatchIsa::SSE2, BatchIsa::AVX2})
+    {
+        if (isa > detectBatchIsa())
+        {
+            std::cout << std::setw(8) << isaName(isa) << "  not supported" << std::endl;
+            continue;
+        }
+
+        OrderBatchResult result;
+        double best = 0;
+        for (int round = 0; round < rounds; round++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            validateOrderBatch(rules, batch, result, isa);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = round == 0 ? ns : std::min(best, ns);
+        }
+
+        if (result.errors != reference.errors || result.passed != reference.passed)
+        {
+            std::cerr << isaName(isa) << " disagrees with the scalar loop" << std::endl;
+            return 1;
+        }
+
+        scalarNs = isa == BatchIsa::SCALAR ? best : scalarNs;
+        std::cout << std::setw(8) << isaName(isa) << std::fixed << std::setprecision(3) << std::setw(10)
+                  << best / static_cast<double>(orders) << " ns/order" << std::setprecision(2) << std::setw(8)
+                  << scalarNs / best << "x" << std::endl;
+    }
+    return 0;
+}
@@ -16,6 +16,9 @@ int main(void)
     RUN_TEST(test_read_json_file_empty_file);
     RUN_TEST(test_initialize_client_udp_host_not_found);
     RUN_TEST(test_initialize_client_udp_socket_error);
+    RUN_TEST(test_chunk_assembler_reassembles_frames_in_order);
+    RUN_TEST(test_chunk_assembler_requests_next_window_and_lost_frames);
+    RUN_TEST(test_chunk_assembler_waits_for_split_frames);
 
     return UNITY_END();
 }
\ No newline at end of file
@@ -351,4 +351,67 @@ void test_initialize_client_udp_socket_error()
     TEST_ASSERT_EQUAL(-1, result);
 
     close(sockfd);
-}
\ No newline at end of file
+}
+void test_chunk_assembler_reassembles_frames_in_order(void)
+{
+    struct chunk_assembler assembler;
+    chunk_assembler_init(&assembler);
+    const char* first = "@CHUNK 7 0 2 5 -\nhello";
+    const char* second = "@CHUNK 7 1 2 6 -\n world";
+    size_t consumed;
+
+    TEST_ASSERT_EQUAL(CHUNK_STORED, chunk_assembler_feed(&assembler, first, strlen(first), &consumed));
+    TEST_ASSERT_EQUAL(strlen(first), consumed);
+    TEST_ASSERT_EQUAL(CHUNK_DONE, chunk_assembler_feed(&assembler, second, strlen(second), &consumed));
+
+    char* message = chunk_assembler_take(&assembler);
+    TEST_ASSERT_EQUAL_STRING("hello world", message);
+    free(message);
+
+    // A late duplicate of a finished stream does not start it again
+    TEST_ASSERT_EQUAL(CHUNK_IGNORED, chunk_assembler_feed(&assembler, second, strlen(second), &consumed));
+    chunk_assembler_free(&assembler);
+}
+
+void test_chunk_assembler_requests_next_window_and_lost_frames(void)
+{
+    struct chunk_assembler assembler;
+    chunk_assembler_init(&assembler);
+    const char* end_of_window = "@CHUNK 3 0 4 1 3:1\na";
+    const char* skipped = "@CHUNK 3 2 4 1 -\nc";
+    char request[64];
+    size_t consumed;
+
+    TEST_ASSERT_EQUAL(CHUNK_CONTINUE,
+                      chunk_assembler_feed(&assembler, end_of_window, strlen(end_of_window), &consumed));
+    chunk_assembler_request(&assembler, request, sizeof(request));
+    TEST_ASSERT_EQUAL_STRING("CONTINUE 3:1", request);
+
+    // Chunk 1 was lost: ask for it once, not once per later frame
+    TEST_ASSERT_EQUAL(CHUNK_GAP, chunk_assembler_feed(&assembler, skipped, strlen(skipped), &consumed));
+    TEST_ASSERT_EQUAL(CHUNK_IGNORED, chunk_assembler_feed(&assembler, skipped, strlen(skipped), &consumed));
+    chunk_assembler_request(&assembler, request, sizeof(request));
+    TEST_ASSERT_EQUAL_STRING("CONTINUE 3:1", request);
+    chunk_assembler_free(&assembler);
+}
+
+void test_chunk_assembler_waits_for_split_frames(void)
+{
+    struct chunk_assembler assembler;
+    chunk_assembler_init(&assembler);
+    const char* frame = "@CHUNK 1 0 1 10 -\n0123456789";
+    size_t consumed;
+
+    TEST_ASSERT_EQUAL(CHUNK_INCOMPLETE, chunk_assembler_feed(&assembler, frame, 10, &consumed));
+    TEST_ASSERT_EQUAL(CHUNK_INCOMPLETE, chunk_assembler_feed(&assembler, frame, strlen(frame) - 1, &consumed));
+    TEST_ASSERT_EQUAL(0, consumed);
+    TEST_ASSERT_EQUAL(CHUNK_DONE, chunk_assembler_feed(&assembler, frame, strlen(frame), &consumed));
+
+    char* message = chunk_assembler_take(&assembler);
+    TEST_ASSERT_EQUAL_STRING("0123456789", message);
+    free(message);
+
+    const char* malformed = "@CHUNK 1 5 2 1 -\nx";
+    TEST_ASSERT_EQUAL(CHUNK_INVALID, chunk_assembler_feed(&assembler, malformed, strlen(malformed), &consumed));
+    chunk_assembler_free(&assembler);
+}
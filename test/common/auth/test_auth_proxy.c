@@ -118,6 +118,34 @@ void test_manageDbUserWithAuth_null_proxy(void)
     TEST_ASSERT_FALSE(result);
 }
 
+// Test para verificar que el pool reutiliza la conexión y sus sentencias preparadas
+void test_pool_reuses_connection(void)
+{
+    DbConnection* first = acquireDbConnection();
+    TEST_ASSERT_NOT_NULL(first);
+    MYSQL* conn = first->conn;
+    MYSQL_STMT* stmt = getDbStatement(first, DB_STMT_LOGIN);
+    TEST_ASSERT_NOT_NULL(stmt);
+    releaseDbConnection(first, false);
+
+    DbConnection* second = acquireDbConnection();
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE(second->conn == conn);
+    TEST_ASSERT_TRUE(getDbStatement(second, DB_STMT_LOGIN) == stmt);
+    releaseDbConnection(second, false);
+}
+
+// Test para varios logins seguidos sobre las conexiones del pool
+void test_authenticate_repeated_logins(void)
+{
+    for (int i = 0; i < 20; i++)
+    {
+        memset(&test_proxy, 0, sizeof(AuthProxy));
+        TEST_ASSERT_TRUE(authenticate(&test_proxy, "usuario_existente@example.com", "password_correcto"));
+        TEST_ASSERT_FALSE(authenticate(&test_proxy, "usuario_no_existente@example.com", "cualquier_password"));
+    }
+}
+
 void test_delete_user(void)
 {
     int delete;
@@ -138,6 +166,8 @@ int main(void)
     RUN_TEST(test_logout_proxy_not_authenticated);
     RUN_TEST(test_manageDbUserWithAuth_success);
     RUN_TEST(test_manageDbUserWithAuth_null_proxy);
+    RUN_TEST(test_pool_reuses_connection);
+    RUN_TEST(test_authenticate_repeated_logins);
     RUN_TEST(test_delete_user);
 
     return UNITY_END();
@@ -0,0 +1,67 @@
+#include "testAlertManager.hpp"
+#include <cstdlib>
+#include <thread>
+
+TEST_F(AlertManagerTest, RepeatsInsideTheWindowAreCounted)
+{
+    ASSERT_TRUE(lowStock());
+    EXPECT_EQ(parse(alert)["name"].asString(), "Low Stock Alert: ");
+    EXPECT_FALSE(parse(alert).isMember("count")) << "a single alert is sent as is";
+
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_FALSE(lowStock());
+    }
+    EXPECT_EQ(manager.suppressed(), 10u);
+
+    // Other locations, products and alert types have their own windows
+    EXPECT_TRUE(lowStock("warehouse 2"));
+    EXPECT_TRUE(manager.submit("warehouse 1", "Re-stock Alert: ", "Stock replenished", 2, "Water", alert));
+    EXPECT_TRUE(manager.submit("warehouse 1", "Low Stock Alert: ", "Stock levels are low", 3, "Meat", alert));
+    EXPECT_FALSE(manager.submit("warehouse 1", "Low Stock Alert: ", "Stock levels are low", 2, "WATER", alert));
+}
+
+TEST_F(AlertManagerTest, NextAlertAfterTheWindowCarriesTheCount)
+{
+    ASSERT_TRUE(lowStock());
+    EXPECT_FALSE(lowStock());
+    EXPECT_FALSE(lowStock());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    ASSERT_TRUE(lowStock());
+    Json::Value summary = parse(alert);
+    EXPECT_EQ(summary["count"].asUInt(), 3u);
+    EXPECT_EQ(summary["location"].asString(), "warehouse 1");
+    EXPECT_EQ(summary["product_name"].asString(), "Water");
+    EXPECT_EQ(manager.suppressed(), 0u);
+}
+
+TEST_F(AlertManagerTest, FlushSummarizesClosedWindows)
+{
+    ASSERT_TRUE(lowStock());
+    ASSERT_TRUE(lowStock("warehouse 2"));
+    EXPECT_FALSE(lowStock());
+    EXPECT_TRUE(manager.flush().empty()) << "the windows are still open";
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    std::vector<std::string> summaries = manager.flush();
+    ASSERT_EQ(summaries.size(), 1u) << "warehouse 2 suppressed nothing";
+    EXPECT_EQ(parse(summaries[0])["count"].asUInt(), 1u);
+    EXPECT_EQ(parse(summaries[0])["location"].asString(), "warehouse 1");
+
+    ASSERT_TRUE(lowStock());
+    EXPECT_FALSE(parse(alert).isMember("count")) << "flushed occurrences are not reported twice";
+}
+
+TEST_F(AlertManagerTest, ZeroWindowSendsEveryAlert)
+{
+    setenv("ALERT_COALESCE_WINDOW_SECONDS", "0", 1);
+    AlertManager unlimited(loadAlertManagerConfig());
+    unsetenv("ALERT_COALESCE_WINDOW_SECONDS");
+
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_TRUE(unlimited.submit("warehouse 1", "Low Stock Alert: ", "low", 2, "Water", alert));
+        EXPECT_FALSE(parse(alert).isMember("count"));
+    }
+}
@@ -1,21 +1,40 @@
 #include "testAnomalieHandler.hpp"
 
-int getHubInventory(mysqlx::Session& session, int id, const std::string& product)
+// Fake inventory backend with fixed hub and warehouse stock
+class FakeInventoryStore : public InventoryStore
 {
-    if (id == 1 && product == "Water")
-        return 50;
-    return -1;
-}
-
-int getWarehouseInventory(mysqlx::Session& session, int id, const std::string& product)
-{
-    if (id == 2 && product == "Fuel")
-        return 5;
-    return -1;
-}
-
-// Dummy Session (no lo usamos realmente en los tests)
-mysqlx::Session dummySession("127.0.0.1", 33070, "root", "root", "manage_system");
+  public:
+    int getQuantity(LocationType type, int id, const std::string& product) override
+    {
+        if (type == LocationType::HUB && id == 1 && product == "Water")
+            return 50;
+        if (type == LocationType::WAREHOUSE && id == 2 && product == "Fuel")
+            return 5;
+        return -1;
+    }
+
+    int addQuantity(LocationType type, int id, const std::string& product, int delta) override
+    {
+        return 1;
+    }
+
+    int raiseToCapacity(LocationType type, int id, const std::string& product, int capacity) override
+    {
+        return 0;
+    }
+
+    int transfer(const InventoryTransfer& transfer) override
+    {
+        return 1;
+    }
+
+    int getSnapshot(LocationType type, const std::vector<int>& locationIds, std::vector<StockLevel>& levels) override
+    {
+        return 0;
+    }
+};
+
+FakeInventoryStore fakeStore;
 
 // Helper: Create a basic order JSON structure
 Json::Value AnomalieHandlerTest::createOrder(const std::string& sourceType, const std::string& sourceLocation,
@@ -45,7 +64,7 @@ TEST_F(AnomalieHandlerTest, SufficientStockReturnsTrue)
 {
     Json::Value order = createOrder("hub", "1", "Water", 30);
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_TRUE(result);
     EXPECT_TRUE(errorMessage.empty());
@@ -56,7 +75,7 @@ TEST_F(AnomalieHandlerTest, InsufficientStockReturnsFalseWithError)
 {
     Json::Value order = createOrder("warehouse", "2", "Fuel", 10); // solo hay 5
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     EXPECT_FALSE(errorMessage.empty());
@@ -72,7 +91,7 @@ TEST_F(AnomalieHandlerTest, MissingGeneralInfoReturnsError)
 {
     Json::Value order; // general_info no se define
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -85,7 +104,7 @@ TEST_F(AnomalieHandlerTest, MissingSourceTypeOrLocationReturnsError)
 {
     Json::Value order = createOrder("", "", "Water", 10); // type y location vacíos
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -98,7 +117,7 @@ TEST_F(AnomalieHandlerTest, InvalidSourceLocationFormatReturnsError)
 {
     Json::Value order = createOrder("hub", "notANumber", "Water", 10);
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -114,7 +133,7 @@ TEST_F(AnomalieHandlerTest, MissingActionOrProductReturnsError)
     order["general_info"]["source"]["location"] = "1";
     // falta action o product
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -127,7 +146,7 @@ TEST_F(AnomalieHandlerTest, InvalidProductDataReturnsError)
 {
     Json::Value order = createOrder("hub", "1", "", 0); // nombre vacío y cantidad 0
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -140,7 +159,7 @@ TEST_F(AnomalieHandlerTest, UnknownSourceTypeReturnsError)
 {
     Json::Value order = createOrder("alienbase", "1", "Water", 10);
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
@@ -153,7 +172,7 @@ TEST_F(AnomalieHandlerTest, InventoryFetchFailureReturnsError)
 {
     Json::Value order = createOrder("hub", "99", "UnknownItem", 1); // id y producto inválidos → -1
     std::string errorMessage;
-    bool result = checkProductStock(order, errorMessage, dummySession);
+    bool result = checkProductStock(order, errorMessage, fakeStore);
 
     EXPECT_FALSE(result);
     Json::Value parsed = parseErrorJson(errorMessage);
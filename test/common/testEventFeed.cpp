@@ -0,0 +1,100 @@
+#include "testEventFeed.hpp"
+#include <condition_variable>
+#include <mutex>
+
+TEST_F(EventFeedTest, ParsesSubscriptions)
+{
+    std::vector<std::string> topics;
+    std::string error;
+
+    ASSERT_TRUE(parseSubscription("SUBSCRIBE low-stock Stock:Warehouse:1 low-stock stock:hub", topics, error));
+    EXPECT_EQ(topics, (std::vector<std::string>{"low-stock", "stock:warehouse:1", "stock:hub"}));
+
+    ASSERT_TRUE(parseSubscription("UNSUBSCRIBE", topics, error));
+    EXPECT_TRUE(topics.empty()) << "UNSUBSCRIBE without topics drops them all";
+
+    EXPECT_FALSE(parseSubscription("SUBSCRIBE", topics, error));
+    EXPECT_FALSE(parseSubscription("SUBSCRIBE orders", topics, error));
+    EXPECT_FALSE(parseSubscription("SUBSCRIBE stock:depot:1", topics, error));
+    EXPECT_FALSE(parseSubscription("SUBSCRIBE stock:hub:x", topics, error));
+    EXPECT_FALSE(parseSubscription("SUBSCRIBE stock:hub:1:2", topics, error));
+    EXPECT_NE(error.find("1014"), std::string::npos);
+}
+
+TEST_F(EventFeedTest, EventsReachTheSubscribersOfTheirTopicInOneBatch)
+{
+    feed.subscribe(1, "TCP", {"stock"});
+    feed.subscribe(2, "udp", {"stock:warehouse:1"});
+    feed.subscribe(3, "udp", {EVENT_TOPIC_LOW_STOCK});
+
+    EXPECT_TRUE(feed.wants(stockTopic("warehouse", 1)));
+    EXPECT_FALSE(feed.wants(EVENT_TOPIC_RESTOCK));
+    EXPECT_EQ(feed.publish(stockTopic("warehouse", 1), stockChange(150)), 2u);
+    EXPECT_EQ(feed.publish(stockTopic("hub", 1), stockChange(40)), 1u);
+    EXPECT_EQ(feed.publish(EVENT_TOPIC_RESTOCK, stockChange(1000)), 0u);
+
+    std::vector<EventBatch> batches = feed.drain();
+    ASSERT_EQ(batches.size(), 2u) << "client 3 has no event";
+    std::string header;
+    std::vector<Json::Value> events = eventsOf(batches[0].message, header);
+    EXPECT_EQ(batches[0].clientId, 1);
+    EXPECT_EQ(batches[0].protocol, "tcp");
+    EXPECT_EQ(header, "@EVENTS 2 0");
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0]["topic"].asString(), "stock:warehouse:1");
+    EXPECT_EQ(events[1]["data"]["quantity"].asInt(), 40);
+
+    EXPECT_EQ(eventsOf(batches[1].message, header).size(), 1u);
+    EXPECT_TRUE(feed.drain().empty()) << "drained events are sent once";
+
+    feed.unsubscribe(1, "tcp", {"stock"});
+    feed.removeClient(2, "UDP");
+    EXPECT_EQ(feed.subscribers(), 1u);
+    EXPECT_EQ(feed.publish(stockTopic("warehouse", 1), stockChange(140)), 0u);
+}
+
+TEST_F(EventFeedTest, SlowSubscriberKeepsTheNewestEvents)
+{
+    feed.subscribe(1, "tcp", {"stock"});
+    for (int quantity = 1; quantity <= 10; quantity++)
+    {
+        feed.publish(stockTopic("hub", 1), stockChange(quantity));
+    }
+
+    std::vector<EventBatch> batches = feed.drain();
+    ASSERT_EQ(batches.size(), 1u);
+    std::string header;
+    std::vector<Json::Value> events = eventsOf(batches[0].message, header);
+    EXPECT_EQ(header, "@EVENTS 4 6");
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events.front()["data"]["quantity"].asInt(), 7);
+    EXPECT_EQ(events.back()["data"]["quantity"].asInt(), 10);
+}
+
+TEST_F(EventFeedTest, DispatcherSendsBurstsAsOneBatch)
+{
+    std::mutex mutex;
+    std::condition_variable sent;
+    std::vector<EventBatch> batches;
+    feed.subscribe(7, "tcp", {"low-stock"});
+    feed.publish(EVENT_TOPIC_LOW_STOCK, stockChange(180));
+    feed.publish(EVENT_TOPIC_LOW_STOCK, stockChange(170));
+
+    ASSERT_TRUE(feed.start([&](const EventBatch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(batch);
+        sent.notify_one();
+    }));
+    EXPECT_FALSE(feed.start([](const EventBatch&) {}));
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(sent.wait_for(lock, std::chrono::seconds(5), [&]() { return !batches.empty(); }));
+        EXPECT_EQ(batches[0].clientId, 7);
+        EXPECT_EQ(batches[0].message.rfind("@EVENTS 2 0", 0), 0u);
+    }
+
+    feed.publish(EVENT_TOPIC_LOW_STOCK, stockChange(160));
+    feed.stop();
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(batches.size(), 2u) << "stop() sends the events still queued";
+}
@@ -1,34 +1,51 @@
 #include "testLowStockChecker.hpp"
 
-// Mock implementation of getWarehouseInventory
-int getWarehouseInventory(mysqlx::Session& session, int warehouseId, const std::string& productName)
+// Fake inventory backend with fixed warehouse stock
+class FakeInventoryStore : public InventoryStore
 {
-    if (warehouseId == 1 && productName == "Water")
-        return 170; // Low stock
-    if (warehouseId == 2 && productName == "Weapons")
-        return 300; // Sufficient stock
-    if (warehouseId == 3 && productName == "Water")
-        return 100;
-    if (warehouseId == 3 && productName == "Food")
-        return -1; // Error in retrieval
-
-    return 500; // Default stock value
-}
-
-// Mock implementation of updateWarehouseInventory
-int updateWarehouseInventory(mysqlx::Session& session, int warehouseId, const std::string& productName, int newQuantity)
-{
-    if (warehouseId == 3 && productName == "Water" && newQuantity == 1000)
-        return 1; // Emulate successful update
-
-    if (warehouseId == 3 && productName == "Food")
-        return 0; // Emulate error in update
-
-    return 1;
-}
-
-// Dummy Session (fake one for tests)
-mysqlx::Session dummySession("127.0.0.1", 33070, "root", "root", "manage_system");
+  public:
+    int getQuantity(LocationType, int warehouseId, const std::string& productName) override
+    {
+        if (warehouseId == 1 && productName == "Water")
+            return 170; // Low stock
+        if (warehouseId == 2 && productName == "Weapons")
+            return 300; // Sufficient stock
+        if (warehouseId == 3 && productName == "Water")
+            return 100;
+        if (warehouseId == 3 && productName == "Food")
+            return -1; // Error in retrieval
+
+        return 500; // Default stock value
+    }
+
+    int addQuantity(LocationType, int warehouseId, const std::string& productName, int newQuantity) override
+    {
+        if (warehouseId == 3 && productName == "Water" && newQuantity == 1000)
+            return 1; // Emulate successful update
+
+        if (warehouseId == 3 && productName == "Food")
+            return 0; // Emulate error in update
+
+        return 1;
+    }
+
+    int raiseToCapacity(LocationType, int, const std::string&, int) override
+    {
+        return 0;
+    }
+
+    int transfer(const InventoryTransfer&) override
+    {
+        return 1;
+    }
+
+    int getSnapshot(LocationType, const std::vector<int>&, std::vector<StockLevel>&) override
+    {
+        return 0;
+    }
+};
+
+FakeInventoryStore fakeStore;
 
 TEST_F(LowStockCheckerTest, ShouldGenerateAlertWhenStockIsLow)
 {
@@ -37,7 +54,7 @@ TEST_F(LowStockCheckerTest, ShouldGenerateAlertWhenStockIsLow)
     order["general_info"]["action"]["product"]["name"] = "Water";
     order["general_info"]["action"]["product"]["id"] = 2;
 
-    EXPECT_TRUE(checkLowStockAlert(dummySession, order, alert));
+    EXPECT_TRUE(checkLowStockAlert(fakeStore, order, alert));
     EXPECT_FALSE(alert.empty());
     EXPECT_NE(alert.find("Water"), std::string::npos);
 }
@@ -49,7 +66,7 @@ TEST_F(LowStockCheckerTest, ShouldNotGenerateAlertWhenStockIsAboveThreshold)
     order["general_info"]["action"]["product"]["name"] = "Weapons";
     order["general_info"]["action"]["product"]["id"] = 4;
 
-    EXPECT_FALSE(checkLowStockAlert(dummySession, order, alert));
+    EXPECT_FALSE(checkLowStockAlert(fakeStore, order, alert));
     EXPECT_TRUE(alert.empty());
 }
 
@@ -60,7 +77,7 @@ TEST_F(LowStockCheckerTest, ShouldNotGenerateAlertIfNotWarehouse)
     order["general_info"]["action"]["product"]["name"] = "Water";
     order["general_info"]["action"]["product"]["id"] = 2;
 
-    EXPECT_FALSE(checkLowStockAlert(dummySession, order, alert));
+    EXPECT_FALSE(checkLowStockAlert(fakeStore, order, alert));
     EXPECT_TRUE(alert.empty());
 }
 
@@ -71,7 +88,7 @@ TEST_F(LowStockCheckerTest, ShouldReturnFalseIfInventoryRetrievalFails)
     order["general_info"]["action"]["product"]["name"] = "Food";
     order["general_info"]["action"]["product"]["id"] = 7;
 
-    EXPECT_FALSE(checkLowStockAlert(dummySession, order, alert));
+    EXPECT_FALSE(checkLowStockAlert(fakeStore, order, alert));
     EXPECT_TRUE(alert.empty());
 }
 
@@ -82,7 +99,7 @@ TEST_F(LowStockCheckerTest, ShouldRestockWhenStockIsAtOrBelowRestockThreshold)
     order["general_info"]["action"]["product"]["name"] = "Water";
     order["general_info"]["action"]["product"]["id"] = 5;
 
-    EXPECT_TRUE(reStock(dummySession, order, alert));
+    EXPECT_TRUE(reStock(fakeStore, order, alert));
     EXPECT_FALSE(alert.empty());
     EXPECT_NE(alert.find("Water"), std::string::npos);
     EXPECT_NE(alert.find("Re-stock Alert: "), std::string::npos);
@@ -95,7 +112,7 @@ TEST_F(LowStockCheckerTest, ShouldNotRestockIfNotWarehouse)
     order["general_info"]["action"]["product"]["name"] = "Water";
     order["general_info"]["action"]["product"]["id"] = 5;
 
-    EXPECT_FALSE(reStock(dummySession, order, alert));
+    EXPECT_FALSE(reStock(fakeStore, order, alert));
     EXPECT_TRUE(alert.empty());
 }
 
@@ -106,6 +123,82 @@ TEST_F(LowStockCheckerTest, ShouldReturnFalseIfGetInventoryFails)
     order["general_info"]["action"]["product"]["name"] = "Food";
     order["general_info"]["action"]["product"]["id"] = 7;
 
-    EXPECT_FALSE(reStock(dummySession, order, alert));
+    EXPECT_FALSE(reStock(fakeStore, order, alert));
     EXPECT_TRUE(alert.empty());
 }
+
+TEST_F(LowStockCheckerTest, CollectsCrossingsReportedByTheBackend)
+{
+    order["general_info"]["source"]["type"] = "warehouse";
+    order["general_info"]["source"]["location"] = "9";
+    order["general_info"]["action"]["product"]["name"] = "Meat";
+    order["general_info"]["action"]["product"]["id"] = 3;
+
+    // Never reported: the level is read once from the fake store, 500 units
+    std::vector<std::string> alerts;
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 0u);
+
+    StockLevelMonitor::getInstance().observe(LocationType::WAREHOUSE, 9, "Meat", 90);
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 2u);
+    EXPECT_NE(alerts[0].find("Low Stock Alert: "), std::string::npos);
+    EXPECT_NE(alerts[1].find("Re-stock Alert: "), std::string::npos);
+
+    // Still low on the next order, but the crossing was already reported
+    StockLevelMonitor::getInstance().observe(LocationType::WAREHOUSE, 9, "Meat", 80);
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 0u);
+}
+
+TEST_F(LowStockCheckerTest, ReadsLevelsTheBackendNeverReported)
+{
+    order["general_info"]["source"]["type"] = "warehouse";
+    order["general_info"]["source"]["location"] = "1";
+    order["general_info"]["action"]["product"]["name"] = "Water";
+    order["general_info"]["action"]["product"]["id"] = 2;
+
+    std::vector<std::string> alerts;
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 1u) << "170 units, read from the store once";
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 0u);
+}
+
+TEST_F(LowStockCheckerTest, PublishesAlertsToSubscribers)
+{
+    order["general_info"]["source"]["type"] = "warehouse";
+    order["general_info"]["source"]["location"] = "11";
+    order["general_info"]["action"]["product"]["name"] = "Meat";
+    order["general_info"]["action"]["product"]["id"] = 3;
+
+    EventFeed& feed = EventFeed::getInstance();
+    feed.subscribe(42, "tcp", {EVENT_TOPIC_LOW_STOCK});
+
+    std::vector<std::string> alerts;
+    StockLevelMonitor::getInstance().observe(LocationType::WAREHOUSE, 11, "Meat", 150);
+    EXPECT_EQ(collectStockAlerts(fakeStore, order, alerts), 1u);
+
+    std::vector<EventBatch> batches = feed.drain();
+    feed.removeClient(42, "tcp");
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].clientId, 42);
+    EXPECT_NE(batches[0].message.find("\"topic\":\"low-stock\""), std::string::npos);
+    EXPECT_NE(batches[0].message.find("\"location\":\"warehouse 11\""), std::string::npos);
+}
+
+TEST_F(LowStockCheckerTest, PublishesFlushedSummariesToTheirTopic)
+{
+    EventFeed& feed = EventFeed::getInstance();
+    feed.subscribe(43, "tcp", {EVENT_TOPIC_RESTOCK});
+
+    std::string restock = AlertHandler::generateAlertSummary(RESTOCK_ALERT_NAME, "Re-stock scheduled", 3, "Meat",
+                                                             "warehouse 11", 4, 60);
+    std::string lowStock = AlertHandler::generateAlertSummary(LOW_STOCK_ALERT_NAME, "Stock is low", 3, "Meat",
+                                                              "warehouse 11", 2, 60);
+    EXPECT_TRUE(publishAlertSummary(restock));
+    EXPECT_TRUE(publishAlertSummary(lowStock));
+    EXPECT_FALSE(publishAlertSummary(AlertHandler::generateAlertSummary("Other", "", 0, "", "", 1, 60)));
+
+    std::vector<EventBatch> batches = feed.drain();
+    feed.removeClient(43, "tcp");
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_EQ(batches[0].message.rfind(std::string(EVENT_FRAME_PREFIX) + " 1 0", 0), 0u);
+    EXPECT_NE(batches[0].message.find("\"topic\":\"restock\""), std::string::npos);
+    EXPECT_NE(batches[0].message.find("\"count\":4"), std::string::npos);
+}
@@ -0,0 +1,83 @@
+#include "testOrderBatch.hpp"
+#include "orderValidation.hpp"
+#include <climits>
+
+TEST_F(OrderBatchTest, ReportsTheErrorsOfSingleOrders)
+{
+    batch.add(rules, "hub", true, 50);
+    batch.add(rules, "hub", true, 101);
+    batch.add(rules, "hub", false, 49);
+    batch.add(rules, "external", true, 26);
+    batch.add(rules, "external", false, 4);
+    batch.add(rules, "alien", false, 60);
+    batch.add(rules, "hub", false, 0);
+    batch.add(rules, "alien", true, -3);
+    batch.add(rules, "external", false, INT_MAX);
+
+    validateOrderBatch(rules, batch, result);
+
+    std::vector<std::int32_t> expected = {0,
+                                          ERR_INVALID_QTY_HUB_CRIT,
+                                          ERR_INVALID_QTY_HUB_NONCRIT,
+                                          ERR_INVALID_QTY_EXT_CRIT,
+                                          ERR_INVALID_QTY_EXT_ANY,
+                                          ERR_UNKNOWN_CLIENT_TYPE,
+                                          ERR_INVALID_VALUES,
+                                          ERR_INVALID_VALUES,
+                                          0};
+    EXPECT_EQ(result.errors, expected);
+    EXPECT_EQ(result.failed, 7u);
+    ASSERT_EQ(result.passed.size(), 1u);
+    EXPECT_EQ(result.passed[0], (1ull << 0) | (1ull << 8));
+    EXPECT_TRUE(result.ok(8));
+    EXPECT_FALSE(result.ok(1));
+}
+
+TEST_F(OrderBatchTest, VectorVersionsMatchTheScalarLoop)
+{
+    // Several bitmap words and a tail shorter than a vector
+    fillRandom(1003);
+
+    OrderBatchResult scalar;
+    validateOrderBatch(rules, batch, scalar, BatchIsa::SCALAR);
+    EXPECT_GT(scalar.failed, 0u);
+    EXPECT_LT(scalar.failed, batch.size());
+
+    for (BatchIsa isa : {BatchIsa::SSE2, BatchIsa::AVX2})
+    {
+        validateOrderBatch(rules, batch, result, isa);
+        EXPECT_EQ(result.errors, scalar.errors) << static_cast<int>(isa);
+        EXPECT_EQ(result.passed, scalar.passed) << static_cast<int>(isa);
+        EXPECT_EQ(result.failed, scalar.failed) << static_cast<int>(isa);
+    }
+}
+
+TEST_F(OrderBatchTest, ConfiguredRulesAndEmptyBatches)
+{
+    validateOrderBatch(rules, batch, result);
+    EXPECT_TRUE(result.passed.empty());
+    EXPECT_EQ(result.failed, 0u);
+
+    Json::Value config;
+    Json::Value& rule = config["rules"][0];
+    rule["client"] = "warehouse";
+    rule["product"] = "critical";
+    rule["max"] = 10;
+    rule["max_error"] = 2001;
+    config["rules"][1]["client"] = "warehouse";
+    config["rules"][1]["product"] = "non_critical";
+    std::string error;
+    ASSERT_TRUE(OrderRuleTable::compile(config, rules, error)) << error;
+
+    for (int i = 0; i < 16; i++)
+    {
+        batch.add(rules, i % 2 ? "warehouse" : "hub", true, 5 + i);
+    }
+    validateOrderBatch(rules, batch, result);
+    for (std::size_t i = 0; i < batch.size(); i++)
+    {
+        int expected = i % 2 == 0 ? ERR_UNKNOWN_CLIENT_TYPE : (5 + static_cast<int>(i) > 10 ? 2001 : 0);
+        EXPECT_EQ(result.errors[i], expected) << i;
+        EXPECT_EQ(result.ok(i), expected == 0) << i;
+    }
+}
@@ -0,0 +1,97 @@
+#include "testOrderDedup.hpp"
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+TEST_F(OrderDedupTest, RetriesGetTheRepliesOfTheOriginal)
+{
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::NEW);
+    dedup.record("order-1", "Successful order!");
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::PENDING);
+
+    dedup.record("order-1", "Low stock alert");
+    dedup.finish("order-1");
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::DONE);
+    EXPECT_EQ(replies, (std::vector<std::string>{"Successful order!", "Low stock alert"}));
+
+    EXPECT_EQ(dedup.begin("order-2", replies), DedupState::NEW);
+    EXPECT_EQ(dedup.size(), 2u);
+}
+
+TEST_F(OrderDedupTest, ForgottenOrdersAreProcessedAgain)
+{
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::NEW);
+    dedup.forget("order-1");
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::NEW);
+
+    dedup.finish("");
+    dedup.forget("");
+    EXPECT_EQ(dedup.size(), 1u);
+
+    // Finished without a reply, a retry would be answered with nothing
+    dedup.finish("order-1");
+    EXPECT_EQ(dedup.begin("order-1", replies), DedupState::NEW);
+}
+
+TEST_F(OrderDedupTest, ClientsReusingAnIdAreKeptApart)
+{
+    std::string first = OrderDedup::makeKey(1, "TCP", "order-1");
+    EXPECT_EQ(dedup.begin(first, replies), DedupState::NEW);
+    dedup.record(first, "Successful order!");
+    dedup.finish(first);
+
+    EXPECT_EQ(dedup.begin(OrderDedup::makeKey(2, "TCP", "order-1"), replies), DedupState::NEW);
+    EXPECT_EQ(dedup.begin(OrderDedup::makeKey(1, "UDP", "order-1"), replies), DedupState::NEW);
+    EXPECT_EQ(dedup.begin(first, replies), DedupState::DONE);
+    EXPECT_EQ(OrderDedup::makeKey(1, "TCP", ""), "");
+}
+
+TEST_F(OrderDedupTest, OrdersAreForgottenAfterTheirTtl)
+{
+    OrderDedupConfig config;
+    config.ttl = std::chrono::seconds(1);
+    OrderDedup shortLived(config);
+
+    EXPECT_EQ(shortLived.begin("order-1", replies), DedupState::NEW);
+    shortLived.record("order-1", "Successful order!");
+    shortLived.finish("order-1");
+    EXPECT_EQ(shortLived.begin("order-1", replies), DedupState::DONE);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(shortLived.begin("order-2", replies), DedupState::NEW);
+    EXPECT_EQ(shortLived.size(), 1u) << "expired orders are dropped on rotation";
+    EXPECT_EQ(shortLived.begin("order-1", replies), DedupState::NEW);
+}
+
+TEST_F(OrderDedupTest, BloomFilterHasNoFalseNegativesAndFewFalsePositives)
+{
+    BloomFilter filter(1000);
+    std::hash<std::string> hash;
+    for (int i = 0; i < 1000; i++)
+    {
+        filter.add(hash("added-" + std::to_string(i)));
+    }
+
+    int falsePositives = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_TRUE(filter.mightContain(hash("added-" + std::to_string(i))));
+        falsePositives += filter.mightContain(hash("other-" + std::to_string(i))) ? 1 : 0;
+    }
+    EXPECT_LT(falsePositives, 30);
+
+    filter.clear();
+    EXPECT_FALSE(filter.mightContain(hash("added-0")));
+}
+
+TEST_F(OrderDedupTest, LoadConfigReadsEnvironment)
+{
+    setenv("ORDER_DEDUP_TTL_SECONDS", "30", 1);
+    setenv("ORDER_DEDUP_EXPECTED_ORDERS", "not-a-number", 1);
+    OrderDedupConfig config = loadOrderDedupConfig();
+    unsetenv("ORDER_DEDUP_TTL_SECONDS");
+    unsetenv("ORDER_DEDUP_EXPECTED_ORDERS");
+
+    EXPECT_EQ(config.ttl, std::chrono::seconds(30));
+    EXPECT_EQ(config.expectedOrders, static_cast<std::size_t>(ORDER_DEDUP_EXPECTED_ORDERS));
+}
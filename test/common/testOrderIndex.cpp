@@ -0,0 +1,179 @@
+#include "testOrderIndex.hpp"
+#include <vector>
+
+TEST_F(OrderIndexTest, PostingListStoresSmallGapsInOneByte)
+{
+    PostingList list;
+    for (std::uint64_t sequence = 1; sequence <= 100; sequence++)
+    {
+        list.add(sequence);
+    }
+    list.add(1000);
+
+    EXPECT_EQ(list.size(), 101u);
+    EXPECT_EQ(list.bytes(), 102u); // the gap of 900 needs a second byte
+    std::vector<std::uint64_t> decoded = list.decode();
+    ASSERT_EQ(decoded.size(), 101u);
+    EXPECT_EQ(decoded.front(), 1u);
+    EXPECT_EQ(decoded[99], 100u);
+    EXPECT_EQ(decoded.back(), 1000u);
+}
+
+TEST_F(OrderIndexTest, PostingListKeepsOutOfOrderAddsSorted)
+{
+    PostingList list;
+    list.add(5);
+    list.add(9);
+    list.add(7);
+    list.add(7);
+
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_EQ(list.decode(), (std::vector<std::uint64_t>{5, 7, 9}));
+}
+
+TEST_F(OrderIndexTest, PostingListInsertsLateAddsAcrossMultiByteDeltas)
+{
+    PostingList list;
+    for (std::uint64_t sequence : {1u, 2u, 300u, 100000u, 100002u, 100001u, 150u, 1u, 100000u})
+    {
+        list.add(sequence);
+    }
+
+    EXPECT_EQ(list.size(), 7u);
+    EXPECT_EQ(list.decode(), (std::vector<std::uint64_t>{1, 2, 150, 300, 100000, 100001, 100002}));
+    list.add(100003);
+    EXPECT_EQ(list.decode().back(), 100003u);
+}
+
+TEST_F(OrderIndexTest, FiltersAreIntersected)
+{
+    index.add(1, 10, facts("Water", "hub 1", "high"));
+    index.add(2, 11, facts("Food", "hub 1", "high"));
+    index.add(3, 10, facts("Water", "hub 2", "low"));
+    index.add(4, 10, facts("Water", "hub 1", "low"));
+
+    EXPECT_EQ(index.find({}), (std::vector<std::uint64_t>{1, 2, 3, 4}));
+    EXPECT_EQ(index.find({{OrderField::PRODUCT, "water"}}), (std::vector<std::uint64_t>{1, 3, 4}));
+    EXPECT_EQ(index.find({{OrderField::PRODUCT, "Water"}, {OrderField::DESTINATION, "Hub 1"}}),
+              (std::vector<std::uint64_t>{1, 4}));
+    EXPECT_EQ(index.find({{OrderField::CLIENT, "10"}, {OrderField::PRIORITY, "low"}}),
+              (std::vector<std::uint64_t>{3, 4}));
+    EXPECT_EQ(index.find({{OrderField::SOURCE, "warehouse 1"}}).size(), 4u);
+    EXPECT_TRUE(index.find({{OrderField::PRODUCT, "Medicine"}}).empty());
+    EXPECT_TRUE(index.find({{OrderField::PRODUCT, "Food"}, {OrderField::CLIENT, "10"}}).empty());
+}
+
+TEST_F(OrderIndexTest, ClearDropsEveryList)
+{
+    index.add(1, 10, facts("Water", "hub 1"));
+    EXPECT_GT(index.bytes(), 0u);
+
+    index.clear();
+    EXPECT_EQ(index.bytes(), 0u);
+    EXPECT_TRUE(index.find({}).empty());
+    EXPECT_TRUE(index.find({{OrderField::PRODUCT, "Water"}}).empty());
+}
+
+TEST_F(OrderIndexTest, ParsesFiltersAndPage)
+{
+    OrderQuery query;
+    std::string error;
+    ASSERT_TRUE(parseOrderQuery("QUERY_ORDERS product=Water destination=hub:2 client=7 offset=20 limit=5", query,
+                                error));
+    ASSERT_EQ(query.filters.size(), 3u);
+    EXPECT_EQ(query.filters[0], std::make_pair(OrderField::PRODUCT, std::string("Water")));
+    EXPECT_EQ(query.filters[1], std::make_pair(OrderField::DESTINATION, std::string("hub 2")));
+    EXPECT_EQ(query.filters[2], std::make_pair(OrderField::CLIENT, std::string("7")));
+    EXPECT_EQ(query.offset, 20u);
+    EXPECT_EQ(query.limit, 5u);
+
+    ASSERT_TRUE(parseOrderQuery("QUERY_ORDERS", query, error));
+    EXPECT_TRUE(query.filters.empty());
+    EXPECT_EQ(query.offset, 0u);
+    EXPECT_EQ(query.limit, static_cast<std::size_t>(ORDER_QUERY_DEFAULT_LIMIT));
+}
+
+TEST_F(OrderIndexTest, RejectsMalformedQueries)
+{
+    OrderQuery query;
+    for (const char* command : {"QUERY_ORDERS color=red", "QUERY_ORDERS source=hub", "QUERY_ORDERS client=abc",
+                                "QUERY_ORDERS limit=0", "QUERY_ORDERS limit=51", "QUERY_ORDERS offset=-1",
+                                "QUERY_ORDERS product"})
+    {
+        std::string error;
+        EXPECT_FALSE(parseOrderQuery(command, query, error)) << command;
+        EXPECT_NE(error.find("1012"), std::string::npos) << command;
+    }
+}
+
+TEST_F(OrderIndexTest, FormatsAPage)
+{
+    OrderQuery query;
+    query.offset = 10;
+    OrderPage page;
+    page.total = 12;
+    page.orders = {{12, "newest"}, {11, "older"}};
+
+    std::string response = formatOrderPage(query, page);
+    EXPECT_NE(response.find("Orders 11-12 of 12"), std::string::npos);
+    EXPECT_LT(response.find("[12] newest"), response.find("[11] older"));
+
+    EXPECT_EQ(formatOrderPage(OrderQuery(), OrderPage()), "No orders match the query.\n");
+}
+
+TEST_F(OrderIndexTest, ExtendAppendsLaterParts)
+{
+    OrderIndex later;
+    index.add(1, 10, facts("Water", "hub 1"));
+    index.add(200, 10, facts("Food", "hub 1"));
+    later.add(201, 11, facts("Water", "hub 2"));
+    later.add(5000, 10, facts("Water", "hub 1"));
+
+    index.extend(later);
+    EXPECT_EQ(index.find({}), (std::vector<std::uint64_t>{1, 200, 201, 5000}));
+    EXPECT_EQ(index.find({{OrderField::PRODUCT, "Water"}}), (std::vector<std::uint64_t>{1, 201, 5000}));
+    EXPECT_EQ(index.find({{OrderField::DESTINATION, "hub 2"}}), (std::vector<std::uint64_t>{201}));
+
+    index.add(5001, 10, facts("Water", "hub 1"));
+    EXPECT_EQ(index.find({{OrderField::CLIENT, "10"}}), (std::vector<std::uint64_t>{1, 200, 5000, 5001}));
+}
+
+TEST_F(OrderIndexTest, SnapshotRestoresEveryList)
+{
+    index.add(1, 10, facts("Water", "hub 1", "high"));
+    index.add(300, 11, facts("Food", "hub 2"));
+
+    SnapshotWriter writer;
+    index.save(writer);
+
+    OrderIndex restored;
+    SnapshotReader reader(writer.data());
+    ASSERT_TRUE(restored.load(reader));
+    EXPECT_TRUE(reader.done());
+    EXPECT_EQ(restored.bytes(), index.bytes());
+    EXPECT_EQ(restored.find({}), (std::vector<std::uint64_t>{1, 300}));
+    EXPECT_EQ(restored.find({{OrderField::PRIORITY, "high"}}), (std::vector<std::uint64_t>{1}));
+
+    restored.add(301, 10, facts("Water", "hub 1"));
+    EXPECT_EQ(restored.find({{OrderField::PRODUCT, "Water"}}), (std::vector<std::uint64_t>{1, 301}));
+
+    SnapshotReader truncated(std::string_view(writer.data()).substr(0, writer.data().size() - 1));
+    EXPECT_FALSE(OrderIndex().load(truncated));
+}
+
+TEST_F(OrderIndexTest, DropBeforeForgetsRemovedRecords)
+{
+    index.add(1, 10, facts("Water", "hub 1"));
+    index.add(2, 11, facts("Food", "hub 1"));
+    index.add(300, 10, facts("Water", "hub 2"));
+    std::size_t bytes = index.bytes();
+
+    index.dropBefore(3);
+    EXPECT_LT(index.bytes(), bytes);
+    EXPECT_EQ(index.find({}), (std::vector<std::uint64_t>{300}));
+    EXPECT_TRUE(index.find({{OrderField::PRODUCT, "Food"}}).empty());
+    EXPECT_EQ(index.find({{OrderField::PRODUCT, "Water"}}), (std::vector<std::uint64_t>{300}));
+
+    index.add(301, 11, facts("Food", "hub 1"));
+    EXPECT_EQ(index.find({{OrderField::PRODUCT, "Food"}}), (std::vector<std::uint64_t>{301}));
+}
@@ -0,0 +1,399 @@
+#include "testOrderJournal.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+TEST_F(OrderJournalTest, AppendAssignsConsecutiveSequences)
+{
+    EXPECT_EQ(journal.append(R"({"id":"1"})"), 1u);
+    EXPECT_EQ(journal.append(R"({"id":"2"})"), 2u);
+    EXPECT_EQ(journal.size(), 2u);
+
+    std::vector<std::uint64_t> sequences;
+    journal.forEach([&sequences](const OrderRecord& record) {
+        sequences.push_back(record.sequence);
+        EXPECT_GT(record.timestamp, 0);
+    });
+    EXPECT_EQ(sequences, (std::vector<std::uint64_t>{1, 2}));
+    EXPECT_EQ(payloads(journal), (std::vector<std::string>{R"({"id":"1"})", R"({"id":"2"})"}));
+}
+
+TEST_F(OrderJournalTest, RecordsSurviveReopen)
+{
+    journal.append("first");
+    journal.append("second");
+    journal.close();
+
+    OrderJournal reopened;
+    ASSERT_TRUE(reopened.open(config));
+    EXPECT_EQ(reopened.size(), 2u);
+    EXPECT_EQ(reopened.append("third"), 3u);
+    EXPECT_EQ(payloads(reopened), (std::vector<std::string>{"first", "second", "third"}));
+}
+
+TEST_F(OrderJournalTest, FullSegmentIsSealedAndANewOneStarted)
+{
+    std::string order(500, 'x');
+    for (int i = 0; i < 30; i++)
+    {
+        ASSERT_EQ(journal.append(order + std::to_string(i)), static_cast<std::uint64_t>(i + 1));
+    }
+    EXPECT_GT(segmentFiles(), 1u);
+    journal.close();
+
+    OrderJournal reopened;
+    ASSERT_TRUE(reopened.open(config));
+    std::vector<std::string> stored = payloads(reopened);
+    ASSERT_EQ(stored.size(), 30u);
+    EXPECT_EQ(stored.front(), order + "0");
+    EXPECT_EQ(stored.back(), order + "29");
+}
+
+TEST_F(OrderJournalTest, DamagedTailIsDiscarded)
+{
+    journal.append("first");
+    journal.append("second");
+    journal.append("third");
+    journal.close();
+
+    // Flip a byte of the last payload, as a torn write would leave it
+    std::string path = (std::filesystem::path(config.directory) / "00000000000000000001.seg").string();
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::size_t position = contents.find("third");
+    ASSERT_NE(position, std::string::npos);
+    contents[position] = 'T';
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    }
+
+    OrderJournal reopened;
+    ASSERT_TRUE(reopened.open(config));
+    EXPECT_EQ(reopened.size(), 2u);
+    EXPECT_EQ(reopened.append("replacement"), 3u);
+    reopened.close();
+
+    ASSERT_TRUE(reopened.open(config));
+    EXPECT_EQ(payloads(reopened), (std::vector<std::string>{"first", "second", "replacement"}));
+}
+
+TEST_F(OrderJournalTest, ClearStartsOver)
+{
+    journal.append("first");
+    journal.append("second");
+
+    ASSERT_TRUE(journal.clear());
+    EXPECT_EQ(journal.size(), 0u);
+    EXPECT_TRUE(payloads(journal).empty());
+    EXPECT_EQ(journal.append("again"), 1u);
+}
+
+TEST_F(OrderJournalTest, OversizedOrderIsRejected)
+{
+    EXPECT_EQ(journal.append(std::string(ORDER_JOURNAL_MIN_SEGMENT_BYTES, 'x')), 0u);
+    EXPECT_EQ(journal.size(), 0u);
+}
+
+TEST_F(OrderJournalTest, ColdSegmentsAreCompressedWithADictionary)
+{
+    journal.close();
+    config.segmentBytes = 64 * 1024;
+    config.hotSegments = 0;
+    ASSERT_TRUE(journal.open(config));
+
+    std::vector<std::string> orders;
+    for (int i = 0; i < 1000; i++)
+    {
+        orders.push_back(sampleOrder(i));
+        ASSERT_NE(journal.append(orders.back()), 0u);
+    }
+    ASSERT_TRUE(waitForCompressed(journal, 2));
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(config.directory) / ORDER_JOURNAL_DICT_FILE));
+    EXPECT_EQ(payloads(journal), orders);
+
+    std::uintmax_t compressedBytes = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(config.directory))
+    {
+        if (entry.path().extension() == ".zst")
+        {
+            compressedBytes += entry.file_size();
+        }
+    }
+    EXPECT_LT(compressedBytes * 10, config.segmentBytes * journal.compressedSegments());
+
+    journal.close();
+    OrderJournal reopened;
+    ASSERT_TRUE(reopened.open(config));
+    EXPECT_EQ(reopened.size(), orders.size());
+    EXPECT_EQ(reopened.append("next"), orders.size() + 1);
+    orders.push_back("next");
+    EXPECT_EQ(payloads(reopened), orders);
+}
+
+TEST_F(OrderJournalTest, HotSegmentsStayUncompressed)
+{
+    journal.close();
+    config.compress = false;
+    ASSERT_TRUE(journal.open(config));
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_NE(journal.append(sampleOrder(i)), 0u);
+    }
+    journal.close();
+    std::size_t sealed = segmentFiles() - 1;
+    ASSERT_GT(sealed, 2u);
+
+    config.compress = true;
+    config.hotSegments = 2;
+    ASSERT_TRUE(journal.open(config));
+    ASSERT_TRUE(waitForCompressed(journal, sealed - 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(journal.compressedSegments(), sealed - 2);
+    EXPECT_EQ(segmentFiles(), 3u);
+    EXPECT_EQ(journal.size(), 100u);
+    EXPECT_EQ(payloads(journal).back(), sampleOrder(99));
+}
+
+TEST_F(OrderJournalTest, ConfigIsReadFromEnvironment)
+{
+    setenv("ORDER_JOURNAL_DIR", "elsewhere", 1);
+    setenv("ORDER_JOURNAL_FSYNC", "always", 1);
+    setenv("ORDER_JOURNAL_SEGMENT_BYTES", "65536", 1);
+    setenv("ORDER_JOURNAL_COMPRESS", "0", 1);
+    setenv("ORDER_JOURNAL_HOT_SEGMENTS", "3", 1);
+    setenv("ORDER_JOURNAL_RETENTION_BYTES", "0", 1);
+    setenv("ORDER_JOURNAL_RETENTION_HOURS", "48", 1);
+
+    OrderJournalConfig loaded = loadOrderJournalConfig();
+    EXPECT_EQ(loaded.directory, "elsewhere");
+    EXPECT_EQ(loaded.sync, JournalSync::ALWAYS);
+    EXPECT_EQ(loaded.segmentBytes, 65536u);
+    EXPECT_FALSE(loaded.compress);
+    EXPECT_EQ(loaded.hotSegments, 3);
+    EXPECT_EQ(loaded.retentionBytes, 0u);
+    EXPECT_EQ(loaded.retentionHours, 48);
+
+    unsetenv("ORDER_JOURNAL_DIR");
+    unsetenv("ORDER_JOURNAL_FSYNC");
+    unsetenv("ORDER_JOURNAL_SEGMENT_BYTES");
+    unsetenv("ORDER_JOURNAL_COMPRESS");
+    unsetenv("ORDER_JOURNAL_HOT_SEGMENTS");
+    unsetenv("ORDER_JOURNAL_RETENTION_BYTES");
+    unsetenv("ORDER_JOURNAL_RETENTION_HOURS");
+}
+
+TEST_F(OrderJournalTest, ForEachOfReadsOnlyTheRequestedRecords)
+{
+    std::string order(500, 'x');
+    for (int i = 1; i <= 30; i++)
+    {
+        journal.append(order + std::to_string(i), static_cast<std::uint32_t>(i % 3));
+    }
+    ASSERT_GT(segmentFiles(), 1u);
+
+    std::vector<std::uint64_t> sequences;
+    std::vector<std::uint32_t> clients;
+    journal.forEachOf({2, 3, 17, 30, 31}, [&](const OrderRecord& record) {
+        sequences.push_back(record.sequence);
+        clients.push_back(record.client);
+        EXPECT_EQ(record.payload, order + std::to_string(record.sequence));
+    });
+    EXPECT_EQ(sequences, (std::vector<std::uint64_t>{2, 3, 17, 30}));
+    EXPECT_EQ(clients, (std::vector<std::uint32_t>{2, 0, 2, 0}));
+}
+
+TEST_F(OrderJournalTest, ForEachAfterVisitsEveryLaterRecordOnce)
+{
+    std::string order(500, 'x');
+    for (int i = 1; i <= 60; i++)
+    {
+        journal.append(order + std::to_string(i));
+    }
+    std::size_t parts = journal.segmentsAfter(20);
+    ASSERT_GT(parts, 1u);
+    EXPECT_EQ(journal.segmentsAfter(60), 0u);
+
+    std::mutex visitedMutex;
+    std::vector<std::vector<std::uint64_t>> visited(parts);
+    journal.forEachAfter(20, 4, [&](std::size_t part, const OrderRecord& record) {
+        std::lock_guard<std::mutex> lock(visitedMutex);
+        ASSERT_LT(part, parts);
+        visited[part].push_back(record.sequence);
+    });
+
+    std::vector<std::uint64_t> sequences;
+    for (const auto& part : visited)
+    {
+        ASSERT_FALSE(part.empty());
+        ASSERT_TRUE(sequences.empty() || part.front() > sequences.back());
+        sequences.insert(sequences.end(), part.begin(), part.end());
+    }
+    ASSERT_EQ(sequences.size(), 40u);
+    EXPECT_EQ(sequences.front(), 21u);
+    EXPECT_EQ(sequences.back(), 60u);
+}
+
+TEST_F(OrderJournalTest, VisitorMayAppendWhileReading)
+{
+    journal.append("first");
+    journal.append("second");
+
+    // Readers visit a copy of the segments, so appending from the visitor does not deadlock
+    std::vector<std::uint64_t> appended;
+    journal.forEach([this, &appended](const OrderRecord& record) {
+        appended.push_back(journal.append("after " + std::string(record.payload)));
+    });
+    EXPECT_EQ(appended, (std::vector<std::uint64_t>{3, 4}));
+    EXPECT_EQ(payloads(journal).back(), "after second");
+}
+
+TEST_F(OrderJournalTest, IntervalSyncRunsWithoutFurtherAppends)
+{
+    journal.close();
+    config.sync = JournalSync::INTERVAL;
+    config.syncIntervalMs = 20;
+    ASSERT_TRUE(journal.open(config));
+
+    journal.append("first");
+    journal.append("second");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (journal.unsyncedBytes() > 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(journal.unsyncedBytes(), 0u);
+}
+
+TEST_F(OrderJournalTest, SnapshotSurvivesReopenAndIsDroppedByClear)
+{
+    journal.append("first");
+    journal.append("second");
+    ASSERT_TRUE(journal.writeSnapshot(2, "state"));
+    EXPECT_FALSE(journal.writeSnapshot(3, "ahead"));
+    journal.close();
+
+    OrderJournal reopened;
+    ASSERT_TRUE(reopened.open(config));
+    std::uint64_t sequence = 0;
+    std::string state;
+    ASSERT_TRUE(reopened.readSnapshot(sequence, state));
+    EXPECT_EQ(sequence, 2u);
+    EXPECT_EQ(state, "state");
+
+    ASSERT_TRUE(reopened.clear());
+    EXPECT_FALSE(reopened.readSnapshot(sequence, state));
+}
+
+TEST_F(OrderJournalTest, SnapshotAheadOfTheJournalOrDamagedIsIgnored)
+{
+    journal.append("first");
+    journal.append("second");
+    ASSERT_TRUE(journal.writeSnapshot(2, "state"));
+    journal.close();
+
+    std::string path = (std::filesystem::path(config.directory) / ORDER_JOURNAL_SNAPSHOT_FILE).string();
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    contents.back() ^= 0x01;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    ASSERT_TRUE(journal.open(config));
+    std::uint64_t sequence = 0;
+    std::string state;
+    EXPECT_FALSE(journal.readSnapshot(sequence, state));
+
+    // A damaged length is refused before anything is allocated for it
+    std::uint64_t length = std::uint64_t(1) << 60;
+    std::memcpy(&contents[16], &length, sizeof(length));
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    EXPECT_FALSE(journal.readSnapshot(sequence, state));
+
+    // A snapshot of records the journal no longer has, as after a discarded tail, does not apply
+    ASSERT_TRUE(journal.writeSnapshot(2, "state"));
+    std::filesystem::copy_file(path, path + ".keep");
+    ASSERT_TRUE(journal.clear());
+    journal.append("first");
+    std::filesystem::rename(path + ".keep", path);
+    EXPECT_FALSE(journal.readSnapshot(sequence, state));
+}
+
+TEST_F(OrderJournalTest, RetentionDropsOldestSegmentsOverTheSizeLimit)
+{
+    journal.close();
+    config.compress = false;
+    config.retentionBytes = 3 * ORDER_JOURNAL_MIN_SEGMENT_BYTES;
+    ASSERT_TRUE(journal.open(config));
+
+    std::string order(500, 'x');
+    for (int i = 1; i <= 60; i++)
+    {
+        ASSERT_EQ(journal.append(order + std::to_string(i)), static_cast<std::uint64_t>(i));
+    }
+    // Nothing is removed before a snapshot covers it
+    EXPECT_EQ(journal.firstSequence(), 1u);
+
+    ASSERT_TRUE(journal.writeSnapshot(60, "state"));
+    EXPECT_LE(segmentFiles(), 4u);
+    EXPECT_GT(journal.firstSequence(), 1u);
+    EXPECT_EQ(journal.lastSequence(), 60u);
+    EXPECT_EQ(journal.size(), 60 - journal.firstSequence() + 1);
+    std::vector<std::string> stored = payloads(journal);
+    ASSERT_EQ(stored.size(), journal.size());
+    EXPECT_EQ(stored.front(), order + std::to_string(journal.firstSequence()));
+
+    // Reopening applies the limits again, now counting the records of the active segment
+    std::uint64_t first = journal.firstSequence();
+    journal.close();
+    ASSERT_TRUE(journal.open(config));
+    EXPECT_GE(journal.firstSequence(), first);
+    EXPECT_EQ(journal.append("next"), 61u);
+}
+
+TEST_F(OrderJournalTest, RetentionDropsSegmentsOlderThanTheAgeLimit)
+{
+    journal.close();
+    config.compress = false;
+    ASSERT_TRUE(journal.open(config));
+
+    std::string order(500, 'x');
+    for (int i = 1; i <= 30; i++)
+    {
+        journal.append(order + std::to_string(i));
+    }
+    ASSERT_TRUE(journal.writeSnapshot(30, "state"));
+    journal.close();
+    std::size_t files = segmentFiles();
+    ASSERT_GT(files, 2u);
+
+    // Age every sealed segment by two days; the last one stays active and is never removed
+    auto old = std::filesystem::file_time_type::clock::now() - std::chrono::hours(48);
+    for (const auto& entry : std::filesystem::directory_iterator(config.directory))
+    {
+        if (entry.path().extension() == ".seg")
+        {
+            std::filesystem::last_write_time(entry.path(), old);
+        }
+    }
+
+    config.retentionHours = 24;
+    ASSERT_TRUE(journal.open(config));
+    EXPECT_EQ(segmentFiles(), 1u);
+    EXPECT_EQ(journal.lastSequence(), 30u);
+    EXPECT_EQ(journal.size(), payloads(journal).size());
+}
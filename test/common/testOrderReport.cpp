@@ -0,0 +1,167 @@
+#include "testOrderReport.hpp"
+#include <thread>
+
+TEST_F(OrderReportTest, NoParametersReportsAllTimeByProduct)
+{
+    ASSERT_TRUE(parseReportQuery("SHOW_REPORT", query, error));
+
+    EXPECT_EQ(query.windowMinutes, 0);
+    EXPECT_EQ(query.group, ReportGroup::PRODUCT);
+}
+
+TEST_F(OrderReportTest, ParsesWindowUnitsAndGroup)
+{
+    ASSERT_TRUE(parseReportQuery("SHOW_REPORT window=90m group=priority", query, error));
+    EXPECT_EQ(query.windowMinutes, 90);
+    EXPECT_EQ(query.group, ReportGroup::PRIORITY);
+
+    ASSERT_TRUE(parseReportQuery("SHOW_REPORT window=6", query, error));
+    EXPECT_EQ(query.windowMinutes, 6 * 60);
+
+    ASSERT_TRUE(parseReportQuery("SHOW_REPORT group=Location window=2d", query, error));
+    EXPECT_EQ(query.windowMinutes, 2 * 24 * 60);
+    EXPECT_EQ(query.group, ReportGroup::LOCATION);
+}
+
+TEST_F(OrderReportTest, RejectsInvalidParameters)
+{
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORT window=0h", query, error));
+    EXPECT_NE(error.find("1011"), std::string::npos);
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORT window=3w", query, error));
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORT window=365d", query, error));
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORT group=color", query, error));
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORT sort=asc", query, error));
+    EXPECT_FALSE(parseReportQuery("SHOW_REPORTS", query, error));
+}
+
+TEST_F(OrderReportTest, WindowOnlyCountsRecentOrders)
+{
+    recordAgo(5, "Water", 3);
+    recordAgo(50, "Water", 2);
+    recordAgo(200, "Water", 7);
+    recordAgo(20, "Food", 1);
+
+    query.windowMinutes = 60;
+    RollupTotals totals = rollup.query(query, NOW_MS);
+    ASSERT_EQ(totals.size(), 2u);
+    EXPECT_EQ(totals["Water"].quantity, 5);
+    EXPECT_EQ(totals["Water"].orders, 2);
+    EXPECT_EQ(totals["Food"].quantity, 1);
+
+    query.windowMinutes = 10;
+    totals = rollup.query(query, NOW_MS);
+    ASSERT_EQ(totals.size(), 1u);
+    EXPECT_EQ(totals["Water"].quantity, 3);
+
+    query.windowMinutes = 0;
+    EXPECT_EQ(rollup.query(query, NOW_MS)["Water"].quantity, 12);
+}
+
+TEST_F(OrderReportTest, LongWindowsUseHourBuckets)
+{
+    // Beyond the two hours of minute buckets, only the hour buckets hold these orders
+    recordAgo(10 * 60, "Water", 4);
+    recordAgo(30 * 60, "Water", 6);
+    recordAgo(40 * 24 * 60, "Water", 100);
+
+    query.windowMinutes = 24 * 60;
+    EXPECT_EQ(rollup.query(query, NOW_MS)["Water"].quantity, 4);
+
+    query.windowMinutes = 2 * 24 * 60;
+    EXPECT_EQ(rollup.query(query, NOW_MS)["Water"].quantity, 10);
+}
+
+TEST_F(OrderReportTest, GroupsByPriorityAndLocation)
+{
+    recordAgo(1, "Water", 3, "high");
+    recordAgo(2, "Food", 2, "low");
+    recordAgo(3, "Medicine", 1, "high");
+
+    query.windowMinutes = 60;
+    query.group = ReportGroup::PRIORITY;
+    RollupTotals totals = rollup.query(query, NOW_MS);
+    EXPECT_EQ(totals["high"].orders, 2);
+    EXPECT_EQ(totals["high"].quantity, 4);
+    EXPECT_EQ(totals["low"].orders, 1);
+
+    query.group = ReportGroup::LOCATION;
+    totals = rollup.query(query, NOW_MS);
+    ASSERT_EQ(totals.size(), 1u);
+    EXPECT_EQ(totals["hub 1"].orders, 3);
+}
+
+TEST_F(OrderReportTest, OldBucketsAreRecycled)
+{
+    OrderRollup small(10, 2);
+    small.record(NOW_MS - 5 * MINUTE_MS, OrderFacts{"Water", "warehouse 1", "hub 1", "high", 1});
+    small.record(NOW_MS + 5 * MINUTE_MS, OrderFacts{"Water", "warehouse 1", "hub 1", "high", 2});
+
+    // Ten minutes later the same minute slot holds the newer order only
+    query.windowMinutes = 1;
+    EXPECT_TRUE(small.query(query, NOW_MS - 5 * MINUTE_MS).empty());
+    EXPECT_EQ(small.query(query, NOW_MS + 5 * MINUTE_MS)["Water"].quantity, 2);
+}
+
+TEST_F(OrderReportTest, ExtractsFactsFromOrder)
+{
+    Json::Value order;
+    order["general_info"]["action"]["product"]["name"] = "Water";
+    order["general_info"]["action"]["product"]["quantity"] = 4;
+    order["general_info"]["destination"]["type"] = "hub";
+    order["general_info"]["destination"]["location"] = "2";
+    order["general_info"]["source"]["type"] = "warehouse";
+    order["general_info"]["source"]["location"] = 1;
+
+    OrderFacts facts;
+    ASSERT_TRUE(extractOrderFacts(order, facts));
+    EXPECT_EQ(facts.source, "warehouse 1");
+    EXPECT_EQ(facts.location, "hub 2");
+    EXPECT_EQ(facts.priority, "none");
+
+    order["general_info"]["action"]["product"]["quantity"] = 0;
+    EXPECT_FALSE(extractOrderFacts(order, facts));
+}
+
+TEST_F(OrderReportTest, FormatsLargestGroupsFirst)
+{
+    RollupTotals totals;
+    totals["Food"] = RollupTotal{1, 2};
+    totals["Water"] = RollupTotal{3, 9};
+    query.windowMinutes = 6 * 60;
+
+    std::string report = formatOrderReport(query, totals);
+    EXPECT_NE(report.find("last 6h, by product"), std::string::npos);
+    EXPECT_LT(report.find("Water: 9 units in 3 orders"), report.find("Food: 2 units in 1 order\n"));
+    EXPECT_EQ(formatOrderReport(query, RollupTotals()), "No orders in the last 6h.\n");
+}
+
+TEST_F(OrderReportTest, SnapshotRestoresEveryBucket)
+{
+    recordAgo(5, "Water", 3);
+    recordAgo(200, "Water", 7);
+    std::thread([this] { recordAgo(5, "Food", 1, "low"); }).join(); // recorded in the shard of another thread
+
+    SnapshotWriter writer;
+    rollup.save(writer);
+    OrderRollup restored;
+    SnapshotReader reader(writer.data());
+    ASSERT_TRUE(restored.load(reader));
+    EXPECT_TRUE(reader.done());
+
+    for (int window : {0, 10, 6 * 60})
+    {
+        query.windowMinutes = window;
+        for (ReportGroup group : {ReportGroup::PRODUCT, ReportGroup::PRIORITY})
+        {
+            query.group = group;
+            RollupTotals expected = rollup.query(query, NOW_MS);
+            RollupTotals actual = restored.query(query, NOW_MS);
+            ASSERT_EQ(actual.size(), expected.size());
+            for (const auto& entry : expected)
+            {
+                EXPECT_EQ(actual[entry.first].orders, entry.second.orders);
+                EXPECT_EQ(actual[entry.first].quantity, entry.second.quantity);
+            }
+        }
+    }
+}
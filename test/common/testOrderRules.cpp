@@ -0,0 +1,136 @@
+#include "testOrderRules.hpp"
+#include "orderValidation.hpp"
+#include <atomic>
+#include <climits>
+#include <filesystem>
+#include <thread>
+
+static const char* WAREHOUSE_RULES = R"({"rules": [
+    {"client": "warehouse", "product": "critical", "min": 10, "min_error": 2001, "max": 40, "max_error": 2002,
+     "max_message": "Too many."},
+    {"client": "warehouse", "product": "non_critical", "min": 100, "min_error": 2003}
+]})";
+
+TEST_F(OrderRulesTest, BuiltinRulesKeepTheLimits)
+{
+    OrderRuleTable table = OrderRuleTable::builtin();
+    std::size_t hub = static_cast<std::size_t>(table.clientIndex("hub"));
+    std::size_t external = static_cast<std::size_t>(table.clientIndex("external"));
+    EXPECT_EQ(table.clientIndex("alien"), -1);
+    EXPECT_EQ(table.clientList(), "'hub' or 'external'");
+
+    EXPECT_EQ(table.check(hub, true, MIN_CRITICAL_HUB_QUANTITY - 1).code, ERR_INVALID_QTY_HUB_CRIT);
+    EXPECT_EQ(table.check(hub, true, MIN_CRITICAL_HUB_QUANTITY).code, 0);
+    EXPECT_EQ(table.check(hub, true, MAX_CRITICAL_HUB_QUANTITY).code, 0);
+    EXPECT_EQ(table.check(hub, true, MAX_CRITICAL_HUB_QUANTITY + 1).code, ERR_INVALID_QTY_HUB_CRIT);
+    EXPECT_EQ(table.check(hub, false, MIN_NONCRITICAL_HUB_QUANTITY - 1).code, ERR_INVALID_QTY_HUB_NONCRIT);
+    EXPECT_EQ(table.check(hub, false, INT_MAX).code, 0);
+
+    EXPECT_EQ(table.check(external, true, MAX_CRITICAL_EXTERNAL_QUANTITY + 1).code, ERR_INVALID_QTY_EXT_CRIT);
+    EXPECT_EQ(table.check(external, true, MIN_EXTERNAL_QUANTITY - 1).code, ERR_INVALID_QTY_EXT_ANY);
+    EXPECT_EQ(table.check(external, false, MIN_EXTERNAL_QUANTITY - 1).code, ERR_INVALID_QTY_EXT_ANY);
+    EXPECT_EQ(table.check(external, false, 1000).code, 0);
+    EXPECT_EQ(table.check(external, true, 1).message, "External clients must order at least 5 units of any product.");
+}
+
+TEST_F(OrderRulesTest, ConfiguredRulesAreCompiled)
+{
+    OrderRuleTable table;
+    ASSERT_TRUE(OrderRuleTable::compile(parse(WAREHOUSE_RULES), table, error)) << error;
+    EXPECT_EQ(table.clientIndex("hub"), -1) << "the file replaces the built-in client types";
+    ASSERT_EQ(table.clientIndex("warehouse"), 0);
+
+    EXPECT_EQ(table.check(0, true, 9).code, 2001);
+    EXPECT_EQ(table.check(0, true, 9).message, "Quantity must be at least 10.");
+    EXPECT_EQ(table.check(0, true, 41).code, 2002);
+    EXPECT_EQ(table.check(0, true, 41).message, "Too many.");
+    EXPECT_EQ(table.check(0, true, 25).code, 0);
+    EXPECT_EQ(table.check(0, false, 99).code, 2003);
+    EXPECT_EQ(table.check(0, false, 100000).code, 0);
+}
+
+TEST_F(OrderRulesTest, InvalidConfigurationsAreRejected)
+{
+    OrderRuleTable table = OrderRuleTable::builtin();
+    const char* invalid[] = {
+        R"({})",
+        R"({"rules": [{"client": "hub", "product": "critical"}]})",
+        R"({"rules": [{"client": "hub", "product": "critical"}, {"client": "hub", "product": "critical"},
+                      {"client": "hub", "product": "non_critical"}]})",
+        R"({"rules": [{"client": "hub", "product": "fuel"}, {"client": "hub", "product": "non_critical"}]})",
+        R"({"rules": [{"client": "hub", "product": "critical", "min": 50, "min_error": 1005, "max": 10,
+                       "max_error": 1005}, {"client": "hub", "product": "non_critical"}]})",
+        R"({"rules": [{"client": "hub", "product": "critical", "min": 5},
+                      {"client": "hub", "product": "non_critical"}]})",
+        R"({"rules": [{"product": "critical"}]})",
+    };
+    for (const char* config : invalid)
+    {
+        error.clear();
+        EXPECT_FALSE(OrderRuleTable::compile(parse(config), table, error)) << config;
+        EXPECT_FALSE(error.empty()) << config;
+    }
+    EXPECT_EQ(table.clientIndex("hub"), 0) << "a rejected configuration leaves the table untouched";
+}
+
+TEST_F(OrderRulesTest, ChangedFilesAreSwappedIn)
+{
+    OrderRules rules(path);
+    std::shared_ptr<const OrderRuleTable> builtin = rules.current();
+    EXPECT_EQ(builtin->clientIndex("hub"), 0) << "no file yet";
+    EXPECT_FALSE(rules.reloadIfChanged());
+
+    writeFile(WAREHOUSE_RULES);
+    EXPECT_TRUE(rules.reloadIfChanged());
+    EXPECT_FALSE(rules.reloadIfChanged()) << "unchanged file";
+    EXPECT_EQ(rules.current()->clientIndex("warehouse"), 0);
+    EXPECT_EQ(builtin->clientIndex("hub"), 0) << "tables in use stay valid";
+
+    writeFile("{\"rules\": [");
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+    EXPECT_FALSE(rules.reloadIfChanged());
+    EXPECT_EQ(rules.current()->clientIndex("warehouse"), 0) << "a broken file keeps the previous rules";
+    EXPECT_FALSE(rules.reload(error));
+    EXPECT_FALSE(error.empty());
+
+    OrderRules loaded(path);
+    EXPECT_EQ(loaded.current()->clientIndex("hub"), 0) << "a broken file at startup keeps the built-in rules";
+}
+
+TEST_F(OrderRulesTest, ReadersSeeWholeTablesDuringSwaps)
+{
+    OrderRules rules;
+    OrderRuleTable warehouse;
+    ASSERT_TRUE(OrderRuleTable::compile(parse(WAREHOUSE_RULES), warehouse, error)) << error;
+    auto tables = std::vector<std::shared_ptr<const OrderRuleTable>>{
+        std::make_shared<const OrderRuleTable>(OrderRuleTable::builtin()),
+        std::make_shared<const OrderRuleTable>(warehouse)};
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> mixed{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++)
+    {
+        readers.emplace_back([&]() {
+            while (!stop)
+            {
+                std::shared_ptr<const OrderRuleTable> table = rules.current();
+                int hub = table->clientIndex("hub");
+                int client = hub >= 0 ? hub : table->clientIndex("warehouse");
+                int expected = hub >= 0 ? ERR_INVALID_QTY_HUB_CRIT : 2002;
+                mixed += table->check(static_cast<std::size_t>(client), true, 1000).code != expected;
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; i++)
+    {
+        rules.publish(tables[static_cast<std::size_t>(i) % tables.size()]);
+    }
+    stop = true;
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(mixed, 0);
+}
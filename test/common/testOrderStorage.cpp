@@ -9,6 +9,19 @@ CoutRedirect::~CoutRedirect()
     std::cout.rdbuf(old);
 }
 
+void OrderStorageTest::SetUpTestSuite()
+{
+    // The journal is opened on first use, so it picks up the scratch directory
+    setenv("ORDER_JOURNAL_DIR", TEST_ORDER_STORAGE_JOURNAL_DIR, 1);
+    std::filesystem::remove_all(TEST_ORDER_STORAGE_JOURNAL_DIR);
+}
+
+void OrderStorageTest::TearDownTestSuite()
+{
+    clearStoredOrders();
+    std::filesystem::remove_all(TEST_ORDER_STORAGE_JOURNAL_DIR);
+}
+
 void OrderStorageTest::SetUp()
 {
     clearStoredOrders();
@@ -132,3 +145,97 @@ TEST_F(OrderStorageTest, ProductReportAggregation)
     EXPECT_NE(output.find("oxygen: 20"), std::string::npos); // 5 + 15
     EXPECT_NE(output.find("water: 20"), std::string::npos);
 }
+
+TEST_F(OrderStorageTest, ConcurrentStoresAreAllCounted)
+{
+    const int threads = 4;
+    const int ordersPerThread = 250;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([t] {
+            for (int i = 0; i < ordersPerThread; i++)
+            {
+                storeOrder(R"({"general_info":{"id":")" + std::to_string(t * ordersPerThread + i) +
+                           R"(","action":{"product":{"name":"oxygen","quantity":2}}}})");
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(loadStoredOrders(), threads * ordersPerThread);
+
+    std::stringstream buffer;
+    {
+        CoutRedirect redirect(buffer.rdbuf());
+        printProductReport();
+    }
+    EXPECT_NE(buffer.str().find("oxygen: " + std::to_string(2 * threads * ordersPerThread)), std::string::npos);
+}
+
+TEST_F(OrderStorageTest, QueryReturnsNewestMatchesFirst)
+{
+    for (int i = 1; i <= 12; i++)
+    {
+        std::string product = i % 2 == 0 ? "water" : "oxygen";
+        storeOrder(R"({"general_info":{"id":")" + std::to_string(i) +
+                       R"(","destination":{"type":"hub","location":1},"action":{"product":{"name":")" + product +
+                       R"(","quantity":1}}}})",
+                   i % 3 == 0 ? 7 : 8);
+    }
+
+    OrderQuery query;
+    query.filters = {{OrderField::PRODUCT, "water"}};
+    query.limit = 4;
+    OrderPage page = queryStoredOrders(query);
+    EXPECT_EQ(page.total, 6u);
+    ASSERT_EQ(page.orders.size(), 4u);
+    EXPECT_EQ(page.orders.front().first, 12u);
+    EXPECT_EQ(page.orders.back().first, 6u);
+    EXPECT_NE(page.orders.front().second.find(R"("id":"12")"), std::string::npos);
+
+    query.offset = 4;
+    page = queryStoredOrders(query);
+    ASSERT_EQ(page.orders.size(), 2u);
+    EXPECT_EQ(page.orders.front().first, 4u);
+    EXPECT_EQ(page.orders.back().first, 2u);
+
+    query.filters = {{OrderField::CLIENT, "7"}, {OrderField::DESTINATION, "hub 1"}};
+    query.offset = 0;
+    page = queryStoredOrders(query);
+    EXPECT_EQ(page.total, 4u);
+    EXPECT_EQ(page.orders.front().first, 12u);
+
+    clearStoredOrders();
+    EXPECT_EQ(queryStoredOrders(OrderQuery()).total, 0u);
+}
+
+TEST_F(OrderStorageTest, SnapshotCoversEveryStoredOrder)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        storeOrder(R"({"general_info":{"id":")" + std::to_string(i) +
+                   R"(","action":{"product":{"name":"oxygen","quantity":2}}}})");
+    }
+    ASSERT_TRUE(saveOrderSnapshot());
+
+    std::uint64_t sequence = 0;
+    std::string state;
+    ASSERT_TRUE(OrderJournal::getInstance().readSnapshot(sequence, state));
+    EXPECT_EQ(sequence, 3u);
+
+    SnapshotReader reader(state);
+    std::uint64_t version = 0;
+    ASSERT_TRUE(reader.getU64(version));
+    EXPECT_EQ(version, static_cast<std::uint64_t>(ORDER_SNAPSHOT_VERSION));
+    ProductCounters counters;
+    ASSERT_TRUE(counters.load(reader));
+    EXPECT_EQ(counters.totals()["oxygen"], 6);
+
+    clearStoredOrders();
+    EXPECT_FALSE(OrderJournal::getInstance().readSnapshot(sequence, state));
+}
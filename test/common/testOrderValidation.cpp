@@ -94,3 +94,57 @@ TEST_F(OrderValidationTest, UnknownClientTypeShouldFail)
     EXPECT_FALSE(validateOrderLimits(order, error));
     EXPECT_NE(error.find("1009"), std::string::npos);
 }
+
+TEST_F(OrderValidationTest, UnknownProductShouldFail)
+{
+    order["general_info"]["destination"]["type"] = "hub";
+    order["general_info"]["action"]["type"] = "request";
+    order["general_info"]["action"]["product"]["name"] = "Spaceships";
+    order["general_info"]["action"]["product"]["quantity"] = 60;
+
+    EXPECT_FALSE(validateOrderLimits(order, error));
+    EXPECT_NE(error.find("1003"), std::string::npos);
+    EXPECT_NE(error.find("Spaceships"), std::string::npos);
+
+    // Names are case-sensitive, like the inventory tables
+    order["general_info"]["action"]["product"]["name"] = "water";
+    EXPECT_FALSE(validateOrderLimits(order, error));
+}
+
+TEST_F(OrderValidationTest, RegisteredProductsAreValidated)
+{
+    ProductCatalog& catalog = ProductCatalog::getInstance();
+    EXPECT_FALSE(catalog.registerProduct("Water", false)) << "built-in products cannot change";
+    EXPECT_TRUE(catalog.registerProduct("Fuel", true));
+    EXPECT_EQ(catalog.registerProducts("Tools:0,Batteries,:1,Rope:2"), 1u);
+
+    order["general_info"]["destination"]["type"] = "hub";
+    order["general_info"]["action"]["type"] = "request";
+    order["general_info"]["action"]["product"]["name"] = "Fuel";
+    order["general_info"]["action"]["product"]["quantity"] = 120;
+    EXPECT_FALSE(validateOrderLimits(order, error)) << "Fuel is critical";
+    EXPECT_NE(error.find("1005"), std::string::npos);
+
+    order["general_info"]["action"]["product"]["name"] = "Tools";
+    EXPECT_TRUE(validateOrderLimits(order, error));
+
+    bool critical = false;
+    EXPECT_TRUE(catalog.find("Water", critical));
+    EXPECT_TRUE(critical);
+    EXPECT_FALSE(catalog.find("Batteries", critical));
+}
+
+TEST_F(OrderValidationTest, BuiltinProductsHaveAPerfectHash)
+{
+    static_assert(builtinProductIndex("Medicines") == 1, "lookup resolved at compile time");
+
+    bool used[PRODUCT_TABLE_SLOTS] = {};
+    for (std::size_t i = 0; i < BUILTIN_PRODUCTS.size(); i++)
+    {
+        std::size_t slot = productHash(BUILTIN_PRODUCTS[i].name, PRODUCT_TABLE.seed) % PRODUCT_TABLE_SLOTS;
+        EXPECT_FALSE(used[slot]) << BUILTIN_PRODUCTS[i].name;
+        used[slot] = true;
+        EXPECT_EQ(builtinProductIndex(BUILTIN_PRODUCTS[i].name), static_cast<int>(i));
+    }
+    EXPECT_EQ(builtinProductIndex("Meats"), -1);
+}
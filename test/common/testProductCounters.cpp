@@ -0,0 +1,105 @@
+#include "testProductCounters.hpp"
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_F(ProductCountersTest, AddsPerProduct)
+{
+    counters.add("Water", 5);
+    counters.add("Food", 2);
+    counters.add("Water", 15);
+
+    std::map<std::string, long long> totals = counters.totals();
+    ASSERT_EQ(totals.size(), 2u);
+    EXPECT_EQ(totals["Water"], 20);
+    EXPECT_EQ(totals["Food"], 2);
+}
+
+TEST_F(ProductCountersTest, ConcurrentWritersAreMerged)
+{
+    const int threads = 8;
+    const int ordersPerThread = 20000;
+    const std::vector<std::string> products = {"Water", "Food", "Medicine", "Ammo"};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < ordersPerThread; i++)
+            {
+                counters.add(products[(t + i) % products.size()], 1);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    long long total = 0;
+    for (const auto& entry : counters.totals())
+    {
+        EXPECT_EQ(entry.second, threads * ordersPerThread / static_cast<long long>(products.size()));
+        total += entry.second;
+    }
+    EXPECT_EQ(total, static_cast<long long>(threads) * ordersPerThread);
+}
+
+TEST_F(ProductCountersTest, ClearKeepsCountersUsable)
+{
+    counters.add("Water", 5);
+    counters.clear();
+    EXPECT_TRUE(counters.totals().empty());
+
+    counters.add("Water", 3);
+    EXPECT_EQ(counters.totals()["Water"], 3);
+}
+
+TEST_F(ProductCountersTest, InstancesAreIndependent)
+{
+    {
+        ProductCounters other;
+        other.add("Water", 100);
+    }
+    ProductCounters fresh;
+    fresh.add("Water", 1);
+    counters.add("Water", 2);
+
+    EXPECT_EQ(fresh.totals()["Water"], 1);
+    EXPECT_EQ(counters.totals()["Water"], 2);
+}
+
+TEST_F(ProductCountersTest, ThreadsAreSpreadOverShards)
+{
+    std::set<std::size_t> shards;
+    std::vector<std::thread> workers;
+    std::vector<std::size_t> seen(ORDER_STATS_SHARDS);
+    for (std::size_t t = 0; t < ORDER_STATS_SHARDS; t++)
+    {
+        workers.emplace_back([&seen, t] { seen[t] = orderStatsShard(); });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    shards.insert(seen.begin(), seen.end());
+    EXPECT_EQ(shards.size(), static_cast<std::size_t>(ORDER_STATS_SHARDS));
+}
+
+TEST_F(ProductCountersTest, SnapshotRestoresTotals)
+{
+    counters.add("Water", 20);
+    counters.add("Food", 2);
+
+    SnapshotWriter writer;
+    counters.save(writer);
+    ProductCounters restored;
+    SnapshotReader reader(writer.data());
+    ASSERT_TRUE(restored.load(reader));
+    EXPECT_TRUE(reader.done());
+    EXPECT_EQ(restored.totals(), counters.totals());
+
+    SnapshotReader truncated(std::string_view(writer.data()).substr(0, 12));
+    EXPECT_FALSE(ProductCounters().load(truncated));
+}
@@ -0,0 +1,81 @@
+#include "testRecentOrders.hpp"
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+TEST_F(RecentOrdersTest, KeepsOnlyTheNewestOrders)
+{
+    for (std::uint64_t sequence = 1; sequence <= 6; sequence++)
+    {
+        ring.add(sequence, "order " + std::to_string(sequence));
+    }
+
+    std::string payload;
+    EXPECT_FALSE(ring.get(1, payload));
+    EXPECT_FALSE(ring.get(2, payload));
+    for (std::uint64_t sequence = 3; sequence <= 6; sequence++)
+    {
+        ASSERT_TRUE(ring.get(sequence, payload));
+        EXPECT_EQ(payload, "order " + std::to_string(sequence));
+    }
+    EXPECT_FALSE(ring.get(7, payload));
+}
+
+TEST_F(RecentOrdersTest, OlderOrderDoesNotReplaceANewerOne)
+{
+    ring.add(6, "newer");
+    ring.add(2, "older");
+
+    std::string payload;
+    EXPECT_FALSE(ring.get(2, payload));
+    ASSERT_TRUE(ring.get(6, payload));
+    EXPECT_EQ(payload, "newer");
+}
+
+TEST_F(RecentOrdersTest, ClearEmptiesEverySlot)
+{
+    ring.add(1, "first");
+    ring.clear();
+
+    std::string payload;
+    EXPECT_FALSE(ring.get(1, payload));
+    ring.add(1, "again");
+    ASSERT_TRUE(ring.get(1, payload));
+    EXPECT_EQ(payload, "again");
+}
+
+TEST_F(RecentOrdersTest, ConcurrentWritersKeepTheNewest)
+{
+    RecentOrders large(64);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++)
+    {
+        workers.emplace_back([&large, t] {
+            for (std::uint64_t sequence = t + 1; sequence <= 1000; sequence += 4)
+            {
+                large.add(sequence, std::to_string(sequence));
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::string payload;
+    for (std::uint64_t sequence = 937; sequence <= 1000; sequence++)
+    {
+        ASSERT_TRUE(large.get(sequence, payload));
+        EXPECT_EQ(payload, std::to_string(sequence));
+    }
+}
+
+TEST_F(RecentOrdersTest, CapacityIsReadFromEnvironment)
+{
+    setenv("ORDER_RING_CAPACITY", "128", 1);
+    EXPECT_EQ(loadRecentOrdersCapacity(), 128u);
+    setenv("ORDER_RING_CAPACITY", "0", 1);
+    EXPECT_EQ(loadRecentOrdersCapacity(), 1u);
+    unsetenv("ORDER_RING_CAPACITY");
+    EXPECT_EQ(loadRecentOrdersCapacity(), static_cast<std::size_t>(RECENT_ORDERS_CAPACITY));
+}
@@ -0,0 +1,105 @@
+#include "testResponseChunks.hpp"
+#include <vector>
+
+TEST_F(ResponseChunksTest, ShortResponsesAreSentAsIs)
+{
+    std::vector<std::string> messages = streams.start(1, "udp", "short report", RESPONSE_CHUNK_WINDOW);
+
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], "short report");
+    EXPECT_EQ(streams.pending(), 0u);
+}
+
+TEST_F(ResponseChunksTest, SplitResponseKeepsEveryByte)
+{
+    std::vector<std::string> chunks = splitResponse("abcdefg", 3);
+    EXPECT_EQ(chunks, (std::vector<std::string>{"abc", "def", "g"}));
+    EXPECT_EQ(splitResponse("", 3).size(), 1u);
+}
+
+TEST_F(ResponseChunksTest, TcpReceivesEveryFrameAtOnce)
+{
+    std::vector<std::string> frames = streams.start(1, "tcp", report, 0);
+
+    ASSERT_EQ(frames.size(), 40u);
+    EXPECT_EQ(headerOf(frames[0]), "@CHUNK 1 0 40 1400 -");
+    std::string joined;
+    for (const std::string& frame : frames)
+    {
+        EXPECT_EQ(headerOf(frame).back(), '-');
+        joined += payloadOf(frame);
+    }
+    EXPECT_EQ(joined, report);
+    EXPECT_EQ(streams.pending(), 0u);
+}
+
+TEST_F(ResponseChunksTest, UdpWindowsEndWithTheCursorOfTheNextOne)
+{
+    std::vector<std::string> frames = streams.start(4, "udp", report, 16);
+    ASSERT_EQ(frames.size(), 16u);
+    EXPECT_EQ(headerOf(frames[14]), "@CHUNK 1 14 40 1400 -");
+    EXPECT_EQ(headerOf(frames[15]), "@CHUNK 1 15 40 1400 1:16");
+
+    std::string error;
+    std::string joined;
+    for (const std::string& frame : frames)
+    {
+        joined += payloadOf(frame);
+    }
+    ASSERT_TRUE(streams.resume(4, "udp", "CONTINUE 1:16", 16, frames, error));
+    ASSERT_EQ(frames.size(), 16u);
+    EXPECT_EQ(headerOf(frames.back()), "@CHUNK 1 31 40 1400 1:32");
+    for (const std::string& frame : frames)
+    {
+        joined += payloadOf(frame);
+    }
+    ASSERT_TRUE(streams.resume(4, "udp", "CONTINUE 1:32", 16, frames, error));
+    ASSERT_EQ(frames.size(), 8u);
+    EXPECT_EQ(headerOf(frames.back()), "@CHUNK 1 39 40 1400 -");
+    for (const std::string& frame : frames)
+    {
+        joined += payloadOf(frame);
+    }
+    EXPECT_EQ(joined, report);
+
+    // A lost frame can be asked for again while the stream is kept
+    ASSERT_TRUE(streams.resume(4, "udp", "CONTINUE 1:3", 1, frames, error));
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(headerOf(frames[0]), "@CHUNK 1 3 40 1400 1:4");
+}
+
+TEST_F(ResponseChunksTest, InvalidCursorsAreRejected)
+{
+    streams.start(4, "udp", report, 16);
+    std::vector<std::string> frames;
+    std::string error;
+
+    EXPECT_FALSE(streams.resume(4, "udp", "CONTINUE", 16, frames, error));
+    EXPECT_NE(error.find("1013"), std::string::npos);
+    EXPECT_FALSE(streams.resume(4, "udp", "CONTINUE 1-16", 16, frames, error));
+    EXPECT_FALSE(streams.resume(4, "udp", "CONTINUE 1:16 extra", 16, frames, error));
+    EXPECT_FALSE(streams.resume(4, "udp", "CONTINUE 2:16", 16, frames, error));
+    EXPECT_FALSE(streams.resume(4, "udp", "CONTINUE 1:40", 16, frames, error));
+    EXPECT_FALSE(streams.resume(5, "udp", "CONTINUE 1:16", 16, frames, error)) << "another client's stream";
+    EXPECT_FALSE(streams.resume(4, "tcp", "CONTINUE 1:16", 16, frames, error));
+    EXPECT_TRUE(frames.empty());
+}
+
+TEST_F(ResponseChunksTest, StreamsExpireAndAreCapped)
+{
+    ResponseStreams expiring(std::chrono::seconds(0));
+    expiring.start(1, "udp", report, 16);
+    std::vector<std::string> frames;
+    std::string error;
+    EXPECT_FALSE(expiring.resume(1, "udp", "CONTINUE 1:16", 16, frames, error));
+    EXPECT_EQ(expiring.pending(), 0u);
+
+    for (int i = 0; i < RESPONSE_STREAMS_MAX + 5; i++)
+    {
+        streams.start(1, "udp", report, 16);
+    }
+    EXPECT_EQ(streams.pending(), static_cast<std::size_t>(RESPONSE_STREAMS_MAX));
+    EXPECT_FALSE(streams.resume(1, "udp", "CONTINUE 1:16", 16, frames, error)) << "oldest stream dropped";
+    EXPECT_TRUE(streams.resume(1, "udp", "CONTINUE " + std::to_string(RESPONSE_STREAMS_MAX + 5) + ":16", 16, frames,
+                               error));
+}
@@ -0,0 +1,80 @@
+#include "testStockQuery.hpp"
+
+TEST_F(StockQueryTest, NoFiltersReadsEverything)
+{
+    ASSERT_TRUE(parseStockQuery("GET_STOCK", query, error));
+
+    ASSERT_EQ(query.types.size(), 2);
+    EXPECT_TRUE(query.locations.empty());
+    EXPECT_TRUE(query.product.empty());
+}
+
+TEST_F(StockQueryTest, ParsesEveryFilter)
+{
+    ASSERT_TRUE(parseStockQuery("GET_STOCK type=warehouse location=1,3 product=Water", query, error));
+
+    ASSERT_EQ(query.types.size(), 1);
+    EXPECT_EQ(query.types[0], LocationType::WAREHOUSE);
+    EXPECT_EQ(query.locations, (std::vector<int>{1, 3}));
+    EXPECT_EQ(query.product, "Water");
+}
+
+TEST_F(StockQueryTest, QuotedProductMayContainSpaces)
+{
+    ASSERT_TRUE(parseStockQuery("GET_STOCK product=\"Canned Food\" type=hub", query, error));
+
+    EXPECT_EQ(query.product, "Canned Food");
+    ASSERT_EQ(query.types.size(), 1);
+    EXPECT_EQ(query.types[0], LocationType::HUB);
+    EXPECT_TRUE(matchesStockQuery(query, StockLevel{LocationType::HUB, 1, "canned food", 10}));
+
+    EXPECT_FALSE(parseStockQuery("GET_STOCK product=\"Canned Food", query, error));
+    EXPECT_FALSE(parseStockQuery("GET_STOCK product=\"\"", query, error));
+}
+
+TEST_F(StockQueryTest, RejectsUnknownType)
+{
+    EXPECT_FALSE(parseStockQuery("GET_STOCK type=depot", query, error));
+    EXPECT_NE(error.find("1010"), std::string::npos);
+}
+
+TEST_F(StockQueryTest, RejectsInvalidLocation)
+{
+    EXPECT_FALSE(parseStockQuery("GET_STOCK location=1,x", query, error));
+    EXPECT_FALSE(parseStockQuery("GET_STOCK location=", query, error));
+}
+
+TEST_F(StockQueryTest, RejectsUnknownFilter)
+{
+    EXPECT_FALSE(parseStockQuery("GET_STOCK color=red", query, error));
+    EXPECT_FALSE(parseStockQuery("GET_STOCKS", query, error));
+}
+
+TEST_F(StockQueryTest, ProductFilterIgnoresCase)
+{
+    ASSERT_TRUE(parseStockQuery("GET_STOCK product=water", query, error));
+
+    EXPECT_TRUE(matchesStockQuery(query, StockLevel{LocationType::HUB, 1, "Water", 10}));
+    EXPECT_FALSE(matchesStockQuery(query, StockLevel{LocationType::HUB, 1, "Meat", 10}));
+}
+
+TEST_F(StockQueryTest, ReportIsSorted)
+{
+    std::string report = formatStockReport({StockLevel{LocationType::WAREHOUSE, 1, "Water", 5},
+                                            StockLevel{LocationType::HUB, 2, "Meat", 7},
+                                            StockLevel{LocationType::HUB, 1, "Water", 3}});
+
+    std::size_t hub1 = report.find("- hub 1 Water: 3");
+    std::size_t hub2 = report.find("- hub 2 Meat: 7");
+    std::size_t warehouse1 = report.find("- warehouse 1 Water: 5");
+    ASSERT_NE(hub1, std::string::npos);
+    ASSERT_NE(hub2, std::string::npos);
+    ASSERT_NE(warehouse1, std::string::npos);
+    EXPECT_LT(hub1, hub2);
+    EXPECT_LT(hub2, warehouse1);
+}
+
+TEST_F(StockQueryTest, EmptyReport)
+{
+    EXPECT_EQ(formatStockReport({}), "No stock matches the query.\n");
+}
@@ -0,0 +1,103 @@
+#include "testCircuitBreaker.hpp"
+
+TEST_F(CircuitBreakerTest, StartsClosed)
+{
+    EXPECT_EQ(breaker.getState(), BreakerState::CLOSED);
+    EXPECT_TRUE(breaker.allowRequest());
+}
+
+TEST_F(CircuitBreakerTest, StaysClosedBelowMinimumCalls)
+{
+    recordCalls(3, true);
+
+    EXPECT_EQ(breaker.getState(), BreakerState::CLOSED);
+}
+
+TEST_F(CircuitBreakerTest, OpensOnErrorRate)
+{
+    recordCalls(2, false);
+    recordCalls(2, true);
+
+    EXPECT_EQ(breaker.getState(), BreakerState::OPEN);
+    EXPECT_FALSE(breaker.allowRequest());
+}
+
+TEST_F(CircuitBreakerTest, StaysClosedWhenMostCallsSucceed)
+{
+    recordCalls(8, false);
+    recordCalls(2, true);
+
+    EXPECT_EQ(breaker.getState(), BreakerState::CLOSED);
+}
+
+TEST_F(CircuitBreakerTest, SlowCallsCountAsFailures)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(breaker.allowRequest());
+        breaker.recordSuccess(std::chrono::milliseconds(config.slowCallMs + 1));
+    }
+
+    EXPECT_EQ(breaker.getState(), BreakerState::OPEN);
+}
+
+TEST_F(CircuitBreakerTest, ResetClosesAndForgetsCalls)
+{
+    recordCalls(4, true);
+    ASSERT_EQ(breaker.getState(), BreakerState::OPEN);
+
+    breaker.reset();
+    recordCalls(1, true);
+    recordCalls(3, false);
+
+    EXPECT_EQ(breaker.getState(), BreakerState::CLOSED);
+}
+
+TEST_F(CircuitBreakerTest, HalfOpenProbeClosesOnSuccess)
+{
+    recordCalls(4, true);
+    waitCoolDown();
+
+    ASSERT_TRUE(breaker.allowRequest());
+    EXPECT_EQ(breaker.getState(), BreakerState::HALF_OPEN);
+    EXPECT_FALSE(breaker.allowRequest());
+
+    breaker.recordSuccess(std::chrono::milliseconds(1));
+    EXPECT_EQ(breaker.getState(), BreakerState::CLOSED);
+    EXPECT_TRUE(breaker.allowRequest());
+}
+
+TEST_F(CircuitBreakerTest, HalfOpenProbeReopensOnFailure)
+{
+    recordCalls(4, true);
+    waitCoolDown();
+
+    ASSERT_TRUE(breaker.allowRequest());
+    breaker.recordFailure();
+
+    EXPECT_EQ(breaker.getState(), BreakerState::OPEN);
+    EXPECT_FALSE(breaker.allowRequest());
+}
+
+TEST_F(CircuitBreakerTest, LostProbeIsReplaced)
+{
+    recordCalls(4, true);
+    waitCoolDown();
+    ASSERT_TRUE(breaker.allowRequest());
+
+    waitCoolDown();
+
+    EXPECT_TRUE(breaker.allowRequest());
+}
+
+TEST_F(CircuitBreakerTest, WouldAllowRequestLeavesTheProbeToTheCall)
+{
+    recordCalls(4, true);
+    EXPECT_FALSE(breaker.wouldAllowRequest());
+    waitCoolDown();
+
+    EXPECT_TRUE(breaker.wouldAllowRequest());
+    EXPECT_EQ(breaker.getState(), BreakerState::OPEN);
+    ASSERT_TRUE(breaker.allowRequest());
+    EXPECT_FALSE(breaker.wouldAllowRequest());
+}
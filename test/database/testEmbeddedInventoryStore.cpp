@@ -0,0 +1,148 @@
+#include "testEmbeddedInventoryStore.hpp"
+#include <fstream>
+
+TEST_F(EmbeddedInventoryStoreTest, GetQuantityIsCaseInsensitive)
+{
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "water"), 500);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 1, "WATER"), 40);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 2, "Water"), -1);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, AddQuantityRejectsNegativeStock)
+{
+    EXPECT_EQ(store.addQuantity(LocationType::HUB, 1, "Water", -40), 1);
+    EXPECT_EQ(store.addQuantity(LocationType::HUB, 1, "Water", -1), -1);
+    EXPECT_EQ(store.addQuantity(LocationType::HUB, 9, "Water", 5), -1);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 1, "Water"), 0);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, RaiseToCapacityOnlyAddsWhatIsMissing)
+{
+    EXPECT_EQ(store.raiseToCapacity(LocationType::HUB, 1, "water", 100), 60);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 1, "Water"), 100);
+    EXPECT_EQ(store.raiseToCapacity(LocationType::HUB, 1, "Water", 100), 0);
+    EXPECT_EQ(store.raiseToCapacity(LocationType::WAREHOUSE, 1, "Water", 100), 0) << "a fuller row is left as is";
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "Water"), 500);
+    EXPECT_EQ(store.raiseToCapacity(LocationType::HUB, 9, "Water", 100), -1);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, RealTimeUpdateMovesStock)
+{
+    EXPECT_EQ(realTimeUpdate(store, createOrder(1, 1, "Water", 100)), 1);
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "Water"), 400);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 1, "Water"), 140);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, FailedTransferChangesNothing)
+{
+    // Not enough stock at the source
+    EXPECT_LT(realTimeUpdate(store, createOrder(1, 1, "Water", 501)), 1);
+    // Unknown destination: the source must not be debited
+    EXPECT_LT(realTimeUpdate(store, createOrder(1, 7, "Water", 10)), 1);
+
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "Water"), 500);
+    EXPECT_EQ(store.getQuantity(LocationType::HUB, 1, "Water"), 40);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, SnapshotFiltersByLocation)
+{
+    store.put(LocationType::WAREHOUSE, 2, "Food", 80);
+
+    std::vector<StockLevel> levels;
+    EXPECT_EQ(store.getSnapshot(LocationType::WAREHOUSE, {2}, levels), 1);
+    ASSERT_EQ(levels.size(), 1u);
+    EXPECT_EQ(levels[0].product, "Food");
+    EXPECT_EQ(levels[0].quantity, 80);
+
+    EXPECT_EQ(store.getSnapshot(LocationType::WAREHOUSE, {}, levels), 2);
+    EXPECT_EQ(levels.size(), 3u);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, ChangesSurviveReopen)
+{
+    {
+        EmbeddedInventoryStore persisted;
+        ASSERT_TRUE(persisted.open(path));
+        ASSERT_TRUE(persisted.put(LocationType::WAREHOUSE, 1, "Fresh Water", 500));
+        ASSERT_TRUE(persisted.put(LocationType::HUB, 3, "Fresh Water", 0));
+
+        InventoryTransfer transfer{LocationType::WAREHOUSE, 1, LocationType::HUB, 3, "fresh water", 120};
+        EXPECT_EQ(persisted.transfer(transfer), 1);
+        EXPECT_EQ(persisted.addQuantity(LocationType::HUB, 3, "Fresh Water", -20), 1);
+        EXPECT_EQ(persisted.raiseToCapacity(LocationType::WAREHOUSE, 1, "Fresh Water", 450), 70);
+    }
+
+    EmbeddedInventoryStore reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.size(), 2u);
+    EXPECT_EQ(reopened.getQuantity(LocationType::WAREHOUSE, 1, "Fresh Water"), 450);
+    EXPECT_EQ(reopened.getQuantity(LocationType::HUB, 3, "Fresh Water"), 100);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, IncompleteLastLineIsIgnored)
+{
+    {
+        std::ofstream out(path);
+        out << "set warehouse 1 500 Water\n";
+        out << "set hub 1 40 Water\n";
+        out << "move warehouse 1 hub 1 100 Water\n";
+        out << "move warehouse 1 hub 1 50 Wat";
+    }
+
+    EmbeddedInventoryStore reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.getQuantity(LocationType::WAREHOUSE, 1, "Water"), 400);
+    EXPECT_EQ(reopened.getQuantity(LocationType::HUB, 1, "Water"), 140);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, RestockRunsOnEmbeddedStore)
+{
+    store.put(LocationType::WAREHOUSE, 4, "Medicines", 60);
+
+    Json::Value order;
+    order["general_info"]["source"]["type"] = "warehouse";
+    order["general_info"]["source"]["location"] = "4";
+    order["general_info"]["action"]["product"]["name"] = "Medicines";
+    order["general_info"]["action"]["product"]["id"] = "3";
+
+    std::string alert;
+    EXPECT_TRUE(reStock(store, order, alert));
+    EXPECT_FALSE(alert.empty());
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 4, "Medicines"), MAX_CAPACITY);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, StockAlertsFireOncePerCrossing)
+{
+    store.put(LocationType::WAREHOUSE, 5, "Clothes", 300);
+    store.put(LocationType::HUB, 5, "Clothes", 0);
+    Json::Value order = createOrder(5, 5, "Clothes", 60);
+    order["general_info"]["action"]["product"]["id"] = "5";
+
+    std::vector<std::size_t> alertsPerOrder;
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_EQ(realTimeUpdate(store, order), 1);
+        std::vector<std::string> alerts;
+        alertsPerOrder.push_back(collectStockAlerts(store, order, alerts));
+        // The scheduler catches up between orders
+        RestockScheduler::getInstance().applyPending(store);
+    }
+
+    // 240, 180 (low stock), 120, 60 (re-stock to capacity requested and applied), 940
+    EXPECT_EQ(alertsPerOrder, (std::vector<std::size_t>{0, 1, 0, 1, 0}));
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 5, "Clothes"), MAX_CAPACITY - 60);
+}
+
+TEST_F(EmbeddedInventoryStoreTest, SeedFillsOnlyAnEmptyStore)
+{
+    EXPECT_EQ(store.seed(), 0u);
+
+    EmbeddedInventoryStore empty;
+    ASSERT_TRUE(empty.open(path));
+    EXPECT_EQ(empty.seed(), 2u * EMBEDDED_SEED_LOCATIONS * 5u);
+    EXPECT_EQ(empty.getQuantity(LocationType::WAREHOUSE, EMBEDDED_SEED_LOCATIONS, "clothes"), 0);
+
+    EmbeddedInventoryStore reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.size(), empty.size());
+}
@@ -0,0 +1,109 @@
+#include "testInventoryCache.hpp"
+#include <thread>
+#include <vector>
+
+TEST_F(InventoryCacheTest, StartsCold)
+{
+    EXPECT_FALSE(cache.isWarm());
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(InventoryCacheTest, LoadAndGet)
+{
+    cache.load(LocationType::WAREHOUSE, 1, "Water", 500);
+    cache.load(LocationType::HUB, 1, "Water", 40);
+    cache.markWarm();
+
+    int quantity = 0;
+    EXPECT_TRUE(cache.isWarm());
+    ASSERT_TRUE(cache.get(LocationType::WAREHOUSE, 1, "Water", quantity));
+    EXPECT_EQ(quantity, 500);
+    ASSERT_TRUE(cache.get(LocationType::HUB, 1, "Water", quantity));
+    EXPECT_EQ(quantity, 40);
+}
+
+TEST_F(InventoryCacheTest, ProductNamesAreCaseInsensitive)
+{
+    cache.load(LocationType::HUB, 2, "Medicines", 75);
+
+    int quantity = 0;
+    ASSERT_TRUE(cache.get(LocationType::HUB, 2, "medicines", quantity));
+    EXPECT_EQ(quantity, 75);
+}
+
+TEST_F(InventoryCacheTest, UnknownRowIsNotFound)
+{
+    cache.load(LocationType::HUB, 1, "Meat", 10);
+
+    int quantity = -7;
+    EXPECT_FALSE(cache.get(LocationType::HUB, 2, "Meat", quantity));
+    EXPECT_FALSE(cache.get(LocationType::WAREHOUSE, 1, "Meat", quantity));
+    EXPECT_EQ(quantity, -7);
+}
+
+TEST_F(InventoryCacheTest, ApplyDeltaWritesThrough)
+{
+    cache.load(LocationType::WAREHOUSE, 3, "Clothes", 100);
+
+    EXPECT_TRUE(cache.applyDelta(LocationType::WAREHOUSE, 3, "Clothes", -30));
+    EXPECT_TRUE(cache.applyDelta(LocationType::WAREHOUSE, 3, "clothes", 5));
+
+    int quantity = 0;
+    ASSERT_TRUE(cache.get(LocationType::WAREHOUSE, 3, "Clothes", quantity));
+    EXPECT_EQ(quantity, 75);
+}
+
+TEST_F(InventoryCacheTest, ApplyDeltaRejectsNegativeStockAndUnknownRows)
+{
+    cache.load(LocationType::HUB, 1, "Weapons", 10);
+
+    EXPECT_FALSE(cache.applyDelta(LocationType::HUB, 1, "Weapons", -11));
+    EXPECT_FALSE(cache.applyDelta(LocationType::HUB, 9, "Weapons", 5));
+
+    int quantity = 0;
+    ASSERT_TRUE(cache.get(LocationType::HUB, 1, "Weapons", quantity));
+    EXPECT_EQ(quantity, 10);
+}
+
+TEST_F(InventoryCacheTest, ConcurrentDeltasAreNotLost)
+{
+    cache.load(LocationType::WAREHOUSE, 1, "Water", 0);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([this]() {
+            for (int i = 0; i < 1000; ++i)
+            {
+                cache.applyDelta(LocationType::WAREHOUSE, 1, "Water", 1);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    int quantity = 0;
+    ASSERT_TRUE(cache.get(LocationType::WAREHOUSE, 1, "Water", quantity));
+    EXPECT_EQ(quantity, 4000);
+}
+
+TEST_F(InventoryCacheTest, ForEachKeepsOriginalProductName)
+{
+    cache.load(LocationType::HUB, 1, "Water", 1);
+
+    std::string seen;
+    cache.forEach([&seen](LocationType, int, const std::string& product, int) { seen = product; });
+    EXPECT_EQ(seen, "Water");
+}
+
+TEST_F(InventoryCacheTest, ParseLocationType)
+{
+    LocationType type;
+    ASSERT_TRUE(parseLocationType("hub", type));
+    EXPECT_EQ(type, LocationType::HUB);
+    ASSERT_TRUE(parseLocationType("warehouse", type));
+    EXPECT_EQ(type, LocationType::WAREHOUSE);
+    EXPECT_FALSE(parseLocationType("depot", type));
+}
@@ -252,8 +252,143 @@ void testConnectToDbCatch()
     unsetenv("DB_PORT");
 }
 
+static Json::Value transferRequest(int destinationLocation, int quantity)
+{
+    Json::Value request;
+    request["general_info"]["source"]["type"] = "warehouse";
+    request["general_info"]["source"]["location"] = 1;
+    request["general_info"]["destination"]["type"] = "hub";
+    request["general_info"]["destination"]["location"] = destinationLocation;
+    request["general_info"]["action"]["product"]["name"] = "Water";
+    request["general_info"]["action"]["product"]["quantity"] = quantity;
+    return request;
+}
+
+void testGetHubInventoryAsync()
+{
+    auto session = connectToDb();
+    int expected = getHubInventory(session, 2, "water");
+
+    int result = getHubInventoryAsync(2, "water").get();
+
+    TEST_ASSERT_EQUAL(expected, result);
+}
+
+void testExecutorSubmit()
+{
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 8; i++)
+    {
+        futures.push_back(InventoryExecutor::getInstance().submit(
+            [](mysqlx::Session& session) { return getWarehouseInventory(session, 1, "water"); }));
+    }
+
+    for (auto& future : futures)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(0, future.get());
+    }
+}
+
+void testRealTimeUpdateAsyncSuccess()
+{
+    auto session = connectToDb();
+    updateWarehouseInventory(session, 1, "Water", 10);
+    int sourceBefore = getWarehouseInventory(session, 1, "Water");
+    int destinationBefore = getHubInventory(session, 1, "Water");
+
+    int result = realTimeUpdateAsync(transferRequest(1, 10)).get();
+
+    TEST_ASSERT_EQUAL(1, result);
+    TEST_ASSERT_EQUAL(sourceBefore - 10, getWarehouseInventory(session, 1, "Water"));
+    TEST_ASSERT_EQUAL(destinationBefore + 10, getHubInventory(session, 1, "Water"));
+}
+
+void testRealTimeUpdateAsyncCompensates()
+{
+    auto session = connectToDb();
+    updateWarehouseInventory(session, 1, "Water", 5);
+    int sourceBefore = getWarehouseInventory(session, 1, "Water");
+
+    int result = realTimeUpdateAsync(transferRequest(-1, 5)).get();
+
+    TEST_ASSERT_EQUAL(-1, result);
+    TEST_ASSERT_EQUAL(sourceBefore, getWarehouseInventory(session, 1, "Water"));
+}
+
+void testRealTimeUpdateAsyncExecutorStopped()
+{
+    InventoryExecutor::getInstance().stop();
+
+    bool queued = realTimeUpdateAsync(transferRequest(1, 5), [](int, mysqlx::Session&) {});
+
+    TEST_ASSERT_FALSE(queued);
+    TEST_ASSERT_EQUAL(-1, realTimeUpdateAsync(transferRequest(1, 5)).get());
+    TEST_ASSERT_TRUE(InventoryExecutor::getInstance().start(2, connectToDb));
+}
+
+void testStatementCacheMatchesProcedures()
+{
+    auto plainSession = connectToDb();
+    auto pooledSession = connectToDb();
+    InventoryStatements::attach(pooledSession);
+
+    TEST_ASSERT_NOT_NULL(InventoryStatements::forSession(pooledSession));
+    TEST_ASSERT_NULL(InventoryStatements::forSession(plainSession));
+    TEST_ASSERT_EQUAL(getHubInventory(plainSession, 2, "Water"), getHubInventory(pooledSession, 2, "Water"));
+
+    int before = getHubInventory(plainSession, 2, "Water");
+    TEST_ASSERT_EQUAL(1, updateHubInventory(pooledSession, 2, "Water", 3));
+    TEST_ASSERT_EQUAL(1, updateHubInventory(pooledSession, 2, "Water", -3));
+    TEST_ASSERT_EQUAL(before, getHubInventory(plainSession, 2, "Water"));
+    TEST_ASSERT_EQUAL(-1, updateHubInventory(pooledSession, -1, "Water", 3));
+
+    InventoryStatements::detach(pooledSession);
+    TEST_ASSERT_NULL(InventoryStatements::forSession(pooledSession));
+}
+
+void testGetInventorySnapshot()
+{
+    auto session = connectToDb();
+    std::vector<StockLevel> levels;
+
+    int loaded = getInventorySnapshot(session, LocationType::WAREHOUSE, {1, 2}, levels);
+
+    TEST_ASSERT_EQUAL(10, loaded);
+    TEST_ASSERT_EQUAL(10, levels.size());
+    for (const auto& level : levels)
+    {
+        TEST_ASSERT_TRUE(level.type == LocationType::WAREHOUSE);
+        TEST_ASSERT_TRUE(level.locationId == 1 || level.locationId == 2);
+        TEST_ASSERT_EQUAL(getWarehouseInventory(session, level.locationId, level.product), level.quantity);
+    }
+
+    TEST_ASSERT_EQUAL(0, getInventorySnapshot(session, LocationType::HUB, {-1}, levels));
+}
+
+void testCircuitOpenServesLastKnownStock()
+{
+    auto session = connectToDb();
+    int lastKnown = getWarehouseInventory(session, 1, "Water");
+    TEST_ASSERT_GREATER_OR_EQUAL(0, lastKnown);
+
+    CircuitBreakerConfig config;
+    config.minCalls = 1;
+    CircuitBreaker& breaker = CircuitBreaker::getInstance();
+    breaker.configure(config);
+    TEST_ASSERT_TRUE(breaker.allowRequest());
+    breaker.recordFailure();
+    TEST_ASSERT_TRUE(breaker.getState() == BreakerState::OPEN);
+
+    TEST_ASSERT_EQUAL(lastKnown, getWarehouseInventory(session, 1, "Water"));
+    TEST_ASSERT_EQUAL(-1, updateWarehouseInventory(session, 1, "Water", 10));
+    TEST_ASSERT_EQUAL(lastKnown, getWarehouseInventory(session, 1, "Water"));
+
+    breaker.configure(CircuitBreakerConfig());
+}
+
 void setUp(void)
 {
+    CircuitBreaker::getInstance().reset();
 }
 
 void tearDown(void)
@@ -284,6 +419,17 @@ int main(void)
     RUN_TEST(testUpdateHubInventoryCatchPath);
     RUN_TEST(testRealTimeUpdateCatchPath);
     RUN_TEST(testConnectToDbCatch);
+    RUN_TEST(testStatementCacheMatchesProcedures);
+    RUN_TEST(testGetInventorySnapshot);
+    RUN_TEST(testCircuitOpenServesLastKnownStock);
+
+    InventoryExecutor::getInstance().start(2, connectToDb);
+    RUN_TEST(testGetHubInventoryAsync);
+    RUN_TEST(testExecutorSubmit);
+    RUN_TEST(testRealTimeUpdateAsyncSuccess);
+    RUN_TEST(testRealTimeUpdateAsyncCompensates);
+    RUN_TEST(testRealTimeUpdateAsyncExecutorStopped);
+    InventoryExecutor::getInstance().stop();
 
     return UNITY_END();
 }
@@ -0,0 +1,195 @@
+#include "testInventoryWriteBehind.hpp"
+#include <chrono>
+#include <thread>
+
+TEST_F(InventoryWriteBehindTest, RequiresWarmCache)
+{
+    cache.clear();
+    WriteBehindConfig config;
+    EXPECT_FALSE(writeBehind.start(config, [](const std::vector<InventoryDelta>&) { return true; }));
+    EXPECT_FALSE(writeBehind.isRunning());
+}
+
+TEST_F(InventoryWriteBehindTest, AckImmediatelyUpdatesLedgerBeforeCommit)
+{
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1000);
+
+    EXPECT_EQ(writeBehind.submit(transfer(30)), 1);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 470);
+    EXPECT_EQ(level(LocationType::HUB, 1, "Water"), 30);
+}
+
+TEST_F(InventoryWriteBehindTest, DeltasAreMergedPerRow)
+{
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1000);
+
+    EXPECT_EQ(writeBehind.submit(transfer(10)), 1);
+    EXPECT_EQ(writeBehind.submit(transfer(15)), 1);
+    writeBehind.stop();
+
+    int warehouseDelta = 0;
+    int hubDelta = 0;
+    std::size_t rows = 0;
+    for (const auto& batch : batches)
+    {
+        for (const auto& delta : batch)
+        {
+            rows++;
+            (delta.type == LocationType::WAREHOUSE ? warehouseDelta : hubDelta) += delta.delta;
+        }
+    }
+    EXPECT_EQ(warehouseDelta, -25);
+    EXPECT_EQ(hubDelta, 25);
+    EXPECT_LE(rows, 4u);
+    EXPECT_EQ(writeBehind.pendingCount(), 0u);
+}
+
+TEST_F(InventoryWriteBehindTest, GroupCommitWaitsForCommit)
+{
+    startLedger(WriteBehindDurability::GROUP_COMMIT, 1);
+
+    EXPECT_EQ(writeBehind.submit(transfer(20)), 1);
+
+    std::lock_guard<std::mutex> lock(batchesMutex);
+    ASSERT_FALSE(batches.empty());
+}
+
+TEST_F(InventoryWriteBehindTest, FailedGroupCommitRevertsLedger)
+{
+    commitSucceeds = false;
+    startLedger(WriteBehindDurability::GROUP_COMMIT, 1);
+
+    EXPECT_EQ(writeBehind.submit(transfer(20)), -1);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 500);
+    EXPECT_EQ(level(LocationType::HUB, 1, "Water"), 0);
+}
+
+TEST_F(InventoryWriteBehindTest, FailedCommitIsRetriedWhenAlreadyAcknowledged)
+{
+    commitSucceeds = false;
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1);
+
+    EXPECT_EQ(writeBehind.submit(transfer(20)), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_GT(writeBehind.pendingCount(), 0u);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 480);
+
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex);
+        commitSucceeds = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(writeBehind.pendingCount(), 0u);
+}
+
+TEST_F(InventoryWriteBehindTest, RejectsOrderThatWouldGoNegative)
+{
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1000);
+
+    EXPECT_EQ(writeBehind.submit(transfer(501)), -1);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 500);
+    EXPECT_EQ(level(LocationType::HUB, 1, "Water"), 0);
+}
+
+TEST_F(InventoryWriteBehindTest, RejectsOrderWithUnknownDestination)
+{
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1000);
+
+    std::vector<InventoryDelta> deltas = {InventoryDelta{LocationType::WAREHOUSE, 1, "Water", -5},
+                                          InventoryDelta{LocationType::HUB, 42, "Water", 5}};
+    EXPECT_EQ(writeBehind.submit(deltas), -1);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 500);
+}
+
+TEST_F(InventoryWriteBehindTest, RejectedDeltaIsDeadLetteredWithoutBlockingOthers)
+{
+    cache.load(LocationType::WAREHOUSE, 1, "Ice", 50);
+    cache.load(LocationType::HUB, 1, "Ice", 0);
+    rejectedProduct = "Ice";
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1);
+
+    EXPECT_EQ(writeBehind.submit({InventoryDelta{LocationType::WAREHOUSE, 1, "Ice", -5},
+                                  InventoryDelta{LocationType::HUB, 1, "Ice", 5}}),
+              1);
+    EXPECT_EQ(writeBehind.submit(transfer(20)), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    EXPECT_EQ(writeBehind.pendingCount(), 0u);
+    EXPECT_EQ(writeBehind.deadLetterCount(), 2u);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Ice"), 50);
+    EXPECT_EQ(level(LocationType::HUB, 1, "Ice"), 0);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 480);
+}
+
+TEST_F(InventoryWriteBehindTest, FailedRevertReloadsCache)
+{
+    cache.load(LocationType::WAREHOUSE, 1, "Ice", 50);
+    cache.load(LocationType::HUB, 1, "Ice", 0);
+    commitSucceeds = false;
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1);
+
+    EXPECT_EQ(writeBehind.submit({InventoryDelta{LocationType::WAREHOUSE, 1, "Ice", -5},
+                                  InventoryDelta{LocationType::HUB, 1, "Ice", 5}}),
+              1);
+    // The hub row moves on before the delta is rejected, so the delta can no longer be reverted
+    ASSERT_TRUE(cache.applyDelta(LocationType::HUB, 1, "Ice", -5));
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex);
+        rejectedProduct = "Ice";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::lock_guard<std::mutex> lock(batchesMutex);
+    EXPECT_EQ(reloads, 1);
+    EXPECT_TRUE(cache.isWarm());
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 500);
+}
+
+TEST_F(InventoryWriteBehindTest, OrdersAreTurnedAwayUntilTheLedgerIsReloaded)
+{
+    cache.load(LocationType::WAREHOUSE, 1, "Ice", 50);
+    cache.load(LocationType::HUB, 1, "Ice", 0);
+    commitSucceeds = false;
+    reloadSucceeds = false;
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1);
+
+    EXPECT_EQ(writeBehind.submit({InventoryDelta{LocationType::WAREHOUSE, 1, "Ice", -5},
+                                  InventoryDelta{LocationType::HUB, 1, "Ice", 5}}),
+              1);
+    ASSERT_TRUE(cache.applyDelta(LocationType::HUB, 1, "Ice", -5));
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex);
+        rejectedProduct = "Ice";
+        commitSucceeds = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(writeBehind.submit(transfer(10)), WRITE_BEHIND_RETRY_LATER);
+
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex);
+        reloadSucceeds = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(WRITE_BEHIND_RELOAD_RETRY_MS + 100));
+    EXPECT_EQ(writeBehind.submit(transfer(10)), 1);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 490);
+}
+
+TEST_F(InventoryWriteBehindTest, RaiseToCapacityCountsDeltasNotFlushedYet)
+{
+    commitSucceeds = false;
+    startLedger(WriteBehindDurability::ACK_IMMEDIATELY, 1);
+
+    EXPECT_EQ(writeBehind.submit(transfer(100)), 1);
+    EXPECT_EQ(writeBehind.raiseToCapacity(LocationType::WAREHOUSE, 1, "water", 450), 50);
+    EXPECT_EQ(writeBehind.raiseToCapacity(LocationType::WAREHOUSE, 1, "Water", 450), 0);
+    EXPECT_EQ(writeBehind.raiseToCapacity(LocationType::WAREHOUSE, 9, "Water", 450), -1);
+
+    {
+        std::lock_guard<std::mutex> lock(batchesMutex);
+        commitSucceeds = true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    EXPECT_EQ(writeBehind.pendingCount(), 0u);
+    EXPECT_EQ(level(LocationType::WAREHOUSE, 1, "Water"), 450);
+}
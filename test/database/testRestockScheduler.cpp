@@ -0,0 +1,70 @@
+#include "testRestockScheduler.hpp"
+#include <atomic>
+
+TEST_F(RestockSchedulerTest, RowsAreRequestedOnceUntilApplied)
+{
+    EXPECT_TRUE(scheduler.request(1, "Water"));
+    EXPECT_FALSE(scheduler.request(1, "WATER")) << "concurrent orders must not refill the row twice";
+    EXPECT_TRUE(scheduler.request(1, "Meat"));
+    EXPECT_TRUE(scheduler.request(2, "Water"));
+    ASSERT_EQ(scheduler.pending().size(), 3u);
+    EXPECT_EQ(scheduler.pending()[0].product, "Meat");
+
+    EXPECT_EQ(scheduler.applyPending(store), 3u);
+    EXPECT_TRUE(scheduler.pending().empty());
+    EXPECT_TRUE(scheduler.request(1, "Water")) << "a re-stocked row can be requested again";
+}
+
+TEST_F(RestockSchedulerTest, TopsUpToCapacityFromTheCurrentLevel)
+{
+    ASSERT_TRUE(scheduler.request(1, "Water"));
+    ASSERT_TRUE(scheduler.request(1, "Meat"));
+    // Stock received after the request is counted, so the row does not go over capacity
+    ASSERT_EQ(store.addQuantity(LocationType::WAREHOUSE, 1, "Water", 100), 1);
+
+    EXPECT_EQ(scheduler.applyPending(store), 2u);
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "Water"), MAX_CAPACITY);
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 1, "Meat"), MAX_CAPACITY);
+
+    std::vector<RestockRecord> completed = scheduler.completed();
+    ASSERT_EQ(completed.size(), 2u);
+    EXPECT_EQ(completed[0].product, "Meat");
+    EXPECT_EQ(completed[0].added, MAX_CAPACITY - 90);
+    EXPECT_EQ(completed[1].added, MAX_CAPACITY - 160);
+
+    std::string status = formatRestockStatus(scheduler.pending(), completed);
+    EXPECT_NE(status.find("Pending: 0"), std::string::npos);
+    EXPECT_NE(status.find("warehouse 1 Water: +840 units"), std::string::npos);
+}
+
+TEST_F(RestockSchedulerTest, FailedRestocksAreRecorded)
+{
+    ASSERT_TRUE(scheduler.request(3, "Water"));
+    EXPECT_EQ(scheduler.applyPending(store), 0u) << "warehouse 3 has no Water row";
+
+    ASSERT_EQ(scheduler.completed().size(), 1u);
+    EXPECT_FALSE(scheduler.completed()[0].ok);
+    EXPECT_NE(formatRestockStatus({}, scheduler.completed()).find("failed"), std::string::npos);
+    EXPECT_TRUE(scheduler.request(3, "Water")) << "a failed re-stock can be requested again";
+}
+
+TEST_F(RestockSchedulerTest, BackgroundThreadRunsOneTaskPerWarehouse)
+{
+    scheduler.request(1, "Water");
+    scheduler.request(1, "Meat");
+    scheduler.request(2, "Water");
+
+    std::atomic<int> tasks{0};
+    ASSERT_TRUE(scheduler.start([this, &tasks](std::function<void(InventoryStore&)> task) {
+        tasks++;
+        task(store);
+        return true;
+    }));
+    EXPECT_FALSE(scheduler.start([](std::function<void(InventoryStore&)>) { return true; }));
+    ASSERT_TRUE(waitForCompleted(3));
+    scheduler.stop();
+
+    EXPECT_EQ(tasks.load(), 2);
+    EXPECT_EQ(store.getQuantity(LocationType::WAREHOUSE, 2, "Water"), MAX_CAPACITY);
+    EXPECT_TRUE(scheduler.pending().empty());
+}
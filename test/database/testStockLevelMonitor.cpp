@@ -0,0 +1,73 @@
+#include "testStockLevelMonitor.hpp"
+
+TEST_F(StockLevelMonitorTest, FiresOncePerDownwardCrossing)
+{
+    level(500);
+    EXPECT_FALSE(crossing.low);
+    EXPECT_FALSE(crossing.restock);
+
+    level(STOCK_THRESHOLD);
+    EXPECT_TRUE(crossing.low);
+    EXPECT_FALSE(crossing.restock);
+
+    // Orders while the stock stays low do not repeat the alert
+    level(STOCK_THRESHOLD - 30);
+    EXPECT_FALSE(crossing.low);
+
+    level(RESTOCK_THRESHOLD - 10);
+    EXPECT_FALSE(crossing.low);
+    EXPECT_TRUE(crossing.restock);
+    EXPECT_EQ(crossing.quantity, RESTOCK_THRESHOLD - 10);
+
+    level(RESTOCK_THRESHOLD - 20);
+    EXPECT_FALSE(crossing.restock);
+}
+
+TEST_F(StockLevelMonitorTest, HysteresisPreventsFlapping)
+{
+    level(STOCK_THRESHOLD);
+    EXPECT_TRUE(crossing.low);
+
+    // Back above the threshold but within the hysteresis band: still disarmed
+    level(STOCK_THRESHOLD + STOCK_HYSTERESIS);
+    level(STOCK_THRESHOLD);
+    EXPECT_FALSE(crossing.low);
+
+    level(STOCK_THRESHOLD + STOCK_HYSTERESIS + 1);
+    level(STOCK_THRESHOLD - 1);
+    EXPECT_TRUE(crossing.low);
+
+    // A re-stock to full capacity re-arms both thresholds
+    level(RESTOCK_THRESHOLD);
+    EXPECT_TRUE(crossing.restock);
+    level(MAX_CAPACITY);
+    level(RESTOCK_THRESHOLD);
+    EXPECT_TRUE(crossing.low);
+    EXPECT_TRUE(crossing.restock);
+}
+
+TEST_F(StockLevelMonitorTest, PendingCrossingsAndUnknownRows)
+{
+    EXPECT_FALSE(monitor.take(1, "Water", crossing)) << "never observed";
+
+    monitor.observe(LocationType::HUB, 1, "Water", 0);
+    EXPECT_FALSE(monitor.take(1, "Water", crossing)) << "hubs are not monitored";
+
+    // The first level seen already below a threshold counts as a crossing
+    monitor.observe(LocationType::WAREHOUSE, 2, "Meat", 150);
+    monitor.observe(LocationType::WAREHOUSE, 3, "Meat", 150);
+    EXPECT_EQ(monitor.pending(), 2u);
+
+    // A crossing nobody took is dropped once the level recovers
+    monitor.observe(LocationType::WAREHOUSE, 3, "Meat", 900);
+    EXPECT_EQ(monitor.pending(), 1u);
+    ASSERT_TRUE(monitor.take(3, "Meat", crossing));
+    EXPECT_FALSE(crossing.low);
+
+    ASSERT_TRUE(monitor.take(2, "MEAT", crossing));
+    EXPECT_TRUE(crossing.low);
+    EXPECT_EQ(monitor.pending(), 0u);
+
+    monitor.forget(2, "Meat");
+    EXPECT_FALSE(monitor.take(2, "Meat", crossing));
+}
@@ -0,0 +1,50 @@
+/**
+ * @file testAlertManager.hpp
+ * @brief Header file for the alert coalescing tests.
+ */
+
+#ifndef TEST_ALERT_MANAGER_HPP
+#define TEST_ALERT_MANAGER_HPP
+
+#include "alertManager.hpp"
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include <memory>
+#include <string>
+
+/**
+ * @class AlertManagerTest
+ * @brief Test fixture with a manager using a short window.
+ */
+class AlertManagerTest : public ::testing::Test
+{
+  protected:
+    AlertManager manager{AlertManagerConfig{std::chrono::milliseconds(200)}}; ///< Manager under test.
+    std::string alert;                                                       ///< Alert returned by submit().
+
+    /**
+     * @brief Submits a low stock alert of Water in a warehouse.
+     * @param location Location of the alert.
+     * @return Whether the alert must be sent.
+     */
+    bool lowStock(const std::string& location = "warehouse 1")
+    {
+        return manager.submit(location, "Low Stock Alert: ", "Stock levels are low", 2, "Water", alert);
+    }
+
+    /**
+     * @brief Parses an alert.
+     * @param json Alert JSON.
+     * @return The "alert" object.
+     */
+    static Json::Value parse(const std::string& json)
+    {
+        Json::Value root;
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        reader->parse(json.data(), json.data() + json.size(), &root, nullptr);
+        return root["alert"];
+    }
+};
+
+#endif // TEST_ALERT_MANAGER_HPP
@@ -6,7 +6,6 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <json/json.h>
-#include <mysqlx/xdevapi.h>
 
 /**
  * @file testAnomalieHandler.hpp
@@ -0,0 +1,61 @@
+/**
+ * @file testCircuitBreaker.hpp
+ * @brief Header file for the inventory circuit breaker tests.
+ */
+
+#ifndef TEST_CIRCUIT_BREAKER_HPP
+#define TEST_CIRCUIT_BREAKER_HPP
+
+#include "circuitBreaker.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+/**
+ * @class CircuitBreakerTest
+ * @brief Test fixture with a breaker using small thresholds and a short cool-down.
+ */
+class CircuitBreakerTest : public ::testing::Test
+{
+  protected:
+    CircuitBreakerConfig config; ///< Thresholds used by the breaker.
+    CircuitBreaker breaker;      ///< Breaker under test.
+
+    void SetUp() override
+    {
+        config.window = 10;
+        config.minCalls = 4;
+        config.errorRatePercent = 50;
+        config.slowCallMs = 50;
+        config.openMs = 20;
+        breaker.configure(config);
+    }
+
+    /**
+     * @brief Records a number of calls with the same outcome.
+     */
+    void recordCalls(int count, bool failed)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            ASSERT_TRUE(breaker.allowRequest());
+            if (failed)
+            {
+                breaker.recordFailure();
+            }
+            else
+            {
+                breaker.recordSuccess(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    /**
+     * @brief Waits until the cool-down of an open breaker elapsed.
+     */
+    void waitCoolDown()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.openMs + 10));
+    }
+};
+
+#endif // TEST_CIRCUIT_BREAKER_HPP
@@ -0,0 +1,54 @@
+/**
+ * @file testEmbeddedInventoryStore.hpp
+ * @brief Header file for the embedded inventory backend tests.
+ */
+
+#ifndef TEST_EMBEDDED_INVENTORY_STORE_HPP
+#define TEST_EMBEDDED_INVENTORY_STORE_HPP
+
+#include "embeddedInventoryStore.hpp"
+#include "lowStockChecker.hpp"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class EmbeddedInventoryStoreTest
+ * @brief Test fixture with a seeded store and a scratch data file.
+ */
+class EmbeddedInventoryStoreTest : public ::testing::Test
+{
+  protected:
+    EmbeddedInventoryStore store;                           ///< In-memory store under test.
+    std::string path = "test_embedded_inventory.db";        ///< Scratch data file.
+
+    void SetUp() override
+    {
+        std::remove(path.c_str());
+        store.put(LocationType::WAREHOUSE, 1, "Water", 500);
+        store.put(LocationType::HUB, 1, "Water", 40);
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".tmp").c_str());
+    }
+
+    /**
+     * @brief Builds an order moving a product from a warehouse to a hub.
+     */
+    Json::Value createOrder(int warehouseId, int hubId, const std::string& product, int quantity)
+    {
+        Json::Value order;
+        order["general_info"]["source"]["type"] = "warehouse";
+        order["general_info"]["source"]["location"] = warehouseId;
+        order["general_info"]["destination"]["type"] = "hub";
+        order["general_info"]["destination"]["location"] = hubId;
+        order["general_info"]["action"]["product"]["name"] = product;
+        order["general_info"]["action"]["product"]["quantity"] = quantity;
+        return order;
+    }
+};
+
+#endif // TEST_EMBEDDED_INVENTORY_STORE_HPP
@@ -0,0 +1,64 @@
+/**
+ * @file testEventFeed.hpp
+ * @brief Header file for the event feed tests.
+ */
+
+#ifndef TEST_EVENT_FEED_HPP
+#define TEST_EVENT_FEED_HPP
+
+#include "eventFeed.hpp"
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class EventFeedTest
+ * @brief Test fixture with a feed keeping few events per subscriber.
+ */
+class EventFeedTest : public ::testing::Test
+{
+  protected:
+    EventFeed feed{4, std::chrono::milliseconds(10)}; ///< Feed under test.
+
+    /**
+     * @brief Builds the data of a stock change.
+     * @param quantity New quantity.
+     * @return The event data.
+     */
+    static Json::Value stockChange(int quantity)
+    {
+        Json::Value data;
+        data["product"] = "Water";
+        data["quantity"] = quantity;
+        return data;
+    }
+
+    /**
+     * @brief Splits a batch into its header and its events.
+     * @param message The @EVENTS message.
+     * @param header Output parameter receiving the first line.
+     * @return The parsed events, in order.
+     */
+    static std::vector<Json::Value> eventsOf(const std::string& message, std::string& header)
+    {
+        std::istringstream stream(message);
+        std::getline(stream, header);
+
+        std::vector<Json::Value> events;
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            Json::Value event;
+            reader->parse(line.data(), line.data() + line.size(), &event, nullptr);
+            events.push_back(event);
+        }
+        return events;
+    }
+};
+
+#endif // TEST_EVENT_FEED_HPP
@@ -0,0 +1,32 @@
+/**
+ * @file testInventoryCache.hpp
+ * @brief Header file for the in-process inventory cache tests.
+ */
+
+#ifndef TEST_INVENTORY_CACHE_HPP
+#define TEST_INVENTORY_CACHE_HPP
+
+#include "inventoryCache.hpp"
+#include <gtest/gtest.h>
+
+/**
+ * @class InventoryCacheTest
+ * @brief Test fixture that starts every test with an empty, cold cache.
+ */
+class InventoryCacheTest : public ::testing::Test
+{
+  protected:
+    InventoryCache& cache = InventoryCache::getInstance(); ///< Cache under test.
+
+    void SetUp() override
+    {
+        cache.clear();
+    }
+
+    void TearDown() override
+    {
+        cache.clear();
+    }
+};
+
+#endif // TEST_INVENTORY_CACHE_HPP
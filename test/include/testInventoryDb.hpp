@@ -141,6 +141,67 @@ void testGetWarehouseInventorySQLException();
  */
 void testConnectToDbFailure();
 
+/**
+ * @brief Tests asynchronous retrieval of hub inventory.
+ *
+ * This test verifies that getHubInventoryAsync() resolves to the same
+ * quantity as the synchronous getHubInventory().
+ */
+void testGetHubInventoryAsync();
+
+/**
+ * @brief Tests that the executor runs submitted tasks on worker sessions.
+ *
+ * This test submits several queries at once and verifies that every
+ * future receives its result.
+ */
+void testExecutorSubmit();
+
+/**
+ * @brief Tests successful asynchronous real-time update.
+ *
+ * This test verifies that realTimeUpdateAsync() moves the quantity from the
+ * source to the destination and invokes the callback with success.
+ */
+void testRealTimeUpdateAsyncSuccess();
+
+/**
+ * @brief Tests compensation of an asynchronous real-time update.
+ *
+ * This test verifies that when the destination update fails, the source
+ * update that already ran is reverted and the failure is reported.
+ */
+void testRealTimeUpdateAsyncCompensates();
+
+/**
+ * @brief Tests that asynchronous updates are rejected when the executor is stopped.
+ */
+void testRealTimeUpdateAsyncExecutorStopped();
+
+/**
+ * @brief Tests that cached statements and stored procedures agree.
+ *
+ * This test reads and updates the same row through an attached session
+ * (reusable statements) and a plain session (stored procedures).
+ */
+void testStatementCacheMatchesProcedures();
+
+/**
+ * @brief Tests the bulk inventory snapshot.
+ *
+ * This test verifies that getInventorySnapshot() returns every product row
+ * of the requested locations in a single call, and only those.
+ */
+void testGetInventorySnapshot();
+
+/**
+ * @brief Tests the degraded read-only mode of an open circuit breaker.
+ *
+ * This test verifies that reads return the last known level and updates
+ * fail fast while the breaker is open.
+ */
+void testCircuitOpenServesLastKnownStock();
+
 /**
  * @brief Unity setup function, called before each test.
  */
@@ -0,0 +1,105 @@
+/**
+ * @file testInventoryWriteBehind.hpp
+ * @brief Header file for the write-behind inventory ledger tests.
+ */
+
+#ifndef TEST_INVENTORY_WRITE_BEHIND_HPP
+#define TEST_INVENTORY_WRITE_BEHIND_HPP
+
+#include "inventoryWriteBehind.hpp"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class InventoryWriteBehindTest
+ * @brief Test fixture with a warm cache and a fake group commit that records every batch.
+ */
+class InventoryWriteBehindTest : public ::testing::Test
+{
+  protected:
+    InventoryCache& cache = InventoryCache::getInstance();                   ///< Ledger backing store.
+    InventoryWriteBehind& writeBehind = InventoryWriteBehind::getInstance(); ///< Ledger under test.
+    std::mutex batchesMutex;                                                 ///< Guards batches.
+    std::vector<std::vector<InventoryDelta>> batches;                        ///< Batches committed so far.
+    bool commitSucceeds = true;                                              ///< Whether the fake database is up.
+    std::string rejectedProduct;                                             ///< Product the fake database rejects.
+    int reloads = 0;                                                         ///< Cache reloads requested.
+    bool reloadSucceeds = true;                                              ///< Whether the fake reload succeeds.
+
+    void SetUp() override
+    {
+        cache.clear();
+        cache.load(LocationType::WAREHOUSE, 1, "Water", 500);
+        cache.load(LocationType::HUB, 1, "Water", 0);
+        cache.markWarm();
+    }
+
+    void TearDown() override
+    {
+        writeBehind.stop();
+        cache.clear();
+    }
+
+    /**
+     * @brief Starts the ledger with the fake group commit.
+     * @param durability Acknowledge policy.
+     * @param flushOrders Orders that force a flush.
+     */
+    void startLedger(WriteBehindDurability durability, int flushOrders)
+    {
+        WriteBehindConfig config;
+        config.enabled = true;
+        config.flushIntervalMs = 1;
+        config.flushOrders = flushOrders;
+        config.durability = durability;
+        ASSERT_TRUE(writeBehind.start(
+            config,
+            [this](const std::vector<InventoryDelta>& deltas) {
+                std::lock_guard<std::mutex> lock(batchesMutex);
+                batches.push_back(deltas);
+                for (const auto& delta : deltas)
+                {
+                    if (delta.product == rejectedProduct)
+                    {
+                        return 0;
+                    }
+                }
+                return commitSucceeds ? 1 : -1;
+            },
+            [this]() {
+                std::lock_guard<std::mutex> lock(batchesMutex);
+                reloads++;
+                if (!reloadSucceeds)
+                {
+                    return false;
+                }
+                cache.load(LocationType::WAREHOUSE, 1, "Water", 500);
+                cache.load(LocationType::HUB, 1, "Water", 0);
+                cache.markWarm();
+                return true;
+            }));
+    }
+
+    /**
+     * @brief Gets the cached quantity of a row.
+     */
+    int level(LocationType type, int locationId, const std::string& product)
+    {
+        int quantity = -1;
+        cache.get(type, locationId, product, quantity);
+        return quantity;
+    }
+
+    /**
+     * @brief Builds the deltas of a warehouse 1 to hub 1 transfer.
+     */
+    static std::vector<InventoryDelta> transfer(int quantity)
+    {
+        return {InventoryDelta{LocationType::WAREHOUSE, 1, "Water", -quantity},
+                InventoryDelta{LocationType::HUB, 1, "Water", quantity}};
+    }
+};
+
+#endif // TEST_INVENTORY_WRITE_BEHIND_HPP
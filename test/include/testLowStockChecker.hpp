@@ -5,7 +5,6 @@
 #include "lowStockChecker.hpp"
 #include <gtest/gtest.h>
 #include <json/json.h>
-#include <mysqlx/xdevapi.h>
 
 /**
  * @class LowStockCheckerTest
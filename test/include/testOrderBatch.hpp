@@ -0,0 +1,40 @@
+/**
+ * @file testOrderBatch.hpp
+ * @brief Header file for the batch order validation tests.
+ */
+
+#ifndef TEST_ORDER_BATCH_HPP
+#define TEST_ORDER_BATCH_HPP
+
+#include "orderBatch.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+/**
+ * @class OrderBatchTest
+ * @brief Test fixture with the built-in rules and helpers to fill batches.
+ */
+class OrderBatchTest : public ::testing::Test
+{
+  protected:
+    OrderRuleTable rules = OrderRuleTable::builtin(); ///< Rules the batches are checked against.
+    OrderBatch batch;                                 ///< Batch under test.
+    OrderBatchResult result;                          ///< Outcome of the batch.
+
+    /**
+     * @brief Appends random orders, with unknown clients and quantities that are not positive.
+     * @param orders Number of orders to append.
+     */
+    void fillRandom(std::size_t orders)
+    {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> client(-1, static_cast<int>(rules.clientCount()));
+        std::uniform_int_distribution<int> quantity(-5, 150);
+        for (std::size_t i = 0; i < orders; i++)
+        {
+            batch.add(client(random), random() % 2, quantity(random));
+        }
+    }
+};
+
+#endif // TEST_ORDER_BATCH_HPP
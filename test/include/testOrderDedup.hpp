@@ -0,0 +1,25 @@
+/**
+ * @file testOrderDedup.hpp
+ * @brief Header file for the order deduplication tests.
+ */
+
+#ifndef TEST_ORDER_DEDUP_HPP
+#define TEST_ORDER_DEDUP_HPP
+
+#include "orderDedup.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+/**
+ * @class OrderDedupTest
+ * @brief Test fixture with an empty record and a buffer for the returned replies.
+ */
+class OrderDedupTest : public ::testing::Test
+{
+  protected:
+    OrderDedup dedup;                 ///< Record under test.
+    std::vector<std::string> replies; ///< Replies returned by begin().
+};
+
+#endif // TEST_ORDER_DEDUP_HPP
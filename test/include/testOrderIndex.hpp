@@ -0,0 +1,32 @@
+/**
+ * @file testOrderIndex.hpp
+ * @brief Header file for the order index and QUERY_ORDERS tests.
+ */
+
+#ifndef TEST_ORDER_INDEX_HPP
+#define TEST_ORDER_INDEX_HPP
+
+#include "orderIndex.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class OrderIndexTest
+ * @brief Test fixture with an empty index.
+ */
+class OrderIndexTest : public ::testing::Test
+{
+  protected:
+    OrderIndex index; ///< Index under test.
+
+    /**
+     * @brief Builds the fields of an order sent from warehouse 1.
+     */
+    static OrderFacts facts(const std::string& product, const std::string& destination,
+                            const std::string& priority = "none")
+    {
+        return OrderFacts{product, "warehouse 1", destination, priority, 1};
+    }
+};
+
+#endif // TEST_ORDER_INDEX_HPP
@@ -0,0 +1,95 @@
+/**
+ * @file testOrderJournal.hpp
+ * @brief Header file for the order journal tests.
+ */
+
+#ifndef TEST_ORDER_JOURNAL_HPP
+#define TEST_ORDER_JOURNAL_HPP
+
+#include "orderJournal.hpp"
+#include <chrono>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class OrderJournalTest
+ * @brief Test fixture with a journal in an empty scratch directory.
+ */
+class OrderJournalTest : public ::testing::Test
+{
+  protected:
+    OrderJournalConfig config; ///< Settings of the journal under test.
+    OrderJournal journal;      ///< Journal under test.
+
+    void SetUp() override
+    {
+        config.directory = "test_order_journal";
+        config.segmentBytes = ORDER_JOURNAL_MIN_SEGMENT_BYTES;
+        config.sync = JournalSync::NEVER;
+        std::filesystem::remove_all(config.directory);
+        ASSERT_TRUE(journal.open(config));
+    }
+
+    void TearDown() override
+    {
+        journal.close();
+        std::filesystem::remove_all(config.directory);
+    }
+
+    /**
+     * @brief Reads every payload of a journal, oldest first.
+     */
+    static std::vector<std::string> payloads(const OrderJournal& source)
+    {
+        std::vector<std::string> result;
+        source.forEach([&result](const OrderRecord& record) { result.emplace_back(record.payload); });
+        return result;
+    }
+
+    /**
+     * @brief Counts the segment files in the journal directory.
+     */
+    std::size_t segmentFiles() const
+    {
+        std::size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(config.directory))
+        {
+            count += entry.path().extension() == ".seg" ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Waits for the background thread to compress a number of segments.
+     */
+    static bool waitForCompressed(const OrderJournal& source, std::size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (source.compressedSegments() < count)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Builds an order shaped like the ones the server receives.
+     */
+    static std::string sampleOrder(int i)
+    {
+        return R"({"general_info":{"id":")" + std::to_string(100000 + i) +
+               R"(","action":{"product":{"name":"product)" + std::to_string(i % 7) + R"(","quantity":)" +
+               std::to_string(i % 50 + 1) + R"(}},"source":{"type":"warehouse","location":")" +
+               std::to_string(i % 5 + 1) + R"("},"destination":{"type":"hub","location":")" +
+               std::to_string(i % 3 + 1) + R"("},"priority":")" + (i % 2 ? "high" : "low") + R"("}})";
+    }
+};
+
+#endif // TEST_ORDER_JOURNAL_HPP
@@ -0,0 +1,39 @@
+/**
+ * @file testOrderReport.hpp
+ * @brief Header file for the order rollup and SHOW_REPORT command tests.
+ */
+
+#ifndef TEST_ORDER_REPORT_HPP
+#define TEST_ORDER_REPORT_HPP
+
+#include "orderReport.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class OrderReportTest
+ * @brief Test fixture with empty rollups and a fixed clock.
+ */
+class OrderReportTest : public ::testing::Test
+{
+  protected:
+    static constexpr std::int64_t MINUTE_MS = 60 * 1000;            ///< One minute in milliseconds.
+    static constexpr std::int64_t HOUR_MS = 60 * MINUTE_MS;         ///< One hour in milliseconds.
+    static constexpr std::int64_t NOW_MS = 1000 * HOUR_MS + 30 * MINUTE_MS; ///< Half past an hour.
+
+    OrderRollup rollup; ///< Rollups under test.
+    ReportQuery query;  ///< Parsed parameters.
+    std::string error;  ///< JSON error of a rejected command.
+
+    /**
+     * @brief Records an order placed some minutes before NOW_MS.
+     */
+    void recordAgo(std::int64_t minutesAgo, const std::string& product, int quantity,
+                   const std::string& priority = "high")
+    {
+        rollup.record(NOW_MS - minutesAgo * MINUTE_MS, OrderFacts{product, "warehouse 1", "hub 1", priority, quantity});
+    }
+};
+
+#endif // TEST_ORDER_REPORT_HPP
@@ -0,0 +1,61 @@
+/**
+ * @file testOrderRules.hpp
+ * @brief Header file for the order rule table tests.
+ */
+
+#ifndef TEST_ORDER_RULES_HPP
+#define TEST_ORDER_RULES_HPP
+
+#include "orderRules.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <json/json.h>
+#include <memory>
+#include <string>
+
+/**
+ * @class OrderRulesTest
+ * @brief Test fixture that parses rule configurations and writes rule files.
+ */
+class OrderRulesTest : public ::testing::Test
+{
+  protected:
+    std::string path = "test_order_rules.json"; ///< Scratch rules file.
+    std::string error;                          ///< Error returned by compile() or reload().
+
+    void SetUp() override
+    {
+        std::remove(path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    /**
+     * @brief Parses a configuration.
+     * @param text JSON text.
+     * @return The parsed value.
+     */
+    static Json::Value parse(const std::string& text)
+    {
+        Json::Value value;
+        Json::CharReaderBuilder builder;
+        std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        reader->parse(text.data(), text.data() + text.size(), &value, nullptr);
+        return value;
+    }
+
+    /**
+     * @brief Writes the rules file.
+     * @param text File contents.
+     */
+    void writeFile(const std::string& text)
+    {
+        std::ofstream(path, std::ios::trunc) << text;
+    }
+};
+
+#endif // TEST_ORDER_RULES_HPP
@@ -2,9 +2,13 @@
 #define TEST_ORDER_STORAGE_HPP
 
 #include "orderStorage.hpp"
+#include <cstdlib>
+#include <filesystem>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 class CoutRedirect
 {
@@ -16,9 +20,14 @@ class CoutRedirect
     std::streambuf* old;
 };
 
+/// Scratch journal directory of the order storage tests, so they never touch the server's journal.
+#define TEST_ORDER_STORAGE_JOURNAL_DIR "test_order_storage_journal"
+
 class OrderStorageTest : public ::testing::Test
 {
   protected:
+    static void SetUpTestSuite();
+    static void TearDownTestSuite();
     void SetUp() override;
 };
 
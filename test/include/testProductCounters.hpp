@@ -0,0 +1,22 @@
+/**
+ * @file testProductCounters.hpp
+ * @brief Header file for the sharded product counter tests.
+ */
+
+#ifndef TEST_PRODUCT_COUNTERS_HPP
+#define TEST_PRODUCT_COUNTERS_HPP
+
+#include "productCounters.hpp"
+#include <gtest/gtest.h>
+
+/**
+ * @class ProductCountersTest
+ * @brief Test fixture with empty counters.
+ */
+class ProductCountersTest : public ::testing::Test
+{
+  protected:
+    ProductCounters counters; ///< Counters under test.
+};
+
+#endif // TEST_PRODUCT_COUNTERS_HPP
@@ -0,0 +1,23 @@
+/**
+ * @file testRecentOrders.hpp
+ * @brief Header file for the recent order ring tests.
+ */
+
+#ifndef TEST_RECENT_ORDERS_HPP
+#define TEST_RECENT_ORDERS_HPP
+
+#include "recentOrders.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class RecentOrdersTest
+ * @brief Test fixture with an empty ring of four orders.
+ */
+class RecentOrdersTest : public ::testing::Test
+{
+  protected:
+    RecentOrders ring{4}; ///< Ring under test.
+};
+
+#endif // TEST_RECENT_ORDERS_HPP
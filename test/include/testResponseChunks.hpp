@@ -0,0 +1,49 @@
+/**
+ * @file testResponseChunks.hpp
+ * @brief Header file for the chunked response tests.
+ */
+
+#ifndef TEST_RESPONSE_CHUNKS_HPP
+#define TEST_RESPONSE_CHUNKS_HPP
+
+#include "responseChunks.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class ResponseChunksTest
+ * @brief Test fixture with an empty set of streams and a report longer than one frame.
+ */
+class ResponseChunksTest : public ::testing::Test
+{
+  protected:
+    ResponseStreams streams; ///< Streams under test.
+    std::string report;      ///< Report of 40 full chunks.
+
+    void SetUp() override
+    {
+        for (int i = 0; report.size() < 40 * RESPONSE_CHUNK_SIZE; i++)
+        {
+            report += "- product " + std::to_string(i) + ": " + std::to_string(i * 7) + "\n";
+        }
+        report.resize(40 * RESPONSE_CHUNK_SIZE);
+    }
+
+    /**
+     * @brief Extracts the payload of a frame.
+     */
+    static std::string payloadOf(const std::string& frame)
+    {
+        return frame.substr(frame.find('\n') + 1);
+    }
+
+    /**
+     * @brief Extracts the header of a frame, without its newline.
+     */
+    static std::string headerOf(const std::string& frame)
+    {
+        return frame.substr(0, frame.find('\n'));
+    }
+};
+
+#endif // TEST_RESPONSE_CHUNKS_HPP
@@ -0,0 +1,48 @@
+/**
+ * @file testRestockScheduler.hpp
+ * @brief Header file for the background re-stock tests.
+ */
+
+#ifndef TEST_RESTOCK_SCHEDULER_HPP
+#define TEST_RESTOCK_SCHEDULER_HPP
+
+#include "embeddedInventoryStore.hpp"
+#include "restockScheduler.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+/**
+ * @class RestockSchedulerTest
+ * @brief Test fixture with a scheduler and a store with two low warehouses.
+ */
+class RestockSchedulerTest : public ::testing::Test
+{
+  protected:
+    RestockScheduler scheduler{MAX_CAPACITY, std::chrono::milliseconds(10)}; ///< Scheduler under test.
+    EmbeddedInventoryStore store;                                            ///< Warehouse stock.
+
+    void SetUp() override
+    {
+        store.put(LocationType::WAREHOUSE, 1, "Water", 60);
+        store.put(LocationType::WAREHOUSE, 1, "Meat", 90);
+        store.put(LocationType::WAREHOUSE, 2, "Water", 80);
+    }
+
+    /**
+     * @brief Waits until the scheduler completed a number of re-stocks.
+     * @param count Completed re-stocks expected.
+     * @return true if they completed within a few seconds.
+     */
+    bool waitForCompleted(std::size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (scheduler.completed().size() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return scheduler.completed().size() >= count;
+    }
+};
+
+#endif // TEST_RESTOCK_SCHEDULER_HPP
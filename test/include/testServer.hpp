@@ -21,12 +21,19 @@
 #include "json/writer.h"
 #include <arpa/inet.h>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #define BUFFER_SIZE_SERVER_T 4024
 #define PORT_SERVER_TEST 8080
+/// Scratch journal directory of the server tests, so they never touch the server's journal.
+#define TEST_SERVER_JOURNAL_DIR "test_server_journal"
 
 class ServerTest : public ::testing::Test
 {
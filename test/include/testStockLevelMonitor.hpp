@@ -0,0 +1,35 @@
+/**
+ * @file testStockLevelMonitor.hpp
+ * @brief Header file for the stock threshold crossing tests.
+ */
+
+#ifndef TEST_STOCK_LEVEL_MONITOR_HPP
+#define TEST_STOCK_LEVEL_MONITOR_HPP
+
+#include "stockLevelMonitor.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class StockLevelMonitorTest
+ * @brief Test fixture with a monitor using the default thresholds.
+ */
+class StockLevelMonitorTest : public ::testing::Test
+{
+  protected:
+    StockLevelMonitor monitor; ///< Monitor under test.
+    StockCrossing crossing;    ///< Crossings returned by take().
+
+    /**
+     * @brief Records a level of Water in warehouse 1 and takes its crossings.
+     * @param quantity New level.
+     */
+    void level(int quantity)
+    {
+        monitor.observe(LocationType::WAREHOUSE, 1, "Water", quantity);
+        crossing = StockCrossing();
+        ASSERT_TRUE(monitor.take(1, "water", crossing));
+    }
+};
+
+#endif // TEST_STOCK_LEVEL_MONITOR_HPP
@@ -0,0 +1,29 @@
+/**
+ * @file testStockQuery.hpp
+ * @brief Header file for the GET_STOCK command tests.
+ */
+
+#ifndef TEST_STOCK_QUERY_HPP
+#define TEST_STOCK_QUERY_HPP
+
+#include "stockQuery.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+/**
+ * @class StockQueryTest
+ * @brief Test fixture holding the parsed query and error of each test.
+ */
+class StockQueryTest : public ::testing::Test
+{
+  protected:
+    StockQuery query;  ///< Parsed filters.
+    std::string error; ///< JSON error of a rejected command.
+
+    void SetUp() override
+    {
+        error.clear();
+    }
+};
+
+#endif // TEST_STOCK_QUERY_HPP
@@ -76,6 +76,16 @@ void test_manageDbUserWithAuth_success(void);
  */
 void test_manageDbUserWithAuth_null_proxy(void);
 
+/**
+ * @brief Prueba que el pool devuelve la misma conexión y la misma sentencia preparada tras liberarla.
+ */
+void test_pool_reuses_connection(void);
+
+/**
+ * @brief Prueba varios logins consecutivos reutilizando las conexiones del pool.
+ */
+void test_authenticate_repeated_logins(void);
+
 /**
  * @brief Prueba de eliminación de un usuario de la base de datos.
  */
@@ -33,6 +33,10 @@ void test_read_json_file_empty_file();
 void test_initialize_client_udp_host_not_found();
 void test_initialize_client_udp_socket_error();
 
+void test_chunk_assembler_reassembles_frames_in_order(void);
+void test_chunk_assembler_requests_next_window_and_lost_frames(void);
+void test_chunk_assembler_waits_for_split_frames(void);
+
 void setUp(void);
 void tearDown(void);
 
@@ -137,13 +137,10 @@ TEST(ServerTests, ForwardMessageToTcpClient)
     mockAddr.sin_family = AF_INET;
     inet_pton(AF_INET, "192.168.0.10", &mockAddr.sin_addr);
 
-    // Simulamos que el cliente TCP tiene un socket ficticio 123
-    server->registerClient(2222, "TCP", mockAddr, 123);
-
     // Mock del write() usando pipe para no fallar
     int fds[2];
     pipe(fds);
-    clientMapTcp[2222].socket_fd = fds[1];
+    server->registerClient(2222, "TCP", mockAddr, fds[1]);
 
     testing::internal::CaptureStdout();
     server->forwardMessageToClient("Test TCP Message", 1, "tcp");
@@ -310,6 +307,81 @@ TEST(ServerTests, RegisterClientMaxIdExceededUDP)
     ASSERT_EQ(result, -1);
 }
 
+TEST(ServerTests, HandleOrderPublishesStockOfStringLocations)
+{
+    resetServerState();
+
+    const std::string path = "test_server_inventory.dat";
+    std::remove(path.c_str());
+    auto store = std::make_shared<EmbeddedInventoryStore>();
+    ASSERT_TRUE(store->open(path));
+    store->seed();
+    ASSERT_TRUE(store->put(LocationType::WAREHOUSE, 1, "Clothes", 500));
+    server->setInventoryStore(store);
+    EventFeed::getInstance().subscribe(77, "tcp", {EVENT_TOPIC_STOCK});
+
+    // Locations sent as numeric strings must not throw while the stock change is published
+    std::vector<std::string> replies;
+    server->handleOrder(R"({"general_info":{"id":"string-location",)"
+                        R"("source":{"type":"warehouse","location":"1"},"destination":{"type":"hub","location":"2"},)"
+                        R"("action":{"type":"request","product":{"id":"5","name":"Clothes","quantity":60}}}})",
+                        "TCP", 77, [&replies](const std::string& message) { replies.push_back(message); });
+
+    std::vector<EventBatch> batches = EventFeed::getInstance().drain();
+    EventFeed::getInstance().removeClient(77, "tcp");
+    server->setInventoryStore(nullptr);
+    store.reset();
+    std::remove(path.c_str());
+
+    ASSERT_FALSE(replies.empty());
+    EXPECT_EQ(replies.front(), "Successful order!");
+    ASSERT_EQ(batches.size(), 1u);
+    EXPECT_NE(batches[0].message.find("\"topic\":\"stock:warehouse:1\""), std::string::npos);
+    EXPECT_NE(batches[0].message.find("\"topic\":\"stock:hub:2\""), std::string::npos);
+}
+
+// Embedded store whose next transfer fails, like one whose stock was taken by a concurrent order
+class RacedInventoryStore : public EmbeddedInventoryStore
+{
+  public:
+    bool failNext = true;
+
+    int transfer(const InventoryTransfer& transfer) override
+    {
+        if (failNext)
+        {
+            failNext = false;
+            return -1;
+        }
+        return EmbeddedInventoryStore::transfer(transfer);
+    }
+};
+
+TEST(ServerTests, HandleOrderAnswersFailedTransfersAndProcessesTheirRetry)
+{
+    resetServerState();
+
+    auto store = std::make_shared<RacedInventoryStore>();
+    store->seed();
+    ASSERT_TRUE(store->put(LocationType::WAREHOUSE, 1, "Clothes", 500));
+    server->setInventoryStore(store);
+
+    const std::string order = R"({"general_info":{"id":"raced-transfer",)"
+                              R"("source":{"type":"warehouse","location":1},"destination":{"type":"hub","location":2},)"
+                              R"("action":{"type":"request","product":{"id":"5","name":"Clothes","quantity":60}}}})";
+    std::vector<std::string> first;
+    server->handleOrder(order, "TCP", 78, [&first](const std::string& message) { first.push_back(message); });
+    std::vector<std::string> retry;
+    server->handleOrder(order, "TCP", 78, [&retry](const std::string& message) { retry.push_back(message); });
+    server->setInventoryStore(nullptr);
+
+    ASSERT_FALSE(first.empty()) << "a failed transfer must be answered";
+    EXPECT_NE(first.front().find("Order not applied"), std::string::npos);
+    ASSERT_FALSE(retry.empty()) << "the retry must be processed, not replayed empty";
+    EXPECT_EQ(retry.front(), "Successful order!");
+    EXPECT_EQ(store->getQuantity(LocationType::WAREHOUSE, 1, "Clothes"), 440);
+}
+
 TEST(ServerTest, StartServer_HandlesClients)
 {
     resetServerState();
@@ -342,8 +414,12 @@ TEST(ServerTest, StartServer_HandlesClients)
 int main(int argc, char** argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
+    // Orders handled by the tests go to a scratch journal, opened on the first one
+    setenv("ORDER_JOURNAL_DIR", TEST_SERVER_JOURNAL_DIR, 1);
+    std::filesystem::remove_all(TEST_SERVER_JOURNAL_DIR);
     server = Server::getInstance(PORT_SERVER_TEST);
     int result = RUN_ALL_TESTS();
     server->closeServer();
+    std::filesystem::remove_all(TEST_SERVER_JOURNAL_DIR);
     return result;
 }